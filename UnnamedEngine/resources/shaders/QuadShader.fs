@@ -0,0 +1,18 @@
+#version 140
+
+/* The texture */
+uniform sampler2D tex;
+
+/* The colour of the quad */
+uniform vec4 colour;
+
+/* The data passed on to the fragment shader */
+in vec2 frag_textureCoord;
+
+/* The fragment colour */
+out vec4 FragColor;
+
+/* The main method */
+void main() {
+	FragColor = colour * texture2D(tex, frag_textureCoord);
+}
\ No newline at end of file
@@ -0,0 +1,20 @@
+#version 140
+
+/* The model view projection matrix */
+uniform mat4 mvpMatrix;
+
+/* The area of the texture being used (left, top, right, bottom) */
+uniform vec4 textureArea;
+
+/* The data being passed in, a quad from (0, 0) to (1, 1) */
+in vec3 position;
+
+/* The data passed on to the fragment shader */
+out vec2 frag_textureCoord;
+
+/* The main method */
+void main() {
+	frag_textureCoord = mix(textureArea.xy, textureArea.zw, position.xy);
+	
+	gl_Position = mvpMatrix * vec4(position, 1.0);
+}
\ No newline at end of file
@@ -1,5 +0,0 @@
-#include "LightingData.fs"
-
-void main() {
-	FragColor = ambientLight * (material.diffuseColour * texture2D(material.diffuseTexture, frag_textureCoord));
-}
\ No newline at end of file
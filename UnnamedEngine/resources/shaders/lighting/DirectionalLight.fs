@@ -1,7 +0,0 @@
-#include "LightingData.fs"
-
-uniform DirectionalLight directionalLight;
-
-void main() {
-	FragColor = calculateDirectionalLight(directionalLight, frag_normal);
-}
\ No newline at end of file
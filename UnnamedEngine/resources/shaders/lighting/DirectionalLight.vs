@@ -1 +0,0 @@
-#include "LightingData.vs"
\ No newline at end of file
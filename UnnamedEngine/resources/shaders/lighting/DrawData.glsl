@@ -0,0 +1,11 @@
+/* The data of each draw in a multi draw, found using its base instance */
+struct DrawData {
+	mat4 modelMatrix;
+	mat4 normalMatrix;
+	vec4 diffuseColour;
+	float shininess;
+};
+
+layout(std430, binding = 0) readonly buffer DrawBuffer {
+	DrawData draws[];
+};
@@ -35,15 +35,81 @@ uniform vec4 ambientLight;
 uniform float specularIntensity;
 uniform vec3 eyePosition;
 
-in vec3 frag_vertex;
+#ifdef TEXTURE
 in vec2 frag_textureCoord;
+#endif
+#ifdef NORMALS
 in vec3 frag_normal;
+#endif
+#ifdef SHADOWS
+uniform sampler2D shadowMap;
+in vec4 frag_lightSpacePosition;
+#endif
 
 in vec3 frag_worldPosition;
 
+#ifdef MULTI_DRAW
+#include "DrawData.glsl"
+flat in int frag_drawIndex;
+#endif
+
+#ifdef DIRECTIONAL_LIGHT
+uniform DirectionalLight directionalLight;
+#endif
+#ifdef POINT_LIGHT
+uniform PointLight pointLight;
+#endif
+#ifdef SPOT_LIGHT
+uniform SpotLight spotLight;
+#endif
+
 /* The fragment colour */
 out vec4 FragColor;
 
+/* Multi draws take the values of the material from their draw, other than the texture */
+vec4 getMaterialDiffuseColour() {
+#ifdef MULTI_DRAW
+	return draws[frag_drawIndex].diffuseColour;
+#else
+	return material.diffuseColour;
+#endif
+}
+
+float getMaterialShininess() {
+#ifdef MULTI_DRAW
+	return draws[frag_drawIndex].shininess;
+#else
+	return material.shininess;
+#endif
+}
+
+vec4 getDiffuseColour() {
+#ifdef TEXTURE
+	return getMaterialDiffuseColour() * texture2D(material.diffuseTexture, frag_textureCoord);
+#else
+	return getMaterialDiffuseColour();
+#endif
+}
+
+vec3 getNormal() {
+#ifdef NORMALS
+	return frag_normal;
+#else
+	return vec3(0.0, 0.0, 1.0);
+#endif
+}
+
+float calculateShadow() {
+#ifdef SHADOWS
+	vec3 coords = (frag_lightSpacePosition.xyz / frag_lightSpacePosition.w) * 0.5 + 0.5;
+	if (coords.z > 1.0)
+		return 1.0;
+	return coords.z - 0.005 > texture2D(shadowMap, coords.xy).r ? 0.0 : 1.0;
+#else
+	return 1.0;
+#endif
+}
+
 vec4 calculateLight(BaseLight base, vec3 direction, vec3 normal) {
 	float diffuseFactor = max(dot(normal, -direction), 0.0);
 	vec4 diffuseColour = vec4(0.0, 0.0, 0.0, 0.0);
@@ -55,11 +121,11 @@ vec4 calculateLight(BaseLight base, vec3 direction, vec3 normal) {
 		float specAngle = max(dot(reflectDir, normalize(eyePosition)), 0.0);
 		
 		if (specAngle > 0.0) {
-			float specularFactor = pow(specAngle, material.shininess);
+			float specularFactor = pow(specAngle, getMaterialShininess());
 			specularColour = vec4(base.colour, 1.0) * specularIntensity * specularFactor;
 		}
 	}
-	return (diffuseColour + specularColour) * material.diffuseColour * texture2D(material.diffuseTexture, frag_textureCoord);
+	return (diffuseColour + specularColour) * getDiffuseColour();
 }
 
 vec4 calculateDirectionalLight(DirectionalLight directionalLight, vec3 normal) {
@@ -97,3 +163,17 @@ vec4 calculateSpotLight(SpotLight spotLight, vec3 normal) {
 	return colour;
 }
 
+void main() {
+#ifdef AMBIENT_LIGHT
+	FragColor = ambientLight * getDiffuseColour();
+#endif
+#ifdef DIRECTIONAL_LIGHT
+	FragColor = calculateDirectionalLight(directionalLight, getNormal()) * calculateShadow();
+#endif
+#ifdef POINT_LIGHT
+	FragColor = calculatePointLight(pointLight, getNormal()) * calculateShadow();
+#endif
+#ifdef SPOT_LIGHT
+	FragColor = calculateSpotLight(spotLight, getNormal()) * calculateShadow();
+#endif
+}
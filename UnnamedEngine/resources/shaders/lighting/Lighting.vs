@@ -0,0 +1,74 @@
+#version 140
+
+/* When INSTANCING or MULTI_DRAW is defined the model matrix of each instance or draw is given
+ * separately and mvpMatrix should only contain the view and projection. Otherwise mvpMatrix
+ * contains the model matrix as well, and modelMatrix is only used to find the world position */
+uniform mat4 mvpMatrix;
+
+#ifndef MULTI_DRAW
+#ifndef INSTANCING
+uniform mat4 modelMatrix;
+#endif
+#endif
+
+in vec3 position;
+
+#ifdef TEXTURE
+in vec2 textureCoord;
+out vec2 frag_textureCoord;
+#endif
+
+#ifdef NORMALS
+uniform mat4 nMatrix;
+in vec3 normal;
+out vec3 frag_normal;
+#endif
+
+#ifdef INSTANCING
+in mat4 instanceMatrix;
+#endif
+
+#ifdef MULTI_DRAW
+#include "DrawData.glsl"
+flat out int frag_drawIndex;
+#endif
+
+#ifdef SHADOWS
+uniform mat4 lightSpaceMatrix;
+out vec4 frag_lightSpacePosition;
+#endif
+
+out vec3 frag_worldPosition;
+
+void main() {
+#ifdef MULTI_DRAW
+	frag_drawIndex = gl_BaseInstanceARB;
+	vec4 vertex = draws[gl_BaseInstanceARB].modelMatrix * vec4(position, 1.0);
+	vec4 worldPosition = vertex;
+#else
+#ifdef INSTANCING
+	vec4 vertex = instanceMatrix * vec4(position, 1.0);
+	vec4 worldPosition = vertex;
+#else
+	vec4 vertex = vec4(position, 1.0);
+	vec4 worldPosition = modelMatrix * vertex;
+#endif
+#endif
+
+#ifdef TEXTURE
+	frag_textureCoord = textureCoord;
+#endif
+#ifdef NORMALS
+#ifdef MULTI_DRAW
+	frag_normal = normalize(vec4(normal, 0.0) * draws[gl_BaseInstanceARB].normalMatrix).xyz;
+#else
+	frag_normal = normalize(vec4(normal, 0.0) * nMatrix).xyz;
+#endif
+#endif
+#ifdef SHADOWS
+	frag_lightSpacePosition = lightSpaceMatrix * worldPosition;
+#endif
+	frag_worldPosition = worldPosition.xyz; //Always in world space, the same space as the positions of point and spot lights
+	
+	gl_Position = mvpMatrix * vertex;
+}
@@ -1,7 +0,0 @@
-#include "LightingData.fs"
-
-uniform PointLight pointLight;
-
-void main() {
-	FragColor = calculatePointLight(pointLight, frag_normal);
-}
\ No newline at end of file
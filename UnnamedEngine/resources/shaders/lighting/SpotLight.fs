@@ -1,7 +0,0 @@
-#include "LightingData.fs"
-
-uniform SpotLight spotLight;
-
-void main() {
-	FragColor = calculateSpotLight(spotLight, frag_normal);
-}
\ No newline at end of file
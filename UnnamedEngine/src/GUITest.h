@@ -36,6 +36,7 @@
 class GUITest : public Game {
 private:
 	Camera2D* camera;
+	SpriteBatch* batch;
 
 	GUIButton* button;
 	GUICheckBox* checkBox;
@@ -78,6 +79,7 @@ void GUITest::created() {
 	camera = new Camera2D(Matrix4f().initOrthographic(0, getSettings()->getWindowWidth(), getSettings()->getWindowHeight(), 0, -1, 1));
 	camera->update();
 	Renderer::addCamera(camera);
+	batch = new SpriteBatch();
 
 	std::vector<Colour> colours;
 	colours.push_back(Colour::LIGHT_BLUE);
@@ -122,7 +124,7 @@ void GUITest::created() {
 	radio->borderEnabled = true;
 
 	textBox = new GUITextBox(Colour::WHITE, 200, 20);
-	textBox->renderer->font = Font::loadFont("H:/Andor/test2.png", 16, 18);
+	textBox->renderer->font = Font::loadFont(GUIComponentRenderer::defaultAtlas, "H:/Andor/test2.png", 16, 18);
 	textBox->setPosition(20, 300);
 	textBox->setDefaultText("Enter something");
 	textBox->border = new GUIBorder(textBox, 1.0f, Colour::LIGHT_BLUE);
@@ -141,19 +143,21 @@ void GUITest::update() {
 
 void GUITest::render() {
 	glClear(GL_COLOR_BUFFER_BIT);
-	glEnable(GL_TEXTURE_2D);
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	GLState::enable(GL_TEXTURE_2D);
+	GLState::enable(GL_BLEND);
+	GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
 	//std::cout << textBox->selection->renderer->colours[0].toString() << std::endl;
 
 	//glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+	batch->begin();
 	button->render();
 	checkBox->render();
 	menu->render();
 	list->render();
 	radio->render();
 	textBox->render();
+	batch->end();
 
 	renderInformation();
 }
@@ -59,6 +59,7 @@ public:
 void LightingTest::initialise(Settings* settings) {
 	settings->setVideoSamples(16);
 	settings->setVideoMaxAnisotropicSamples(16);
+	settings->setVideoTextureBudget(256);
 	wireframe = false;
 }
 
@@ -139,13 +140,13 @@ void LightingTest::update() {
 
 void LightingTest::render() {
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-	glEnable(GL_TEXTURE_2D);
-	glEnable(GL_DEPTH_TEST);
+	GLState::enable(GL_TEXTURE_2D);
+	GLState::enable(GL_DEPTH_TEST);
 	camera->useView();
 
-	glEnable(GL_MULTISAMPLE_ARB);
-	glEnable(GL_SAMPLE_ALPHA_TO_COVERAGE_ARB);
-	glEnable(GL_CULL_FACE);
+	GLState::enable(GL_MULTISAMPLE_ARB);
+	GLState::enable(GL_SAMPLE_ALPHA_TO_COVERAGE_ARB);
+	GLState::enable(GL_CULL_FACE);
 	glCullFace(GL_BACK);
 
 //	Renderer::setShader(Renderer::getShader("DirectionalLight"));
@@ -162,8 +163,8 @@ void LightingTest::render() {
 
 	scene->render(camera->position);
 
-	glDisable(GL_CULL_FACE);
-	glDisable(GL_DEPTH_TEST);
+	GLState::disable(GL_CULL_FACE);
+	GLState::disable(GL_DEPTH_TEST);
 	renderInformation();
 }
 
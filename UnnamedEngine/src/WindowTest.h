@@ -149,23 +149,23 @@ void WindowTest::update() {
 
 void WindowTest::render() {
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-	glEnable(GL_TEXTURE_2D);
+	GLState::enable(GL_TEXTURE_2D);
 	//glEnable(GL_BLEND);
 	//glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 	//glEnable(GL_ALPHA_TEST);
 	//glAlphaFunc(GL_GREATER, 0.5);
-	glEnable(GL_DEPTH_TEST);
+	GLState::enable(GL_DEPTH_TEST);
 	camera->useView();
 	object.render();
 
-	glEnable(GL_MULTISAMPLE_ARB);
-	glEnable(GL_SAMPLE_ALPHA_TO_COVERAGE_ARB);
-	glEnable(GL_CULL_FACE);
+	GLState::enable(GL_MULTISAMPLE_ARB);
+	GLState::enable(GL_SAMPLE_ALPHA_TO_COVERAGE_ARB);
+	GLState::enable(GL_CULL_FACE);
 	glCullFace(GL_BACK);
 	model->render();
 	//	model2->render();
-	glDisable(GL_CULL_FACE);
-	glDisable(GL_DEPTH_TEST);
+	GLState::disable(GL_CULL_FACE);
+	GLState::disable(GL_DEPTH_TEST);
 	renderInformation();
 
 //	button->render();
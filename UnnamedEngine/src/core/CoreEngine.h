@@ -42,16 +42,33 @@
 #include "../utils/Timer.h"
 #include "../utils/FPSCalculator.h"
 #include "render/Shader.h"
+#include "render/ShaderManager.h"
+#include "render/RenderStats.h"
+#include "render/GLState.h"
+#include "render/SamplerCache.h"
+#include "render/MeshBuffers.h"
+#include "render/MultiDraw.h"
+#include "render/OcclusionCuller.h"
+#include "render/SceneSpatialIndex.h"
+#include "render/TriangleBVH.h"
+#include "render/UberShader.h"
 #include "render/Renderer.h"
+#include "render/SpriteBatch.h"
 #include "render/Scene.h"
+#include "render/TextureResidency.h"
+#include "render/TextureStreamer.h"
 #include "ResourceLoader.h"
 #include "Settings.h"
 #include "Mesh.h"
 #include "Texture.h"
+#include "ImageLoader.h"
+#include "TextureAtlas.h"
 #include "Object.h"
 #include "Camera.h"
-#include "Skybox.h"
+#include "SkyBox.h"
 #include "Model.h"
+#include "Profiler.h"
+#include "Memory.h"
 #include "Game.h"
 #include "Window.h"
 
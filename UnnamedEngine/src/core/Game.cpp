@@ -19,7 +19,11 @@
 #include "Game.h"
 #include "gui/GUIComponent.h"
 #include "render/Renderer.h"
+#include "render/TextureStreamer.h"
+#include "render/MultiDraw.h"
 #include "ResourceLoader.h"
+#include "Profiler.h"
+#include "../utils/Time.h"
 
 Game* Game::current;
 
@@ -27,12 +31,16 @@ Game* Game::current;
 void Game::create() {
 	//Assigns the current game instance and sets up basic variables
 	Game::current = this;
+	//Write logs from a background thread so logging doesn't stall the game loop
+	Logger::start();
 	m_settings = new Settings();
 	initialise(m_settings);
 	m_window = new Window(m_settings);
 
 	//Continue only if the window can be created successfully
 	if (m_window->create()) {
+		long startTime = Time::getTimeMilliseconds();
+
 		//Assign the window callbacks
 		m_window->setKeyCallback(input_callback_key);
 		m_window->setCharCallback(input_callback_char);
@@ -45,11 +53,16 @@ void Game::create() {
 		addListener();
 
 		//Initialise the rendering system
+		SamplerCache::setMaxAnisotropy(m_settings->getVideoMaxAnisotropicSamples());
 		Renderer::initialise();
+		if (m_settings->getVideoTextureBudget() > 0)
+			TextureStreamer::initialise(m_settings->getVideoTextureBudget() * 1024LL * 1024LL);
 
-		//Load default resources
-		m_font = ResourceLoader::loadFont("resources/textures/font-segoeui.png", 16, 16);
-		GUIComponentRenderer::defaultFont = ResourceLoader::loadFont("resources/textures/font-segoeui.png", 16, 16);
+		//Load default resources, the default font is packed into an atlas that GUI images can
+		//share so the GUI and the debug information only need one texture
+		GUIComponentRenderer::defaultAtlas = new TextureAtlas(1024, 1024, TextureParameters().setFilter(GL_NEAREST));
+		GUIComponentRenderer::defaultFont = Font::loadFont(GUIComponentRenderer::defaultAtlas, "resources/textures/font-segoeui.png", 16, 16);
+		m_font = new Font(new BitmapText(GUIComponentRenderer::defaultFont->getTexture(), 16, 16, Colour::WHITE));
 
 		//Setup the debug information camera
 		m_camera = new Camera2D(Matrix4f().initOrthographic(0, m_settings->getWindowWidth(), m_settings->getWindowHeight(), 0, -1, 1));
@@ -58,20 +71,79 @@ void Game::create() {
 		//Notify the game that the engine has been initalised
 		created();
 
+		//Setup the fixed time step if the game should be updated at a set rate
+		if (m_settings->getEngineUpdateRate() > 0)
+			m_timestep = new FixedTimestep(m_settings->getEngineUpdateRate(), m_settings->getEngineMaxUpdateSteps());
+		long long frameTime = 0;
+		if (m_settings->getEngineMaxFPS() > 0)
+			frameTime = 1000000000LL / m_settings->getEngineMaxFPS();
+		long long lastFrameStart = Time::getTimeNanoseconds();
+
 		//The main game loop
 		while (! m_window->shouldClose() && ! m_closeRequested) {
+			PROFILE_FRAME();
+			//Free everything allocated for the last frame
+			Memory::nextFrame();
+			long long frameStart = Time::getTimeNanoseconds();
 			//Update the FPS calculator (Calculates the current FPS and delta time)
 			m_fpsCalculator->update();
-			//Update and render the game
-			update();
-			render();
+			//Dispatch the input received since the last frame
+			{
+				PROFILE_SCOPE("Input");
+				InputManager::dispatchEvents();
+			}
+			//Update the game, either once or as many times as needed to catch up
+			{
+				PROFILE_SCOPE("Update");
+				if (m_timestep != NULL) {
+					unsigned int steps = m_timestep->advance(frameStart - lastFrameStart);
+					for (unsigned int a = 0; a < steps; a++)
+						update();
+					m_interpolation = m_timestep->getAlpha();
+				} else
+					update();
+			}
+			lastFrameStart = frameStart;
+			//Upload the textures that have been streamed in and load the next ones
+			TextureStreamer::update();
+			//Render the game
+			{
+				PROFILE_SCOPE("Render");
+				PROFILE_GPU_SCOPE("Render");
+				render();
+			}
 			//Update the window
-			m_window->update();
+			{
+				PROFILE_SCOPE("Swap Buffers");
+				m_window->update();
+			}
+			RenderStats::nextFrame();
+
+			//Wait for the rest of the frame if the frame rate is limited
+			if (frameTime > 0) {
+				PROFILE_SCOPE("Wait");
+				Time::waitUntil(frameStart + frameTime);
+			}
+
+			//Record how long it took to get the first frame on the screen
+			if (m_startupTime == 0) {
+				m_startupTime = Time::getTimeMilliseconds() - startTime;
+				logInformation("Time to first frame: " + to_string(m_startupTime) + "ms");
+			}
 		}
 		//Destroy the game and window
 		destroy();
+		TextureStreamer::destroy();
+		SamplerCache::destroy();
+		MultiDraw::destroy();
+		MeshBuffers::destroy();
+		if (m_timestep != NULL) {
+			delete m_timestep;
+			m_timestep = NULL;
+		}
 		m_window->destroy();
 	}
+	Logger::stop();
 }
 
 /* This method simply renders some information */
@@ -88,5 +160,24 @@ void Game::renderInformation() {
 	m_font->render("VSync:               " + to_string(m_settings->getVideoVSync()), 0, 122);
 	m_font->render("MSAA Samples:        " + to_string(m_settings->getVideoSamples()), 0, 136);
 	m_font->render("Max Anisotropic Samples: " + to_string(m_settings->getVideoMaxAnisotropicSamples()), 0, 150);
+	m_font->render("Startup Time:        " + to_string(m_startupTime) + "ms", 0, 164);
+	m_font->render("------------- STATS -------------", 0, 178);
+	m_font->render(RenderStats::toString(RENDER_STAT_DRAW_CALLS), 0, 192);
+	m_font->render(RenderStats::toString(RENDER_STAT_PRIMITIVES), 0, 206);
+	m_font->render(RenderStats::toString(RENDER_STAT_SHADER_SWITCHES), 0, 220);
+	m_font->render(RenderStats::toString(RENDER_STAT_TEXTURE_BINDS), 0, 234);
+	m_font->render(RenderStats::toString(RENDER_STAT_BUFFER_BYTES), 0, 248);
+	m_font->render(RenderStats::toString(RENDER_STAT_INDIRECT_COMMANDS), 0, 262);
+	m_font->render(RenderStats::toString(RENDER_STAT_FRUSTUM_CULLED_OBJECTS), 0, 276);
+	m_font->render(RenderStats::toString(RENDER_STAT_OCCLUDED_OBJECTS), 0, 290);
+	m_font->render(RenderStats::toString(RENDER_STAT_CULLED_PRIMITIVES), 0, 304);
+	m_font->render("------------- MEMORY ------------", 0, 318);
+	m_font->render(Memory::toString(MEMORY_MESH), 0, 332);
+	m_font->render(Memory::toString(MEMORY_OBJECT), 0, 346);
+	m_font->render(Memory::toString(MEMORY_FRAME), 0, 360);
+	if (TextureStreamer::isEnabled()) {
+		TextureResidency* residency = TextureStreamer::getResidency();
+		m_font->render("Streamed Textures:   " + to_string(residency->getResidentBytes() / 1024) + "KB / " + to_string(residency->getBudget() / 1024) + "KB", 0, 374);
+	}
 	Renderer::removeCamera();
 }
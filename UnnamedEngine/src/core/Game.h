@@ -20,6 +20,7 @@
 #define CORE_GAME_H_
 
 #include "../utils/FPSCalculator.h"
+#include "../utils/FixedTimestep.h"
 #include "input/Input.h"
 #include "gui/Font.h"
 #include "Settings.h"
@@ -48,6 +49,15 @@ private:
 
 	/* A boolean used to request the game to stop */
 	bool m_closeRequested;
+
+	/* The time taken (in milliseconds) from creating the window to presenting the first frame */
+	long m_startupTime;
+
+	/* The fixed time step used for updates, NULL when update() is called once a frame */
+	FixedTimestep* m_timestep;
+
+	/* How far between the last update and the next one the frame being rendered is */
+	float m_interpolation;
 public:
 	/* The current instance of the game */
 	static Game* current;
@@ -60,6 +70,9 @@ public:
 		m_settings = new Settings();
 		m_fpsCalculator = new FPSCalculator();
 		m_camera = NULL;
+		m_startupTime = 0;
+		m_timestep = NULL;
+		m_interpolation = 1.0f;
 	}
 	virtual ~Game() {}
 
@@ -97,8 +110,19 @@ public:
 
 	/* The setters and getters */
 	inline FPSCalculator* getFPSCalculator() { return m_fpsCalculator; }
+	/* Returns the time (in milliseconds) the last frame took. This is not the time an update
+	 * simulates when there is a fixed time step, so update() should use getUpdateDelta() */
 	inline long getDelta() { return m_fpsCalculator->getDelta(); }
 	inline float getFPS() { return m_fpsCalculator->getFPS(); }
+	inline long getStartupTime() { return m_startupTime; }
+
+	/* Returns the time (in seconds) that each call to update() should simulate */
+	inline double getUpdateDelta() { return m_timestep != NULL ? m_timestep->getStepSeconds() : m_fpsCalculator->getDeltaSeconds(); }
+
+	/* Returns the fraction of an update between the last state and the next one that should be
+	 * rendered, this is always 1 when there isn't a fixed time step */
+	inline float getInterpolation() { return m_interpolation; }
+	inline FixedTimestep* getTimestep() { return m_timestep; }
 
 	Window* getWindow() { return m_window; }
 	Settings* getSettings() { return m_settings; }
@@ -0,0 +1,303 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <thread>
+#include <algorithm>
+#include <cstdlib>
+
+#include "ImageLoader.h"
+#include "../utils/Logging.h"
+#include "../utils/StringUtils.h"
+#include <GL/stb_image.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define IMAGE_SSE2
+#endif
+//The SSSE3 kernels are always compiled on x86, and only used when the processor supports them
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <tmmintrin.h>
+#define IMAGE_SSSE3
+#define IMAGE_SSSE3_TARGET __attribute__((target("ssse3")))
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <tmmintrin.h>
+#include <intrin.h>
+#define IMAGE_SSSE3
+#define IMAGE_SSSE3_TARGET
+#endif
+
+/***************************************************************************************************
+ * The Image class
+ ***************************************************************************************************/
+
+Image::~Image() {
+	if (pixels != NULL)
+		stbi_image_free(pixels);
+}
+
+/***************************************************************************************************/
+
+/***************************************************************************************************
+ * The ImageLoader class
+ ***************************************************************************************************/
+
+#ifdef IMAGE_SSSE3
+/* Expands as many pixels as it can four at a time and returns the number expanded. Each load reads
+ * 16 bytes but only uses the first 12, so the last few pixels are left to the caller to avoid
+ * reading past the end of the source */
+IMAGE_SSSE3_TARGET static unsigned int expandRGBToRGBASSSE3(const unsigned char* source, unsigned char* destination, unsigned int numPixels) {
+	const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+	const __m128i alpha = _mm_set1_epi32(0xFF000000);
+	unsigned int a = 0;
+	for (; a + 6 <= numPixels; a += 4) {
+		__m128i pixels = _mm_loadu_si128((const __m128i*) (source + (a * 3)));
+		_mm_storeu_si128((__m128i*) (destination + (a * 4)), _mm_or_si128(_mm_shuffle_epi8(pixels, shuffle), alpha));
+	}
+	return a;
+}
+#endif
+
+bool ImageLoader::m_ssse3Enabled = ImageLoader::isSSSE3Supported();
+
+bool ImageLoader::isSSSE3Supported() {
+#if defined(IMAGE_SSSE3) && defined(__GNUC__)
+	return __builtin_cpu_supports("ssse3");
+#elif defined(IMAGE_SSSE3)
+	int info[4];
+	__cpuid(info, 1);
+	return (info[2] & (1 << 9)) != 0;
+#else
+	return false;
+#endif
+}
+
+void ImageLoader::setSSSE3Enabled(bool enabled) {
+	m_ssse3Enabled = enabled && isSSSE3Supported();
+}
+
+Image* ImageLoader::decode(std::string path, int flags) {
+	Image* image = new Image();
+	image->path = path;
+	image->flags = flags;
+	decode(image);
+	if (! image->isLoaded())
+		logError("Failed to load the image from the path '" + path + "'");
+	return image;
+}
+
+void ImageLoader::decode(const std::vector<std::string>& paths, int flags, std::vector<Image*>& images) {
+	std::vector<Image*> decoded;
+	for (unsigned int a = 0; a < paths.size(); a++) {
+		Image* image = new Image();
+		image->path = paths[a];
+		image->flags = flags;
+		decoded.push_back(image);
+	}
+
+	//The calling thread decodes images as well, so one less thread is needed
+	unsigned int numThreads = std::thread::hardware_concurrency();
+	if (numThreads == 0)
+		numThreads = 1;
+	if (numThreads > decoded.size())
+		numThreads = decoded.size();
+
+	std::atomic<unsigned int> next(0);
+	std::vector<std::thread> threads;
+	for (unsigned int a = 1; a < numThreads; a++)
+		threads.push_back(std::thread(decodeWorker, &decoded, &next));
+	decodeWorker(&decoded, &next);
+	for (unsigned int a = 0; a < threads.size(); a++)
+		threads[a].join();
+
+	//Errors are only logged now so they appear in the same order as the paths
+	for (unsigned int a = 0; a < decoded.size(); a++) {
+		if (! decoded[a]->isLoaded())
+			logError("Failed to load the image from the path '" + decoded[a]->path + "'");
+		images.push_back(decoded[a]);
+	}
+}
+
+void ImageLoader::decode(Image* image) {
+	image->pixels = stbi_load(image->path.c_str(), &image->width, &image->height, &image->numComponents, 0);
+	if (image->pixels != NULL && image->numComponents == 4 && (image->flags & IMAGE_PREMULTIPLY_ALPHA))
+		premultiplyAlpha(image->pixels, image->width * image->height);
+}
+
+void ImageLoader::decodeWorker(std::vector<Image*>* images, std::atomic<unsigned int>* next) {
+	unsigned int index;
+	while ((index = next->fetch_add(1)) < images->size())
+		decode(images->at(index));
+}
+
+Image* ImageLoader::downsample(Image* image) {
+	Image* result = new Image();
+	result->path = image->path;
+	result->flags = image->flags;
+	if (! image->isLoaded())
+		return result;
+
+	result->width = std::max(image->width / 2, 1);
+	result->height = std::max(image->height / 2, 1);
+	result->numComponents = image->numComponents;
+	//Allocated in the same way as stb_image so both can be freed by the Image
+	result->pixels = (unsigned char*) malloc(result->width * result->height * result->numComponents);
+
+	unsigned int components = image->numComponents;
+	for (int y = 0; y < result->height; y++) {
+		//Images with an odd size have their last row and column clamped
+		const unsigned char* row0 = image->pixels + (std::min(y * 2, image->height - 1) * image->width * components);
+		const unsigned char* row1 = image->pixels + (std::min(y * 2 + 1, image->height - 1) * image->width * components);
+		unsigned char* destination = result->pixels + (y * result->width * components);
+		for (int x = 0; x < result->width; x++) {
+			unsigned int x0 = std::min(x * 2, image->width - 1) * components;
+			unsigned int x1 = std::min(x * 2 + 1, image->width - 1) * components;
+			for (unsigned int c = 0; c < components; c++)
+				destination[x * components + c] = (unsigned char) ((row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) / 4);
+		}
+	}
+	return result;
+}
+
+void ImageLoader::getFormats(Image* image, GLenum& format, GLenum& internalFormat) {
+	format = GL_RGBA;
+	internalFormat = GL_RGBA8;
+	if (image->numComponents == 1) {
+		format = GL_RED;
+		internalFormat = GL_R8;
+	} else if (image->numComponents == 2) {
+		format = GL_RG;
+		internalFormat = GL_RG8;
+	} else if (image->numComponents == 3 && ! (image->flags & IMAGE_EXPAND_RGBA)) {
+		format = GL_RGB;
+		internalFormat = GL_RGB8;
+	}
+
+	if (image->flags & IMAGE_SRGB) {
+		if (format == GL_RGB)
+			internalFormat = GL_SRGB8;
+		else if (format == GL_RGBA)
+			internalFormat = GL_SRGB8_ALPHA8;
+	}
+}
+
+void ImageLoader::upload(Image* image, GLenum target) {
+	if (! image->isLoaded())
+		return;
+
+	GLenum format;
+	GLenum internalFormat;
+	getFormats(image, format, internalFormat);
+
+	if (image->numComponents == 3 && format == GL_RGBA) {
+		//The image is expanded as it is uploaded, so the texture is created empty
+		glTexImage2D(target, 0, internalFormat, image->width, image->height, 0, format, GL_UNSIGNED_BYTE, NULL);
+		uploadSubImage(image, target);
+	} else {
+		//Rows of images without an alpha channel are not always 4 byte aligned
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glTexImage2D(target, 0, internalFormat, image->width, image->height, 0, format, GL_UNSIGNED_BYTE, image->pixels);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	}
+}
+
+void ImageLoader::allocate(Image* image, GLenum target, int numMips) {
+	GLenum format;
+	GLenum internalFormat;
+	getFormats(image, format, internalFormat);
+	glTexStorage2D(target, numMips, internalFormat, image->width, image->height);
+}
+
+void ImageLoader::uploadSubImage(Image* image, GLenum target) {
+	if (! image->isLoaded())
+		return;
+
+	GLenum format;
+	GLenum internalFormat;
+	getFormats(image, format, internalFormat);
+
+	//Rows of images without an alpha channel are not always 4 byte aligned
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	if (! (image->numComponents == 3 && format == GL_RGBA))
+		glTexSubImage2D(target, 0, 0, 0, image->width, image->height, format, GL_UNSIGNED_BYTE, image->pixels);
+	else {
+		//Convert and upload a band of rows at a time to limit the memory needed
+		unsigned int rowBytes = image->width * 4;
+		int bandRows = UPLOAD_BAND_BYTES / rowBytes;
+		if (bandRows < 1)
+			bandRows = 1;
+		if (bandRows > image->height)
+			bandRows = image->height;
+		std::vector<unsigned char> band(rowBytes * bandRows);
+
+		for (int y = 0; y < image->height; y += bandRows) {
+			int rows = bandRows;
+			if (y + rows > image->height)
+				rows = image->height - y;
+			expandRGBToRGBA(image->pixels + (y * image->width * 3), &band.front(), image->width * rows);
+			glTexSubImage2D(target, 0, 0, y, image->width, rows, format, GL_UNSIGNED_BYTE, &band.front());
+		}
+	}
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+}
+
+void ImageLoader::expandRGBToRGBA(const unsigned char* source, unsigned char* destination, unsigned int numPixels) {
+	unsigned int a = 0;
+#ifdef IMAGE_SSSE3
+	if (m_ssse3Enabled)
+		a = expandRGBToRGBASSSE3(source, destination, numPixels);
+#endif
+	for (; a < numPixels; a++) {
+		destination[a * 4]     = source[a * 3];
+		destination[a * 4 + 1] = source[a * 3 + 1];
+		destination[a * 4 + 2] = source[a * 3 + 2];
+		destination[a * 4 + 3] = 255;
+	}
+}
+
+void ImageLoader::premultiplyAlpha(unsigned char* pixels, unsigned int numPixels) {
+	unsigned int a = 0;
+#ifdef IMAGE_SSE2
+	//Four pixels at a time, widened to 16 bits so the products fit
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i colourMask = _mm_setr_epi16(-1, -1, -1, 0, -1, -1, -1, 0);
+	const __m128i alphaOne = _mm_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255);
+	const __m128i half = _mm_set1_epi16(128);
+	for (; a + 4 <= numPixels; a += 4) {
+		__m128i packed = _mm_loadu_si128((const __m128i*) (pixels + (a * 4)));
+		__m128i halves[2] = { _mm_unpacklo_epi8(packed, zero), _mm_unpackhi_epi8(packed, zero) };
+		for (unsigned int b = 0; b < 2; b++) {
+			//Multiply the colours by the alpha and the alpha by one
+			__m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(halves[b], _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+			alpha = _mm_or_si128(_mm_and_si128(alpha, colourMask), alphaOne);
+			__m128i product = _mm_add_epi16(_mm_mullo_epi16(halves[b], alpha), half);
+			//Divide by 255 with rounding, the same as the loop below
+			halves[b] = _mm_srli_epi16(_mm_add_epi16(product, _mm_srli_epi16(product, 8)), 8);
+		}
+		_mm_storeu_si128((__m128i*) (pixels + (a * 4)), _mm_packus_epi16(halves[0], halves[1]));
+	}
+#endif
+	for (; a < numPixels; a++) {
+		unsigned int alpha = pixels[a * 4 + 3];
+		for (unsigned int b = 0; b < 3; b++) {
+			unsigned int product = (pixels[a * 4 + b] * alpha) + 128;
+			pixels[a * 4 + b] = (unsigned char) ((product + (product >> 8)) >> 8);
+		}
+	}
+}
+
+/***************************************************************************************************/
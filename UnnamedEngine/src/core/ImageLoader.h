@@ -0,0 +1,116 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef CORE_IMAGELOADER_H_
+#define CORE_IMAGELOADER_H_
+
+#include <windows.h>
+#include <GL/GLEW/glew.h>
+#include <string>
+#include <vector>
+#include <atomic>
+
+/* The conversions that can be applied to an image */
+enum {
+	/* Adds an alpha channel to RGB images so every row is 4 byte aligned when uploaded */
+	IMAGE_EXPAND_RGBA       = 1,
+	/* Multiplies the colour of each pixel by its alpha */
+	IMAGE_PREMULTIPLY_ALPHA = 2,
+	/* Stores the image as sRGB so it is converted to linear colour when sampled */
+	IMAGE_SRGB              = 4
+};
+
+/***************************************************************************************************
+ * The Image class stores an image that has been decoded but not yet uploaded
+ ***************************************************************************************************/
+
+class Image {
+public:
+	std::string path;
+	int width;
+	int height;
+	int numComponents;
+	int flags;
+	unsigned char* pixels;
+
+	Image() : width(0), height(0), numComponents(0), flags(0), pixels(NULL) {}
+	virtual ~Image();
+
+	inline bool isLoaded() { return pixels != NULL; }
+};
+
+/***************************************************************************************************/
+
+/***************************************************************************************************
+ * The ImageLoader class decodes images, converts them into formats suited to the GPU and uploads
+ * them. Many images can be decoded at once on separate threads, while the uploads are done on the
+ * calling thread as they need the OpenGL context
+ ***************************************************************************************************/
+
+class ImageLoader {
+private:
+	/* The most bytes converted at once while uploading, larger images are uploaded in bands of
+	 * rows so a converted copy of the whole image is never needed */
+	static const unsigned int UPLOAD_BAND_BYTES = 1024 * 1024;
+
+	/* States whether the kernels use SSSE3, this is checked when the program starts */
+	static bool m_ssse3Enabled;
+
+	/* Decodes the image at the path given to it */
+	static void decode(Image* image);
+
+	/* Run by each thread decoding images, taking the next image to decode until there are none */
+	static void decodeWorker(std::vector<Image*>* images, std::atomic<unsigned int>* next);
+
+	/* Returns the format of the pixels uploaded for an image, and the format to store it in */
+	static void getFormats(Image* image, GLenum& format, GLenum& internalFormat);
+public:
+	/* Decodes a single image on the calling thread, applying any conversions that don't change
+	 * its size. The image should be checked with isLoaded() */
+	static Image* decode(std::string path, int flags);
+
+	/* Decodes many images at once, using up to one thread for each processor */
+	static void decode(const std::vector<std::string>& paths, int flags, std::vector<Image*>& images);
+
+	/* Returns a copy of an image at half the size, averaging each block of 2x2 pixels */
+	static Image* downsample(Image* image);
+
+	/* Uploads an image to the texture bound to a target, which may be the face of a cube map. The
+	 * texture is created again, so it can change size */
+	static void upload(Image* image, GLenum target);
+
+	/* Allocates immutable storage with a number of mip levels for an image in the texture bound to
+	 * a target, so uploadSubImage() can fill the first level. This needs ARB_texture_storage */
+	static void allocate(Image* image, GLenum target, int numMips);
+	static void uploadSubImage(Image* image, GLenum target);
+
+	/* The conversion kernels, using SIMD instructions where they are available */
+	static void expandRGBToRGBA(const unsigned char* source, unsigned char* destination, unsigned int numPixels);
+	static void premultiplyAlpha(unsigned char* pixels, unsigned int numPixels);
+
+	/* Returns whether the processor running the program supports SSSE3 */
+	static bool isSSSE3Supported();
+
+	/* Allows the SSSE3 kernels to be turned off, they can't be turned on when they aren't supported */
+	static void setSSSE3Enabled(bool enabled);
+	static inline bool isSSSE3Enabled() { return m_ssse3Enabled; }
+};
+
+/***************************************************************************************************/
+
+#endif /* CORE_IMAGELOADER_H_ */
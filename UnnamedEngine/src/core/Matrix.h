@@ -368,6 +368,22 @@ public:
 		translate(t);
 	}
 
+	/* Finds the planes of the frustum this matrix projects into clip space, each stored as (a, b,
+	 * c, d) with a normalised normal, where points inside have ax + by + cz + d >= 0 */
+	inline void getFrustumPlanes(float planes[6][4]) {
+		//Each plane is the last row plus or minus one of the others
+		for (unsigned int a = 0; a < 6; a++) {
+			float sign = (a % 2 == 0) ? 1.0f : -1.0f;
+			for (unsigned int b = 0; b < 4; b++)
+				planes[a][b] = m_values[3][b] + sign * m_values[a / 2][b];
+			float length = sqrt(planes[a][0] * planes[a][0] + planes[a][1] * planes[a][1] + planes[a][2] * planes[a][2]);
+			if (length > 0) {
+				for (unsigned int b = 0; b < 4; b++)
+					planes[a][b] /= length;
+			}
+		}
+	}
+
 	/* The method used to invert this matrix */
 	Matrix4f inverse() {
 		//Get the values of the matrix (Transposed)
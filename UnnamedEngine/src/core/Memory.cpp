@@ -0,0 +1,216 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <new>
+
+#include "Memory.h"
+#include "../utils/StringUtils.h"
+
+/***************************************************************************************************
+ * The MemoryArena class
+ ***************************************************************************************************/
+
+MemoryArena::MemoryArena(size_t size, MemoryCategory category) {
+	m_offset = 0;
+	m_used = 0;
+	m_capacity = 0;
+	m_numAllocations = 0;
+	m_category = category;
+	addBlock(size);
+}
+
+MemoryArena::~MemoryArena() {
+	for (unsigned int a = 0; a < m_blocks.size(); a++)
+		Memory::free(m_blocks[a], m_blockSizes[a], m_category);
+}
+
+void MemoryArena::addBlock(size_t size) {
+	m_blocks.push_back(static_cast<char*>(Memory::allocate(size, m_category)));
+	m_blockSizes.push_back(size);
+	m_capacity += size;
+	m_offset = 0;
+}
+
+void* MemoryArena::allocate(size_t size, size_t alignment) {
+	//Align the address rather than the offset as the block is only aligned to max_align_t
+	uintptr_t start = reinterpret_cast<uintptr_t>(m_blocks.back()) + m_offset;
+	size_t padding = (alignment - (start % alignment)) % alignment;
+
+	if (m_offset + padding + size > m_blockSizes.back()) {
+		//Grow by at least the size of the last block so the number of blocks stays small
+		size_t blockSize = m_blockSizes.back();
+		if (size + alignment > blockSize)
+			blockSize = size + alignment;
+		addBlock(blockSize);
+		start = reinterpret_cast<uintptr_t>(m_blocks.back());
+		padding = (alignment - (start % alignment)) % alignment;
+	}
+
+	m_offset += padding + size;
+	m_used += padding + size;
+	m_numAllocations++;
+	return m_blocks.back() + m_offset - size;
+}
+
+void MemoryArena::reset() {
+	//Replace all of the blocks by one that would have fitted everything
+	if (m_blocks.size() > 1) {
+		size_t capacity = m_capacity;
+		for (unsigned int a = 0; a < m_blocks.size(); a++)
+			Memory::free(m_blocks[a], m_blockSizes[a], m_category);
+		m_blocks.clear();
+		m_blockSizes.clear();
+		m_capacity = 0;
+		addBlock(capacity);
+	}
+	m_offset = 0;
+	m_used = 0;
+	m_numAllocations = 0;
+}
+
+/***************************************************************************************************/
+
+/***************************************************************************************************
+ * The MemoryPool class
+ ***************************************************************************************************/
+
+MemoryPool::MemoryPool(size_t elementSize, unsigned int elementsPerChunk, MemoryCategory category) {
+	//Every element has to be able to hold a link in the free list and be aligned for any type
+	size_t alignment = alignof(std::max_align_t);
+	m_objectSize = elementSize;
+	if (elementSize < sizeof(FreeElement))
+		elementSize = sizeof(FreeElement);
+	m_elementSize = ((elementSize + alignment - 1) / alignment) * alignment;
+	m_elementsPerChunk = elementsPerChunk;
+	m_category = category;
+	m_free = NULL;
+	m_chunkUsed = 0;
+	m_numAllocated = 0;
+}
+
+MemoryPool::~MemoryPool() {
+	for (unsigned int a = 0; a < m_chunks.size(); a++)
+		::operator delete(m_chunks[a]);
+}
+
+void* MemoryPool::allocate() {
+	void* element;
+	if (m_free != NULL) {
+		element = m_free;
+		m_free = m_free->next;
+	} else {
+		if (m_chunks.empty() || m_chunkUsed == m_elementsPerChunk) {
+			m_chunks.push_back(static_cast<char*>(::operator new(m_elementSize * m_elementsPerChunk)));
+			m_chunkUsed = 0;
+		}
+		element = m_chunks.back() + (m_chunkUsed * m_elementSize);
+		m_chunkUsed++;
+	}
+	m_numAllocated++;
+	Memory::allocated(m_category, m_elementSize);
+	return element;
+}
+
+void MemoryPool::free(void* pointer) {
+	if (pointer == NULL)
+		return;
+	FreeElement* element = static_cast<FreeElement*>(pointer);
+	element->next = m_free;
+	m_free = element;
+	m_numAllocated--;
+	Memory::freed(m_category, m_elementSize);
+}
+
+void* MemoryPool::allocate(size_t size) {
+	if (size != m_objectSize)
+		return Memory::allocate(size, m_category);
+	return allocate();
+}
+
+void MemoryPool::free(void* pointer, size_t size) {
+	if (size != m_objectSize)
+		Memory::free(pointer, size, m_category);
+	else
+		free(pointer);
+}
+
+/***************************************************************************************************/
+
+/***************************************************************************************************
+ * The Memory class
+ ***************************************************************************************************/
+
+std::atomic<long long> Memory::m_liveBytes[MEMORY_CATEGORY_COUNT];
+std::atomic<long long> Memory::m_liveAllocations[MEMORY_CATEGORY_COUNT];
+std::atomic<unsigned int> Memory::m_frameAllocations[MEMORY_CATEGORY_COUNT];
+unsigned int Memory::m_lastFrameAllocations[MEMORY_CATEGORY_COUNT];
+
+MemoryArena* Memory::m_frameArena = NULL;
+
+void Memory::allocated(MemoryCategory category, size_t size) {
+	m_liveBytes[category].fetch_add(size, std::memory_order_relaxed);
+	m_liveAllocations[category].fetch_add(1, std::memory_order_relaxed);
+	m_frameAllocations[category].fetch_add(1, std::memory_order_relaxed);
+}
+
+void Memory::freed(MemoryCategory category, size_t size) {
+	m_liveBytes[category].fetch_sub(size, std::memory_order_relaxed);
+	m_liveAllocations[category].fetch_sub(1, std::memory_order_relaxed);
+}
+
+void* Memory::allocate(size_t size, MemoryCategory category) {
+	void* pointer = ::operator new(size);
+	allocated(category, size);
+	return pointer;
+}
+
+void Memory::free(void* pointer, size_t size, MemoryCategory category) {
+	if (pointer == NULL)
+		return;
+	::operator delete(pointer);
+	freed(category, size);
+}
+
+void Memory::nextFrame() {
+	for (unsigned int a = 0; a < MEMORY_CATEGORY_COUNT; a++)
+		m_lastFrameAllocations[a] = m_frameAllocations[a].exchange(0);
+	if (m_frameArena != NULL)
+		m_frameArena->reset();
+}
+
+MemoryArena* Memory::getFrameArena() {
+	if (m_frameArena == NULL)
+		m_frameArena = new MemoryArena(256 * 1024, MEMORY_FRAME);
+	return m_frameArena;
+}
+
+std::string Memory::getName(MemoryCategory category) {
+	switch (category) {
+		case MEMORY_GENERAL: return "General";
+		case MEMORY_MESH:    return "Mesh";
+		case MEMORY_OBJECT:  return "Object";
+		case MEMORY_FRAME:   return "Frame";
+		default:             return "Unknown";
+	}
+}
+
+std::string Memory::toString(MemoryCategory category) {
+	return getName(category) + ": " + to_string(getLiveBytes(category) / 1024) + "KB (" + to_string(getLiveAllocations(category)) + " live, " + to_string(getLastFrameAllocations(category)) + " last frame)";
+}
+
+/***************************************************************************************************/
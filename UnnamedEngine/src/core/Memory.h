@@ -0,0 +1,194 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef CORE_MEMORY_H_
+#define CORE_MEMORY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <atomic>
+
+/* The categories allocations are tracked under */
+enum MemoryCategory {
+	MEMORY_GENERAL,
+	MEMORY_MESH,
+	MEMORY_OBJECT,
+	MEMORY_FRAME,
+	MEMORY_CATEGORY_COUNT
+};
+
+/***************************************************************************************************
+ * The MemoryArena class is a linear allocator, allocating only moves a pointer along a block of
+ * memory and everything is freed at once by resetting it. If a block fills up another is added,
+ * and on the next reset they are replaced by a single block large enough for all of them
+ ***************************************************************************************************/
+
+class MemoryArena {
+private:
+	std::vector<char*> m_blocks;
+	std::vector<size_t> m_blockSizes;
+
+	/* The offset of the next allocation in the last block */
+	size_t m_offset;
+
+	/* The total number of bytes and allocations since the last reset */
+	size_t m_used;
+	size_t m_capacity;
+	unsigned int m_numAllocations;
+
+	MemoryCategory m_category;
+
+	void addBlock(size_t size);
+public:
+	MemoryArena(size_t size, MemoryCategory category);
+	virtual ~MemoryArena();
+
+	/* Returns memory that is valid until the next reset, no destructors are ever called for it */
+	void* allocate(size_t size, size_t alignment);
+	inline void* allocate(size_t size) { return allocate(size, alignof(std::max_align_t)); }
+
+	/* Allocates an array of a type that doesn't need its destructor calling */
+	template<typename T>
+	inline T* allocateArray(size_t count) { return static_cast<T*>(allocate(count * sizeof(T), alignof(T))); }
+
+	/* Frees everything allocated since the last reset */
+	void reset();
+
+	inline size_t getUsed() { return m_used; }
+	inline unsigned int getNumAllocations() { return m_numAllocations; }
+	inline size_t getCapacity() { return m_capacity; }
+	inline unsigned int getNumBlocks() { return m_blocks.size(); }
+};
+
+/***************************************************************************************************/
+
+/***************************************************************************************************
+ * The MemoryPool class allocates objects of a single size from larger chunks, keeping freed ones
+ * in a list to be reused. It isn't thread safe so should only be used from the main thread
+ ***************************************************************************************************/
+
+class MemoryPool {
+private:
+	/* A freed element, its memory is reused to link it to the next one */
+	struct FreeElement {
+		FreeElement* next;
+	};
+
+	/* The size of the objects the pool is for, and the space each takes up once aligned */
+	size_t m_objectSize;
+	size_t m_elementSize;
+	unsigned int m_elementsPerChunk;
+	MemoryCategory m_category;
+
+	std::vector<char*> m_chunks;
+	FreeElement* m_free;
+
+	/* The number of elements that have been taken from the last chunk */
+	unsigned int m_chunkUsed;
+
+	unsigned int m_numAllocated;
+public:
+	MemoryPool(size_t elementSize, unsigned int elementsPerChunk, MemoryCategory category);
+	virtual ~MemoryPool();
+
+	void* allocate();
+	void free(void* pointer);
+
+	/* Used by a class's operator new and delete, anything that isn't the size the pool is for (a
+	 * class extending it) is allocated from the heap instead */
+	void* allocate(size_t size);
+	void free(void* pointer, size_t size);
+
+	inline size_t getElementSize() { return m_elementSize; }
+	inline unsigned int getNumAllocated() { return m_numAllocated; }
+	inline size_t getCapacity() { return m_chunks.size() * m_elementsPerChunk * m_elementSize; }
+};
+
+/***************************************************************************************************/
+
+/***************************************************************************************************
+ * The Memory class keeps track of the memory allocated in each category, along with the arena
+ * used for data that is only needed for the current frame
+ ***************************************************************************************************/
+
+class Memory {
+private:
+	static std::atomic<long long> m_liveBytes[MEMORY_CATEGORY_COUNT];
+	static std::atomic<long long> m_liveAllocations[MEMORY_CATEGORY_COUNT];
+	static std::atomic<unsigned int> m_frameAllocations[MEMORY_CATEGORY_COUNT];
+	static unsigned int m_lastFrameAllocations[MEMORY_CATEGORY_COUNT];
+
+	static MemoryArena* m_frameArena;
+public:
+	/* Records memory being allocated or freed by one of the allocators */
+	static void allocated(MemoryCategory category, size_t size);
+	static void freed(MemoryCategory category, size_t size);
+
+	/* Allocates from the heap while tracking it */
+	static void* allocate(size_t size, MemoryCategory category);
+	static void free(void* pointer, size_t size, MemoryCategory category);
+
+	/* Resets the frame arena and the allocation counts for the frame, called by the game at the
+	 * start of each frame */
+	static void nextFrame();
+
+	static MemoryArena* getFrameArena();
+
+	static inline long long getLiveBytes(MemoryCategory category) { return m_liveBytes[category].load(); }
+	static inline long long getLiveAllocations(MemoryCategory category) { return m_liveAllocations[category].load(); }
+	static inline unsigned int getFrameAllocations(MemoryCategory category) { return m_frameAllocations[category].load(); }
+	static inline unsigned int getLastFrameAllocations(MemoryCategory category) { return m_lastFrameAllocations[category]; }
+
+	static std::string getName(MemoryCategory category);
+	static std::string toString(MemoryCategory category);
+};
+
+/***************************************************************************************************/
+
+/***************************************************************************************************
+ * The FrameAllocator class allows standard containers to use the frame arena, anything using it
+ * must not be kept past the end of the frame
+ ***************************************************************************************************/
+
+template<typename T>
+class FrameAllocator {
+public:
+	typedef T value_type;
+
+	FrameAllocator() {}
+	template<typename U>
+	FrameAllocator(const FrameAllocator<U>& other) {}
+
+	inline T* allocate(size_t count) { return Memory::getFrameArena()->allocateArray<T>(count); }
+	inline void deallocate(T* pointer, size_t count) {}
+
+	template<typename U>
+	inline bool operator==(const FrameAllocator<U>& other) const { return true; }
+	template<typename U>
+	inline bool operator!=(const FrameAllocator<U>& other) const { return false; }
+};
+
+/* A vector whose memory comes from the frame arena */
+template<typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
+
+/***************************************************************************************************/
+
+#endif /* CORE_MEMORY_H_ */
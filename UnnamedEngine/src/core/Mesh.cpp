@@ -26,13 +26,99 @@
 /***************************************************************************************************
  * The Mesh class
  ***************************************************************************************************/
+
+MemoryPool MeshData::m_pool(sizeof(MeshData), 64, MEMORY_MESH);
+MemoryPool MeshRenderData::m_pool(sizeof(MeshRenderData), 64, MEMORY_MESH);
+MemoryPool Mesh::m_pool(sizeof(Mesh), 64, MEMORY_MESH);
+
+const float* MeshData::getValues(unsigned int attribute, unsigned int vertex) {
+	const unsigned int components[] = { 3, 4, 2, 3 };
+	const bool separate[] = { m_separatePositions, m_separateColours, m_separateTextureCoords, m_separateNormals };
+	const bool present[] = { hasPositions(), hasColours(), hasTextureCoords(), hasNormals() };
+	std::vector<float>* arrays[] = { &m_positions, &m_colours, &m_textureCoords, &m_normals };
+
+	//Values that aren't separate are interleaved in the 'other' array in the order of the attributes
+	unsigned int index = 0;
+	unsigned int offset = 0;
+	unsigned int stride = 0;
+	for (unsigned int a = 0; a < 4; a++) {
+		if ((1u << a) == attribute) {
+			index = a;
+			offset = stride;
+		}
+		if (present[a] && ! separate[a])
+			stride += components[a];
+	}
+	if (separate[index])
+		return &(*arrays[index])[vertex * components[index]];
+	return &m_other[vertex * stride + offset];
+}
+
+TriangleBVH* MeshData::getBVH() {
+	if (m_bvh == NULL)
+		m_bvh = new TriangleBVH(this);
+	return m_bvh;
+}
+
+void MeshData::reorderTriangles(const std::vector<unsigned int>& order) {
+	//The hierarchy refers to the triangles by their old positions
+	if (m_bvh != NULL) {
+		delete m_bvh;
+		m_bvh = NULL;
+	}
+	if (hasIndices()) {
+		std::vector<unsigned int> indices(m_indices.size());
+		for (unsigned int a = 0; a < order.size(); a++) {
+			for (unsigned int b = 0; b < 3; b++)
+				indices[a * 3 + b] = m_indices[order[a] * 3 + b];
+		}
+		m_indices.swap(indices);
+		return;
+	}
+	const unsigned int components[] = { 3, 4, 2, 3 };
+	const bool separate[] = { m_separatePositions, m_separateColours, m_separateTextureCoords, m_separateNormals };
+	const bool present[] = { hasPositions(), hasColours(), hasTextureCoords(), hasNormals() };
+	std::vector<float>* arrays[] = { &m_positions, &m_colours, &m_textureCoords, &m_normals };
+
+	unsigned int stride = 0;
+	for (unsigned int a = 0; a < 4; a++) {
+		if (present[a] && separate[a])
+			reorderTriangles(*arrays[a], components[a], order);
+		else if (present[a])
+			stride += components[a];
+	}
+	if (stride > 0)
+		reorderTriangles(m_other, stride, order);
+}
+
+void MeshData::reorderTriangles(std::vector<float>& values, unsigned int size, const std::vector<unsigned int>& order) {
+	unsigned int triangleSize = size * 3;
+	std::vector<float> reordered(values.size());
+	for (unsigned int a = 0; a < order.size(); a++)
+		std::copy(values.begin() + order[a] * triangleSize, values.begin() + (order[a] + 1) * triangleSize, reordered.begin() + a * triangleSize);
+	values.swap(reordered);
+}
+
 MeshRenderData::MeshRenderData(MeshData* data, std::string shaderType) {
-	m_shaderType = shaderType;
+	setShaderType(shaderType);
 	setup(data, true);
 }
 
+MeshRenderData::MeshRenderData(MeshData* data, std::string shaderType, bool shared) {
+	setShaderType(shaderType);
+	if (shared)
+		setupShared(data);
+	else
+		setup(data, true);
+}
+
 MeshRenderData::MeshRenderData(std::string shaderType) {
+	setShaderType(shaderType);
+}
+
+void MeshRenderData::setShaderType(const std::string& shaderType) {
 	m_shaderType = shaderType;
+	m_shaderHandle = Renderer::getShaderHandle(shaderType);
 }
 
 MeshRenderData::MeshRenderData(MeshData* data) : MeshRenderData::MeshRenderData(data, "Basic") {}
@@ -42,7 +128,7 @@ void MeshRenderData::setupVertexAttribPointer(std::string name, Shader* shader,
 
 	if (loc >= 0) {
 		glEnableVertexAttribArray(loc);
-		glVertexAttribPointer(loc, count, GL_FLOAT, GL_FALSE, stride, (void*) offset);
+		glVertexAttribPointer(loc, count, GL_FLOAT, GL_FALSE, stride, (void*) (uintptr_t) offset);
 	} else {
 		logDebug(std::string("The shader type '") + m_shaderType + std::string("' does not support the attribute '") + name + std::string("'"));
 	}
@@ -61,7 +147,7 @@ void MeshRenderData::setup(MeshData* data, bool generateVBOs) {
 	//Setup the VAO
 	if (generateVBOs)
 		glGenVertexArrays(1, &m_vao);
-	glBindVertexArray(m_vao);
+	GLState::bindVertexArray(m_vao);
 
 	//The current stride being used
 	GLuint currentStride = 0;
@@ -70,15 +156,15 @@ void MeshRenderData::setup(MeshData* data, bool generateVBOs) {
 	bool useOther = false;
 
 	//The shader
-	Shader* shader = Renderer::getShader(m_shaderType);
+	Shader* shader = Renderer::getShader(m_shaderHandle);
 
 	//Check for any positions
 	if (data->hasPositions() && data->separatePositions()) {
 		//Setup the VBO
 		if (generateVBOs)
 			glGenBuffers(1, &m_position_vbo);
-		glBindBuffer(GL_ARRAY_BUFFER, m_position_vbo);
-		glBufferData(GL_ARRAY_BUFFER, data->getNumPositions() * 3 * sizeof(data->getPositions()[0]), &data->getPositions().front(), m_positionsUsage);
+		GLState::bindBuffer(GL_ARRAY_BUFFER, m_position_vbo);
+		RenderStats::bufferData(GL_ARRAY_BUFFER, data->getNumPositions() * 3 * sizeof(data->getPositions()[0]), &data->getPositions().front(), m_positionsUsage);
 
 		setupVertexAttribPointer("Position", shader, 3, 0, 0);
 	} else if (data->hasPositions()) {
@@ -91,8 +177,8 @@ void MeshRenderData::setup(MeshData* data, bool generateVBOs) {
 		//Setup the VBO
 		if (generateVBOs)
 			glGenBuffers(1, &m_colour_vbo);
-		glBindBuffer(GL_ARRAY_BUFFER, m_colour_vbo);
-		glBufferData(GL_ARRAY_BUFFER, data->getNumColours() * 4 * sizeof(data->getColours()[0]), &data->getColours().front(), m_coloursUsage);
+		GLState::bindBuffer(GL_ARRAY_BUFFER, m_colour_vbo);
+		RenderStats::bufferData(GL_ARRAY_BUFFER, data->getNumColours() * 4 * sizeof(data->getColours()[0]), &data->getColours().front(), m_coloursUsage);
 
 		setupVertexAttribPointer("Colour", shader, 4, 0, 0);
 	} else if (data->hasColours()) {
@@ -105,8 +191,8 @@ void MeshRenderData::setup(MeshData* data, bool generateVBOs) {
 		//Setup the VBO
 		if (generateVBOs)
 			glGenBuffers(1, &m_colour_vbo);
-		glBindBuffer(GL_ARRAY_BUFFER, m_colour_vbo);
-		glBufferData(GL_ARRAY_BUFFER, data->getNumTextureCoords() * 2 * sizeof(data->getTextureCoords()[0]), &data->getTextureCoords().front(), m_textureCoordsUsage);
+		GLState::bindBuffer(GL_ARRAY_BUFFER, m_colour_vbo);
+		RenderStats::bufferData(GL_ARRAY_BUFFER, data->getNumTextureCoords() * 2 * sizeof(data->getTextureCoords()[0]), &data->getTextureCoords().front(), m_textureCoordsUsage);
 
 		setupVertexAttribPointer("TextureCoordinate", shader, 2, 0, 0);
 	} else if (data->hasTextureCoords()) {
@@ -119,8 +205,8 @@ void MeshRenderData::setup(MeshData* data, bool generateVBOs) {
 		//Setup the VBO
 		if (generateVBOs)
 			glGenBuffers(1, &m_normal_vbo);
-		glBindBuffer(GL_ARRAY_BUFFER, m_normal_vbo);
-		glBufferData(GL_ARRAY_BUFFER, data->getNumNormals() * 3 * sizeof(data->getNormals()[0]), &data->getNormals().front(), m_normalsUsage);
+		GLState::bindBuffer(GL_ARRAY_BUFFER, m_normal_vbo);
+		RenderStats::bufferData(GL_ARRAY_BUFFER, data->getNumNormals() * 3 * sizeof(data->getNormals()[0]), &data->getNormals().front(), m_normalsUsage);
 
 		setupVertexAttribPointer("Normal", shader, 3, 0, 0);
 	} else if (data->hasNormals()) {
@@ -136,8 +222,8 @@ void MeshRenderData::setup(MeshData* data, bool generateVBOs) {
 		//Setup the VBO
 		if (generateVBOs)
 			glGenBuffers(1, &m_other_vbo);
-		glBindBuffer(GL_ARRAY_BUFFER, m_other_vbo);
-		glBufferData(GL_ARRAY_BUFFER, data->getOthers().size() * sizeof(data->getOthers()[0]), &data->getOthers().front(), m_otherUsage);
+		GLState::bindBuffer(GL_ARRAY_BUFFER, m_other_vbo);
+		RenderStats::bufferData(GL_ARRAY_BUFFER, data->getOthers().size() * sizeof(data->getOthers()[0]), &data->getOthers().front(), m_otherUsage);
 
 		if (data->hasPositions() && ! data->separatePositions()) {
 			m_positionsOffset = currentOffset;
@@ -180,23 +266,50 @@ void MeshRenderData::setup(MeshData* data, bool generateVBOs) {
 		//Setup the VBO
 		if (generateVBOs)
 			glGenBuffers(1, &m_indices_vbo);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indices_vbo);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, data->getNumIndices() * sizeof(data->getIndices()[0]), &data->getIndices().front(), m_indicesUsage);
+		GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indices_vbo);
+		RenderStats::bufferData(GL_ELEMENT_ARRAY_BUFFER, data->getNumIndices() * sizeof(data->getIndices()[0]), &data->getIndices().front(), m_indicesUsage);
+	}
+	GLState::bindVertexArray(0);
+}
+
+void MeshRenderData::setupShared(MeshData* data) {
+	//Fall back on buffers of its own if the data can't be stored in the shared ones
+	if (! MeshBuffers::add(data, m_shaderHandle, m_range)) {
+		setup(data, true);
+		return;
+	}
+	m_shared = true;
+	m_vao = MeshBuffers::getVertexArray(m_range.format);
+	if (data->hasIndices()) {
+		m_numVertices = data->getNumIndices();
+		m_hasIndices = true;
+	} else {
+		m_numVertices = data->getNumPositions();
+		m_hasIndices = false;
 	}
-	glBindVertexArray(0);
 }
 
 void MeshRenderData::render() {
-	glBindVertexArray(m_vao);
-	if (m_hasIndices) {
+	GLState::bindVertexArray(m_vao);
+	if (m_shared) {
+		//Meshes in the shared buffers are found by their offsets within them
+		if (m_hasIndices)
+			glDrawElementsBaseVertex(GL_TRIANGLES, m_numVertices, GL_UNSIGNED_INT, (void*) (uintptr_t) m_range.indices.offset, m_range.baseVertex);
+		else
+			glDrawArrays(GL_TRIANGLES, m_range.baseVertex, m_numVertices);
+	} else if (m_hasIndices) {
 		glDrawElements(GL_TRIANGLES, m_numVertices, GL_UNSIGNED_INT, (void *) NULL);
 	} else {
 		glDrawArrays(GL_TRIANGLES, 0, m_numVertices);
 	}
-	glBindVertexArray(0);
+	RenderStats::addDraw(m_hasIndices, m_numVertices);
 }
 
 void MeshRenderData::updateVertices(MeshData* data) {
+	if (m_shared) {
+		logError("Meshes stored in the MeshBuffers can't be updated");
+		return;
+	}
 	if (data->hasIndices()) {
 		m_numVertices = data->getIndices().size();
 		m_hasIndices = true;
@@ -204,12 +317,12 @@ void MeshRenderData::updateVertices(MeshData* data) {
 		m_numVertices = data->getPositions().size();
 		m_hasIndices = false;
 	}
-	glBindVertexArray(m_vao);
+	GLState::bindVertexArray(m_vao);
 
-	glBindBuffer(GL_ARRAY_BUFFER, m_position_vbo);
-	glBufferData(GL_ARRAY_BUFFER, data->getPositions().size() * sizeof(data->getPositions()[0]), &data->getPositions().front(), GL_STATIC_DRAW);
+	GLState::bindBuffer(GL_ARRAY_BUFFER, m_position_vbo);
+	RenderStats::bufferData(GL_ARRAY_BUFFER, data->getPositions().size() * sizeof(data->getPositions()[0]), &data->getPositions().front(), GL_STATIC_DRAW);
 
-	GLint loc = Renderer::getShader(m_shaderType)->getAttributeLocation("Position");
+	GLint loc = Renderer::getShader(m_shaderHandle)->getAttributeLocation("Position");
 
 	if (loc >= 0) {
 		glEnableVertexAttribArray(loc);
@@ -217,29 +330,37 @@ void MeshRenderData::updateVertices(MeshData* data) {
 	} else
 		logDebug(std::string("The shader type '") + m_shaderType + std::string("' does not support positions"));
 
-	glBindVertexArray(0);
+	GLState::bindVertexArray(0);
 
 }
 
 void MeshRenderData::updateIndices(MeshData* data) {
+	if (m_shared) {
+		logError("Meshes stored in the MeshBuffers can't be updated");
+		return;
+	}
 	m_numVertices = data->getIndices().size();
 	m_hasIndices = true;
 
-	glBindVertexArray(m_vao);
+	GLState::bindVertexArray(m_vao);
 
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indices_vbo);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, data->getIndices().size() * sizeof(data->getIndices()[0]), &data->getIndices().front(), GL_STATIC_DRAW);
+	GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indices_vbo);
+	RenderStats::bufferData(GL_ELEMENT_ARRAY_BUFFER, data->getIndices().size() * sizeof(data->getIndices()[0]), &data->getIndices().front(), GL_STATIC_DRAW);
 
-	glBindVertexArray(0);
+	GLState::bindVertexArray(0);
 }
 
 void MeshRenderData::updateColours(MeshData* data) {
-	glBindVertexArray(m_vao);
+	if (m_shared) {
+		logError("Meshes stored in the MeshBuffers can't be updated");
+		return;
+	}
+	GLState::bindVertexArray(m_vao);
 
-	glBindBuffer(GL_ARRAY_BUFFER, m_colour_vbo);
-	glBufferData(GL_ARRAY_BUFFER, data->getColours().size() * sizeof(data->getColours()[0]), &data->getColours().front(), GL_STATIC_DRAW);
+	GLState::bindBuffer(GL_ARRAY_BUFFER, m_colour_vbo);
+	RenderStats::bufferData(GL_ARRAY_BUFFER, data->getColours().size() * sizeof(data->getColours()[0]), &data->getColours().front(), GL_STATIC_DRAW);
 
-	GLint loc = Renderer::getShader(m_shaderType)->getAttributeLocation("Colour");
+	GLint loc = Renderer::getShader(m_shaderHandle)->getAttributeLocation("Colour");
 
 	if (loc >= 0) {
 		glEnableVertexAttribArray(loc);
@@ -247,16 +368,20 @@ void MeshRenderData::updateColours(MeshData* data) {
 	} else
 		logDebug(std::string("The shader type '") + m_shaderType + std::string("' does not support colours"));
 
-	glBindVertexArray(0);
+	GLState::bindVertexArray(0);
 }
 
 void MeshRenderData::updateTextureCoords(MeshData* data) {
-	glBindVertexArray(m_vao);
+	if (m_shared) {
+		logError("Meshes stored in the MeshBuffers can't be updated");
+		return;
+	}
+	GLState::bindVertexArray(m_vao);
 
-	glBindBuffer(GL_ARRAY_BUFFER, m_textureCoord_vbo);
-	glBufferData(GL_ARRAY_BUFFER, data->getTextureCoords().size() * sizeof(data->getTextureCoords()[0]), &data->getTextureCoords().front(), GL_STATIC_DRAW);
+	GLState::bindBuffer(GL_ARRAY_BUFFER, m_textureCoord_vbo);
+	RenderStats::bufferData(GL_ARRAY_BUFFER, data->getTextureCoords().size() * sizeof(data->getTextureCoords()[0]), &data->getTextureCoords().front(), GL_STATIC_DRAW);
 
-	GLint loc = Renderer::getShader(m_shaderType)->getAttributeLocation("TextureCoordinate");
+	GLint loc = Renderer::getShader(m_shaderHandle)->getAttributeLocation("TextureCoordinate");
 
 	if (loc >= 0) {
 		glEnableVertexAttribArray(loc);
@@ -264,14 +389,16 @@ void MeshRenderData::updateTextureCoords(MeshData* data) {
 	} else
 		logDebug(std::string("The shader type '") + m_shaderType + std::string("' does not support texture coordinates"));
 
-	glBindVertexArray(0);
+	GLState::bindVertexArray(0);
 }
 
 MeshRenderData::~MeshRenderData() {
-//	glDeleteBuffers(1, &m_position_vbo);
-//	glDeleteBuffers(1, &m_colour_vbo);
-//	glDeleteBuffers(1, &m_indices_vbo);
-//	glDeleteVertexArrays(1, &m_vao);
+	if (m_shared)
+		MeshBuffers::remove(m_range);
+//	GLState::deleteBuffer(m_position_vbo);
+//	GLState::deleteBuffer(m_colour_vbo);
+//	GLState::deleteBuffer(m_indices_vbo);
+//	GLState::deleteVertexArray(m_vao);
 }
 
 /***************************************************************************************************/
@@ -280,6 +407,21 @@ MeshRenderData::~MeshRenderData() {
  * The MeshBuilder class provides various methods to make Mesh objects
  ***************************************************************************************************/
 
+Mesh* MeshBuilder::m_unitQuad = NULL;
+
+Mesh* MeshBuilder::createUnitQuad(Texture* texture) {
+	//Only the positions are needed as the texture coordinates are calculated from them
+	if (m_unitQuad == NULL) {
+		MeshData* data = new MeshData();
+		addQuadV(data, 1, 1);
+		addQuadI(data);
+		m_unitQuad = new Mesh(data, "Quad");
+	}
+	Mesh* mesh = new Mesh(m_unitQuad->getData(), m_unitQuad->getRenderData());
+	mesh->setTexture(texture);
+	return mesh;
+}
+
 Mesh* MeshBuilder::createQuad(float width, float height, std::string shaderType) {
 	MeshData* data = new MeshData();
 	addQuadV(data, Vector2f(0, 0), Vector2f(width, height));
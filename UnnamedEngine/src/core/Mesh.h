@@ -22,11 +22,16 @@
 #include<iostream>
 #include<string>
 #include<vector>
+#include<algorithm>
 
 #include "../utils/MathUtils.h"
+#include "Memory.h"
 #include "render/Material.h"
 #include "Vector.h"
 #include "Texture.h"
+#include "render/MeshBuffers.h"
+#include "render/Meshlets.h"
+#include "render/TriangleBVH.h"
 
 /***************************************************************************************************
  * The Mesh class stores data that can be used to render a mesh
@@ -54,7 +59,26 @@ private:
 	unsigned int m_numTextureCoordinates = 0;
 	unsigned int m_numNormals = 0;
 	unsigned int m_numIndices = 0;
+
+	/* The bounding box of the positions added */
+	Vector3f m_boundsMin;
+	Vector3f m_boundsMax;
+
+	/* The meshlets the triangles have been split into, if any */
+	std::vector<Meshlet> m_meshlets;
+
+	/* The hierarchy used to find the triangles hit by rays, built when it is first needed */
+	TriangleBVH* m_bvh = NULL;
+
+	/* Moves the values of each triangle's vertices in an array into a new order */
+	static void reorderTriangles(std::vector<float>& values, unsigned int size, const std::vector<unsigned int>& order);
+
+	/* The pool MeshData instances are allocated from */
+	static MemoryPool m_pool;
 public:
+	static inline void* operator new(size_t size) { return m_pool.allocate(size); }
+	static inline void operator delete(void* pointer, size_t size) { m_pool.free(pointer, size); }
+
 	MeshData() {
 		m_positions     = std::vector<float>();
 		m_colours       = std::vector<float>();
@@ -64,6 +88,12 @@ public:
 		m_indices       = std::vector<unsigned int>();
 	}
 
+	~MeshData() { delete m_bvh; }
+
+	/* Copies would share the hierarchy and delete it twice */
+	MeshData(const MeshData& other) = delete;
+	MeshData& operator=(const MeshData& other) = delete;
+
 	MeshData(bool separatePositions, bool separateColours, bool separateTextureCoords, bool separateNormals) : MeshData() {
 		m_separatePositions = separatePositions;
 		m_separateColours = separateColours;
@@ -72,6 +102,13 @@ public:
 	}
 
 	inline void addPosition(Vector3f position) {
+		if (m_numPositions == 0) {
+			m_boundsMin = position;
+			m_boundsMax = position;
+		} else {
+			m_boundsMin = Vector3f(std::min(m_boundsMin.getX(), position.getX()), std::min(m_boundsMin.getY(), position.getY()), std::min(m_boundsMin.getZ(), position.getZ()));
+			m_boundsMax = Vector3f(std::max(m_boundsMax.getX(), position.getX()), std::max(m_boundsMax.getY(), position.getY()), std::max(m_boundsMax.getZ(), position.getZ()));
+		}
 		if (m_separatePositions) {
 			m_positions.push_back(position.getX());
 			m_positions.push_back(position.getY());
@@ -121,12 +158,12 @@ public:
 	}
 	inline void addIndex(unsigned int index)           { m_indices.push_back(index); m_numIndices++; }
 
-	inline std::vector<float> getPositions()        { return m_positions;                      }
-	inline std::vector<float> getColours()          { return m_colours;                        }
-	inline std::vector<float> getNormals()          { return m_normals;                        }
-	inline std::vector<float> getTextureCoords()    { return m_textureCoords;                  }
-	inline std::vector<float> getOthers()   		{ return m_other;                        }
-	inline std::vector<unsigned int> getIndices()   { return m_indices;                        }
+	inline std::vector<float>& getPositions()        { return m_positions;                      }
+	inline std::vector<float>& getColours()          { return m_colours;                        }
+	inline std::vector<float>& getNormals()          { return m_normals;                        }
+	inline std::vector<float>& getTextureCoords()    { return m_textureCoords;                  }
+	inline std::vector<float>& getOthers()   		{ return m_other;                        }
+	inline std::vector<unsigned int>& getIndices()   { return m_indices;                        }
 
 	inline bool separatePositions() { return m_separatePositions; }
 	inline bool separateColours() { return m_separateColours; }
@@ -149,6 +186,27 @@ public:
 	inline unsigned int getNumTextureCoords() { return m_numTextureCoordinates; }
 	inline unsigned int getNumNormals() { return m_numNormals; }
 	inline unsigned int getNumIndices() { return m_numIndices; }
+	inline unsigned int getNumTriangles() { return (hasIndices() ? m_numIndices : m_numPositions) / 3; }
+
+	/* Returns the bounding box of the positions, which is empty when there are none */
+	inline Vector3f getBoundsMin() { return m_boundsMin; }
+	inline Vector3f getBoundsMax() { return m_boundsMax; }
+
+	/* Returns the values of one of the MeshBuffers::Attribute for a vertex, wherever they are
+	 * stored */
+	const float* getValues(unsigned int attribute, unsigned int vertex);
+
+	/* Moves the triangles into a new order, given as the triangle that should be at each position.
+	 * This moves the indices, or the vertices when there are none */
+	void reorderTriangles(const std::vector<unsigned int>& order);
+
+	inline std::vector<Meshlet>& getMeshlets() { return m_meshlets; }
+	inline bool hasMeshlets() { return m_meshlets.size() > 0; }
+
+	/* Returns the hierarchy of the triangles, building it the first time. It is built from the
+	 * positions at the time, so they shouldn't be changed afterwards */
+	TriangleBVH* getBVH();
+	inline bool hasBVH() { return m_bvh != NULL; }
 };
 
 class MeshRenderData {
@@ -185,19 +243,36 @@ private:
 	int m_numVertices         = 0;
 	bool m_hasIndices         = false;
 
+	/* States whether the data is stored in the MeshBuffers rather than buffers of its own, and
+	 * where it is within them */
+	bool m_shared             = false;
+	MeshBufferRange m_range;
+
 	Material* m_material = NULL;
 	std::string m_shaderType = "Basic";
 
+	/* The handle of the shader type, found once so the Renderer doesn't have to look it up */
+	unsigned int m_shaderHandle = SHADER_TYPE_BASIC;
+
+	/* The pool MeshRenderData instances are allocated from */
+	static MemoryPool m_pool;
 private:
 	void setupVertexAttribPointer(std::string name, Shader* shader, int count, int offset, int stride);
 public:
+	static inline void* operator new(size_t size) { return m_pool.allocate(size); }
+	static inline void operator delete(void* pointer, size_t size) { m_pool.free(pointer, size); }
+
 	MeshRenderData() { }
 	MeshRenderData(MeshData* data);
 	MeshRenderData(std::string shaderType);
 	MeshRenderData(MeshData* data, std::string shaderType);
+	/* Stores the data in the MeshBuffers when shared is true and it is possible to, it can't be
+	 * updated afterwards */
+	MeshRenderData(MeshData* data, std::string shaderType, bool shared);
 	virtual ~MeshRenderData();
 
 	void setup(MeshData* data, bool generateVBOs);
+	void setupShared(MeshData* data);
 
 	void render();
 
@@ -207,11 +282,15 @@ public:
 	void updateIndices(MeshData* data);
 
 	inline void setMaterial(Material* material) { m_material = material; }
-	inline void setShaderType(std::string shaderType) { m_shaderType = shaderType; }
+	void setShaderType(const std::string& shaderType);
 	inline Material* getMaterial() { return m_material; }
-	inline std::string getShaderType() { return m_shaderType; }
+	inline const std::string& getShaderType() { return m_shaderType; }
+	inline unsigned int getShaderHandle() { return m_shaderHandle; }
 	inline bool hasMaterial() { return m_material != NULL; }
 	inline int getNumVertices() { return m_numVertices; }
+	inline bool isShared() { return m_shared; }
+	inline bool hasIndices() { return m_hasIndices; }
+	inline const MeshBufferRange& getBufferRange() { return m_range; }
 };
 
 class Mesh {
@@ -219,10 +298,19 @@ private:
 	MeshData* m_data;
 	MeshRenderData* m_renderData;
 	Texture* m_texture;
+
+	/* The pool Mesh instances are allocated from, as one is created for almost every object */
+	static MemoryPool m_pool;
 public:
+	static inline void* operator new(size_t size) { return m_pool.allocate(size); }
+	static inline void operator delete(void* pointer, size_t size) { m_pool.free(pointer, size); }
+
 	Mesh() { m_data = NULL; m_renderData = NULL; m_texture = NULL; }
 	Mesh(MeshData* data) { m_data = data; m_renderData = new MeshRenderData(m_data); m_texture = NULL; }
 	Mesh(MeshData* data, std::string shaderType) { m_data = data; m_renderData = new MeshRenderData(m_data, shaderType); m_texture = NULL; }
+	Mesh(MeshData* data, std::string shaderType, bool shared) { m_data = data; m_renderData = new MeshRenderData(m_data, shaderType, shared); m_texture = NULL; }
+	/* Creates a mesh that shares its data and buffers with another */
+	Mesh(MeshData* data, MeshRenderData* renderData) { m_data = data; m_renderData = renderData; m_texture = NULL; }
 	virtual ~Mesh() { }
 
 	inline void render() { m_renderData->render(); }
@@ -244,8 +332,20 @@ public:
  ***************************************************************************************************/
 
 class MeshBuilder {
+private:
+	/* The quad shared by every mesh created with createUnitQuad */
+	static Mesh* m_unitQuad;
 public:
 	//2D stuff
+
+	/* Returns a mesh using a quad from (0, 0) to (1, 1) that is shared with every other mesh
+	 * created this way, so creating one doesn't allocate anything on the GPU. It is scaled to the
+	 * size of the object rendering it, and its colour and the area of its texture are given when
+	 * it is drawn rather than stored in its vertices */
+	static Mesh* createUnitQuad(Texture* texture);
+	static inline Mesh* createUnitQuad() { return createUnitQuad(NULL); }
+	static inline bool isUnitQuad(Mesh* mesh) { return m_unitQuad != NULL && mesh != NULL && mesh->getRenderData() == m_unitQuad->getRenderData(); }
+
 	static inline Mesh* createQuad(Vector2f topLeft, Vector2f bottomRight) { return createQuad(topLeft, bottomRight, "Basic"); }
 	static inline Mesh* createQuad(float width, float height) { return createQuad(width, height, "Basic"); }
 	static inline Mesh* createQuad(float width, float height, Colour colour) { return createQuad(width, height, colour, "Basic"); }
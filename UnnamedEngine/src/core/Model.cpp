@@ -25,6 +25,7 @@
 #include "../utils/StringUtils.h"
 #include "../utils/Logging.h"
 #include "render/Renderer.h"
+#include "render/TextureStreamer.h"
 #include "Model.h"
 
 /***************************************************************************************************
@@ -32,8 +33,24 @@
  ***************************************************************************************************/
 
 void Model::render() {
+	Matrix4f modelMatrix = getModelMatrix();
 	for (unsigned int a = 0; a < m_meshes.size(); a++)
-		Renderer::render(m_meshes[a], getModelMatrix());
+		Renderer::render(m_meshes[a], modelMatrix);
+}
+
+bool Model::raycast(Vector3f origin, Vector3f direction, float maxDistance, RayHit& hit) {
+	Matrix4f inverseModelMatrix = getModelMatrix().inverse();
+	bool found = false;
+	for (unsigned int a = 0; a < m_meshes.size(); a++) {
+		//Each mesh only has to be tested closer than anything already hit
+		if (raycastMesh(m_meshes[a], a, inverseModelMatrix, origin, direction, found ? hit.distance : maxDistance, hit))
+			found = true;
+	}
+	if (found) {
+		hit.object = this;
+		hit.source = NULL;
+	}
+	return found;
 }
 
 Model* Model::loadModel(const char* path, const char* fileName, std::string shaderType) {
@@ -61,14 +78,21 @@ Model* Model::loadModel(const char* path, const char* fileName, std::string shad
 					}
 				}
 			}
-			Mesh* mesh = new Mesh(currentData, shaderType);
+			//Split the mesh up so the parts that can't be seen don't have to be drawn
+			Meshlets::build(currentData);
+			//Models aren't changed once loaded, so they can share buffers with each other
+			Mesh* mesh = new Mesh(currentData, shaderType, MeshBuffers::isSupported());
 			if (scene->mMaterials[0] != NULL) {
 				aiMaterial* currentMaterial = scene->mMaterials[currentMesh->mMaterialIndex];
 				Material* material = new Material();
 				if (currentMaterial->GetTextureCount(aiTextureType_DIFFUSE) != 0) {
 					aiString p;
 					currentMaterial->GetTexture(aiTextureType_DIFFUSE, 0, &p, NULL, NULL, NULL, NULL, NULL);
-					material->setDiffuseTexture(Texture::loadTexture((to_string(path) + to_string(p.C_Str())).c_str()));
+					std::string texturePath = to_string(path) + to_string(p.C_Str());
+					if (TextureStreamer::isEnabled())
+						material->setDiffuseTexture(TextureStreamer::load(texturePath.c_str(), TextureParameters()));
+					else
+						material->setDiffuseTexture(Texture::loadTexture(texturePath.c_str()));
 				}
 				aiColor3D ambientColour = aiColor3D(1.0f, 1.0f, 1.0f);
 				currentMaterial->Get(AI_MATKEY_COLOR_AMBIENT, ambientColour);
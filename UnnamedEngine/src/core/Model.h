@@ -36,8 +36,10 @@ public:
 	virtual ~Model() {}
 	inline void addMesh(Mesh* mesh) { m_meshes.push_back(mesh); }
 	void render();
+	bool raycast(Vector3f origin, Vector3f direction, float maxDistance, RayHit& hit);
 
 	inline Mesh* getMesh(unsigned int n) { return m_meshes[n]; }
+	inline unsigned int getNumMeshes() { return m_meshes.size(); }
 
 	static Model* loadModel(const char* path, const char* fileName, std::string shaderType);
 	static inline Model* loadModel(const char* path, const char* fileName) { return loadModel(path, fileName, "Material"); }
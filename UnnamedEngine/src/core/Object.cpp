@@ -19,6 +19,9 @@
 #include "Object.h"
 #include "render/Renderer.h"
 
+MemoryPool RenderableObject2D::m_pool(sizeof(RenderableObject2D), 64, MEMORY_OBJECT);
+MemoryPool RenderableObject3D::m_pool(sizeof(RenderableObject3D), 64, MEMORY_OBJECT);
+
 void RenderableObject2D::render() {
 	Renderer::render(m_mesh, m_modelMatrix);
 }
@@ -26,3 +29,30 @@ void RenderableObject2D::render() {
 void RenderableObject3D::render() {
 	Renderer::render(m_mesh, m_modelMatrix);
 }
+
+bool RenderableObject3D::raycast(Vector3f origin, Vector3f direction, float maxDistance, RayHit& hit) {
+	if (m_mesh == NULL || ! raycastMesh(m_mesh, 0, m_modelMatrix.inverse(), origin, direction, maxDistance, hit))
+		return false;
+	hit.object = this;
+	hit.source = NULL;
+	return true;
+}
+
+bool RenderableObject3D::raycastMesh(Mesh* mesh, unsigned int index, const Matrix4f& inverseModelMatrix, Vector3f origin, Vector3f direction, float maxDistance, RayHit& hit) {
+	MeshData* data = mesh->getData();
+	if (data == NULL || ! data->hasPositions())
+		return false;
+	//The ray is moved into the space of the mesh without normalising its direction, so distances
+	//along it stay the same
+	const Matrix4f& m = inverseModelMatrix;
+	Vector3f o = Vector3f(m.m_values[0][0] * origin[0] + m.m_values[0][1] * origin[1] + m.m_values[0][2] * origin[2] + m.m_values[0][3],
+						  m.m_values[1][0] * origin[0] + m.m_values[1][1] * origin[1] + m.m_values[1][2] * origin[2] + m.m_values[1][3],
+						  m.m_values[2][0] * origin[0] + m.m_values[2][1] * origin[1] + m.m_values[2][2] * origin[2] + m.m_values[2][3]);
+	Vector3f d = Vector3f(m.m_values[0][0] * direction[0] + m.m_values[0][1] * direction[1] + m.m_values[0][2] * direction[2],
+						  m.m_values[1][0] * direction[0] + m.m_values[1][1] * direction[1] + m.m_values[1][2] * direction[2],
+						  m.m_values[2][0] * direction[0] + m.m_values[2][1] * direction[1] + m.m_values[2][2] * direction[2]);
+	if (! data->getBVH()->intersect(o, d, maxDistance, hit))
+		return false;
+	hit.mesh = index;
+	return true;
+}
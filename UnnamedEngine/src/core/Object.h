@@ -70,15 +70,17 @@ public:
 	Object2D(Vector2f position, float rotation, Vector2f scale, Vector2f size) : position(position), rotation(rotation), scale(scale), size(size) {}
 
 
-	inline void setPosition(Vector2f position) { this->position = position; }
-	inline void setPosition(float x, float y) { position = Vector2f(x, y); }
+	virtual ~Object2D() {}
+
+	inline void setPosition(Vector2f position) { this->position = position; onTransformChanged(false); }
+	inline void setPosition(float x, float y) { position = Vector2f(x, y); onTransformChanged(false); }
 	inline void setRotation(float rotation) { this->rotation = rotation; }
-	inline void setScale(Vector2f scale) { this->scale = scale; }
-	inline void setScale(float x, float y) { scale = Vector2f(x, y); }
-	inline void setSize(Vector2f size) { this->size = size; }
-	inline void setSize(float width, float height) { size = Vector2f(width, height); }
-	inline void setWidth(float width) { size.setX(width); }
-	inline void setHeight(float height) { size.setY(height); }
+	inline void setScale(Vector2f scale) { this->scale = scale; onTransformChanged(true); }
+	inline void setScale(float x, float y) { scale = Vector2f(x, y); onTransformChanged(true); }
+	inline void setSize(Vector2f size) { this->size = size; onTransformChanged(true); }
+	inline void setSize(float width, float height) { size = Vector2f(width, height); onTransformChanged(true); }
+	inline void setWidth(float width) { size.setX(width); onTransformChanged(true); }
+	inline void setHeight(float height) { size.setY(height); onTransformChanged(true); }
 	inline Vector2f getPosition() {
 		if (m_parent == NULL)
 			return position;
@@ -113,6 +115,11 @@ public:
 	inline void setParent(Object2D* parent) { m_parent = parent; }
 	inline Object2D* getParent() { return m_parent; }
 	inline void attach(Object2D* child) { child->setParent(this); }
+protected:
+	/* Called by each of the setters above after the position, or the size or scale when resized
+	 * is true, has changed. Classes extending this one override it to keep anything that depends
+	 * on their bounds up to date, however they are changed */
+	virtual void onTransformChanged(bool resized) {}
 };
 
 class Object3D : public Object {
@@ -197,7 +204,13 @@ class RenderableObject2D : public Object2D {
 private:
 	Mesh* m_mesh;
 	Matrix4f m_modelMatrix;
+
+	/* The pool instances are allocated from, classes extending this one use the heap */
+	static MemoryPool m_pool;
 public:
+	static inline void* operator new(size_t size) { return m_pool.allocate(size); }
+	static inline void operator delete(void* pointer, size_t size) { m_pool.free(pointer, size); }
+
 	RenderableObject2D() { m_mesh = NULL; }
 	RenderableObject2D(Mesh* mesh) : m_mesh(mesh) {
 		m_modelMatrix = Matrix4f();
@@ -223,6 +236,9 @@ public:
 		m_modelMatrix.rotate(getRotation());
 		m_modelMatrix.translate(Vector2f(-w, -h));
 		m_modelMatrix.scale(getScale());
+		//A shared unit quad has to be scaled to the size of this object
+		if (MeshBuilder::isUnitQuad(m_mesh))
+			m_modelMatrix.scale(Vector2f(getWidth(), getHeight()));
 	}
 
 	virtual void render();
@@ -235,7 +251,21 @@ class RenderableObject3D : public Object3D {
 private:
 	Mesh* m_mesh;
 	Matrix4f m_modelMatrix;
+
+	/* Incremented whenever update changes the model matrix, so anything keeping track of where
+	 * the object is only has to look at it again once it has moved */
+	unsigned int m_transformVersion = 0;
+
+	/* States whether the object will never move, so it can be merged with others by
+	 * Scene::bakeStatic */
+	bool m_static = false;
+
+	/* The pool instances are allocated from, classes extending this one use the heap */
+	static MemoryPool m_pool;
 public:
+	static inline void* operator new(size_t size) { return m_pool.allocate(size); }
+	static inline void operator delete(void* pointer, size_t size) { m_pool.free(pointer, size); }
+
 	RenderableObject3D() { m_mesh = NULL; }
 	RenderableObject3D(Mesh* mesh) : m_mesh(mesh) {
 		m_modelMatrix = Matrix4f();
@@ -251,6 +281,7 @@ public:
 	virtual ~RenderableObject3D() {}
 
 	void update() {
+		Matrix4f previous = m_modelMatrix;
 		m_modelMatrix.setIdentity();
 		Vector3f p = getPosition();
 		float w = getWidth() / 2;
@@ -261,12 +292,33 @@ public:
 		m_modelMatrix.rotate(getRotation());
 		m_modelMatrix.translate(Vector3f(-w, -h, -d));
 		m_modelMatrix.scale(getScale());
+
+		for (unsigned int a = 0; a < 16; a++) {
+			if (previous.m_values[a / 4][a % 4] != m_modelMatrix.m_values[a / 4][a % 4]) {
+				m_transformVersion++;
+				break;
+			}
+		}
 	}
 
 	virtual void render();
 
+	/* Finds the closest triangle of the object's meshes hit by a ray in world space, within a
+	 * distance in multiples of the ray's direction. Returns false when nothing closer is hit */
+	virtual bool raycast(Vector3f origin, Vector3f direction, float maxDistance, RayHit& hit);
+
+	/* The same as raycast for the segment between two points */
+	inline bool raycastSegment(Vector3f start, Vector3f end, RayHit& hit) { return raycast(start, end - start, 1.0f, hit); }
+
 	inline Mesh* getMesh() { return m_mesh; }
 	inline Matrix4f getModelMatrix() { return m_modelMatrix; }
+	inline unsigned int getTransformVersion() { return m_transformVersion; }
+	inline void setStatic(bool isStatic) { m_static = isStatic; }
+	inline bool isStatic() { return m_static; }
+protected:
+	/* Tests a ray in world space against a mesh using the inverse of the model matrix it is drawn
+	 * with, setting the index of the mesh when it is hit */
+	static bool raycastMesh(Mesh* mesh, unsigned int index, const Matrix4f& inverseModelMatrix, Vector3f origin, Vector3f direction, float maxDistance, RayHit& hit);
 };
 
 /***************************************************************************************************/
@@ -0,0 +1,361 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <fstream>
+#include <cstring>
+
+#include "Profiler.h"
+#include "../utils/Logging.h"
+#include "../utils/StringUtils.h"
+#include "../utils/Time.h"
+
+/***************************************************************************************************
+ * The ProfilerThreadBuffer class
+ ***************************************************************************************************/
+
+ProfilerThreadBuffer::ProfilerThreadBuffer(unsigned int thread, unsigned int capacity, unsigned int maxOverflow) {
+	unsigned int size = 1;
+	while (size < capacity)
+		size <<= 1;
+	m_events.resize(size);
+	m_mask = size - 1;
+	m_head.store(0, std::memory_order_relaxed);
+	m_tail.store(0, std::memory_order_relaxed);
+	m_maxOverflow = maxOverflow;
+	m_dropped.store(0, std::memory_order_relaxed);
+	this->thread = thread;
+	depth = 0;
+}
+
+void ProfilerThreadBuffer::moveEvents(std::vector<ProfilerEvent>& events) {
+	unsigned int tail = m_tail.load(std::memory_order_relaxed);
+	unsigned int head = m_head.load(std::memory_order_acquire);
+	while (tail != head) {
+		events.push_back(m_events[tail & m_mask]);
+		tail++;
+	}
+	m_tail.store(tail, std::memory_order_release);
+}
+
+void ProfilerThreadBuffer::add(const ProfilerEvent& event) {
+	unsigned int head = m_head.load(std::memory_order_relaxed);
+	if (head - m_tail.load(std::memory_order_acquire) > m_mask) {
+		//The ring is full, so make room by moving its events into the overflow
+		std::lock_guard<std::mutex> lock(m_overflowMutex);
+		//The frame may have been collected while waiting for the lock
+		if (head - m_tail.load(std::memory_order_acquire) > m_mask) {
+			if (m_overflow.size() + m_mask + 1 > m_maxOverflow) {
+				m_dropped.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+			moveEvents(m_overflow);
+		}
+	}
+	m_events[head & m_mask] = event;
+	m_head.store(head + 1, std::memory_order_release);
+}
+
+unsigned int ProfilerThreadBuffer::collect(std::vector<ProfilerEvent>& events) {
+	std::lock_guard<std::mutex> lock(m_overflowMutex);
+	if (! m_overflow.empty()) {
+		events.insert(events.end(), m_overflow.begin(), m_overflow.end());
+		m_overflow.clear();
+	}
+	moveEvents(events);
+	return m_dropped.exchange(0, std::memory_order_relaxed);
+}
+
+/***************************************************************************************************/
+
+/***************************************************************************************************
+ * The Profiler class
+ ***************************************************************************************************/
+
+/* The buffer of the current thread, created the first time it records an event */
+static thread_local ProfilerThreadBuffer* profiler_threadBuffer = NULL;
+
+bool Profiler::m_enabled = true;
+std::vector<ProfilerThreadBuffer*> Profiler::m_threadBuffers;
+std::mutex Profiler::m_threadBuffersMutex;
+std::vector<ProfilerFrame> Profiler::m_history;
+unsigned int Profiler::m_historySize = 300;
+unsigned int Profiler::m_historyStart = 0;
+ProfilerFrame Profiler::m_currentFrame;
+bool Profiler::m_gpuSupported = false;
+bool Profiler::m_gpuInitialised = false;
+long long Profiler::m_gpuOffset = 0;
+unsigned int Profiler::m_gpuDepth = 0;
+std::vector<GLuint> Profiler::m_freeQueries;
+std::vector<Profiler::PendingGPUScope> Profiler::m_pendingGPUScopes;
+std::vector<Profiler::PendingGPUScope> Profiler::m_openGPUScopes;
+
+ProfilerThreadBuffer* Profiler::getThreadBuffer() {
+	if (profiler_threadBuffer == NULL) {
+		std::lock_guard<std::mutex> lock(m_threadBuffersMutex);
+		//Thread 0 is used for the GPU
+		//Frames with more events than the ring holds spill into the overflow, and only events
+		//beyond around a million in a frame are dropped
+		profiler_threadBuffer = new ProfilerThreadBuffer(m_threadBuffers.size() + 1, 8192, 1 << 20);
+		m_threadBuffers.push_back(profiler_threadBuffer);
+	}
+	return profiler_threadBuffer;
+}
+
+unsigned int Profiler::beginScope() {
+	return getThreadBuffer()->depth++;
+}
+
+void Profiler::endScope(const char* name, long long start, unsigned int depth) {
+	ProfilerThreadBuffer* buffer = getThreadBuffer();
+	buffer->depth = depth;
+
+	ProfilerEvent event;
+	event.name = name;
+	event.start = start;
+	event.end = Time::getTimeNanoseconds();
+	event.depth = depth;
+	event.thread = buffer->thread;
+	buffer->add(event);
+}
+
+void Profiler::initialiseGPU() {
+	m_gpuSupported = GLEW_ARB_timer_query;
+	m_gpuInitialised = true;
+	if (! m_gpuSupported)
+		logWarning("Timer queries are not supported, GPU scopes will not be profiled");
+}
+
+GLuint Profiler::getQuery() {
+	if (m_freeQueries.empty()) {
+		GLuint queries[16];
+		glGenQueries(16, queries);
+		m_freeQueries.insert(m_freeQueries.end(), queries, queries + 16);
+	}
+	GLuint query = m_freeQueries.back();
+	m_freeQueries.pop_back();
+	return query;
+}
+
+bool Profiler::beginGPUScope(const char* name) {
+	if (! m_enabled)
+		return false;
+	if (! m_gpuInitialised)
+		initialiseGPU();
+	if (! m_gpuSupported)
+		return false;
+
+	//Timestamps are used rather than GL_TIME_ELAPSED as those queries can't be nested
+	PendingGPUScope scope;
+	scope.name = name;
+	scope.depth = m_gpuDepth++;
+	scope.frame = m_currentFrame.number;
+	scope.startQuery = getQuery();
+	scope.endQuery = getQuery();
+	glQueryCounter(scope.startQuery, GL_TIMESTAMP);
+	m_openGPUScopes.push_back(scope);
+	return true;
+}
+
+void Profiler::endGPUScope() {
+	if (m_openGPUScopes.empty())
+		return;
+	PendingGPUScope scope = m_openGPUScopes.back();
+	m_openGPUScopes.pop_back();
+	glQueryCounter(scope.endQuery, GL_TIMESTAMP);
+	m_gpuDepth--;
+	m_pendingGPUScopes.push_back(scope);
+}
+
+void Profiler::collectGPUScopes() {
+	unsigned int remaining = 0;
+	for (unsigned int a = 0; a < m_pendingGPUScopes.size(); a++) {
+		PendingGPUScope& scope = m_pendingGPUScopes[a];
+		//The end query finishes last, so once it is available both are
+		GLint available = 0;
+		glGetQueryObjectiv(scope.endQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+		if (available) {
+			GLuint64 start = 0;
+			GLuint64 end = 0;
+			glGetQueryObjectui64v(scope.startQuery, GL_QUERY_RESULT, &start);
+			glGetQueryObjectui64v(scope.endQuery, GL_QUERY_RESULT, &end);
+			m_freeQueries.push_back(scope.startQuery);
+			m_freeQueries.push_back(scope.endQuery);
+
+			//The frame may have already left the history
+			ProfilerFrame* frame = getFrame(scope.frame);
+			if (frame != NULL) {
+				ProfilerEvent event;
+				event.name = scope.name;
+				event.start = (long long) start + m_gpuOffset;
+				event.end = (long long) end + m_gpuOffset;
+				event.depth = scope.depth;
+				event.thread = 0;
+				frame->events.push_back(event);
+			}
+		} else
+			m_pendingGPUScopes[remaining++] = scope;
+	}
+	m_pendingGPUScopes.resize(remaining);
+}
+
+ProfilerFrame* Profiler::getFrame(unsigned long long number) {
+	if (m_currentFrame.number == number)
+		return &m_currentFrame;
+	for (unsigned int a = 0; a < m_history.size(); a++) {
+		if (m_history[a].number == number)
+			return &m_history[a];
+	}
+	return NULL;
+}
+
+void Profiler::nextFrame() {
+	long long now = Time::getTimeNanoseconds();
+
+	if (m_enabled && m_currentFrame.start != 0) {
+		//Collect the events from every thread
+		unsigned int dropped = 0;
+		{
+			std::lock_guard<std::mutex> lock(m_threadBuffersMutex);
+			for (unsigned int a = 0; a < m_threadBuffers.size(); a++)
+				dropped += m_threadBuffers[a]->collect(m_currentFrame.events);
+		}
+		if (dropped > 0)
+			logWarning("The profiler dropped " + to_string(dropped) + " events in frame " + to_string(m_currentFrame.number));
+
+		//Add the frame to the history, replacing the oldest one when it is full
+		ProfilerFrame* frame;
+		if (m_history.size() < m_historySize) {
+			m_history.push_back(ProfilerFrame());
+			frame = &m_history.back();
+		} else {
+			frame = &m_history[m_historyStart];
+			m_historyStart = (m_historyStart + 1) % m_history.size();
+		}
+		frame->number = m_currentFrame.number;
+		frame->start = m_currentFrame.start;
+		frame->end = now;
+		frame->dropped = dropped;
+		//Swapped so the memory of the replaced frame is reused for the next one
+		frame->events.swap(m_currentFrame.events);
+	}
+
+	if (m_gpuInitialised && m_gpuSupported) {
+		collectGPUScopes();
+		//Keep track of the difference between the clocks so GPU times line up with the CPU
+		GLint64 gpuTime = 0;
+		glGetInteger64v(GL_TIMESTAMP, &gpuTime);
+		m_gpuOffset = Time::getTimeNanoseconds() - gpuTime;
+	}
+
+	m_currentFrame.number++;
+	m_currentFrame.start = now;
+	m_currentFrame.end = 0;
+	m_currentFrame.events.clear();
+}
+
+bool Profiler::exportChromeTrace(std::string path) {
+	std::ofstream output(path.c_str(), std::ios::out | std::ios::trunc);
+	if (! output.is_open()) {
+		logError("Unable to write the trace '" + path + "'");
+		return false;
+	}
+	if (m_history.empty()) {
+		output << "{\"traceEvents\":[]}";
+		return true;
+	}
+
+	//Times are written in microseconds from the start of the oldest frame
+	long long origin = getFrameAt(0).start;
+	output.setf(std::ios::fixed);
+	output.precision(3);
+	output << "{\"traceEvents\":[\n";
+	output << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":0,\"args\":{\"name\":\"GPU\"}}";
+	for (unsigned int a = 0; a < m_threadBuffers.size(); a++)
+		output << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << m_threadBuffers[a]->thread << ",\"args\":{\"name\":\"Thread " << m_threadBuffers[a]->thread << "\"}}";
+	for (unsigned int a = 0; a < m_history.size(); a++) {
+		ProfilerFrame& frame = getFrameAt(a);
+		for (unsigned int b = 0; b < frame.events.size(); b++) {
+			ProfilerEvent& event = frame.events[b];
+			output << ",\n{\"name\":\"" << event.name << "\",\"cat\":\"" << (event.thread == 0 ? "gpu" : "cpu") << "\",\"ph\":\"X\"";
+			output << ",\"ts\":" << ((event.start - origin) / 1000.0) << ",\"dur\":" << ((event.end - event.start) / 1000.0);
+			output << ",\"pid\":0,\"tid\":" << event.thread << ",\"args\":{\"frame\":" << frame.number << "}}";
+		}
+	}
+	output << "\n]}\n";
+	output.close();
+	return true;
+}
+
+void Profiler::clear() {
+	m_history.clear();
+	m_historyStart = 0;
+}
+
+void Profiler::setHistorySize(unsigned int historySize) {
+	clear();
+	m_historySize = historySize > 0 ? historySize : 1;
+}
+
+long long Profiler::getLastFrameTime(std::string name) {
+	long long total = 0;
+	if (! m_history.empty()) {
+		ProfilerFrame& frame = getFrameAt(m_history.size() - 1);
+		for (unsigned int a = 0; a < frame.events.size(); a++) {
+			if (strcmp(frame.events[a].name, name.c_str()) == 0)
+				total += frame.events[a].end - frame.events[a].start;
+		}
+	}
+	return total;
+}
+
+/***************************************************************************************************/
+
+/***************************************************************************************************
+ * The ProfilerScope class
+ ***************************************************************************************************/
+
+ProfilerScope::ProfilerScope(const char* name) {
+	if (Profiler::isEnabled()) {
+		m_name = name;
+		m_depth = Profiler::beginScope();
+		m_start = Time::getTimeNanoseconds();
+	} else
+		m_name = NULL;
+}
+
+ProfilerScope::~ProfilerScope() {
+	if (m_name != NULL)
+		Profiler::endScope(m_name, m_start, m_depth);
+}
+
+/***************************************************************************************************/
+
+/***************************************************************************************************
+ * The ProfilerGPUScope class
+ ***************************************************************************************************/
+
+ProfilerGPUScope::ProfilerGPUScope(const char* name) {
+	m_active = Profiler::beginGPUScope(name);
+}
+
+ProfilerGPUScope::~ProfilerGPUScope() {
+	if (m_active)
+		Profiler::endGPUScope();
+}
+
+/***************************************************************************************************/
@@ -0,0 +1,240 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef CORE_PROFILER_H_
+#define CORE_PROFILER_H_
+
+#include <windows.h>
+#include <GL/GLEW/glew.h>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <mutex>
+
+/***************************************************************************************************
+ * The profiling macros, these should be used instead of the classes below so that profiling can
+ * be compiled out entirely by defining PROFILER_DISABLED
+ ***************************************************************************************************/
+
+#define PROFILER_CONCAT_IMPL(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_IMPL(a, b)
+
+#ifndef PROFILER_DISABLED
+/* Times the rest of the current block on the CPU, the name must be a string literal */
+#define PROFILE_SCOPE(name) ProfilerScope PROFILER_CONCAT(profilerScope, __LINE__)(name)
+/* Times the GPU work submitted in the rest of the current block, on the thread with the context */
+#define PROFILE_GPU_SCOPE(name) ProfilerGPUScope PROFILER_CONCAT(profilerGPUScope, __LINE__)(name)
+/* Ends the current frame and starts the next one */
+#define PROFILE_FRAME() Profiler::nextFrame()
+#else
+#define PROFILE_SCOPE(name) ((void) 0)
+#define PROFILE_GPU_SCOPE(name) ((void) 0)
+#define PROFILE_FRAME() ((void) 0)
+#endif
+
+/***************************************************************************************************/
+
+/***************************************************************************************************
+ * The ProfilerEvent structure stores a single timed scope, times are in nanoseconds from
+ * Time::getTimeNanoseconds()
+ ***************************************************************************************************/
+
+struct ProfilerEvent {
+	const char* name;
+	long long start;
+	long long end;
+	/* How many scopes this one is nested within */
+	unsigned int depth;
+	/* The thread the scope was on, 0 is used for the GPU */
+	unsigned int thread;
+};
+
+/***************************************************************************************************/
+
+/***************************************************************************************************
+ * The ProfilerFrame structure stores every event recorded during a frame
+ ***************************************************************************************************/
+
+struct ProfilerFrame {
+	unsigned long long number;
+	long long start;
+	long long end;
+	std::vector<ProfilerEvent> events;
+	/* The number of events that couldn't be stored */
+	unsigned int dropped;
+};
+
+/***************************************************************************************************/
+
+/***************************************************************************************************
+ * The ProfilerThreadBuffer class stores the events recorded by a single thread until they are
+ * collected at the end of the frame. Only the owning thread adds events and only the thread
+ * ending the frame removes them, so no locks are needed until the ring fills up, at which point
+ * its events are moved into an overflow list that grows up to a limit
+ ***************************************************************************************************/
+
+class ProfilerThreadBuffer {
+private:
+	std::vector<ProfilerEvent> m_events;
+	unsigned int m_mask;
+	std::atomic<unsigned int> m_head;
+	std::atomic<unsigned int> m_tail;
+
+	/* The events moved out of the ring since the last collection, these are older than any
+	 * still in the ring. The lock is needed as the ring then has two threads removing events */
+	std::vector<ProfilerEvent> m_overflow;
+	unsigned int m_maxOverflow;
+	std::mutex m_overflowMutex;
+
+	/* The number of events dropped since the last collection */
+	std::atomic<unsigned int> m_dropped;
+
+	/* Moves the events in the ring to the end of the list given, the lock must be held */
+	void moveEvents(std::vector<ProfilerEvent>& events);
+public:
+	/* The id of the thread in the exported traces */
+	unsigned int thread;
+
+	/* The current depth of the scopes on this thread */
+	unsigned int depth;
+
+	ProfilerThreadBuffer(unsigned int thread, unsigned int capacity, unsigned int maxOverflow);
+	virtual ~ProfilerThreadBuffer() {}
+
+	/* Adds an event, it is only dropped if both the ring and the overflow are full */
+	void add(const ProfilerEvent& event);
+
+	/* Moves all of the events added so far into the list given and returns the number that were
+	 * dropped since the last collection */
+	unsigned int collect(std::vector<ProfilerEvent>& events);
+};
+
+/***************************************************************************************************/
+
+/***************************************************************************************************
+ * The Profiler class records timed scopes from any thread along with the time taken by the GPU,
+ * and keeps the events from a number of the most recent frames so they can be inspected or
+ * exported in the Chrome trace format (viewable at chrome://tracing)
+ ***************************************************************************************************/
+
+class Profiler {
+private:
+	/* A GPU scope whose result hasn't been read yet */
+	struct PendingGPUScope {
+		const char* name;
+		unsigned int depth;
+		unsigned long long frame;
+		GLuint startQuery;
+		GLuint endQuery;
+	};
+
+	static bool m_enabled;
+
+	/* The buffers of every thread that has recorded an event, the lock is only used when a new
+	 * thread records its first event */
+	static std::vector<ProfilerThreadBuffer*> m_threadBuffers;
+	static std::mutex m_threadBuffersMutex;
+
+	/* The recent frames, used as a ring with m_historyStart being the oldest */
+	static std::vector<ProfilerFrame> m_history;
+	static unsigned int m_historySize;
+	static unsigned int m_historyStart;
+	static ProfilerFrame m_currentFrame;
+
+	/* The GPU timing, queries are reused once their results have been read */
+	static bool m_gpuSupported;
+	static bool m_gpuInitialised;
+	static long long m_gpuOffset;
+	static unsigned int m_gpuDepth;
+	static std::vector<GLuint> m_freeQueries;
+	static std::vector<PendingGPUScope> m_pendingGPUScopes;
+	static std::vector<PendingGPUScope> m_openGPUScopes;
+
+	static ProfilerThreadBuffer* getThreadBuffer();
+	static GLuint getQuery();
+	static void initialiseGPU();
+	static void collectGPUScopes();
+	static ProfilerFrame* getFrame(unsigned long long number);
+public:
+	/* Used by ProfilerScope to record a scope on the current thread */
+	static unsigned int beginScope();
+	static void endScope(const char* name, long long start, unsigned int depth);
+
+	/* Used by ProfilerGPUScope, these must be called on the thread with the OpenGL context, the
+	 * scope should only be ended when beginning it returned true */
+	static bool beginGPUScope(const char* name);
+	static void endGPUScope();
+
+	/* Collects the events recorded during the current frame and starts the next one */
+	static void nextFrame();
+
+	/* Writes every frame in the history to a file in the Chrome trace format */
+	static bool exportChromeTrace(std::string path);
+
+	/* Removes every frame from the history */
+	static void clear();
+
+	static void setHistorySize(unsigned int historySize);
+
+	static inline void setEnabled(bool enabled) { m_enabled = enabled; }
+	static inline bool isEnabled() { return m_enabled; }
+	static inline unsigned int getHistorySize() { return m_historySize; }
+	static inline unsigned int getNumFrames() { return m_history.size(); }
+
+	/* Returns a frame in the history, where 0 is the oldest */
+	static inline ProfilerFrame& getFrameAt(unsigned int index) { return m_history[(m_historyStart + index) % m_history.size()]; }
+
+	/* Returns the total time (in nanoseconds) of the events with the given name in the most
+	 * recent complete frame */
+	static long long getLastFrameTime(std::string name);
+};
+
+/***************************************************************************************************/
+
+/***************************************************************************************************
+ * The ProfilerScope class times the scope it is created in on the CPU
+ ***************************************************************************************************/
+
+class ProfilerScope {
+private:
+	const char* m_name;
+	long long m_start;
+	unsigned int m_depth;
+public:
+	ProfilerScope(const char* name);
+	~ProfilerScope();
+};
+
+/***************************************************************************************************/
+
+/***************************************************************************************************
+ * The ProfilerGPUScope class times the GPU work submitted within the scope it is created in, and
+ * does nothing when timer queries aren't supported
+ ***************************************************************************************************/
+
+class ProfilerGPUScope {
+private:
+	bool m_active;
+public:
+	ProfilerGPUScope(const char* name);
+	~ProfilerGPUScope();
+};
+
+/***************************************************************************************************/
+
+#endif /* CORE_PROFILER_H_ */
@@ -17,6 +17,7 @@
  *****************************************************************************/
 
 #include "render/Renderer.h"
+#include "render/ShaderManager.h"
 #include "ResourceLoader.h"
 
 /***************************************************************************************************
@@ -24,19 +25,20 @@
  ***************************************************************************************************/
 
 Shader* ResourceLoader::loadShader(const char* path, const char* vertexShaderName, const char* fragmentShaderName) {
-	return new Shader(loadShader(path, vertexShaderName, GL_VERTEX_SHADER),
-					  loadShader(path, fragmentShaderName, GL_FRAGMENT_SHADER));
+	Shader* shader = ShaderManager::loadShader(path, vertexShaderName, fragmentShaderName);
+	ShaderManager::finish();
+	return shader;
 }
 
 Shader* ResourceLoader::loadShader(const char* path, const char* name) {
-	std::string p = std::string(name);
-	return new Shader(loadShader(path, (p + ".vs").c_str(), GL_VERTEX_SHADER),
-					  loadShader(path, (p + ".fs").c_str(), GL_FRAGMENT_SHADER));
+	Shader* shader = ShaderManager::loadShader(path, name);
+	ShaderManager::finish();
+	return shader;
 }
 
 RenderShader* ResourceLoader::loadRenderShader(const char* path, const char* name, const char* type) {
 	Shader* shader = loadShader(path, name);
-	Renderer::setupShader(shader, type);
+	Renderer::setupShader(shader, Renderer::getShaderHandle(type));
 	return new RenderShader(shader);
 }
 
@@ -64,9 +64,20 @@ private:
 	int         m_video_max_anisotropic_samples;
 	Vector2i    m_video_resolution;
 
+	/* The most memory in megabytes that streamed textures can use, when it is 0 textures are
+	 * loaded in full instead of being streamed */
+	int         m_video_texture_budget;
+
 	/* The values that correspond to specific 'input' settings */
 	bool        m_input_mouse_events_repeat;
 	bool        m_input_keyboard_events_repeat;
+
+	/* The values that correspond to the game loop, when the update rate is 0 update() is called
+	 * once a frame, otherwise it is called at that rate with a fixed time step. The max FPS
+	 * limits how often frames are rendered, 0 leaves it unlimited */
+	int         m_engine_update_rate;
+	int         m_engine_max_update_steps;
+	int         m_engine_max_fps;
 public:
 	static const char* ENGINE_NAME;
 	static const char* ENGINE_VERSION;
@@ -93,9 +104,14 @@ public:
 		m_video_refresh_rate = 60;
 		m_video_max_anisotropic_samples = 0;
 		m_video_resolution   = VIDEO_RESOLUTION_DEFAULT;
+		m_video_texture_budget = 0;
 
 		m_input_mouse_events_repeat = false;
 		m_input_keyboard_events_repeat = true;
+
+		m_engine_update_rate      = 0;
+		m_engine_max_update_steps = 5;
+		m_engine_max_fps          = 0;
 	}
 
 	/* Define all of the methods used to assign and get values stored
@@ -116,10 +132,15 @@ public:
 	inline void setVideoRefreshRate(int refreshRate) { m_video_refresh_rate = refreshRate; }
 	inline void setVideoMaxAnisotropicSamples(int maxAnisotropicSamples) { m_video_max_anisotropic_samples = maxAnisotropicSamples; }
 	inline void setVideoResolution(Vector2i videoResolution)             { m_video_resolution              = videoResolution;       }
+	inline void setVideoTextureBudget(int textureBudget)                 { m_video_texture_budget          = textureBudget;         }
 
 	inline void setMouseEventsRepeat(bool mouseEventsRepeat)             { m_input_mouse_events_repeat = mouseEventsRepeat; }
 	inline void setKeyboardEventsRepeat(bool keyboardEventsRepeat)             { m_input_keyboard_events_repeat = keyboardEventsRepeat; }
 
+	inline void setEngineUpdateRate(int updateRate)            { m_engine_update_rate      = updateRate;     }
+	inline void setEngineMaxUpdateSteps(int maxUpdateSteps)    { m_engine_max_update_steps = maxUpdateSteps; }
+	inline void setEngineMaxFPS(int maxFPS)                    { m_engine_max_fps          = maxFPS;         }
+
 	inline const char* getWindowTitle()                    { return m_window_title;            }
 	inline int         getWindowWidth()                    { return m_window_width;            }
 	inline int         getWindowHeight()                   { return m_window_height;           }
@@ -134,9 +155,14 @@ public:
 	inline int         getVideoRefreshRate()               { return m_video_refresh_rate;      }
 	inline int         getVideoMaxAnisotropicSamples()     { return m_video_max_anisotropic_samples; }
 	inline Vector2i    getVideoResolution()                { return m_video_resolution;        }
+	inline int         getVideoTextureBudget()             { return m_video_texture_budget;    }
 
 	inline bool        getMouseEventsRepeat()              { return m_input_mouse_events_repeat; }
 	inline bool        getKeyboardEventsRepeat()              { return m_input_keyboard_events_repeat; }
+
+	inline int         getEngineUpdateRate()               { return m_engine_update_rate;      }
+	inline int         getEngineMaxUpdateSteps()           { return m_engine_max_update_steps; }
+	inline int         getEngineMaxFPS()                   { return m_engine_max_fps;          }
 };
 
 /***************************************************************************************************/
@@ -18,6 +18,7 @@
 
 #include "SkyBox.h"
 #include "render/Renderer.h"
+#include "ImageLoader.h"
 
 /***************************************************************************************************
  * The SkyBox class
@@ -26,13 +27,40 @@
 SkyBox::SkyBox(std::string path, std::string front, std::string back, std::string left, std::string right, std::string top, std::string bottom, float size) {
 	m_box = RenderableObject3D(MeshBuilder::createCube(size, size, size, "SkyBox"));
 	Texture* texture = new Texture(TextureParameters().setTarget(GL_TEXTURE_CUBE_MAP));
+
+	//Decode all of the faces at once, then upload each of them to the cube map
+	std::vector<std::string> paths;
+	paths.push_back(path + back);
+	paths.push_back(path + front);
+	paths.push_back(path + left);
+	paths.push_back(path + right);
+	paths.push_back(path + bottom);
+	paths.push_back(path + top);
+	const GLenum faces[] = {
+		GL_TEXTURE_CUBE_MAP_NEGATIVE_Z,
+		GL_TEXTURE_CUBE_MAP_POSITIVE_Z,
+		GL_TEXTURE_CUBE_MAP_NEGATIVE_X,
+		GL_TEXTURE_CUBE_MAP_POSITIVE_X,
+		GL_TEXTURE_CUBE_MAP_NEGATIVE_Y,
+		GL_TEXTURE_CUBE_MAP_POSITIVE_Y
+	};
+	std::vector<Image*> images;
+	ImageLoader::decode(paths, IMAGE_EXPAND_RGBA, images);
+
 	texture->bind();
-	Texture::loadTexture((path + back).c_str(), TextureParameters().setTarget(GL_TEXTURE_CUBE_MAP_NEGATIVE_Z), false);
-	Texture::loadTexture((path + front).c_str(), TextureParameters().setTarget(GL_TEXTURE_CUBE_MAP_POSITIVE_Z), false);
-	Texture::loadTexture((path + left).c_str(), TextureParameters().setTarget(GL_TEXTURE_CUBE_MAP_NEGATIVE_X), false);
-	Texture::loadTexture((path + right).c_str(), TextureParameters().setTarget(GL_TEXTURE_CUBE_MAP_POSITIVE_X), false);
-	Texture::loadTexture((path + bottom).c_str(), TextureParameters().setTarget(GL_TEXTURE_CUBE_MAP_NEGATIVE_Y), false);
-	Texture::loadTexture((path + top).c_str(), TextureParameters().setTarget(GL_TEXTURE_CUBE_MAP_POSITIVE_Y), false);
+	texture->setSize(images[0]->width, images[0]->height);
+	//The storage is shared by every face, so it is only allocated once
+	bool immutable = GLEW_ARB_texture_storage && images[0]->isLoaded();
+	if (immutable)
+		ImageLoader::allocate(images[0], GL_TEXTURE_CUBE_MAP, 1);
+	for (unsigned int a = 0; a < images.size(); a++) {
+		if (immutable)
+			ImageLoader::uploadSubImage(images[a], faces[a]);
+		else
+			ImageLoader::upload(images[a], faces[a]);
+		delete images[a];
+	}
+	texture->generateMipmaps();
 	texture->applyParameters(false, true);
 	m_box.getMesh()->setTexture(texture);
 }
@@ -43,10 +71,10 @@ void SkyBox::update(Vector3f cameraPosition) {
 
 void SkyBox::render() {
 	m_box.update();
-	glDepthMask(false);
-	glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
-	Renderer::render(m_box.getMesh(), m_box.getModelMatrix(), "SkyBox");
-	glDepthMask(true);
+	GLState::depthMask(false);
+	GLState::enable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
+	Renderer::render(m_box.getMesh(), m_box.getModelMatrix(), SHADER_TYPE_SKYBOX);
+	GLState::depthMask(true);
 }
 
 /***************************************************************************************************/
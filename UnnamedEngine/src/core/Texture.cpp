@@ -17,9 +17,10 @@
  *****************************************************************************/
 
 #include "Texture.h"
-#include "Game.h"
+#include "ImageLoader.h"
+#include "render/TextureResidency.h"
 #define STB_IMAGE_IMPLEMENTATION
-#include <GL\stb_image.h>
+#include <GL/stb_image.h>
 
 /***************************************************************************************************
  * The TextureParameters class
@@ -32,24 +33,34 @@ bool TextureParameters::DEFAULT_SHOULD_CLAMP = false;
 
 void TextureParameters::apply(GLuint texture, bool bind, bool unbind) {
 	if (bind)
-		glBindTexture(m_target, texture);
-	glTexParameteri(m_target, GL_TEXTURE_MAG_FILTER, m_filter);
-	glTexParameteri(m_target, GL_TEXTURE_MIN_FILTER, m_filter);
-	if (m_shouldClamp) {
-		glTexParameteri(m_target, GL_TEXTURE_WRAP_S, m_clamp);
-		glTexParameteri(m_target, GL_TEXTURE_WRAP_T, m_clamp);
-		if (m_target == GL_TEXTURE_CUBE_MAP)
-			glTexParameteri(m_target, GL_TEXTURE_WRAP_R, m_clamp);
-	}
-	if (m_filter == GL_NEAREST_MIPMAP_NEAREST ||
-		m_filter == GL_NEAREST_MIPMAP_LINEAR ||
-		m_filter == GL_LINEAR_MIPMAP_NEAREST ||
-		m_filter == GL_LINEAR_MIPMAP_LINEAR) {
-		glGenerateMipmap(m_target);
-		glTexParameterf(m_target, GL_TEXTURE_MAX_ANISOTROPY_EXT, Game::current->getSettings()->getVideoMaxAnisotropicSamples());
-	}
+		GLState::bindTexture(m_target, texture);
+	//The filtering and wrapping are held by a sampler when they are supported
+	if (! SamplerCache::isSupported())
+		SamplerCache::applyToTexture(getSamplerDescriptor(), m_target);
 	if (unbind)
-		glBindTexture(m_target, 0);
+		GLState::bindTexture(m_target, 0);
+}
+
+void TextureParameters::generateMipmaps() {
+	if (usesMipmaps())
+		glGenerateMipmap(m_target);
+}
+
+SamplerDescriptor TextureParameters::getSamplerDescriptor() {
+	//Mipmaps are only used when minifying, so the magnifying filter can't use them
+	GLenum magFilter = m_filter;
+	if (m_filter == GL_NEAREST_MIPMAP_NEAREST || m_filter == GL_NEAREST_MIPMAP_LINEAR)
+		magFilter = GL_NEAREST;
+	else if (m_filter == GL_LINEAR_MIPMAP_NEAREST || m_filter == GL_LINEAR_MIPMAP_LINEAR)
+		magFilter = GL_LINEAR;
+	GLenum wrap = m_shouldClamp ? m_clamp : GL_REPEAT;
+	float maxAnisotropy = usesMipmaps() ? SamplerCache::getMaxAnisotropy() : 0.0f;
+	return SamplerDescriptor(m_filter, magFilter, wrap, maxAnisotropy);
+}
+
+bool TextureParameters::usesMipmaps() {
+	return m_filter == GL_NEAREST_MIPMAP_NEAREST || m_filter == GL_NEAREST_MIPMAP_LINEAR ||
+		   m_filter == GL_LINEAR_MIPMAP_NEAREST || m_filter == GL_LINEAR_MIPMAP_LINEAR;
 }
 
 /***************************************************************************************************/
@@ -58,37 +69,38 @@ void TextureParameters::apply(GLuint texture, bool bind, bool unbind) {
  * The Texture class
  ***************************************************************************************************/
 
-Texture* Texture::loadTexture(const char* path, TextureParameters parameters, bool applyParameters) {
-	int w, h, numC;
-	unsigned char* image = stbi_load(path, &w, &h, &numC, 0);
-	if (image == nullptr) {
-		logError("Failed to load the image from the path '" + to_string(path) + "'");
+Texture* Texture::loadTexture(const char* path, TextureParameters parameters, bool applyParameters, int imageFlags) {
+	Image* image = ImageLoader::decode(path, imageFlags);
+	if (! image->isLoaded()) {
+		delete image;
 		return NULL;
 	}
-	GLuint colourMode = 0;
-	if (numC == 1)
-		colourMode = GL_RED;
-	else if (numC == 2)
-		colourMode = GL_RG;
-	else if (numC == 3)
-		colourMode = GL_RGB;
-	else if (numC == 4)
-		colourMode = GL_RGBA;
 
 	Texture* texture = new Texture(parameters);
-	texture->setWidth(w);
-	texture->setHeight(h);
-	texture->setNumComponents(numC);
+	texture->setWidth(image->width);
+	texture->setHeight(image->height);
+	texture->setNumComponents(image->numComponents);
 
 	texture->bind();
 
-	glTexImage2D(parameters.getTarget(), 0, colourMode, w, h, 0, colourMode, GL_UNSIGNED_BYTE, image);
+	//Immutable storage lets the driver allocate every mip level once, up front
+	if (GLEW_ARB_texture_storage) {
+		int numMips = parameters.usesMipmaps() ? TextureResidency::getNumMips(image->width, image->height) : 1;
+		ImageLoader::allocate(image, parameters.getTarget(), numMips);
+		ImageLoader::uploadSubImage(image, parameters.getTarget());
+	} else
+		ImageLoader::upload(image, parameters.getTarget());
+	texture->generateMipmaps();
 
 	if (applyParameters)
 		texture->applyParameters(false, true);
 
-	stbi_image_free(image);
+	delete image;
 	return texture;
 }
 
+Texture* Texture::loadTexture(const char* path, TextureParameters parameters, bool applyParameters) {
+	return loadTexture(path, parameters, applyParameters, IMAGE_EXPAND_RGBA);
+}
+
 /***************************************************************************************************/
@@ -22,6 +22,8 @@
 #include <windows.h>
 #include <GL/GLEW/glew.h>
 #include "../utils/Logging.h"
+#include "render/GLState.h"
+#include "render/SamplerCache.h"
 
 /***************************************************************************************************
  * The TextureParameters class
@@ -78,10 +80,19 @@ public:
 	inline void apply(GLuint texture, bool unbind) { apply(texture, true, unbind); }
 	inline void apply(GLuint texture) { apply(texture, true, false); }
 
+	/* Generates the mipmaps of the texture bound to the target when the filter uses them, this
+	 * should be called after the first level has been uploaded rather than each time the
+	 * parameters are applied */
+	void generateMipmaps();
+
 	inline TextureParameters setTarget(GLuint target) { m_target = target; return (*this); }
 	inline TextureParameters setFilter(GLuint filter) { m_filter = filter; return (*this); }
 	inline TextureParameters setClamp(GLuint clamp) { m_clamp = clamp; return (*this); }
 	inline TextureParameters setShouldClamp(bool shouldClamp) { m_shouldClamp = shouldClamp; return (*this); }
+
+	/* Returns the descriptor of the sampler these parameters need */
+	SamplerDescriptor getSamplerDescriptor();
+	bool usesMipmaps();
 	inline GLuint getTarget() { return m_target; }
 	inline GLuint getFilter() { return m_filter; }
 	inline GLuint getClamp() { return m_clamp; }
@@ -101,6 +112,10 @@ protected:
 	int m_height;
 	int m_numComponents;
 	TextureParameters m_parameters;
+
+	/* The sampler from the SamplerCache for the parameters, found when it is first needed */
+	GLuint m_sampler = 0;
+	bool m_samplerFound = false;
 public:
 	float top;
 	float bottom;
@@ -186,14 +201,18 @@ public:
 			m_parameters.apply(m_texture, bind, unbind);
 	}
 
-	inline void bind() { glBindTexture(m_parameters.getTarget(), m_texture); }
-	inline void unbind() { glBindTexture(m_parameters.getTarget(), 0); }
+	/* Generates the mipmaps of this texture after its first level has been uploaded, when its
+	 * parameters use them. The texture should be bound */
+	inline void generateMipmaps() { m_parameters.generateMipmaps(); }
+
+	inline void bind() { GLState::bindTexture(m_parameters.getTarget(), m_texture); }
+	inline void unbind() { GLState::bindTexture(m_parameters.getTarget(), 0); }
 
 	inline void release() {
-		glDeleteTextures(1, &m_texture);
+		GLState::deleteTexture(m_texture);
 	}
 
-	inline void setParameters(TextureParameters parameters) { m_parameters = parameters; }
+	inline void setParameters(TextureParameters parameters) { m_parameters = parameters; m_samplerFound = false; }
 	inline void setWidth(int width) { m_width = width; }
 	inline void setHeight(int height) { m_height = height; }
 	inline void setSize(int width, int height) { m_width = width; m_height = height; }
@@ -204,7 +223,16 @@ public:
 	inline int getHeight() { return m_height; }
 	inline int getNumComponents() { return m_numComponents; }
 	inline bool hasTexture() { return m_texture != 0; }
+	inline GLuint getSampler() {
+		if (! m_samplerFound) {
+			m_sampler = SamplerCache::getSampler(m_parameters.getSamplerDescriptor());
+			m_samplerFound = true;
+		}
+		return m_sampler;
+	}
 
+	/* Loads a texture, the image flags are the conversions applied to it by the ImageLoader */
+	static Texture* loadTexture(const char* path, TextureParameters parameters, bool applyParameters, int imageFlags);
 	static Texture* loadTexture(const char* path, TextureParameters parameters, bool applyParameters);
 	inline static Texture* loadTexture(const char* path) { return loadTexture(path, TextureParameters(), true); }
 };
@@ -227,7 +255,7 @@ public:
 	/* The constructor */
 	RenderTexture(int width, int height, int internalFormat, int format, int attachment, int type, TextureParameters parameters) : Texture(width, height, parameters),
 				m_internalFormat(internalFormat), m_format(format), m_attachment(attachment), m_type(type) {
-		glBindTexture(m_parameters.getTarget(), m_texture);
+		GLState::bindTexture(m_parameters.getTarget(), m_texture);
 		glTexImage2D(m_parameters.getTarget(), 0, m_internalFormat, m_width, m_height, 0, m_format, m_type, 0);
 
 		m_parameters.apply(m_texture, false, false);
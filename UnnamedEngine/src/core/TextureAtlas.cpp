@@ -0,0 +1,264 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <algorithm>
+
+#include "TextureAtlas.h"
+#include "../utils/StringUtils.h"
+#include <GL/stb_image.h>
+
+/***************************************************************************************************
+ * The AtlasPacker class
+ ***************************************************************************************************/
+
+AtlasPacker::AtlasPacker(int width, int height) {
+	m_width = width;
+	m_height = height;
+	clear();
+}
+
+void AtlasPacker::clear() {
+	m_skyline.clear();
+	SkylineNode node;
+	node.x = 0;
+	node.y = 0;
+	node.width = m_width;
+	m_skyline.push_back(node);
+	m_usedArea = 0;
+}
+
+int AtlasPacker::fit(unsigned int index, int width, int height) {
+	int x = m_skyline[index].x;
+	if (x + width > m_width)
+		return -1;
+	//The rectangle has to sit on top of the highest node it covers
+	int y = 0;
+	int remaining = width;
+	while (remaining > 0) {
+		if (index >= m_skyline.size())
+			return -1;
+		y = std::max(y, m_skyline[index].y);
+		if (y + height > m_height)
+			return -1;
+		remaining -= m_skyline[index].width;
+		index++;
+	}
+	return y;
+}
+
+bool AtlasPacker::pack(int width, int height, int &x, int &y) {
+	int bestIndex = -1;
+	int bestTop = m_height + 1;
+	int bestWidth = m_width + 1;
+	for (unsigned int a = 0; a < m_skyline.size(); a++) {
+		int top = fit(a, width, height);
+		if (top >= 0) {
+			//Prefer the lowest position, then the narrowest node to leave less wasted space
+			top += height;
+			if (top < bestTop || (top == bestTop && m_skyline[a].width < bestWidth)) {
+				bestIndex = a;
+				bestTop = top;
+				bestWidth = m_skyline[a].width;
+			}
+		}
+	}
+	if (bestIndex == -1)
+		return false;
+
+	x = m_skyline[bestIndex].x;
+	y = bestTop - height;
+
+	SkylineNode node;
+	node.x = x;
+	node.y = bestTop;
+	node.width = width;
+	m_skyline.insert(m_skyline.begin() + bestIndex, node);
+
+	//Shrink or remove the nodes now covered by the new one
+	for (unsigned int a = bestIndex + 1; a < m_skyline.size(); a++) {
+		int covered = (m_skyline[a - 1].x + m_skyline[a - 1].width) - m_skyline[a].x;
+		if (covered <= 0)
+			break;
+		m_skyline[a].x += covered;
+		m_skyline[a].width -= covered;
+		if (m_skyline[a].width > 0)
+			break;
+		m_skyline.erase(m_skyline.begin() + a);
+		a--;
+	}
+	merge();
+
+	m_usedArea += width * height;
+	return true;
+}
+
+void AtlasPacker::merge() {
+	for (unsigned int a = 1; a < m_skyline.size(); a++) {
+		if (m_skyline[a - 1].y == m_skyline[a].y) {
+			m_skyline[a - 1].width += m_skyline[a].width;
+			m_skyline.erase(m_skyline.begin() + a);
+			a--;
+		}
+	}
+}
+
+/***************************************************************************************************/
+
+/***************************************************************************************************
+ * The TextureAtlas class
+ ***************************************************************************************************/
+
+TextureAtlas::TextureAtlas(int width, int height, TextureParameters parameters, int padding) : m_packer(width, height) {
+	m_parameters = parameters;
+	m_width = width;
+	m_height = height;
+	m_padding = padding;
+
+	glGenTextures(1, &m_texture);
+	clearTexture();
+}
+
+TextureAtlas::~TextureAtlas() {
+	for (unsigned int a = 0; a < m_entries.size(); a++) {
+		delete m_entries[a]->texture;
+		delete m_entries[a];
+	}
+	GLState::deleteTexture(m_texture);
+}
+
+void TextureAtlas::clearTexture() {
+	std::vector<unsigned char> blank(m_width * m_height * 4, 0);
+	GLState::bindTexture(m_parameters.getTarget(), m_texture);
+	glTexImage2D(m_parameters.getTarget(), 0, GL_RGBA, m_width, m_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, &blank.front());
+	m_parameters.generateMipmaps();
+	m_parameters.apply(m_texture, false, true);
+}
+
+void TextureAtlas::upload(AtlasEntry* entry) {
+	GLState::bindTexture(m_parameters.getTarget(), m_texture);
+	glTexSubImage2D(m_parameters.getTarget(), 0, entry->x, entry->y, entry->width, entry->height, GL_RGBA, GL_UNSIGNED_BYTE, &entry->pixels.front());
+}
+
+void TextureAtlas::updateCoordinates(AtlasEntry* entry) {
+	entry->texture->left = (float) entry->x / (float) m_width;
+	entry->texture->right = (float) (entry->x + entry->width) / (float) m_width;
+	entry->texture->top = (float) entry->y / (float) m_height;
+	entry->texture->bottom = (float) (entry->y + entry->height) / (float) m_height;
+}
+
+Texture* TextureAtlas::add(unsigned char* data, int width, int height, int numComponents) {
+	int x = 0;
+	int y = 0;
+	if (! m_packer.pack(width + m_padding, height + m_padding, x, y)) {
+		if (! defragment() || ! m_packer.pack(width + m_padding, height + m_padding, x, y)) {
+			logError("There is not enough room in the texture atlas for an image of size " + to_string(width) + "x" + to_string(height));
+			return NULL;
+		}
+	}
+
+	AtlasEntry* entry = new AtlasEntry();
+	entry->x = x;
+	entry->y = y;
+	entry->width = width;
+	entry->height = height;
+
+	//Everything in the atlas is stored as RGBA, missing components are filled in the same way
+	//OpenGL does for textures with fewer components
+	entry->pixels.resize(width * height * 4);
+	for (int a = 0; a < width * height; a++) {
+		for (int b = 0; b < 4; b++) {
+			if (b < numComponents)
+				entry->pixels[a * 4 + b] = data[a * numComponents + b];
+			else
+				entry->pixels[a * 4 + b] = b == 3 ? 255 : 0;
+		}
+	}
+
+	entry->texture = new Texture(m_texture, m_parameters);
+	entry->texture->setSize(width, height);
+	entry->texture->setNumComponents(4);
+	updateCoordinates(entry);
+	upload(entry);
+
+	m_entries.push_back(entry);
+	return entry->texture;
+}
+
+Texture* TextureAtlas::add(const char* path) {
+	int w, h, numC;
+	unsigned char* image = stbi_load(path, &w, &h, &numC, 0);
+	if (image == nullptr) {
+		logError("Failed to load the image from the path '" + to_string(path) + "'");
+		return NULL;
+	}
+	Texture* texture = add(image, w, h, numC);
+	stbi_image_free(image);
+	return texture;
+}
+
+void TextureAtlas::remove(Texture* texture) {
+	for (unsigned int a = 0; a < m_entries.size(); a++) {
+		if (m_entries[a]->texture == texture) {
+			delete m_entries[a]->texture;
+			delete m_entries[a];
+			m_entries.erase(m_entries.begin() + a);
+			return;
+		}
+	}
+}
+
+bool TextureAtlas::compareHeights(AtlasEntry* a, AtlasEntry* b) {
+	return a->height > b->height;
+}
+
+bool TextureAtlas::defragment() {
+	std::vector<AtlasEntry*> sorted = m_entries;
+	//Packing the tallest images first gives a much flatter skyline
+	std::stable_sort(sorted.begin(), sorted.end(), compareHeights);
+
+	AtlasPacker packer(m_width, m_height);
+	std::vector<int> positions;
+	for (unsigned int a = 0; a < sorted.size(); a++) {
+		int x = 0;
+		int y = 0;
+		//Leave everything where it was if the images do not fit when repacked
+		if (! packer.pack(sorted[a]->width + m_padding, sorted[a]->height + m_padding, x, y))
+			return false;
+		positions.push_back(x);
+		positions.push_back(y);
+	}
+
+	m_packer = packer;
+	clearTexture();
+	for (unsigned int a = 0; a < sorted.size(); a++) {
+		sorted[a]->x = positions[a * 2];
+		sorted[a]->y = positions[a * 2 + 1];
+		updateCoordinates(sorted[a]);
+		upload(sorted[a]);
+	}
+	return true;
+}
+
+float TextureAtlas::getOccupancy() {
+	int area = 0;
+	for (unsigned int a = 0; a < m_entries.size(); a++)
+		area += m_entries[a]->width * m_entries[a]->height;
+	return (float) area / (float) (m_width * m_height);
+}
+
+/***************************************************************************************************/
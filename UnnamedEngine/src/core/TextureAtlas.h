@@ -0,0 +1,131 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef CORE_TEXTUREATLAS_H_
+#define CORE_TEXTUREATLAS_H_
+
+#include <vector>
+
+#include "Texture.h"
+
+/***************************************************************************************************
+ * The AtlasPacker class packs rectangles into a fixed area using the skyline bottom-left
+ * heuristic, placing each rectangle where its top edge would be lowest
+ ***************************************************************************************************/
+
+class AtlasPacker {
+private:
+	/* A segment of the skyline, the highest point reached by the rectangles below it */
+	struct SkylineNode {
+		int x;
+		int y;
+		int width;
+	};
+
+	int m_width;
+	int m_height;
+	std::vector<SkylineNode> m_skyline;
+
+	/* The total area of the rectangles that have been packed */
+	int m_usedArea;
+
+	/* Returns the y position a rectangle would be placed at if its left edge was at the start
+	 * of a node, or -1 if it will not fit there */
+	int fit(unsigned int index, int width, int height);
+	void merge();
+public:
+	AtlasPacker(int width, int height);
+
+	void clear();
+
+	/* Finds a place for a rectangle, returning false if there is not enough room left */
+	bool pack(int width, int height, int &x, int &y);
+
+	inline int getWidth() { return m_width; }
+	inline int getHeight() { return m_height; }
+	inline int getUsedArea() { return m_usedArea; }
+	inline float getOccupancy() { return (float) m_usedArea / (float) (m_width * m_height); }
+};
+
+/***************************************************************************************************/
+
+/***************************************************************************************************
+ * The TextureAtlas class packs many images into a single texture, so that GUI components and fonts
+ * using them can share one texture instead of binding their own. The textures it returns share
+ * the atlas's texture with their top, bottom, left and right set to their part of it, so they
+ * should not be released
+ ***************************************************************************************************/
+
+class TextureAtlas {
+private:
+	/* An image that has been added to the atlas, a copy of the pixels is kept so that the atlas
+	 * can be defragmented */
+	struct AtlasEntry {
+		Texture* texture;
+		int x;
+		int y;
+		int width;
+		int height;
+		std::vector<unsigned char> pixels;
+	};
+
+	GLuint m_texture;
+	TextureParameters m_parameters;
+	int m_width;
+	int m_height;
+
+	/* The space left around each image to stop neighbouring images bleeding into it */
+	int m_padding;
+
+	AtlasPacker m_packer;
+	std::vector<AtlasEntry*> m_entries;
+
+	void clearTexture();
+	void upload(AtlasEntry* entry);
+	void updateCoordinates(AtlasEntry* entry);
+
+	static bool compareHeights(AtlasEntry* a, AtlasEntry* b);
+public:
+	TextureAtlas(int width, int height, TextureParameters parameters, int padding);
+	TextureAtlas(int width, int height, TextureParameters parameters) : TextureAtlas(width, height, parameters, 1) {}
+	TextureAtlas(int width, int height) : TextureAtlas(width, height, TextureParameters(), 1) {}
+	virtual ~TextureAtlas();
+
+	/* Adds an image to the atlas, defragmenting it if there is not enough room, returns NULL
+	 * if the image still cannot fit */
+	Texture* add(unsigned char* data, int width, int height, int numComponents);
+	Texture* add(const char* path);
+
+	/* Removes a texture returned by add(), the space it used is reclaimed when the atlas is
+	 * next defragmented */
+	void remove(Texture* texture);
+
+	/* Repacks all of the images from scratch, updating the coordinates of their textures */
+	bool defragment();
+
+	float getOccupancy();
+	inline GLuint getTexture() { return m_texture; }
+	inline int getWidth() { return m_width; }
+	inline int getHeight() { return m_height; }
+	inline unsigned int getNumTextures() { return m_entries.size(); }
+	inline float getPackedOccupancy() { return m_packer.getOccupancy(); }
+};
+
+/***************************************************************************************************/
+
+#endif /* CORE_TEXTUREATLAS_H_ */
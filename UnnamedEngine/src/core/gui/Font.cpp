@@ -17,12 +17,13 @@
  *****************************************************************************/
 
 #include "Font.h"
+#include "../render/SpriteBatch.h"
 
 /***************************************************************************************************
  * The BitmapText class
  ***************************************************************************************************/
 
-void BitmapText::update(std::string text) {
+void BitmapText::update(const std::string& text) {
 	RenderableObject2D::update();
 	if (text != m_currentText) {
 		m_currentText = text;
@@ -34,14 +35,18 @@ void BitmapText::update(std::string text) {
 
 		float x = 0;
 
-		float mapWidth = getMesh()->getTexture()->getWidth();
-		float mapHeight = getMesh()->getTexture()->getHeight();
+		//The texture may only be part of an atlas, so the coordinates are mapped onto its area
+		Texture* texture = getMesh()->getTexture();
+		float mapWidth = texture->getWidth() / (texture->right - texture->left);
+		float mapHeight = texture->getHeight() / (texture->bottom - texture->top);
+		float mapX = texture->left * mapWidth;
+		float mapY = texture->top * mapHeight;
 
 		for (unsigned int a = 0; a < text.length(); a++) {
 			int asciiCode = (int) text.c_str()[a];
 
-			float cellX = (((int) asciiCode % m_gridWidth) * m_cellWidth);
-			float cellY = (float) ((floor((int) asciiCode / m_gridHeight)) * m_cellHeight);
+			float cellX = (((int) asciiCode % m_gridWidth) * m_cellWidth) + mapX;
+			float cellY = (float) ((floor((int) asciiCode / m_gridHeight)) * m_cellHeight) + mapY;
 
 			getMesh()->getData()->addPosition(Vector3f(x, 0.0f, 0.0f));
 			getMesh()->getData()->addPosition(Vector3f(x + (m_cellWidth / m_cellHeight) * m_fontSize, 0.0f, 0.0f));
@@ -80,10 +85,13 @@ void BitmapText::update(std::string text) {
  * The Font class
  ***************************************************************************************************/
 
-void Font::render(std::string text, float x, float y) {
+void Font::render(const std::string& text, float x, float y) {
 	m_bitmapFont->setPosition(Vector2f(x, y));
 	m_bitmapFont->update(text);
-	m_bitmapFont->render();
+	if (SpriteBatch::isBatching())
+		SpriteBatch::getCurrent()->add(m_bitmapFont->getMesh(), m_bitmapFont->getModelMatrix());
+	else
+		m_bitmapFont->render();
 }
 
 void Font::renderAtCentre(std::string text, Object2D* object, Vector2f offset) {
@@ -95,4 +103,11 @@ Font* Font::loadFont(const char* path, float gridSize, float size, Colour colour
 	return new Font(new BitmapText(Texture::loadTexture(path, TextureParameters().setFilter(GL_NEAREST), true), gridSize, size, colour));
 }
 
+Font* Font::loadFont(TextureAtlas* atlas, const char* path, float gridSize, float size, Colour colour) {
+	Texture* texture = atlas->add(path);
+	if (texture == NULL)
+		return loadFont(path, gridSize, size, colour);
+	return new Font(new BitmapText(texture, gridSize, size, colour));
+}
+
 /***************************************************************************************************/
@@ -22,6 +22,7 @@
 #include "../Vector.h"
 #include "../Mesh.h"
 #include "../Object.h"
+#include "../TextureAtlas.h"
 
 /***************************************************************************************************
  * The BitmapText class
@@ -51,7 +52,7 @@ public:
 	}
 
 	void update() { RenderableObject2D::update(); }
-	void update(std::string text);
+	void update(const std::string& text);
 
 	inline float getWidth(std::string text) {
 		return (text.length() * (((m_cellWidth / m_cellHeight) * m_fontSize) / 1.4f));
@@ -75,15 +76,21 @@ private:
 	BitmapText* m_bitmapFont;
 public:
 	Font(BitmapText* bitmapFont) { m_bitmapFont = bitmapFont; }
-	void render(std::string, float x, float y);
+	void render(const std::string& text, float x, float y);
 	void renderAtCentre(std::string text, Object2D* object, Vector2f offset);
 	inline void renderAtCentre(std::string text, Object2D* object) { renderAtCentre(text, object, Vector2f(0, 0)); }
 	inline void setSize(float size) { m_bitmapFont->setFontSize(size); }
 	inline float getWidth(std::string text) { return m_bitmapFont->getWidth(text); }
 	inline float getHeight(std::string text) { return m_bitmapFont->getHeight(text); }
+	inline Texture* getTexture() { return m_bitmapFont->getMesh()->getTexture(); }
 
 	static Font* loadFont(const char* path, float gridSize, float size, Colour colour);
 	static inline Font* loadFont(const char* path, float gridSize, float size) { return loadFont(path, gridSize, size, Colour::WHITE); }
+
+	/* Loads a font into an atlas so it can share a texture with the GUI, falling back to its own
+	 * texture if the atlas is full */
+	static Font* loadFont(TextureAtlas* atlas, const char* path, float gridSize, float size, Colour colour);
+	static inline Font* loadFont(TextureAtlas* atlas, const char* path, float gridSize, float size) { return loadFont(atlas, path, gridSize, size, Colour::WHITE); }
 };
 
 /***************************************************************************************************/
@@ -28,19 +28,19 @@ GUIButton::GUIButton(GUIComponentRenderer* renderer) {
 }
 
 GUIButton::GUIButton(std::string text, std::vector<Colour> colours, float width, float height) :
-		GUIComponent(new RenderableObject2D(MeshBuilder::createQuad(width, height, Colour::WHITE), width, height)) {
+		GUIComponent(new RenderableObject2D(MeshBuilder::createUnitQuad(), width, height)) {
 	this->renderer->colours = colours;
 	this->text = text;
 }
 
 GUIButton::GUIButton(std::string text, std::vector<Texture*> textures, float width, float height) :
-		GUIComponent(new RenderableObject2D(MeshBuilder::createQuad(width, height, textures[0], Colour::WHITE), width, height)) {
+		GUIComponent(new RenderableObject2D(MeshBuilder::createUnitQuad(textures[0]), width, height)) {
 	this->renderer->textures = textures;
 	this->text = text;
 }
 
 GUIButton::GUIButton(std::string text, std::vector<Texture*> textures, std::vector<Colour> colours, float width, float height) :
-		GUIComponent(new RenderableObject2D(MeshBuilder::createQuad(width, height, textures[0], Colour::WHITE), width, height)) {
+		GUIComponent(new RenderableObject2D(MeshBuilder::createUnitQuad(textures[0]), width, height)) {
 	this->renderer->colours = colours;
 	this->renderer->textures = textures;
 	this->text = text;
@@ -18,11 +18,14 @@
 
 #include "../input/Input.h"
 #include "GUIComponent.h"
+#include "../Profiler.h"
 
 /***************************************************************************************************
  * The GUIComponent class
  ***************************************************************************************************/
 
+GUIComponent* GUIComponent::m_focused = NULL;
+
 GUIComponent::GUIComponent(RenderableObject2D* object) {
 	if (object != NULL)
 		setSize(object->getSize());
@@ -34,6 +37,13 @@ GUIComponent::GUIComponent(RenderableObject2D* object, float width, float height
 	setup(object);
 }
 
+GUIComponent::~GUIComponent() {
+	if (m_focused == this)
+		m_focused = NULL;
+	if (m_spatialIndex != NULL)
+		delete m_spatialIndex;
+}
+
 void GUIComponent::setup(GUIComponentRenderer* renderer) {
 	this->renderer = renderer;
 	setDefaults();
@@ -57,33 +67,22 @@ void GUIComponent::setDefaults() {
 	borderEnabled = false;
 	positionPreference = GUIPosition::CENTRE;
 	toolTip = NULL;
+	focusable = false;
+	useLayout = false;
+	layoutOffset = Vector2f(0, 0);
 }
 
 void GUIComponent::update() {
+	//Only the root of the tree needs to check, it will lay out everything below it and find
+	//the components the mouse is over
+	if (m_layoutParent == NULL) {
+		PROFILE_SCOPE("GUI Layout");
+		if (needsLayout())
+			layout();
+		updateMouseTargets();
+	}
+
 	if (visible && active) {
-		if (getBounds().contains((float) Mouse::lastX, (float) Mouse::lastY)) {
-			if (! mouseHoveringInside && ! Mouse::leftButtonDown) {
-				mouseHoveringInside = true;
-				callOnMouseEnterEvent();
-			}
-			if (Mouse::leftButtonDown && mouseHoveringInside) {
-				if (repeatClickedEvents || (! repeatClickedEvents && ! hasBeenClickedEvent)) {
-					clicked = true;
-					hasBeenClickedEvent = true;
-					callOnClickedEvent();
-				}
-			} else {
-				clicked = false;
-				hasBeenClickedEvent = false;
-			}
-		} else {
-			if (mouseHoveringInside) {
-				mouseHoveringInside = false;
-				callOnMouseLeaveEvent();
-			}
-			clicked = false;
-			hasBeenClickedEvent = false;
-		}
 		updateComponent();
 		for (unsigned int a = 0; a < components.size(); a++)
 			components[a]->update();
@@ -92,7 +91,112 @@ void GUIComponent::update() {
 	}
 }
 
+void GUIComponent::updateMouseTargets() {
+	if (m_spatialIndex == NULL) {
+		m_spatialIndex = new GUISpatialIndex();
+		indexBounds(m_spatialIndex, getPosition());
+	}
+
+	//The index is relative to this component so moving it doesn't change anything within it
+	Vector2f origin = getPosition();
+	//These are only needed while finding the targets so are allocated from the frame arena
+	FrameVector<GUIComponent*> candidates;
+	m_spatialIndex->query((float) Mouse::lastX - origin.getX(), (float) Mouse::lastY - origin.getY(), candidates);
+
+	FrameVector<GUIComponent*> targets;
+	for (unsigned int a = 0; a < candidates.size(); a++) {
+		if (candidates[a]->isInteractive())
+			targets.push_back(candidates[a]);
+	}
+
+	//Let the components the mouse has left know first
+	for (unsigned int a = 0; a < m_mouseTargets.size(); a++) {
+		if (std::find(targets.begin(), targets.end(), m_mouseTargets[a]) == targets.end())
+			m_mouseTargets[a]->updateMouse(false);
+	}
+	for (unsigned int a = 0; a < targets.size(); a++)
+		targets[a]->updateMouse(true);
+	m_mouseTargets.assign(targets.begin(), targets.end());
+}
+
+void GUIComponent::updateMouse(bool inside) {
+	if (inside) {
+		if (! mouseHoveringInside && ! Mouse::leftButtonDown) {
+			mouseHoveringInside = true;
+			callOnMouseEnterEvent();
+		}
+		if (Mouse::leftButtonDown && mouseHoveringInside) {
+			if (repeatClickedEvents || (! repeatClickedEvents && ! hasBeenClickedEvent)) {
+				clicked = true;
+				hasBeenClickedEvent = true;
+				if (focusable)
+					focus();
+				callOnClickedEvent();
+			}
+		} else {
+			clicked = false;
+			hasBeenClickedEvent = false;
+		}
+	} else {
+		if (mouseHoveringInside) {
+			mouseHoveringInside = false;
+			callOnMouseLeaveEvent();
+		}
+		clicked = false;
+		hasBeenClickedEvent = false;
+	}
+}
+
+bool GUIComponent::isInteractive() {
+	GUIComponent* current = this;
+	while (current != NULL) {
+		if (! current->visible || ! current->active)
+			return false;
+		current = current->m_layoutParent;
+	}
+	return true;
+}
+
+GUIComponent* GUIComponent::getLayoutRoot() {
+	GUIComponent* current = this;
+	while (current->m_layoutParent != NULL)
+		current = current->m_layoutParent;
+	return current;
+}
+
+void GUIComponent::indexBounds(GUISpatialIndex* index, Vector2f origin) {
+	Vector2f p = getPosition() - origin;
+	index->update(this, Rect(p.getX(), p.getY(), getWidth(), getHeight()));
+	for (unsigned int a = 0; a < components.size(); a++)
+		components[a]->indexBounds(index, origin);
+}
+
+void GUIComponent::removeBounds(GUISpatialIndex* index) {
+	index->remove(this);
+	for (unsigned int a = 0; a < components.size(); a++)
+		components[a]->removeBounds(index);
+}
+
+void GUIComponent::removeFromIndex(GUIComponent* component) {
+	GUIComponent* root = getLayoutRoot();
+	if (root->m_spatialIndex != NULL)
+		component->removeBounds(root->m_spatialIndex);
+	std::vector<GUIComponent*>& targets = root->m_mouseTargets;
+	targets.erase(std::remove(targets.begin(), targets.end(), component), targets.end());
+}
+
 void GUIComponent::render() {
+	//Only the root is timed so the whole GUI is a single event rather than one per component
+	if (m_layoutParent == NULL) {
+		PROFILE_SCOPE("GUI Render");
+		if (needsLayout())
+			layout();
+		renderTree();
+	} else
+		renderTree();
+}
+
+void GUIComponent::renderTree() {
 	if (visible) {
 		if (hasBorder() && borderEnabled)
 			border->render();
@@ -133,45 +237,140 @@ void GUIComponent::callOnClickedEvent() {
 		componentListeners[a]->onClicked(this);
 }
 
+void GUIComponent::callOnKeyPressedEvent(int code) {
+	componentOnKeyPressed(code);
+}
+
+void GUIComponent::callOnKeyReleasedEvent(int code) {
+	componentOnKeyReleased(code);
+}
+
+void GUIComponent::callOnCharEvent(int code, char character) {
+	componentOnChar(code, character);
+}
+
+void GUIComponent::callOnMousePressedEvent(int button) {
+	componentOnMousePressed(button);
+}
+
+void GUIComponent::callOnMouseDraggedEvent(double x, double y, double dx, double dy) {
+	componentOnMouseDragged(x, y, dx, dy);
+}
+
+void GUIComponent::focus() {
+	if (m_focused != this) {
+		GUIInputRouter::initialise();
+		clearFocus();
+		m_focused = this;
+		componentOnFocusGained();
+	}
+}
+
+void GUIComponent::clearFocus() {
+	if (m_focused != NULL) {
+		GUIComponent* last = m_focused;
+		m_focused = NULL;
+		last->componentOnFocusLost();
+	}
+}
+
 void GUIComponent::add(GUIComponent* component) {
 	attach(component);
 	components.push_back(component);
+	component->setLayoutParent(this);
+	component->markLayoutDirty();
 }
 
 void GUIComponent::add(GUIComponent* component, GUIPosition pos, Vector2f offset) {
 	component->positionPreference = pos;
-	float xPos = 0;
-	float yPos = 0;
-	if (pos == GUIPosition::TOP) {
-		std::vector<GUIComponent*> comps = getComponentsWithPositionPreference(pos);
-		xPos = (getWidth() / 2) - (component->getWidth() / 2);
-		yPos = 0;
-		for (unsigned int a = 0; a < comps.size(); a++)
-			yPos += comps[a]->getHeight();
-	} else if (pos == GUIPosition::BOTTOM) {
-		std::vector<GUIComponent*> comps = getComponentsWithPositionPreference(pos);
-		xPos = (getWidth() / 2) - (component->getWidth() / 2);
-		yPos = getHeight() - component->getHeight();
-		for (unsigned int a = 0; a < comps.size(); a++)
-			yPos -= comps[a]->getHeight();
-	} else if (pos == GUIPosition::LEFT) {
-		std::vector<GUIComponent*> comps = getComponentsWithPositionPreference(pos);
-		xPos = 0;
-		yPos = (getHeight() / 2) - (component->getHeight() / 2);
-		for (unsigned int a = 0; a < comps.size(); a++)
-			xPos += comps[a]->getWidth();
-	} else if (pos == GUIPosition::RIGHT) {
-		std::vector<GUIComponent*> comps = getComponentsWithPositionPreference(pos);
-		xPos = getWidth() - component->getWidth();
-		yPos = (getHeight() / 2) - (component->getHeight() / 2);
-		for (unsigned int a = 0; a < comps.size(); a++)
-			xPos -= comps[a]->getWidth();
-	} else if (pos == GUIPosition::CENTRE) {
-		xPos = (getWidth() / 2) - (component->getWidth() / 2);
-		yPos = (getHeight() / 2) - (component->getHeight() / 2);
-	}
-	component->position = Vector2f(xPos, yPos) + offset;
+	component->useLayout = true;
+	component->layoutOffset = offset;
 	add(component);
+	//Position it straight away so it can be used before the next update
+	layout();
+}
+
+void GUIComponent::markLayoutDirty() {
+	m_layoutDirty = true;
+	//The position of this component depends on its size, as do those of the components after it
+	if (m_layoutParent != NULL && useLayout)
+		m_layoutParent->m_layoutDirty = true;
+	//Let the ancestors know which branch needs to be visited, once one has already been told
+	//the ones above it will have been too
+	GUIComponent* current = this;
+	while (current->m_layoutParent != NULL && ! current->m_layoutParent->m_childLayoutDirty) {
+		current->m_layoutParent->m_childLayoutDirty = true;
+		current = current->m_layoutParent;
+	}
+}
+
+void GUIComponent::onTransformChanged(bool resized) {
+	if (resized || m_layoutParent != NULL)
+		markLayoutDirty();
+}
+
+void GUIComponent::layout() {
+	if (m_layoutDirty) {
+		//The space already taken up along each edge by the components before
+		float top = 0;
+		float bottom = 0;
+		float left = 0;
+		float right = 0;
+		float width = getWidth();
+		float height = getHeight();
+		for (unsigned int a = 0; a < components.size(); a++) {
+			GUIComponent* component = components[a];
+			if (! component->useLayout)
+				continue;
+			float componentWidth = component->getWidth();
+			float componentHeight = component->getHeight();
+			float xPos = (width / 2) - (componentWidth / 2);
+			float yPos = (height / 2) - (componentHeight / 2);
+			if (component->positionPreference == GUIPosition::TOP) {
+				yPos = top;
+				top += componentHeight;
+			} else if (component->positionPreference == GUIPosition::BOTTOM) {
+				yPos = height - componentHeight - bottom;
+				bottom += componentHeight;
+			} else if (component->positionPreference == GUIPosition::LEFT) {
+				xPos = left;
+				left += componentWidth;
+			} else if (component->positionPreference == GUIPosition::RIGHT) {
+				xPos = width - componentWidth - right;
+				right += componentWidth;
+			} else if (component->positionPreference == GUIPosition::NONE)
+				continue;
+			//Set directly as this is the layout being updated, the setter would mark it dirty again
+			component->position = Vector2f(xPos, yPos) + component->layoutOffset;
+		}
+		m_layoutDirty = false;
+
+		//The bounds within this branch may have changed, so they need updating in the index
+		GUIComponent* root = getLayoutRoot();
+		if (root->m_spatialIndex != NULL)
+			indexBounds(root->m_spatialIndex, root->getPosition());
+	}
+	if (m_childLayoutDirty) {
+		m_childLayoutDirty = false;
+		layoutChildren();
+	}
+}
+
+void GUIComponent::layoutChildren() {
+	for (unsigned int a = 0; a < components.size(); a++) {
+		if (components[a]->needsLayout())
+			components[a]->layout();
+	}
+}
+
+void GUIComponent::setLayoutParent(GUIComponent* layoutParent) {
+	//Once it is no longer a root it is found using the index of the tree it was added to
+	if (layoutParent != NULL && m_spatialIndex != NULL) {
+		delete m_spatialIndex;
+		m_spatialIndex = NULL;
+		m_mouseTargets.clear();
+	}
+	m_layoutParent = layoutParent;
 }
 
 std::vector<GUIComponent*> GUIComponent::getComponentsWithPositionPreference(GUIPosition preference) {
@@ -184,9 +383,54 @@ std::vector<GUIComponent*> GUIComponent::getComponentsWithPositionPreference(GUI
 }
 
 void GUIComponent::scale(Vector2f amount) {
-	setScale(getScale() * amount);
-	for (unsigned int a = 0; a < components.size(); a++)
-		components[a]->scale(amount);
+	//The children already take on the scale of their parent, so only their positions change
+	setScale(Object2D::scale * amount);
+}
+
+/***************************************************************************************************/
+
+/***************************************************************************************************
+ * The GUIInputRouter class
+ ***************************************************************************************************/
+
+GUIInputRouter* GUIInputRouter::m_instance = NULL;
+
+void GUIInputRouter::initialise() {
+	if (m_instance == NULL) {
+		m_instance = new GUIInputRouter();
+		m_instance->addListener();
+	}
+}
+
+void GUIInputRouter::onKeyPressed(int code) {
+	if (GUIComponent::getFocused() != NULL)
+		GUIComponent::getFocused()->callOnKeyPressedEvent(code);
+}
+
+void GUIInputRouter::onKeyReleased(int code) {
+	if (GUIComponent::getFocused() != NULL)
+		GUIComponent::getFocused()->callOnKeyReleasedEvent(code);
+}
+
+void GUIInputRouter::onChar(int code, char character) {
+	if (GUIComponent::getFocused() != NULL)
+		GUIComponent::getFocused()->callOnCharEvent(code, character);
+}
+
+void GUIInputRouter::onMousePressed(int button) {
+	GUIComponent* focused = GUIComponent::getFocused();
+	if (focused != NULL) {
+		//Clicking anywhere else takes the focus away
+		if (! focused->mouseHoveringInside)
+			GUIComponent::clearFocus();
+		else
+			focused->callOnMousePressedEvent(button);
+	}
+}
+
+void GUIInputRouter::onMouseDragged(double x, double y, double dx, double dy) {
+	if (GUIComponent::getFocused() != NULL)
+		GUIComponent::getFocused()->callOnMouseDraggedEvent(x, y, dx, dy);
 }
 
 /***************************************************************************************************/
@@ -200,6 +444,26 @@ GUIGroup::GUIGroup(std::string name) : GUIComponent(NULL) {
 	setSize(0, 0);
 }
 
+void GUIGroup::layoutChildren() {
+	GUIComponent::layoutChildren();
+	for (unsigned int a = 0; a < m_groupComponents.size(); a++) {
+		if (m_groupComponents[a]->needsLayout())
+			m_groupComponents[a]->layout();
+	}
+}
+
+void GUIGroup::indexBounds(GUISpatialIndex* index, Vector2f origin) {
+	GUIComponent::indexBounds(index, origin);
+	for (unsigned int a = 0; a < m_groupComponents.size(); a++)
+		m_groupComponents[a]->indexBounds(index, origin);
+}
+
+void GUIGroup::removeBounds(GUISpatialIndex* index) {
+	GUIComponent::removeBounds(index);
+	for (unsigned int a = 0; a < m_groupComponents.size(); a++)
+		m_groupComponents[a]->removeBounds(index);
+}
+
 void GUIGroup::updateComponent() {
 	for (unsigned int a = 0; a < m_groupComponents.size(); a++)
 		m_groupComponents[a]->update();
@@ -214,12 +478,17 @@ void GUIGroup::add(GUIComponent* component) {
 	component->setGroup(this);
 	attach(component);
 	m_groupComponents.push_back(component);
+	component->setLayoutParent(this);
+	component->markLayoutDirty();
 }
 
 void GUIGroup::remove(GUIComponent* component) {
 	for (unsigned int a = 0; a < m_groupComponents.size(); a++) {
-		if (m_groupComponents[a] == component)
+		if (m_groupComponents[a] == component) {
+			removeFromIndex(component);
 			m_groupComponents.erase(m_groupComponents.begin() + a);
+			component->setLayoutParent(NULL);
+		}
 	}
 }
 
@@ -281,7 +550,7 @@ GUIBorder::GUIBorder(GUIComponent* component, float thickness, std::vector<Textu
 
 void GUIBorder::setup(GUIComponent* component) {
 	this->component = component;
-	renderer = new GUIComponentRenderer(MeshBuilder::createQuad(component->getWidth() + (m_thickness * 2), component->getHeight() + (m_thickness * 2), Colour::WHITE));
+	renderer = new GUIComponentRenderer(MeshBuilder::createUnitQuad());
 	setPosition(-m_thickness, -m_thickness);
 	this->component->attach(this);
 	if (hasColour())
@@ -291,8 +560,11 @@ void GUIBorder::setup(GUIComponent* component) {
 }
 
 void GUIBorder::render() {
-	if (renderer != NULL)
+	if (renderer != NULL) {
+		//Follow the size of the component as the quad is scaled when it is drawn
+		setSize(component->getWidth() + (m_thickness * 2), component->getHeight() + (m_thickness * 2));
 		renderer->render(this, component->active);
+	}
 }
 
 void GUIBorder::setColour(Colour colour) {
@@ -431,9 +703,9 @@ void GUIFill::setup(GUIComponent* component) {
 	this->component = component;
 	this->component->attach(this);
 	if (texture != NULL)
-		renderer = new GUIComponentRenderer(MeshBuilder::createQuad(component->getWidth(), component->getHeight(), texture, Colour::WHITE));
+		renderer = new GUIComponentRenderer(MeshBuilder::createUnitQuad(texture));
 	else
-		renderer = new GUIComponentRenderer(MeshBuilder::createQuad(component->getWidth(), component->getHeight(), Colour::WHITE));
+		renderer = new GUIComponentRenderer(MeshBuilder::createUnitQuad());
 	colour = Colour::WHITE;
 }
 
@@ -445,13 +717,6 @@ void GUIFill::update() {
 			renderer->textures.clear();
 			renderer->textures.push_back(texture);
 		}
-		if (size.getX() != lastWidth || size.getY() != lastHeight) {
-			renderer->entity->getMesh()->getData()->clearPositions();
-			MeshBuilder::addQuadV(renderer->entity->getMesh()->getData(), Vector2f(0, 0), Vector2f(size.getX(), size.getY()));
-			renderer->entity->getMesh()->updateVertices();
-			lastWidth = size.getX();
-			lastHeight = size.getY();
-		}
 	}
 }
 
@@ -22,7 +22,9 @@
 #include <string>
 
 #include "../../utils/Timer.h"
+#include "../input/Input.h"
 #include "GUIComponentRenderer.h"
+#include "GUISpatialIndex.h"
 
 /***************************************************************************************************
  * The GUIPosition enum
@@ -61,11 +63,60 @@ class GUIToolTip;
 
 class GUIComponent : public Object2D {
 protected:
+	/* The component this one was added to, used to pass on changes that need a relayout */
+	GUIComponent* m_layoutParent = NULL;
+
+	/* States whether the positions of this component's children need to be recalculated, and
+	 * whether any of its descendants need to be laid out */
+	bool m_layoutDirty      = false;
+	bool m_childLayoutDirty = false;
+
+	/* Lays out the descendants that need it, called by layout() */
+	virtual void layoutChildren();
+
+	/* The bounds of this component and its descendants relative to its own position, only
+	 * created for the root of a tree so that the components under the mouse can be found without
+	 * testing every one of them */
+	GUISpatialIndex* m_spatialIndex = NULL;
+
+	/* The components the mouse was inside during the last update of this root, kept so they can
+	 * be told when it leaves */
+	std::vector<GUIComponent*> m_mouseTargets;
+
+	/* The component that keyboard input is currently sent to */
+	static GUIComponent* m_focused;
+
+	/* Finds the components under the mouse using the index, called by the root of the tree */
+	void updateMouseTargets();
+
+	/* Updates the hover and click state of this component */
+	void updateMouse(bool inside);
+
+	/* Returns whether this component and all of the ones above it are visible and active */
+	bool isInteractive();
+
+	GUIComponent* getLayoutRoot();
+
+	/* Marks the layout as dirty whenever the bounds change through one of the setters, so the
+	 * positions and the index can't be left out of date. Moving the root doesn't need a relayout
+	 * as everything is stored relative to it */
+	void onTransformChanged(bool resized) override;
+
+	/* Renders this component and everything within it */
+	void renderTree();
+
 	virtual void updateComponent() {}
 	virtual void renderComponent() {}
 	virtual void componentOnMouseEnter() {}
 	virtual void componentOnMouseLeave() {}
 	virtual void componentOnClicked() {}
+	virtual void componentOnFocusGained() {}
+	virtual void componentOnFocusLost() {}
+	virtual void componentOnKeyPressed(int code) {}
+	virtual void componentOnKeyReleased(int code) {}
+	virtual void componentOnChar(int code, char character) {}
+	virtual void componentOnMousePressed(int button) {}
+	virtual void componentOnMouseDragged(double x, double y, double dx, double dy) {}
 public:
 	GUIComponentRenderer* renderer;
 	std::string name;
@@ -83,6 +134,14 @@ public:
 	GUIPosition positionPreference;
 	GUIToolTip* toolTip;
 
+	/* States whether this component takes the keyboard focus when it is clicked */
+	bool focusable;
+
+	/* States whether the position of this component is calculated from its position preference,
+	 * and the offset applied to it afterwards */
+	bool useLayout;
+	Vector2f layoutOffset;
+
 	GUIComponent() {
 		renderer = NULL;
 		setDefaults();
@@ -91,7 +150,7 @@ public:
 	GUIComponent(RenderableObject2D* object);
 	GUIComponent(RenderableObject2D* object, float width, float height);
 
-	virtual ~GUIComponent() {}
+	virtual ~GUIComponent();
 
 	void setup(GUIComponentRenderer* renderer);
 	void setup(RenderableObject2D* object);
@@ -109,6 +168,11 @@ public:
 	void callOnMouseEnterEvent();
 	void callOnMouseLeaveEvent();
 	void callOnClickedEvent();
+	void callOnKeyPressedEvent(int code);
+	void callOnKeyReleasedEvent(int code);
+	void callOnCharEvent(int code, char character);
+	void callOnMousePressedEvent(int button);
+	void callOnMouseDraggedEvent(double x, double y, double dx, double dy);
 	void add(GUIComponent* component);
 	void add(GUIComponent* component, GUIPosition pos, Vector2f offset);
 	inline void add(GUIComponent* component, GUIPosition pos) { add(component, pos, Vector2f(0, 0)); }
@@ -116,6 +180,32 @@ public:
 	std::vector<GUIComponent*> getComponentsWithPositionPreference(GUIPosition preference);
 	void scale(Vector2f amount);
 
+	/* Marks this component as needing to be laid out again, this is done automatically when
+	 * the size is changed through this class */
+	void markLayoutDirty();
+
+	/* Recalculates the positions of any children that have changed, only visiting the parts of
+	 * the tree that have been marked as dirty */
+	void layout();
+	inline bool needsLayout() { return m_layoutDirty || m_childLayoutDirty; }
+
+	/* Adds the bounds of this component and its descendants to the index given, relative to
+	 * the position of the root */
+	virtual void indexBounds(GUISpatialIndex* index, Vector2f origin);
+	virtual void removeBounds(GUISpatialIndex* index);
+
+	/* Removes a component that is being taken out of the tree from the index of its root */
+	void removeFromIndex(GUIComponent* component);
+
+	void setLayoutParent(GUIComponent* layoutParent);
+	inline GUIComponent* getLayoutParent() { return m_layoutParent; }
+
+	/* Gives this component the keyboard focus, taking it from any other component */
+	void focus();
+	static void clearFocus();
+	inline bool isFocused() { return m_focused == this; }
+	static inline GUIComponent* getFocused() { return m_focused; }
+
 	inline void setName(std::string name) { this->name = name; }
 	inline void setVisible(bool visible) { this->visible = visible; }
 	inline void setActive(bool active) { this->active = active; }
@@ -145,6 +235,27 @@ public:
 
 /***************************************************************************************************/
 
+/***************************************************************************************************
+ * The GUIInputRouter class passes keyboard input on to the component that has the focus, so
+ * components don't each need to listen for every key event
+ ***************************************************************************************************/
+
+class GUIInputRouter : public InputListener {
+private:
+	static GUIInputRouter* m_instance;
+public:
+	/* Adds the router as an input listener, only done once */
+	static void initialise();
+
+	void onKeyPressed(int code) override;
+	void onKeyReleased(int code) override;
+	void onChar(int code, char character) override;
+	void onMousePressed(int button) override;
+	void onMouseDragged(double x, double y, double dx, double dy) override;
+};
+
+/***************************************************************************************************/
+
 /***************************************************************************************************
  * The GUIGroup class
  ***************************************************************************************************/
@@ -155,6 +266,9 @@ private:
 public:
 	GUIGroup(std::string name);
 	virtual ~GUIGroup() {}
+	void layoutChildren() override;
+	void indexBounds(GUISpatialIndex* index, Vector2f origin) override;
+	void removeBounds(GUISpatialIndex* index) override;
 	void updateComponent() override;
 	void renderComponent() override;
 	void add(GUIComponent* component);
@@ -261,15 +375,11 @@ public:
 	GUIComponentRenderer* renderer;
 	Colour colour;
 	Texture* texture;
-	float lastWidth;
-	float lastHeight;
 	GUIFill() {
 		component = NULL;
 		renderer = NULL;
 		texture = NULL;
 		colour = Colour(-1, -1, -1, -1);
-		lastWidth = 0;
-		lastHeight = 0;
 	}
 	GUIFill(GUIComponent* component) {
 		setup(component);
@@ -297,25 +407,25 @@ public:
 class GUITexture : public GUIComponent {
 public:
 	GUITexture(Texture* texture) :
-		GUIComponent(new RenderableObject2D(MeshBuilder::createQuad(texture->getWidth(), texture->getHeight(), texture, Colour::WHITE))) {
+		GUIComponent(new RenderableObject2D(MeshBuilder::createUnitQuad(texture))) {
 		setSize(texture->getWidth(), texture->getHeight());
 		renderer->textures.push_back(texture);
 		renderer->colours.push_back(Colour::WHITE);
 	}
 	GUITexture(Texture* texture, Colour colour) :
-		GUIComponent(new RenderableObject2D(MeshBuilder::createQuad(texture->getWidth(), texture->getHeight(), texture, Colour::WHITE))) {
+		GUIComponent(new RenderableObject2D(MeshBuilder::createUnitQuad(texture))) {
 		setSize(texture->getWidth(), texture->getHeight());
 		renderer->textures.push_back(texture);
 		renderer->colours.push_back(colour);
 	}
 	GUITexture(Texture* texture, float width, float height) :
-		GUIComponent(new RenderableObject2D(MeshBuilder::createQuad(width, height, texture, Colour::WHITE))) {
+		GUIComponent(new RenderableObject2D(MeshBuilder::createUnitQuad(texture))) {
 		setSize(width, height);
 		renderer->textures.push_back(texture);
 		renderer->colours.push_back(Colour::WHITE);
 	}
 	GUITexture(Texture* texture, Colour colour, float width, float height) :
-		GUIComponent(new RenderableObject2D(MeshBuilder::createQuad(width, height, texture, Colour::WHITE))) {
+		GUIComponent(new RenderableObject2D(MeshBuilder::createUnitQuad(texture))) {
 		setSize(width, height);
 		renderer->textures.push_back(texture);
 		renderer->colours.push_back(colour);
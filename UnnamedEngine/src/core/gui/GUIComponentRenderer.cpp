@@ -17,12 +17,15 @@
  *****************************************************************************/
 
 #include "GUIComponentRenderer.h"
+#include "../render/SpriteBatch.h"
+#include "../render/Renderer.h"
 
 /***************************************************************************************************
  * The GUIComponentRenderer
  ***************************************************************************************************/
 
 Font* GUIComponentRenderer::defaultFont;
+TextureAtlas* GUIComponentRenderer::defaultAtlas = NULL;
 
 GUIComponentRenderer::GUIComponentRenderer(RenderableObject2D* entity) {
 	this->entity = entity;
@@ -43,42 +46,38 @@ void GUIComponentRenderer::render(Object2D* object, bool active) {
 
 		entity->update();
 
-		if (active || (! shouldUseInactiveTexture()) || (! shouldUseInactiveColour())) {
-			if (shouldUseTextures()) {
-				entity->getMesh()->getData()->clearTextureCoords();
-				MeshBuilder::addQuadT(entity->getMesh()->getData(), textures[componentIndex]);
-				entity->getMesh()->updateTextureCoords();
-				entity->getMesh()->setTexture(textures[componentIndex]);
-
-				if (shouldUseColours()) {
-					entity->getMesh()->getData()->clearColours();
-					MeshBuilder::addQuadC(entity->getMesh()->getData(), colours[componentIndex]);
-					entity->getMesh()->updateColours();
-				} else {
-					entity->getMesh()->getData()->clearColours();
-					MeshBuilder::addQuadC(entity->getMesh()->getData(), Colour::WHITE);
-					entity->getMesh()->updateColours();
-				}
-			} else if (shouldUseColours()) {
-				entity->getMesh()->getData()->clearColours();
-				MeshBuilder::addQuadC(entity->getMesh()->getData(), colours[componentIndex]);
-				entity->getMesh()->updateColours();
-			}
+		//The colour and texture are given when drawing so the mesh can be shared
+		Texture* texture;
+		Colour colour;
+		getAppearance(active, texture, colour);
+		Mesh* mesh = entity->getMesh();
+		if (MeshBuilder::isUnitQuad(mesh)) {
+			if (SpriteBatch::isBatching())
+				SpriteBatch::getCurrent()->addQuad(mesh, entity->getModelMatrix(), texture, colour);
+			else
+				Renderer::renderQuad(mesh, entity->getModelMatrix(), texture, colour);
 		} else {
-			if (shouldUseInactiveTexture()) {
-				entity->getMesh()->setTexture(inactiveTexture);
-				if (shouldUseInactiveColour()) {
-					entity->getMesh()->getData()->clearColours();
-					MeshBuilder::addQuadC(entity->getMesh()->getData(), inactiveColour);
-					entity->getMesh()->updateColours();
-				}
-			} else if (shouldUseInactiveColour())  {
-				entity->getMesh()->getData()->clearColours();
-				MeshBuilder::addQuadC(entity->getMesh()->getData(), inactiveColour);
-				entity->getMesh()->updateColours();
-			}
+			//Any other mesh is drawn using its own colours
+			mesh->setTexture(texture);
+			if (SpriteBatch::isBatching())
+				SpriteBatch::getCurrent()->add(mesh, entity->getModelMatrix());
+			else
+				entity->render();
 		}
-		entity->render();
+	}
+}
+
+void GUIComponentRenderer::getAppearance(bool active, Texture*& texture, Colour& colour) {
+	texture = entity->getMesh()->getTexture();
+	colour = Colour::WHITE;
+	if (active || (! shouldUseInactiveTexture()) || (! shouldUseInactiveColour())) {
+		if (shouldUseTextures())
+			texture = textures[componentIndex];
+		if (shouldUseColours())
+			colour = colours[componentIndex];
+	} else {
+		texture = inactiveTexture;
+		colour = inactiveColour;
 	}
 }
 
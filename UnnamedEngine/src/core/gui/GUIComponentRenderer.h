@@ -30,8 +30,15 @@
  ***************************************************************************************************/
 
 class GUIComponentRenderer {
+private:
+	/* Finds the texture and colour to draw with */
+	void getAppearance(bool active, Texture*& texture, Colour& colour);
 public:
 	static Font* defaultFont;
+
+	/* The atlas the default font is packed into, GUI images added to it with TextureAtlas::add()
+	 * share it so the GUI can be drawn with as few texture changes as possible */
+	static TextureAtlas* defaultAtlas;
 	std::vector<Colour> colours;
 	std::vector<Texture*> textures;
 	Colour inactiveColour;
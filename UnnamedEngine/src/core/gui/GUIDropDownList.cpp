@@ -35,7 +35,7 @@ GUIDropDownList::GUIDropDownList(GUIButton* menuButton, Texture* overlayTexture)
 
 void GUIDropDownList::setupOverlay(Texture* texture) {
 	overlayTexture = texture;
-	overlay = new RenderableObject2D(MeshBuilder::createQuad(menuButton->getWidth(), menuButton->getHeight(), overlayTexture, Colour::WHITE));
+	overlay = new RenderableObject2D(MeshBuilder::createUnitQuad(overlayTexture), menuButton->getWidth(), menuButton->getHeight());
 }
 
 void GUIDropDownList::renderComponent() {
@@ -43,6 +43,8 @@ void GUIDropDownList::renderComponent() {
 		menuButton->render();
 	if (overlay != NULL) {
 		overlay->position = menuButton->position;
+		overlay->setSize(menuButton->getWidth(), menuButton->getHeight());
+		overlay->update();
 		overlay->render();
 	}
 	if (menuOpen) {
@@ -32,7 +32,7 @@ public:
 	GUIFill* barFill;
 
 	GUILoadingBar(int loadingStages, float width, float height) :
-		GUIComponent(new RenderableObject2D(MeshBuilder::createQuad(width, height, Colour::WHITE), width, height)) {
+		GUIComponent(new RenderableObject2D(MeshBuilder::createUnitQuad(), width, height)) {
 		this->loadingStages = loadingStages;
 		currentLoadingStage = 0;
 		renderer->colours.push_back(Colour::WHITE);
@@ -40,7 +40,7 @@ public:
 	}
 
 	GUILoadingBar(int loadingStages, Colour colour, float width, float height) :
-		GUIComponent(new RenderableObject2D(MeshBuilder::createQuad(width, height, Colour::WHITE), width, height)) {
+		GUIComponent(new RenderableObject2D(MeshBuilder::createUnitQuad(), width, height)) {
 		this->loadingStages = loadingStages;
 		currentLoadingStage = 0;
 		renderer->colours.push_back(colour);
@@ -48,7 +48,7 @@ public:
 	}
 
 	GUILoadingBar(int loadingStages, Texture* texture, float width, float height) :
-		GUIComponent(new RenderableObject2D(MeshBuilder::createQuad(width, height, texture, Colour::WHITE), width, height)) {
+		GUIComponent(new RenderableObject2D(MeshBuilder::createUnitQuad(texture), width, height)) {
 		this->loadingStages = loadingStages;
 		currentLoadingStage = 0;
 		renderer->colours.push_back(Colour::WHITE);
@@ -57,7 +57,7 @@ public:
 	}
 
 	GUILoadingBar(int loadingStages, Texture* texture, Colour colour, float width, float height) :
-		GUIComponent(new RenderableObject2D(MeshBuilder::createQuad(width, height, texture, Colour::WHITE), width, height)) {
+		GUIComponent(new RenderableObject2D(MeshBuilder::createUnitQuad(texture), width, height)) {
 		this->loadingStages = loadingStages;
 		currentLoadingStage = 0;
 		renderer->colours.push_back(colour);
@@ -0,0 +1,105 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <cmath>
+#include <algorithm>
+
+#include "GUISpatialIndex.h"
+
+/***************************************************************************************************
+ * The GUISpatialIndex class
+ ***************************************************************************************************/
+
+GUISpatialIndex::GUISpatialIndex(float cellSize) {
+	m_cellSize = cellSize;
+}
+
+int GUISpatialIndex::getCell(float value) {
+	//Floored so that negative coordinates don't share the cells either side of 0
+	return (int) std::floor(value / m_cellSize);
+}
+
+void GUISpatialIndex::addToCells(GUIComponent* component, Rect& bounds) {
+	int minX = getCell(bounds.x);
+	int minY = getCell(bounds.y);
+	int maxX = getCell(bounds.x + bounds.width);
+	int maxY = getCell(bounds.y + bounds.height);
+	for (int y = minY; y <= maxY; y++) {
+		for (int x = minX; x <= maxX; x++)
+			m_cells[getCellKey(x, y)].push_back(component);
+	}
+}
+
+void GUISpatialIndex::removeFromCells(GUIComponent* component, Rect& bounds) {
+	int minX = getCell(bounds.x);
+	int minY = getCell(bounds.y);
+	int maxX = getCell(bounds.x + bounds.width);
+	int maxY = getCell(bounds.y + bounds.height);
+	for (int y = minY; y <= maxY; y++) {
+		for (int x = minX; x <= maxX; x++) {
+			std::map<long long, std::vector<GUIComponent*>>::iterator cell = m_cells.find(getCellKey(x, y));
+			if (cell != m_cells.end()) {
+				std::vector<GUIComponent*>& components = cell->second;
+				components.erase(std::remove(components.begin(), components.end(), component), components.end());
+				if (components.empty())
+					m_cells.erase(cell);
+			}
+		}
+	}
+}
+
+void GUISpatialIndex::update(GUIComponent* component, Rect bounds) {
+	std::map<GUIComponent*, Rect>::iterator current = m_bounds.find(component);
+	if (current != m_bounds.end()) {
+		Rect& last = current->second;
+		//Nothing needs to change if it hasn't moved or been resized
+		if (last.x == bounds.x && last.y == bounds.y && last.width == bounds.width && last.height == bounds.height)
+			return;
+		removeFromCells(component, last);
+		last = bounds;
+	} else
+		m_bounds.insert(std::pair<GUIComponent*, Rect>(component, bounds));
+	addToCells(component, bounds);
+}
+
+void GUISpatialIndex::remove(GUIComponent* component) {
+	std::map<GUIComponent*, Rect>::iterator current = m_bounds.find(component);
+	if (current != m_bounds.end()) {
+		removeFromCells(component, current->second);
+		m_bounds.erase(current);
+	}
+}
+
+void GUISpatialIndex::clear() {
+	m_cells.clear();
+	m_bounds.clear();
+}
+
+void GUISpatialIndex::query(float x, float y, FrameVector<GUIComponent*>& components) {
+	std::map<long long, std::vector<GUIComponent*>>::iterator cell = m_cells.find(getCellKey(getCell(x), getCell(y)));
+	if (cell != m_cells.end()) {
+		std::vector<GUIComponent*>& candidates = cell->second;
+		for (unsigned int a = 0; a < candidates.size(); a++) {
+			//The cell may be larger than the component, so its bounds still need checking
+			if (m_bounds[candidates[a]].contains(x, y))
+				components.push_back(candidates[a]);
+		}
+	}
+}
+
+/***************************************************************************************************/
@@ -0,0 +1,72 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef CORE_GUI_GUISPATIALINDEX_H_
+#define CORE_GUI_GUISPATIALINDEX_H_
+
+#include <vector>
+#include <map>
+
+#include "../Rectangle.h"
+#include "../Memory.h"
+
+class GUIComponent;
+
+/***************************************************************************************************
+ * The GUISpatialIndex class stores the bounds of components in a uniform grid so that the ones
+ * under a point can be found by only testing those in the same cell, instead of every component.
+ * Components are moved between cells only when their bounds change
+ ***************************************************************************************************/
+
+class GUISpatialIndex {
+private:
+	/* The width and height of each cell */
+	float m_cellSize;
+
+	/* The components overlapping each cell, keyed by the cell's coordinates */
+	std::map<long long, std::vector<GUIComponent*>> m_cells;
+
+	/* The bounds each component was last added with */
+	std::map<GUIComponent*, Rect> m_bounds;
+
+	inline long long getCellKey(int x, int y) { return ((long long) x << 32) | (unsigned int) y; }
+	int getCell(float value);
+	void addToCells(GUIComponent* component, Rect& bounds);
+	void removeFromCells(GUIComponent* component, Rect& bounds);
+public:
+	GUISpatialIndex(float cellSize);
+	GUISpatialIndex() { m_cellSize = 64.0f; }
+	virtual ~GUISpatialIndex() {}
+
+	/* Adds a component, or moves it if it has been added before and its bounds have changed */
+	void update(GUIComponent* component, Rect bounds);
+	void remove(GUIComponent* component);
+	void clear();
+
+	/* Adds every component whose bounds contain the point to the list given */
+	void query(float x, float y, FrameVector<GUIComponent*>& components);
+
+	inline bool contains(GUIComponent* component) { return m_bounds.count(component) > 0; }
+	inline unsigned int getNumComponents() { return m_bounds.size(); }
+	inline unsigned int getNumCells() { return m_cells.size(); }
+	inline float getCellSize() { return m_cellSize; }
+};
+
+/***************************************************************************************************/
+
+#endif /* CORE_GUI_GUISPATIALINDEX_H_ */
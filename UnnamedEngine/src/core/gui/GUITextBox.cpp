@@ -43,7 +43,7 @@ GUITextBoxCursor::GUITextBoxCursor(GUITextBox* textBox, float thickness) {
 void GUITextBoxCursor::setup(GUITextBox* textBox) {
 	this->textBox = textBox;
 	setHeight(textBox->renderer->font->getHeight("A"));
-	renderer = new GUIComponentRenderer(MeshBuilder::createQuad(getWidth(), getHeight(), Colour::WHITE));
+	renderer = new GUIComponentRenderer(MeshBuilder::createUnitQuad());
 	renderer->colours.push_back(Colour::BLACK);
 	timer = new Timer();
 	timer->start();
@@ -127,7 +127,7 @@ GUITextBoxSelection::GUITextBoxSelection(GUITextBox* textBox) {
 void GUITextBoxSelection::setup(GUITextBox* textBox) {
 	this->textBox = textBox;
 	setSize(0, 0);
-	renderer = new GUIComponentRenderer(MeshBuilder::createQuad(getWidth(), getHeight(), Colour::WHITE));
+	renderer = new GUIComponentRenderer(MeshBuilder::createUnitQuad());
 	renderer->colours.push_back(Colour::BLACK);
 	if (colour.getR() != -1.0f)
 		setColour(colour);
@@ -182,9 +182,7 @@ void GUITextBoxSelection::render() {
 		float selectionY = p.getY();
 		float selectionWidth = textBox->renderer->font->getWidth(textBox->getRenderTextSelection());
 		float selectionHeight = textBox->getHeight();
-		renderer->entity->getMesh()->getData()->clearPositions();
-		MeshBuilder::addQuadV(renderer->entity->getMesh()->getData(), selectionWidth, selectionHeight);
-		renderer->entity->getMesh()->updateVertices();
+		setSize(selectionWidth, selectionHeight);
 		position = Vector2f(selectionX, selectionY);
 		renderer->render(this, textBox->active);
 	}
@@ -197,24 +195,24 @@ void GUITextBoxSelection::render() {
  ***************************************************************************************************/
 
 GUITextBox::GUITextBox(float width, float height) :
-	GUIComponent(new RenderableObject2D(MeshBuilder::createQuad(width, height, Colour::WHITE), width, height)) {
+	GUIComponent(new RenderableObject2D(MeshBuilder::createUnitQuad(), width, height)) {
 	setup();
 }
 
 GUITextBox::GUITextBox(Colour colour, float width, float height) :
-	GUIComponent(new RenderableObject2D(MeshBuilder::createQuad(width, height, Colour::WHITE), width, height)) {
+	GUIComponent(new RenderableObject2D(MeshBuilder::createUnitQuad(), width, height)) {
 	renderer->colours.push_back(colour);
 	setup();
 }
 
 GUITextBox::GUITextBox(Texture* texture, float width, float height) :
-	GUIComponent(new RenderableObject2D(MeshBuilder::createQuad(width, height, texture, Colour::WHITE), width, height)) {
+	GUIComponent(new RenderableObject2D(MeshBuilder::createUnitQuad(texture), width, height)) {
 	renderer->textures.push_back(texture);
 	setup();
 }
 
 GUITextBox::GUITextBox(Texture* texture, Colour colour, float width, float height) :
-	GUIComponent(new RenderableObject2D(MeshBuilder::createQuad(width, height, texture, Colour::WHITE), width, height)) {
+	GUIComponent(new RenderableObject2D(MeshBuilder::createUnitQuad(texture), width, height)) {
 	renderer->colours.push_back(colour);
 	renderer->textures.push_back(texture);
 	setup();
@@ -253,7 +251,8 @@ bool GUITextBox::hasTexture() {
 }
 
 void GUITextBox::setup() {
-	InputManager::addListener(this);
+	//Key events are only passed on while this has the focus
+	focusable = true;
 
 	text = "";
 	renderText = "";
@@ -269,7 +268,7 @@ void GUITextBox::setup() {
 	selectionIndexStart = 0;
 	selectionIndexEnd = 0;
 	selection = new GUITextBoxSelection(this);
-	shortcuts = new KeyboardShortcuts();
+	shortcuts = new KeyboardShortcuts(false);
 	shortcuts->addListener(this);
 
 	std::vector<int> shiftLeftKeys1;
@@ -483,11 +482,19 @@ void GUITextBox::deleteSelection() {
 }
 
 void GUITextBox::componentOnClicked() {
+	cursor->showCursor();
+}
+
+void GUITextBox::componentOnFocusGained() {
 	selected = true;
 	cursor->showCursor();
 }
 
-void GUITextBox::onKeyPressed(int code) {
+void GUITextBox::componentOnFocusLost() {
+	selected = false;
+}
+
+void GUITextBox::componentOnKeyPressed(int code) {
 	if (visible && active && selected) {
 		if (code == GLFW_KEY_BACKSPACE) {
 			if (isSelection)
@@ -573,9 +580,14 @@ void GUITextBox::onKeyPressed(int code) {
 		//Show the cursor
 		cursor->showCursor();
 	}
+	shortcuts->onKeyPressed(code);
+}
+
+void GUITextBox::componentOnKeyReleased(int code) {
+	shortcuts->onKeyReleased(code);
 }
 
-void GUITextBox::onChar(int code, char character) {
+void GUITextBox::componentOnChar(int code, char character) {
 	if (visible && active && selected) {
 		if (code == GLFW_KEY_BACKSPACE) {
 		} else if (code == GLFW_KEY_DELETE) {
@@ -606,16 +618,14 @@ void GUITextBox::onChar(int code, char character) {
 	}
 }
 
-void GUITextBox::onMousePressed(int button) {
-	if (! mouseHoveringInside)
-		selected = false;
-	else if (selected && button == GLFW_MOUSE_BUTTON_LEFT) {
+void GUITextBox::componentOnMousePressed(int button) {
+	if (selected && button == GLFW_MOUSE_BUTTON_LEFT) {
 		moveCursor(Mouse::lastX);
 		resetSelection();
 	}
 }
 
-void GUITextBox::onMouseDragged(double x, double y, double dx, double dy) {
+void GUITextBox::componentOnMouseDragged(double x, double y, double dx, double dy) {
 	//Make sure this is selected
 	if (visible && active && selected) {
 		//Check to see whether there is a selection
@@ -94,7 +94,7 @@ public:
  * The GUITextBox class
  ***************************************************************************************************/
 
-class GUITextBox : public GUIComponent, InputListener, KeyboardShortcutListener {
+class GUITextBox : public GUIComponent, KeyboardShortcutListener {
 public:
 	std::string text;
 	std::string renderText;
@@ -154,13 +154,19 @@ public:
 
 	virtual void componentOnClicked() override;
 
-	virtual void onKeyPressed(int code) override;
+	virtual void componentOnFocusGained() override;
 
-	virtual void onChar(int code, char character) override;
+	virtual void componentOnFocusLost() override;
 
-	virtual void onMousePressed(int button) override;
+	virtual void componentOnKeyPressed(int code) override;
 
-	virtual void onMouseDragged(double x, double y, double dx, double dy) override;
+	virtual void componentOnKeyReleased(int code) override;
+
+	virtual void componentOnChar(int code, char character) override;
+
+	virtual void componentOnMousePressed(int button) override;
+
+	virtual void componentOnMouseDragged(double x, double y, double dx, double dy) override;
 
 	virtual void onShortcut(KeyboardShortcut* e) override;
 
@@ -171,7 +177,12 @@ public:
 	void setText(std::string text);
 
 	inline void setRenderText(std::string renderText) { this->renderText = renderText; }
-	inline void setSelected(bool selected) { this->selected = selected; }
+	inline void setSelected(bool selected) {
+		if (selected)
+			focus();
+		else if (isFocused())
+			clearFocus();
+	}
 	inline void setMasked(bool masked) { this->masked = masked; }
 	inline void setMask(std::string mask) { this->mask = mask; }
 	inline void setDefaultText(std::string defaulttext) { this->defaultText = defaultText; }
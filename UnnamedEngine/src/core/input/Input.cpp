@@ -79,6 +79,128 @@ bool Keyboard::isPressed(int key) {
  ***************************************************************************************************/
 
 std::vector<InputListener*> InputManager::m_listeners;
+InputEventQueue InputManager::m_queue(4096);
+bool InputManager::m_coalesceMouseMoves = true;
+bool InputManager::m_hasPendingMove = false;
+InputEvent InputManager::m_pendingMove;
+InputRecording* InputManager::m_recording = NULL;
+InputRecording* InputManager::m_playback = NULL;
+unsigned int InputManager::m_playbackIndex = 0;
+double InputManager::m_playbackStart = 0;
+
+void InputManager::queueEvent(InputEvent event) {
+	if (! m_queue.push(event))
+		logWarning("The input event queue is full, an event has been dropped");
+}
+
+void InputManager::dispatchEvents() {
+	//Play any recorded events that are now due
+	if (m_playback != NULL) {
+		std::vector<InputEvent>& events = m_playback->getEvents();
+		double elapsed = glfwGetTime() - m_playbackStart;
+		while (m_playbackIndex < events.size() && events[m_playbackIndex].time - events[0].time <= elapsed) {
+			processEvent(events[m_playbackIndex]);
+			m_playbackIndex++;
+		}
+		if (m_playbackIndex >= events.size())
+			m_playback = NULL;
+	}
+
+	InputEvent event;
+	while (m_queue.pop(event))
+		processEvent(event);
+	dispatchPendingMove();
+}
+
+void InputManager::play(InputRecording* recording) {
+	m_playback = recording;
+	m_playbackIndex = 0;
+	m_playbackStart = glfwGetTime();
+}
+
+void InputManager::replay(InputRecording* recording) {
+	std::vector<InputEvent>& events = recording->getEvents();
+	for (unsigned int a = 0; a < events.size(); a++)
+		processEvent(events[a]);
+	dispatchPendingMove();
+}
+
+void InputManager::processEvent(InputEvent& event) {
+	if (m_recording != NULL)
+		m_recording->add(event);
+
+	if (event.type == INPUT_EVENT_CURSOR_POSITION && m_coalesceMouseMoves) {
+		//The offsets are calculated when it is dispatched, so only the latest position is needed
+		m_pendingMove = event;
+		m_hasPendingMove = true;
+	} else {
+		//Anything else has to be dispatched after the movements before it to keep the order
+		dispatchPendingMove();
+		dispatchEvent(event);
+	}
+}
+
+void InputManager::dispatchPendingMove() {
+	if (m_hasPendingMove) {
+		m_hasPendingMove = false;
+		dispatchEvent(m_pendingMove);
+	}
+}
+
+void InputManager::dispatchEvent(InputEvent& event) {
+	if (event.type == INPUT_EVENT_KEY) {
+		bool repeat = Game::current != NULL && Game::current->getSettings()->getKeyboardEventsRepeat();
+		if (event.action == GLFW_PRESS || (repeat && event.action == GLFW_REPEAT)) {
+			callOnKeyPressed(event.code);
+		} else if (event.action == GLFW_RELEASE) {
+			callOnKeyReleased(event.code);
+			callOnKeyTyped(event.code);
+		}
+	} else if (event.type == INPUT_EVENT_CHAR) {
+		callOnChar(event.code, (char) event.code);
+	} else if (event.type == INPUT_EVENT_MOUSE_BUTTON) {
+		bool repeat = Game::current != NULL && Game::current->getSettings()->getMouseEventsRepeat();
+		if (event.action == GLFW_PRESS || (repeat && event.action == GLFW_REPEAT)) {
+			if (event.code == GLFW_MOUSE_BUTTON_LEFT)
+				Mouse::leftButtonDown = true;
+			else if (event.code == GLFW_MOUSE_BUTTON_MIDDLE)
+				Mouse::middleButtonDown = true;
+			else if (event.code == GLFW_MOUSE_BUTTON_RIGHT)
+				Mouse::rightMouseDown = true;
+			callOnMousePressed(event.code);
+		} else if (event.action == GLFW_RELEASE) {
+			if (event.code == GLFW_MOUSE_BUTTON_LEFT)
+				Mouse::leftButtonDown = false;
+			else if (event.code == GLFW_MOUSE_BUTTON_MIDDLE)
+				Mouse::middleButtonDown = false;
+			else if (event.code == GLFW_MOUSE_BUTTON_RIGHT)
+				Mouse::rightMouseDown = false;
+			callOnMouseReleased(event.code);
+			callOnMouseClicked(event.code);
+		}
+	} else if (event.type == INPUT_EVENT_CURSOR_POSITION) {
+		double xOffset = event.x - Mouse::lastX;
+		double yOffset = event.y - Mouse::lastY;
+		if (Mouse::lastX == -1) {
+			xOffset = 0;
+			yOffset = 0;
+		}
+		Mouse::lastX = event.x;
+		Mouse::lastY = event.y;
+
+		callOnMouseMoved(event.x, event.y, xOffset, yOffset);
+
+		if (Mouse::leftButtonDown)
+			callOnMouseDragged(event.x, event.y, xOffset, yOffset);
+	} else if (event.type == INPUT_EVENT_CURSOR_ENTER) {
+		if (event.code)
+			callOnMouseEnter();
+		else
+			callOnMouseLeave();
+	} else if (event.type == INPUT_EVENT_SCROLL) {
+		callOnScroll(event.x, event.y);
+	}
+}
 
 void InputManager::callOnKeyPressed(int code) {
 	for (unsigned int a = 0; a < m_listeners.size(); a++)
@@ -146,65 +268,56 @@ void InputManager::callOnScroll(double dx, double dy) {
  * The various input callbacks
  ***************************************************************************************************/
 
+/* Creates an event with the time it was received, the rest of the values are set by the callback */
+InputEvent input_createEvent(InputEventType type) {
+	InputEvent event;
+	event.type = type;
+	event.time = glfwGetTime();
+	event.code = 0;
+	event.action = 0;
+	event.x = 0;
+	event.y = 0;
+	return event;
+}
+
 void input_callback_key(GLFWwindow* window, int key, int scancode, int action, int mods) {
-	if (action == GLFW_PRESS || (Game::current->getSettings()->getKeyboardEventsRepeat() && action == GLFW_REPEAT)) {
-		InputManager::callOnKeyPressed(key);
-	} else if (action == GLFW_RELEASE) {
-		InputManager::callOnKeyReleased(key);
-		InputManager::callOnKeyTyped(key);
-	}
+	InputEvent event = input_createEvent(INPUT_EVENT_KEY);
+	event.code = key;
+	event.action = action;
+	InputManager::queueEvent(event);
 }
 
 void input_callback_char(GLFWwindow* window, unsigned int codepoint) {
-	InputManager::callOnChar(codepoint, (char) codepoint);
+	InputEvent event = input_createEvent(INPUT_EVENT_CHAR);
+	event.code = codepoint;
+	InputManager::queueEvent(event);
 }
 
 void input_callback_mouseButton(GLFWwindow* window, int button, int action, int mods) {
-	if (action == GLFW_PRESS || (Game::current->getSettings()->getMouseEventsRepeat() && action == GLFW_REPEAT)) {
-		if (button == GLFW_MOUSE_BUTTON_LEFT)
-			Mouse::leftButtonDown = true;
-		else if (button == GLFW_MOUSE_BUTTON_MIDDLE)
-			Mouse::middleButtonDown = true;
-		else if (button == GLFW_MOUSE_BUTTON_RIGHT)
-			Mouse::rightMouseDown = true;
-		InputManager::callOnMousePressed(button);
-	} else if (action == GLFW_RELEASE) {
-		if (button == GLFW_MOUSE_BUTTON_LEFT)
-			Mouse::leftButtonDown = false;
-		else if (button == GLFW_MOUSE_BUTTON_MIDDLE)
-			Mouse::middleButtonDown = false;
-		else if (button == GLFW_MOUSE_BUTTON_RIGHT)
-			Mouse::rightMouseDown = false;
-		InputManager::callOnMouseReleased(button);
-		InputManager::callOnMouseClicked(button);
-	}
+	InputEvent event = input_createEvent(INPUT_EVENT_MOUSE_BUTTON);
+	event.code = button;
+	event.action = action;
+	InputManager::queueEvent(event);
 }
 
 void input_callback_cursorPosition(GLFWwindow* window, double xpos, double ypos) {
-	double xOffset = xpos - Mouse::lastX;
-	double yOffset = ypos - Mouse::lastY;
-	if (Mouse::lastX == -1) {
-		xOffset = 0;
-		yOffset = 0;
-	}
-	Mouse::lastX = xpos;
-	Mouse::lastY = ypos;
-
-	InputManager::callOnMouseMoved(xpos, ypos, xOffset, yOffset);
-
-	if (Mouse::leftButtonDown)
-		InputManager::callOnMouseDragged(xpos, ypos, xOffset, yOffset);
+	InputEvent event = input_createEvent(INPUT_EVENT_CURSOR_POSITION);
+	event.x = xpos;
+	event.y = ypos;
+	InputManager::queueEvent(event);
 }
 
 void input_callback_cursorEnter(GLFWwindow* window, int entered) {
-	if (entered)
-		InputManager::callOnMouseEnter();
-	else
-		InputManager::callOnMouseLeave();
+	InputEvent event = input_createEvent(INPUT_EVENT_CURSOR_ENTER);
+	event.code = entered;
+	InputManager::queueEvent(event);
 }
 
 void input_callback_scroll(GLFWwindow* window, double xoffset, double yoffset) {
-	InputManager::callOnScroll(xoffset, yoffset);
+	InputEvent event = input_createEvent(INPUT_EVENT_SCROLL);
+	event.x = xoffset;
+	event.y = yoffset;
+	InputManager::queueEvent(event);
 }
 
 /***************************************************************************************************/
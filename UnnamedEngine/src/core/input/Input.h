@@ -26,6 +26,9 @@
 #include <algorithm>
 #include <iostream>
 
+#include "InputEventQueue.h"
+#include "InputRecording.h"
+
 /***************************************************************************************************
  * The Mouse class
  ***************************************************************************************************/
@@ -72,7 +75,54 @@ class InputListener;
 class InputManager {
 private:
 	static std::vector<InputListener*> m_listeners;
+
+	/* The events received from the window that are waiting to be dispatched */
+	static InputEventQueue m_queue;
+
+	/* Only the last of several cursor movements in a row is dispatched, with the offset covering
+	 * all of them, when this is enabled */
+	static bool m_coalesceMouseMoves;
+	static bool m_hasPendingMove;
+	static InputEvent m_pendingMove;
+
+	/* The recording dispatched events are added to, if any */
+	static InputRecording* m_recording;
+
+	/* The recording being played back, the next event to play and the time playing started */
+	static InputRecording* m_playback;
+	static unsigned int m_playbackIndex;
+	static double m_playbackStart;
+
+	static void processEvent(InputEvent& event);
+	static void dispatchPendingMove();
+	static void dispatchEvent(InputEvent& event);
 public:
+	/* Adds an event to be dispatched later, this is called by the window callbacks and should
+	 * only be called from one thread */
+	static void queueEvent(InputEvent event);
+
+	/* Dispatches all of the events that have been queued so far, called once a frame by the Game
+	 * after polling the window, or from the single thread that consumes the input */
+	static void dispatchEvents();
+
+	/* Starts adding every dispatched event to the recording given, until stopRecording() */
+	static inline void startRecording(InputRecording* recording) { m_recording = recording; }
+	static inline void stopRecording() { m_recording = NULL; }
+
+	/* Plays back a recording, dispatching its events as the same amount of time passes as when
+	 * they were recorded */
+	static void play(InputRecording* recording);
+	static inline void stopPlaying() { m_playback = NULL; }
+	static inline bool isPlaying() { return m_playback != NULL; }
+
+	/* Dispatches every event in a recording straight away, so the result doesn't depend on
+	 * timing (e.g. when testing without a window) */
+	static void replay(InputRecording* recording);
+
+	static inline void setCoalesceMouseMoves(bool coalesceMouseMoves) { m_coalesceMouseMoves = coalesceMouseMoves; }
+	static inline bool getCoalesceMouseMoves() { return m_coalesceMouseMoves; }
+	static inline InputEventQueue& getQueue() { return m_queue; }
+
 	static inline void addListener(InputListener* listener) { m_listeners.push_back(listener); }
 	static inline void removeListener(InputListener* listener) { m_listeners.erase(std::remove(m_listeners.begin(), m_listeners.end(), listener), m_listeners.end()); }
 	static void callOnKeyPressed(int code);
@@ -125,6 +175,7 @@ public:
  * The various input callbacks
  ***************************************************************************************************/
 
+InputEvent input_createEvent(InputEventType type);
 void input_callback_key(GLFWwindow* window, int key, int scancode, int action, int mods);
 void input_callback_char(GLFWwindow* winodw, unsigned int codepoint);
 void input_callback_cursorPosition(GLFWwindow* window, double xpos, double ypos);
@@ -0,0 +1,60 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include "InputEventQueue.h"
+
+/***************************************************************************************************
+ * The InputEventQueue class
+ ***************************************************************************************************/
+
+InputEventQueue::InputEventQueue(unsigned int capacity) {
+	//Round the capacity up to the next power of 2
+	unsigned int size = 1;
+	while (size < capacity)
+		size <<= 1;
+	m_events.resize(size);
+	m_mask = size - 1;
+	m_head.store(0, std::memory_order_relaxed);
+	m_tail.store(0, std::memory_order_relaxed);
+	m_numDropped = 0;
+}
+
+bool InputEventQueue::push(const InputEvent& event) {
+	unsigned int head = m_head.load(std::memory_order_relaxed);
+	//The indices only ever increase, so the difference is the number of events in the queue
+	if (head - m_tail.load(std::memory_order_acquire) > m_mask) {
+		m_numDropped++;
+		return false;
+	}
+	m_events[head & m_mask] = event;
+	//Publish the event only once it has been written
+	m_head.store(head + 1, std::memory_order_release);
+	return true;
+}
+
+bool InputEventQueue::pop(InputEvent& event) {
+	unsigned int tail = m_tail.load(std::memory_order_relaxed);
+	if (tail == m_head.load(std::memory_order_acquire))
+		return false;
+	event = m_events[tail & m_mask];
+	//Let the producer reuse the slot only once it has been read
+	m_tail.store(tail + 1, std::memory_order_release);
+	return true;
+}
+
+/***************************************************************************************************/
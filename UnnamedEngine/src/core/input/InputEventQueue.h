@@ -0,0 +1,97 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef CORE_INPUT_INPUTEVENTQUEUE_H_
+#define CORE_INPUT_INPUTEVENTQUEUE_H_
+
+#include <vector>
+#include <atomic>
+
+/***************************************************************************************************
+ * The InputEventType enum
+ ***************************************************************************************************/
+
+enum InputEventType {
+	INPUT_EVENT_KEY,
+	INPUT_EVENT_CHAR,
+	INPUT_EVENT_MOUSE_BUTTON,
+	INPUT_EVENT_CURSOR_POSITION,
+	INPUT_EVENT_CURSOR_ENTER,
+	INPUT_EVENT_SCROLL
+};
+
+/***************************************************************************************************/
+
+/***************************************************************************************************
+ * The InputEvent structure stores a single event as it was received from the window, the values
+ * that are used depend on its type
+ ***************************************************************************************************/
+
+struct InputEvent {
+	InputEventType type;
+	/* The time the event was received in seconds */
+	double time;
+	/* The key, character or button along with the action (e.g. GLFW_PRESS) */
+	int code;
+	int action;
+	/* The cursor position or the scroll offsets */
+	double x;
+	double y;
+};
+
+/***************************************************************************************************/
+
+/***************************************************************************************************
+ * The InputEventQueue class is a lock free ring buffer that allows input events to be added by
+ * one thread and removed by another, so the events from the window callbacks can be handled at a
+ * fixed point in the frame or on another thread
+ ***************************************************************************************************/
+
+class InputEventQueue {
+private:
+	std::vector<InputEvent> m_events;
+	/* The capacity is a power of 2 so the indices can be wrapped with a mask */
+	unsigned int m_mask;
+
+	/* The index of the next event to add, only changed by the producer, and the index of the
+	 * next event to remove, only changed by the consumer. These are kept on separate cache lines
+	 * so the two threads don't keep invalidating each other's cache */
+	alignas(64) std::atomic<unsigned int> m_head;
+	alignas(64) std::atomic<unsigned int> m_tail;
+
+	/* The number of events that have been dropped because the queue was full */
+	unsigned int m_numDropped;
+public:
+	InputEventQueue(unsigned int capacity);
+	virtual ~InputEventQueue() {}
+
+	/* Adds an event, returns false if the queue is full, should only be called by the producer */
+	bool push(const InputEvent& event);
+
+	/* Removes the oldest event, returns false if there isn't one, should only be called by the
+	 * consumer */
+	bool pop(InputEvent& event);
+
+	inline bool isEmpty() { return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire); }
+	inline unsigned int getCapacity() { return m_mask + 1; }
+	inline unsigned int getNumDropped() { return m_numDropped; }
+};
+
+/***************************************************************************************************/
+
+#endif /* CORE_INPUT_INPUTEVENTQUEUE_H_ */
@@ -0,0 +1,89 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <fstream>
+
+#include "InputRecording.h"
+#include "../../utils/Logging.h"
+
+/***************************************************************************************************
+ * The InputRecording class
+ ***************************************************************************************************/
+
+bool InputRecording::save(std::string path) {
+	std::ofstream output(path.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+	if (! output.is_open()) {
+		logError("Unable to write the input recording '" + path + "'");
+		return false;
+	}
+	unsigned int magic = FILE_MAGIC;
+	unsigned int version = FILE_VERSION;
+	unsigned int count = m_events.size();
+	output.write((char*) &magic, sizeof(magic));
+	output.write((char*) &version, sizeof(version));
+	output.write((char*) &count, sizeof(count));
+	if (count > 0)
+		output.write((char*) &m_events.front(), count * sizeof(InputEvent));
+	output.close();
+	return true;
+}
+
+bool InputRecording::load(std::string path) {
+	std::ifstream input(path.c_str(), std::ios::in | std::ios::binary);
+	if (! input.is_open()) {
+		logError("Unable to read the input recording '" + path + "'");
+		return false;
+	}
+	unsigned int magic = 0;
+	unsigned int version = 0;
+	unsigned int count = 0;
+	input.read((char*) &magic, sizeof(magic));
+	input.read((char*) &version, sizeof(version));
+	input.read((char*) &count, sizeof(count));
+	if (magic != FILE_MAGIC || version != FILE_VERSION) {
+		logError("The file '" + path + "' is not a supported input recording");
+		return false;
+	}
+	//The count is checked against the size of the file so a damaged one can't allocate too much
+	std::streampos eventsStart = input.tellg();
+	input.seekg(0, std::ios::end);
+	unsigned long long remaining = (unsigned long long) (input.tellg() - eventsStart);
+	input.seekg(eventsStart);
+	if ((unsigned long long) count * sizeof(InputEvent) > remaining) {
+		logError("The input recording '" + path + "' is incomplete");
+		m_events.clear();
+		return false;
+	}
+	m_events.resize(count);
+	if (count > 0)
+		input.read((char*) &m_events.front(), count * sizeof(InputEvent));
+	if (! input) {
+		logError("The input recording '" + path + "' is incomplete");
+		m_events.clear();
+		return false;
+	}
+	return true;
+}
+
+double InputRecording::getDuration() {
+	if (m_events.size() < 2)
+		return 0;
+	return m_events.back().time - m_events.front().time;
+}
+
+/***************************************************************************************************/
@@ -0,0 +1,60 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef CORE_INPUT_INPUTRECORDING_H_
+#define CORE_INPUT_INPUTRECORDING_H_
+
+#include <string>
+#include <vector>
+
+#include "InputEventQueue.h"
+
+/***************************************************************************************************
+ * The InputRecording class stores a stream of input events so that it can be saved and then
+ * played back through the InputManager later, e.g. to reproduce a bug or to drive a test without
+ * a window
+ ***************************************************************************************************/
+
+class InputRecording {
+private:
+	std::vector<InputEvent> m_events;
+
+	/* Written at the start of a saved recording to identify it, the second value is the version */
+	static const unsigned int FILE_MAGIC   = 0x52504E49;
+	static const unsigned int FILE_VERSION = 1;
+public:
+	InputRecording() {}
+	virtual ~InputRecording() {}
+
+	inline void add(const InputEvent& event) { m_events.push_back(event); }
+	inline void clear() { m_events.clear(); }
+
+	/* Saves or loads the events in a binary file, returns whether this was successful */
+	bool save(std::string path);
+	bool load(std::string path);
+
+	/* Returns the time between the first and last events in seconds */
+	double getDuration();
+
+	inline std::vector<InputEvent>& getEvents() { return m_events; }
+	inline unsigned int getNumEvents() { return m_events.size(); }
+};
+
+/***************************************************************************************************/
+
+#endif /* CORE_INPUT_INPUTRECORDING_H_ */
@@ -76,6 +76,13 @@ public:
 		InputListener::addListener();
 	}
 
+	/* Creates shortcuts that are only checked when key events are passed on to them, instead of
+	 * listening for every key event */
+	KeyboardShortcuts(bool listen) {
+		if (listen)
+			InputListener::addListener();
+	}
+
 	void add(KeyboardShortcut* instance);
 	inline void addListener(KeyboardShortcutListener* listener) { listeners.push_back(listener); }
 	void callOnShortcut(KeyboardShortcut* e);
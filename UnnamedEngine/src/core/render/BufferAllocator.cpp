@@ -0,0 +1,269 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#include "BufferAllocator.h"
+
+/***************************************************************************************************
+ * The BufferAllocator class
+ ***************************************************************************************************/
+
+/* Returns the index of the lowest and highest bits set in a value that isn't 0 */
+static inline unsigned int getLowestBit(unsigned int value) {
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward(&index, value);
+	return index;
+#else
+	return __builtin_ctz(value);
+#endif
+}
+
+static inline unsigned int getHighestBit(unsigned int value) {
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanReverse(&index, value);
+	return index;
+#else
+	return 31 - __builtin_clz(value);
+#endif
+}
+
+BufferAllocator::BufferAllocator(unsigned int capacity, unsigned int alignment) {
+	m_alignment = alignment > 0 ? alignment : 1;
+	m_capacity = 0;
+	m_used = 0;
+	m_numAllocations = 0;
+	m_numFreeBlocks = 0;
+	m_last = INVALID;
+	m_firstLevelBitmap = 0;
+	for (unsigned int a = 0; a < FIRST_LEVEL_COUNT; a++) {
+		m_secondLevelBitmaps[a] = 0;
+		for (unsigned int b = 0; b < SECOND_LEVEL_COUNT; b++)
+			m_freeLists[a][b] = INVALID;
+	}
+	grow(capacity);
+}
+
+void BufferAllocator::getLists(unsigned int size, unsigned int& firstLevel, unsigned int& secondLevel) {
+	//Small sizes all go in the first list, split linearly
+	if (size < SECOND_LEVEL_COUNT) {
+		firstLevel = 0;
+		secondLevel = size;
+	} else {
+		unsigned int highest = getHighestBit(size);
+		firstLevel = highest - SECOND_LEVEL_BITS + 1;
+		secondLevel = (size >> (highest - SECOND_LEVEL_BITS)) - SECOND_LEVEL_COUNT;
+	}
+}
+
+unsigned int BufferAllocator::createBlock(unsigned int offset, unsigned int size) {
+	Block block;
+	block.offset = offset;
+	block.size = size;
+	block.previous = INVALID;
+	block.next = INVALID;
+	block.previousFree = INVALID;
+	block.nextFree = INVALID;
+	block.free = false;
+
+	if (! m_unusedBlocks.empty()) {
+		unsigned int index = m_unusedBlocks.back();
+		m_unusedBlocks.pop_back();
+		m_blocks[index] = block;
+		return index;
+	}
+	m_blocks.push_back(block);
+	return m_blocks.size() - 1;
+}
+
+void BufferAllocator::insertFree(unsigned int index) {
+	Block& block = m_blocks[index];
+	unsigned int firstLevel, secondLevel;
+	getLists(block.size, firstLevel, secondLevel);
+
+	block.free = true;
+	block.previousFree = INVALID;
+	block.nextFree = m_freeLists[firstLevel][secondLevel];
+	if (block.nextFree != INVALID)
+		m_blocks[block.nextFree].previousFree = index;
+	m_freeLists[firstLevel][secondLevel] = index;
+
+	m_firstLevelBitmap |= 1u << firstLevel;
+	m_secondLevelBitmaps[firstLevel] |= 1u << secondLevel;
+	m_numFreeBlocks++;
+}
+
+void BufferAllocator::removeFree(unsigned int index) {
+	Block& block = m_blocks[index];
+	unsigned int firstLevel, secondLevel;
+	getLists(block.size, firstLevel, secondLevel);
+
+	if (block.previousFree != INVALID)
+		m_blocks[block.previousFree].nextFree = block.nextFree;
+	else
+		m_freeLists[firstLevel][secondLevel] = block.nextFree;
+	if (block.nextFree != INVALID)
+		m_blocks[block.nextFree].previousFree = block.previousFree;
+
+	//Clear the bits for any lists that are now empty
+	if (m_freeLists[firstLevel][secondLevel] == INVALID) {
+		m_secondLevelBitmaps[firstLevel] &= ~(1u << secondLevel);
+		if (m_secondLevelBitmaps[firstLevel] == 0)
+			m_firstLevelBitmap &= ~(1u << firstLevel);
+	}
+
+	block.free = false;
+	block.previousFree = INVALID;
+	block.nextFree = INVALID;
+	m_numFreeBlocks--;
+}
+
+unsigned int BufferAllocator::mergeWithPrevious(unsigned int index) {
+	unsigned int previous = m_blocks[index].previous;
+	unsigned int next = m_blocks[index].next;
+	m_blocks[previous].size += m_blocks[index].size;
+	m_blocks[previous].next = next;
+	if (next != INVALID)
+		m_blocks[next].previous = previous;
+	if (m_last == index)
+		m_last = previous;
+	m_unusedBlocks.push_back(index);
+	return previous;
+}
+
+bool BufferAllocator::allocate(unsigned int size, Allocation& allocation) {
+	unsigned int units = (size + m_alignment - 1) / m_alignment;
+	if (units == 0)
+		units = 1;
+
+	//Round the size up to the start of the next list, so any block in the list found fits
+	unsigned int search = units;
+	if (search >= SECOND_LEVEL_COUNT) {
+		unsigned int round = (1u << (getHighestBit(search) - SECOND_LEVEL_BITS)) - 1;
+		if (search > 0xFFFFFFFF - round)
+			return false;
+		search += round;
+	}
+	unsigned int firstLevel, secondLevel;
+	getLists(search, firstLevel, secondLevel);
+
+	//Look for a list in the same first level with larger blocks, then in the larger first levels
+	unsigned int secondLevelBitmap = m_secondLevelBitmaps[firstLevel] & (0xFFFFFFFF << secondLevel);
+	if (secondLevelBitmap == 0) {
+		unsigned int firstLevelBitmap = firstLevel + 1 < 32 ? m_firstLevelBitmap & (0xFFFFFFFF << (firstLevel + 1)) : 0;
+		if (firstLevelBitmap == 0)
+			return false;
+		firstLevel = getLowestBit(firstLevelBitmap);
+		secondLevelBitmap = m_secondLevelBitmaps[firstLevel];
+	}
+	secondLevel = getLowestBit(secondLevelBitmap);
+	unsigned int index = m_freeLists[firstLevel][secondLevel];
+	removeFree(index);
+
+	//Split off whatever isn't needed so it can be used by something else
+	if (m_blocks[index].size > units) {
+		unsigned int remaining = createBlock(m_blocks[index].offset + units, m_blocks[index].size - units);
+		m_blocks[remaining].previous = index;
+		m_blocks[remaining].next = m_blocks[index].next;
+		if (m_blocks[index].next != INVALID)
+			m_blocks[m_blocks[index].next].previous = remaining;
+		m_blocks[index].next = remaining;
+		m_blocks[index].size = units;
+		if (m_last == index)
+			m_last = remaining;
+		insertFree(remaining);
+	}
+
+	m_used += units;
+	m_numAllocations++;
+
+	allocation.offset = m_blocks[index].offset * m_alignment;
+	allocation.size = units * m_alignment;
+	allocation.block = index;
+	return true;
+}
+
+void BufferAllocator::free(Allocation& allocation) {
+	if (! allocation.isValid())
+		return;
+	unsigned int index = allocation.block;
+	m_used -= m_blocks[index].size;
+	m_numAllocations--;
+
+	//Merge with the free blocks either side so they can be used by larger allocations
+	unsigned int previous = m_blocks[index].previous;
+	if (previous != INVALID && m_blocks[previous].free) {
+		removeFree(previous);
+		index = mergeWithPrevious(index);
+	}
+	unsigned int next = m_blocks[index].next;
+	if (next != INVALID && m_blocks[next].free) {
+		removeFree(next);
+		mergeWithPrevious(next);
+	}
+	insertFree(index);
+
+	allocation = Allocation();
+}
+
+void BufferAllocator::grow(unsigned int capacity) {
+	unsigned int units = capacity / m_alignment;
+	if (units <= m_capacity)
+		return;
+	unsigned int added = units - m_capacity;
+
+	if (m_last != INVALID && m_blocks[m_last].free) {
+		removeFree(m_last);
+		m_blocks[m_last].size += added;
+		insertFree(m_last);
+	} else {
+		unsigned int index = createBlock(m_capacity, added);
+		m_blocks[index].previous = m_last;
+		if (m_last != INVALID)
+			m_blocks[m_last].next = index;
+		m_last = index;
+		insertFree(index);
+	}
+	m_capacity = units;
+}
+
+unsigned int BufferAllocator::getLargestFree() {
+	if (m_firstLevelBitmap == 0)
+		return 0;
+	//The largest block is in the highest list that isn't empty, but not always first in it
+	unsigned int firstLevel = getHighestBit(m_firstLevelBitmap);
+	unsigned int secondLevel = getHighestBit(m_secondLevelBitmaps[firstLevel]);
+	unsigned int largest = 0;
+	for (unsigned int index = m_freeLists[firstLevel][secondLevel]; index != INVALID; index = m_blocks[index].nextFree) {
+		if (m_blocks[index].size > largest)
+			largest = m_blocks[index].size;
+	}
+	return largest * m_alignment;
+}
+
+float BufferAllocator::getFragmentation() {
+	unsigned int free = getCapacity() - getUsed();
+	if (free == 0)
+		return 0.0f;
+	return 1.0f - ((float) getLargestFree() / (float) free);
+}
+
+/***************************************************************************************************/
@@ -0,0 +1,120 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+#ifndef CORE_RENDER_BUFFERALLOCATOR_H_
+#define CORE_RENDER_BUFFERALLOCATOR_H_
+
+#include <vector>
+
+/***************************************************************************************************
+ * The BufferAllocator class hands out ranges of a larger buffer using a two level segregated fit
+ * (TLSF) allocator. Free ranges are kept in lists by their size, with bitmaps of the lists that
+ * aren't empty, so allocating and freeing take the same time however many ranges there are. It
+ * only keeps track of offsets, so it doesn't need an OpenGL context
+ ***************************************************************************************************/
+
+class BufferAllocator {
+public:
+	/* The value used for a block that doesn't exist */
+	static const unsigned int INVALID = 0xFFFFFFFF;
+
+	/* A range that has been allocated, the offset and size are in bytes */
+	struct Allocation {
+		unsigned int offset;
+		unsigned int size;
+		unsigned int block;
+
+		Allocation() : offset(0), size(0), block(INVALID) {}
+		inline bool isValid() const { return block != INVALID; }
+	};
+private:
+	/* Each first level list covers sizes between two powers of two, and is split into this many
+	 * second level lists */
+	static const unsigned int SECOND_LEVEL_BITS = 4;
+	static const unsigned int SECOND_LEVEL_COUNT = 1 << SECOND_LEVEL_BITS;
+	static const unsigned int FIRST_LEVEL_COUNT = 32 - SECOND_LEVEL_BITS + 1;
+
+	/* A range of the buffer, its offset and size are in units of the alignment */
+	struct Block {
+		unsigned int offset;
+		unsigned int size;
+		/* The blocks either side of this one in the buffer */
+		unsigned int previous;
+		unsigned int next;
+		/* The blocks either side of this one in its free list */
+		unsigned int previousFree;
+		unsigned int nextFree;
+		bool free;
+	};
+
+	std::vector<Block> m_blocks;
+	/* The blocks that have been merged into others and can be reused */
+	std::vector<unsigned int> m_unusedBlocks;
+	/* The block at the end of the buffer */
+	unsigned int m_last;
+
+	unsigned int m_firstLevelBitmap;
+	unsigned int m_secondLevelBitmaps[FIRST_LEVEL_COUNT];
+	unsigned int m_freeLists[FIRST_LEVEL_COUNT][SECOND_LEVEL_COUNT];
+
+	unsigned int m_alignment;
+	unsigned int m_capacity;
+	unsigned int m_used;
+	unsigned int m_numAllocations;
+	unsigned int m_numFreeBlocks;
+
+	/* Returns the lists a block of a size (in units) belongs in */
+	static void getLists(unsigned int size, unsigned int& firstLevel, unsigned int& secondLevel);
+
+	unsigned int createBlock(unsigned int offset, unsigned int size);
+	void insertFree(unsigned int block);
+	void removeFree(unsigned int block);
+	/* Merges a block into the one before it in the buffer, returning the one before it */
+	unsigned int mergeWithPrevious(unsigned int block);
+public:
+	/* Creates an allocator for a buffer with a size in bytes, every allocation starts at a multiple
+	 * of the alignment and takes up a whole number of them */
+	BufferAllocator(unsigned int capacity, unsigned int alignment);
+	virtual ~BufferAllocator() {}
+
+	/* Allocates a range of a size in bytes, returning false if there isn't a free range large
+	 * enough for it */
+	bool allocate(unsigned int size, Allocation& allocation);
+
+	/* Frees a range so it can be used again, merging it with any free ranges next to it */
+	void free(Allocation& allocation);
+
+	/* Adds space onto the end of the buffer, after it has been made larger */
+	void grow(unsigned int capacity);
+
+	/* Returns the size of the largest range that could be allocated in bytes */
+	unsigned int getLargestFree();
+
+	/* Returns how much of the free space can't be used by a single allocation, between 0 when it
+	 * is all in one range and 1 */
+	float getFragmentation();
+
+	inline unsigned int getAlignment() { return m_alignment; }
+	inline unsigned int getCapacity() { return m_capacity * m_alignment; }
+	inline unsigned int getUsed() { return m_used * m_alignment; }
+	inline unsigned int getNumAllocations() { return m_numAllocations; }
+	inline unsigned int getNumFreeBlocks() { return m_numFreeBlocks; }
+};
+
+/***************************************************************************************************/
+
+#endif /* CORE_RENDER_BUFFERALLOCATOR_H_ */
@@ -0,0 +1,113 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include "GLState.h"
+
+/***************************************************************************************************
+ * The GLState class
+ ***************************************************************************************************/
+
+GLuint GLState::m_program = GLState::UNKNOWN;
+GLuint GLState::m_vertexArray = GLState::UNKNOWN;
+GLuint GLState::m_arrayBuffer = GLState::UNKNOWN;
+GLuint GLState::m_activeTextureUnit = GLState::UNKNOWN;
+GLuint GLState::m_textures2D[GLState::MAX_TEXTURE_UNITS];
+GLuint GLState::m_texturesCubeMap[GLState::MAX_TEXTURE_UNITS];
+GLuint GLState::m_samplers[GLState::MAX_TEXTURE_UNITS];
+GLuint GLState::m_capabilities[GLState::CAPABILITY_COUNT];
+GLuint GLState::m_blendSource = GLState::UNKNOWN;
+GLuint GLState::m_blendDestination = GLState::UNKNOWN;
+GLuint GLState::m_depthMask = GLState::UNKNOWN;
+GLuint GLState::m_depthFunc = GLState::UNKNOWN;
+
+void GLState::reset() {
+	m_program = UNKNOWN;
+	m_vertexArray = UNKNOWN;
+	m_arrayBuffer = UNKNOWN;
+	m_activeTextureUnit = UNKNOWN;
+	for (unsigned int a = 0; a < MAX_TEXTURE_UNITS; a++) {
+		m_textures2D[a] = UNKNOWN;
+		m_texturesCubeMap[a] = UNKNOWN;
+		m_samplers[a] = UNKNOWN;
+	}
+	for (unsigned int a = 0; a < CAPABILITY_COUNT; a++)
+		m_capabilities[a] = UNKNOWN;
+	m_blendSource = UNKNOWN;
+	m_blendDestination = UNKNOWN;
+	m_depthMask = UNKNOWN;
+	m_depthFunc = UNKNOWN;
+}
+
+GLuint* GLState::getCapability(GLenum capability) {
+	switch (capability) {
+		case GL_BLEND:                       return &m_capabilities[CAPABILITY_BLEND];
+		case GL_DEPTH_TEST:                  return &m_capabilities[CAPABILITY_DEPTH_TEST];
+		case GL_CULL_FACE:                   return &m_capabilities[CAPABILITY_CULL_FACE];
+		case GL_TEXTURE_CUBE_MAP_SEAMLESS:   return &m_capabilities[CAPABILITY_TEXTURE_CUBE_MAP_SEAMLESS];
+		default:                             return NULL;
+	}
+}
+
+GLuint* GLState::getTexture(GLenum target) {
+	//The unit is unknown until activeTexture() has been called
+	if (m_activeTextureUnit >= MAX_TEXTURE_UNITS)
+		return NULL;
+	if (target == GL_TEXTURE_2D)
+		return &m_textures2D[m_activeTextureUnit];
+	else if (target == GL_TEXTURE_CUBE_MAP)
+		return &m_texturesCubeMap[m_activeTextureUnit];
+	return NULL;
+}
+
+void GLState::deleteProgram(GLuint program) {
+	if (m_program == program)
+		m_program = 0;
+	glDeleteProgram(program);
+}
+
+void GLState::deleteVertexArray(GLuint vertexArray) {
+	if (m_vertexArray == vertexArray)
+		m_vertexArray = 0;
+	glDeleteVertexArrays(1, &vertexArray);
+}
+
+void GLState::deleteBuffer(GLuint buffer) {
+	if (m_arrayBuffer == buffer)
+		m_arrayBuffer = 0;
+	glDeleteBuffers(1, &buffer);
+}
+
+void GLState::deleteTexture(GLuint texture) {
+	for (unsigned int a = 0; a < MAX_TEXTURE_UNITS; a++) {
+		if (m_textures2D[a] == texture)
+			m_textures2D[a] = 0;
+		if (m_texturesCubeMap[a] == texture)
+			m_texturesCubeMap[a] = 0;
+	}
+	glDeleteTextures(1, &texture);
+}
+
+void GLState::deleteSampler(GLuint sampler) {
+	for (unsigned int a = 0; a < MAX_TEXTURE_UNITS; a++) {
+		if (m_samplers[a] == sampler)
+			m_samplers[a] = 0;
+	}
+	glDeleteSamplers(1, &sampler);
+}
+
+/***************************************************************************************************/
@@ -0,0 +1,193 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef CORE_RENDER_GLSTATE_H_
+#define CORE_RENDER_GLSTATE_H_
+
+#include <windows.h>
+#include <GL/GLEW/glew.h>
+
+#include "RenderStats.h"
+
+/***************************************************************************************************
+ * The GLState class shadows the OpenGL state the engine changes while rendering, so calls that
+ * wouldn't change anything are skipped. The state is unknown to begin with, so the first call for
+ * each value is always made. Anything that changes the state directly instead of going through this
+ * class should call reset() afterwards
+ ***************************************************************************************************/
+
+class GLState {
+public:
+	/* The number of texture units that are shadowed, binds to others are always made */
+	static const unsigned int MAX_TEXTURE_UNITS = 32;
+private:
+	/* The value used for anything whose state isn't known */
+	static const GLuint UNKNOWN = 0xFFFFFFFF;
+
+	/* The capabilities that are shadowed, others are always changed */
+	enum Capability {
+		CAPABILITY_BLEND,
+		CAPABILITY_DEPTH_TEST,
+		CAPABILITY_CULL_FACE,
+		CAPABILITY_TEXTURE_CUBE_MAP_SEAMLESS,
+		CAPABILITY_COUNT
+	};
+
+	static GLuint m_program;
+	static GLuint m_vertexArray;
+	static GLuint m_arrayBuffer;
+	static GLuint m_activeTextureUnit;
+
+	/* The 2D and cube map textures bound to each unit */
+	static GLuint m_textures2D[MAX_TEXTURE_UNITS];
+	static GLuint m_texturesCubeMap[MAX_TEXTURE_UNITS];
+	static GLuint m_samplers[MAX_TEXTURE_UNITS];
+
+	static GLuint m_capabilities[CAPABILITY_COUNT];
+	static GLuint m_blendSource;
+	static GLuint m_blendDestination;
+	static GLuint m_depthMask;
+	static GLuint m_depthFunc;
+
+	/* Returns the shadowed value for a capability, or NULL if it isn't shadowed */
+	static GLuint* getCapability(GLenum capability);
+
+	/* Returns the shadowed value for a texture bound to the active unit, or NULL if it isn't
+	 * shadowed */
+	static GLuint* getTexture(GLenum target);
+
+	/* Updates a shadowed value, returning whether it changed */
+	static inline bool change(GLuint& current, GLuint value) {
+		if (current == value) {
+			RenderStats::increment(RENDER_STAT_STATE_CHANGES_SKIPPED);
+			return false;
+		}
+		current = value;
+		RenderStats::increment(RENDER_STAT_STATE_CHANGES);
+		return true;
+	}
+public:
+	/* Forgets the shadowed state so the next call for each value is made */
+	static void reset();
+
+	/* The methods that change the state, each returns whether the call was made */
+	static inline bool useProgram(GLuint program) {
+		if (! change(m_program, program))
+			return false;
+		glUseProgram(program);
+		RenderStats::increment(RENDER_STAT_SHADER_SWITCHES);
+		return true;
+	}
+	static inline bool bindVertexArray(GLuint vertexArray) {
+		if (! change(m_vertexArray, vertexArray))
+			return false;
+		glBindVertexArray(vertexArray);
+		return true;
+	}
+	/* Element array buffers are part of the state of the vertex array bound, so they are always
+	 * bound */
+	static inline bool bindBuffer(GLenum target, GLuint buffer) {
+		if (target == GL_ARRAY_BUFFER && ! change(m_arrayBuffer, buffer))
+			return false;
+		glBindBuffer(target, buffer);
+		return true;
+	}
+	static inline bool activeTexture(GLuint unit) {
+		if (! change(m_activeTextureUnit, unit))
+			return false;
+		glActiveTexture(GL_TEXTURE0 + unit);
+		return true;
+	}
+	/* Binds a texture to the active unit */
+	static inline bool bindTexture(GLenum target, GLuint texture) {
+		GLuint* current = getTexture(target);
+		if (current != NULL && ! change(*current, texture))
+			return false;
+		glBindTexture(target, texture);
+		RenderStats::increment(RENDER_STAT_TEXTURE_BINDS);
+		return true;
+	}
+	static inline bool bindTexture(GLuint unit, GLenum target, GLuint texture) {
+		activeTexture(unit);
+		return bindTexture(target, texture);
+	}
+	/* Binds a sampler to a unit, 0 uses the parameters of the texture instead */
+	static inline bool bindSampler(GLuint unit, GLuint sampler) {
+		if (unit < MAX_TEXTURE_UNITS && ! change(m_samplers[unit], sampler))
+			return false;
+		glBindSampler(unit, sampler);
+		return true;
+	}
+	static inline bool setEnabled(GLenum capability, bool enabled) {
+		GLuint* current = getCapability(capability);
+		if (current != NULL && ! change(*current, enabled))
+			return false;
+		if (enabled)
+			glEnable(capability);
+		else
+			glDisable(capability);
+		return true;
+	}
+	static inline bool enable(GLenum capability) { return setEnabled(capability, true); }
+	/* Returns whether a capability is enabled, only asking OpenGL when it isn't known */
+	static inline bool isEnabled(GLenum capability) {
+		GLuint* current = getCapability(capability);
+		if (current == NULL || *current == UNKNOWN)
+			return glIsEnabled(capability) == GL_TRUE;
+		return *current != 0;
+	}
+	static inline bool disable(GLenum capability) { return setEnabled(capability, false); }
+	static inline bool blendFunc(GLenum source, GLenum destination) {
+		//Both are always compared so neither is counted as skipped when only one changes
+		if (m_blendSource == source && m_blendDestination == destination) {
+			RenderStats::increment(RENDER_STAT_STATE_CHANGES_SKIPPED);
+			return false;
+		}
+		m_blendSource = source;
+		m_blendDestination = destination;
+		RenderStats::increment(RENDER_STAT_STATE_CHANGES);
+		glBlendFunc(source, destination);
+		return true;
+	}
+	static inline bool depthMask(bool mask) {
+		if (! change(m_depthMask, mask))
+			return false;
+		glDepthMask(mask);
+		return true;
+	}
+	static inline bool depthFunc(GLenum func) {
+		if (! change(m_depthFunc, func))
+			return false;
+		glDepthFunc(func);
+		return true;
+	}
+
+	/* Deletes objects, forgetting them wherever they are bound as OpenGL unbinds them */
+	static void deleteProgram(GLuint program);
+	static void deleteVertexArray(GLuint vertexArray);
+	static void deleteBuffer(GLuint buffer);
+	static void deleteTexture(GLuint texture);
+	static void deleteSampler(GLuint sampler);
+
+	static inline GLuint getProgram() { return m_program; }
+	static inline GLuint getVertexArray() { return m_vertexArray; }
+};
+
+/***************************************************************************************************/
+
+#endif /* CORE_RENDER_GLSTATE_H_ */
@@ -0,0 +1,112 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+#include <algorithm>
+#include <functional>
+
+#include "IndirectDrawList.h"
+
+/***************************************************************************************************
+ * The IndirectDrawList class
+ ***************************************************************************************************/
+
+bool IndirectDrawList::DrawOrder::operator()(const Draw& a, const Draw& b) const {
+	if (a.format != b.format)
+		return a.format < b.format;
+	if (a.texture != b.texture)
+		return std::less<Texture*>()(a.texture, b.texture);
+	if (a.indexed != b.indexed)
+		return a.indexed;
+	//Keeps the draws in the order they were added within a batch
+	return a.data < b.data;
+}
+
+void IndirectDrawList::clear() {
+	m_draws.clear();
+	m_drawData.clear();
+	m_elementCommands.clear();
+	m_arrayCommands.clear();
+	m_batches.clear();
+}
+
+void IndirectDrawList::addElements(unsigned int format, Texture* texture, unsigned int count, unsigned int firstIndex, int baseVertex, unsigned int data) {
+	Draw draw;
+	draw.format = format;
+	draw.texture = texture;
+	draw.indexed = true;
+	draw.count = count;
+	draw.first = firstIndex;
+	draw.baseVertex = baseVertex;
+	draw.data = data;
+	m_draws.push_back(draw);
+}
+
+void IndirectDrawList::addArrays(unsigned int format, Texture* texture, unsigned int count, unsigned int first, unsigned int data) {
+	Draw draw;
+	draw.format = format;
+	draw.texture = texture;
+	draw.indexed = false;
+	draw.count = count;
+	draw.first = first;
+	draw.baseVertex = 0;
+	draw.data = data;
+	m_draws.push_back(draw);
+}
+
+void IndirectDrawList::build() {
+	m_elementCommands.clear();
+	m_arrayCommands.clear();
+	m_batches.clear();
+	std::sort(m_draws.begin(), m_draws.end(), DrawOrder());
+
+	for (unsigned int a = 0; a < m_draws.size(); a++) {
+		Draw& draw = m_draws[a];
+
+		//Start a new batch whenever something that can't change within a call does
+		if (m_batches.empty() || m_batches.back().format != draw.format || m_batches.back().texture != draw.texture || m_batches.back().indexed != draw.indexed) {
+			Batch batch;
+			batch.format = draw.format;
+			batch.texture = draw.texture;
+			batch.indexed = draw.indexed;
+			batch.firstCommand = draw.indexed ? m_elementCommands.size() : m_arrayCommands.size();
+			batch.numCommands = 0;
+			batch.numVertices = 0;
+			m_batches.push_back(batch);
+		}
+
+		if (draw.indexed) {
+			DrawElementsIndirectCommand command;
+			command.count = draw.count;
+			command.instanceCount = 1;
+			command.firstIndex = draw.first;
+			command.baseVertex = draw.baseVertex;
+			command.baseInstance = draw.data;
+			m_elementCommands.push_back(command);
+		} else {
+			DrawArraysIndirectCommand command;
+			command.count = draw.count;
+			command.instanceCount = 1;
+			command.first = draw.first;
+			command.baseInstance = draw.data;
+			m_arrayCommands.push_back(command);
+		}
+		m_batches.back().numCommands++;
+		m_batches.back().numVertices += draw.count;
+	}
+}
+
+/***************************************************************************************************/
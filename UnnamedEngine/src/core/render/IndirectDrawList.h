@@ -0,0 +1,121 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+#ifndef CORE_RENDER_INDIRECTDRAWLIST_H_
+#define CORE_RENDER_INDIRECTDRAWLIST_H_
+
+#include <vector>
+
+class Texture;
+
+/* The layouts glMultiDrawElementsIndirect and glMultiDrawArraysIndirect read commands in */
+struct DrawElementsIndirectCommand {
+	unsigned int count;
+	unsigned int instanceCount;
+	unsigned int firstIndex;
+	int baseVertex;
+	unsigned int baseInstance;
+};
+
+struct DrawArraysIndirectCommand {
+	unsigned int count;
+	unsigned int instanceCount;
+	unsigned int first;
+	unsigned int baseInstance;
+};
+
+/* The values of a single draw read by the shader, laid out to match the std430 struct in
+ * DrawData.glsl. The matrices are in the same order they are uploaded as uniforms */
+struct DrawData {
+	float modelMatrix[16];
+	float normalMatrix[16];
+	float diffuseColour[4];
+	float shininess;
+	float padding[3];
+};
+
+/***************************************************************************************************
+ * The IndirectDrawList class collects the draws of meshes stored in the MeshBuffers and groups
+ * them into batches that can each be submitted with a single multi draw call. Draws are grouped by
+ * their vertex format and texture, as those are what can't change within a call. It only builds
+ * the commands, so it doesn't need an OpenGL context
+ ***************************************************************************************************/
+
+class IndirectDrawList {
+public:
+	/* A group of commands drawn with one call, the first command is an index into either the
+	 * element or array commands depending on whether it is indexed */
+	struct Batch {
+		unsigned int format;
+		Texture* texture;
+		bool indexed;
+		unsigned int firstCommand;
+		unsigned int numCommands;
+		unsigned int numVertices;
+	};
+private:
+	/* A draw that has been added but not built yet */
+	struct Draw {
+		unsigned int format;
+		Texture* texture;
+		bool indexed;
+		unsigned int count;
+		unsigned int first;
+		int baseVertex;
+		unsigned int data;
+	};
+
+	/* Orders the draws so those that can be in the same batch are next to each other */
+	struct DrawOrder {
+		bool operator()(const Draw& a, const Draw& b) const;
+	};
+
+	std::vector<Draw> m_draws;
+	std::vector<DrawData> m_drawData;
+	std::vector<DrawElementsIndirectCommand> m_elementCommands;
+	std::vector<DrawArraysIndirectCommand> m_arrayCommands;
+	std::vector<Batch> m_batches;
+public:
+	/* Removes everything, keeping the memory to be reused */
+	void clear();
+
+	/* Adds the data for draws and returns its index, so many draws can share it */
+	inline unsigned int addData(const DrawData& data) { m_drawData.push_back(data); return m_drawData.size() - 1; }
+
+	/* Adds a draw of indices starting at an index, offset by a base vertex */
+	void addElements(unsigned int format, Texture* texture, unsigned int count, unsigned int firstIndex, int baseVertex, unsigned int data);
+	inline void addElements(unsigned int format, Texture* texture, unsigned int count, unsigned int firstIndex, int baseVertex, const DrawData& data) { addElements(format, texture, count, firstIndex, baseVertex, addData(data)); }
+
+	/* Adds a draw of vertices starting at a vertex */
+	void addArrays(unsigned int format, Texture* texture, unsigned int count, unsigned int first, unsigned int data);
+	inline void addArrays(unsigned int format, Texture* texture, unsigned int count, unsigned int first, const DrawData& data) { addArrays(format, texture, count, first, addData(data)); }
+
+	/* Sorts the draws and writes their commands and batches. The base instance of each command is
+	 * the index of its data, which is how the shader finds it */
+	void build();
+
+	inline std::vector<DrawData>& getDrawData() { return m_drawData; }
+	inline std::vector<DrawElementsIndirectCommand>& getElementCommands() { return m_elementCommands; }
+	inline std::vector<DrawArraysIndirectCommand>& getArrayCommands() { return m_arrayCommands; }
+	inline std::vector<Batch>& getBatches() { return m_batches; }
+	inline unsigned int getNumDraws() { return m_draws.size(); }
+	inline bool isEmpty() { return m_draws.empty(); }
+};
+
+/***************************************************************************************************/
+
+#endif /* CORE_RENDER_INDIRECTDRAWLIST_H_ */
@@ -23,28 +23,27 @@
  * The Material class
  ***************************************************************************************************/
 
-void Material::addUniforms(Shader* shader) {
-	shader->addUniform("Material_AmbientColour", "material.ambientColour");
-	shader->addUniform("Material_DiffuseColour", "material.diffuseColour");
-	shader->addUniform("Material_SpecularColour", "material.specularColour");
-	shader->addUniform("Material_DiffuseTexture", "material.diffuseTexture");
-	shader->addUniform("Material_SpecularTexture", "material.specularTexture");
-	shader->addUniform("Material_Shininess", "material.shininess");
-}
+/* The names of the uniforms, kept so they aren't allocated for every draw */
+static const std::string MATERIAL_AMBIENT_COLOUR = "material.ambientColour";
+static const std::string MATERIAL_DIFFUSE_COLOUR = "material.diffuseColour";
+static const std::string MATERIAL_SPECULAR_COLOUR = "material.specularColour";
+static const std::string MATERIAL_DIFFUSE_TEXTURE = "material.diffuseTexture";
+static const std::string MATERIAL_SPECULAR_TEXTURE = "material.specularTexture";
+static const std::string MATERIAL_SHININESS = "material.shininess";
 
 void Material::setUniforms(Shader* shader) {
-	shader->setUniform("Material_AmbientColour", m_ambientColour);
-	shader->setUniform("Material_DiffuseColour", m_diffuseColour);
-	shader->setUniform("Material_SpecularColour", m_specularColour);
+	shader->setUniform(MATERIAL_AMBIENT_COLOUR, m_ambientColour);
+	shader->setUniform(MATERIAL_DIFFUSE_COLOUR, m_diffuseColour);
+	shader->setUniform(MATERIAL_SPECULAR_COLOUR, m_specularColour);
 
 	if (m_diffuseTexture == NULL)
-		shader->setUniform("Material_DiffuseTexture", Renderer::bindTexture(Renderer::TEXTURE_BLANK));
+		shader->setUniform(MATERIAL_DIFFUSE_TEXTURE, Renderer::bindTexture(Renderer::TEXTURE_BLANK));
 	else
-		shader->setUniform("Material_DiffuseTexture", Renderer::bindTexture(m_diffuseTexture));
+		shader->setUniform(MATERIAL_DIFFUSE_TEXTURE, Renderer::bindTexture(m_diffuseTexture));
 
-	shader->setUniform("Material_SpecularTexture", 0); //Will need to change this
+	shader->setUniform(MATERIAL_SPECULAR_TEXTURE, 0); //Will need to change this
 
-	shader->setUniform("Material_Shininess", m_shininess);
+	shader->setUniform(MATERIAL_SHININESS, m_shininess);
 }
 
 /***************************************************************************************************/
@@ -48,8 +48,8 @@ public:
 	inline bool hasDiffuseTexture() { return m_diffuseTexture != NULL; }
 	inline float getShininess() { return m_shininess; }
 
+	/* Assigns the uniforms of the material, the shader should have been set up using reflection */
 	void setUniforms(Shader* shader);
-	static void addUniforms(Shader* shader);
 };
 
 /***************************************************************************************************/
@@ -0,0 +1,201 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+#include "MeshBuffers.h"
+#include "Renderer.h"
+#include "GLState.h"
+
+/***************************************************************************************************
+ * The MeshBuffers class
+ ***************************************************************************************************/
+
+std::vector<MeshBuffers::Format> MeshBuffers::m_formats;
+GLuint MeshBuffers::m_indexBuffer = 0;
+BufferAllocator* MeshBuffers::m_indexAllocator = NULL;
+
+unsigned int MeshBuffers::getFormat(unsigned int attributes, unsigned int shaderHandle) {
+	for (unsigned int a = 0; a < m_formats.size(); a++) {
+		if (m_formats[a].attributes == attributes && m_formats[a].shaderHandle == shaderHandle)
+			return a;
+	}
+
+	Format format;
+	format.attributes = attributes;
+	format.shaderHandle = shaderHandle;
+	format.stride = 0;
+	if (attributes & ATTRIBUTE_POSITION)
+		format.stride += 3 * sizeof(float);
+	if (attributes & ATTRIBUTE_COLOUR)
+		format.stride += 4 * sizeof(float);
+	if (attributes & ATTRIBUTE_TEXTURE_COORD)
+		format.stride += 2 * sizeof(float);
+	if (attributes & ATTRIBUTE_NORMAL)
+		format.stride += 3 * sizeof(float);
+
+	//Allocations are aligned to the size of a vertex so their offset is always a whole vertex
+	format.allocator = new BufferAllocator((INITIAL_VERTEX_BYTES / format.stride) * format.stride, format.stride);
+	glGenVertexArrays(1, &format.vao);
+	glGenBuffers(1, &format.buffer);
+	GLState::bindBuffer(GL_ARRAY_BUFFER, format.buffer);
+	RenderStats::bufferData(GL_ARRAY_BUFFER, format.allocator->getCapacity(), NULL, GL_STATIC_DRAW);
+
+	if (m_indexAllocator == NULL) {
+		m_indexAllocator = new BufferAllocator(INITIAL_INDEX_BYTES, sizeof(unsigned int));
+		glGenBuffers(1, &m_indexBuffer);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, m_indexBuffer);
+		RenderStats::bufferData(GL_COPY_WRITE_BUFFER, m_indexAllocator->getCapacity(), NULL, GL_STATIC_DRAW);
+	}
+
+	m_formats.push_back(format);
+	setupFormat(m_formats.back());
+	return m_formats.size() - 1;
+}
+
+void MeshBuffers::setupFormat(Format& format) {
+	Shader* shader = Renderer::getShader(format.shaderHandle);
+	const char* names[] = { "Position", "Colour", "TextureCoordinate", "Normal" };
+	const unsigned int attributes[] = { ATTRIBUTE_POSITION, ATTRIBUTE_COLOUR, ATTRIBUTE_TEXTURE_COORD, ATTRIBUTE_NORMAL };
+	const int counts[] = { 3, 4, 2, 3 };
+
+	GLState::bindVertexArray(format.vao);
+	GLState::bindBuffer(GL_ARRAY_BUFFER, format.buffer);
+	unsigned int offset = 0;
+	for (unsigned int a = 0; a < 4; a++) {
+		if (! (format.attributes & attributes[a]))
+			continue;
+		GLint location = shader == NULL ? -1 : shader->getAttributeLocation(names[a]);
+		if (location >= 0) {
+			glEnableVertexAttribArray(location);
+			glVertexAttribPointer(location, counts[a], GL_FLOAT, GL_FALSE, format.stride, (void*) (uintptr_t) offset);
+		}
+		offset += counts[a] * sizeof(float);
+	}
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+	GLState::bindVertexArray(0);
+}
+
+bool MeshBuffers::allocate(BufferAllocator* allocator, GLuint& buffer, unsigned int size, BufferAllocator::Allocation& allocation) {
+	if (allocator->allocate(size, allocation))
+		return true;
+
+	//Copy everything into a buffer at least twice the size, the offsets stay the same
+	unsigned int capacity = allocator->getCapacity() * 2;
+	if (capacity < allocator->getCapacity() + size)
+		capacity = allocator->getCapacity() + size;
+	GLuint larger;
+	glGenBuffers(1, &larger);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, larger);
+	RenderStats::bufferData(GL_COPY_WRITE_BUFFER, capacity, NULL, GL_STATIC_DRAW);
+	glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+	glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, allocator->getCapacity());
+	GLState::deleteBuffer(buffer);
+	buffer = larger;
+	allocator->grow(capacity);
+
+	//The VAOs still point at the old buffer
+	for (unsigned int a = 0; a < m_formats.size(); a++)
+		setupFormat(m_formats[a]);
+
+	return allocator->allocate(size, allocation);
+}
+
+bool MeshBuffers::interleave(MeshData* data, unsigned int attributes, std::vector<float>& vertices) {
+	const unsigned int counts[] = { data->getNumPositions(), data->getNumColours(), data->getNumTextureCoords(), data->getNumNormals() };
+	const unsigned int components[] = { 3, 4, 2, 3 };
+
+	unsigned int numVertices = data->getNumPositions();
+	unsigned int vertexSize = 0;
+	for (unsigned int a = 0; a < 4; a++) {
+		if (! (attributes & (1 << a)))
+			continue;
+		if (counts[a] != numVertices)
+			return false;
+		vertexSize += components[a];
+	}
+
+	vertices.reserve(vertices.size() + numVertices * vertexSize);
+	for (unsigned int v = 0; v < numVertices; v++) {
+		for (unsigned int a = 0; a < 4; a++) {
+			if (! (attributes & (1 << a)))
+				continue;
+			const float* source = data->getValues(1 << a, v);
+			vertices.insert(vertices.end(), source, source + components[a]);
+		}
+	}
+	return true;
+}
+
+bool MeshBuffers::add(MeshData* data, unsigned int shaderHandle, MeshBufferRange& range) {
+	if (! isSupported() || ! data->hasPositions())
+		return false;
+
+	unsigned int attributes = ATTRIBUTE_POSITION;
+	if (data->hasColours())
+		attributes |= ATTRIBUTE_COLOUR;
+	if (data->hasTextureCoords())
+		attributes |= ATTRIBUTE_TEXTURE_COORD;
+	if (data->hasNormals())
+		attributes |= ATTRIBUTE_NORMAL;
+
+	std::vector<float> vertices;
+	if (! interleave(data, attributes, vertices))
+		return false;
+
+	range.format = getFormat(attributes, shaderHandle);
+	Format& format = m_formats[range.format];
+	if (! allocate(format.allocator, format.buffer, vertices.size() * sizeof(float), range.vertices))
+		return false;
+	range.baseVertex = range.vertices.offset / format.stride;
+	GLState::bindBuffer(GL_ARRAY_BUFFER, format.buffer);
+	RenderStats::bufferSubData(GL_ARRAY_BUFFER, range.vertices.offset, vertices.size() * sizeof(float), &vertices.front());
+
+	if (data->hasIndices()) {
+		std::vector<unsigned int>& indices = data->getIndices();
+		if (! allocate(m_indexAllocator, m_indexBuffer, indices.size() * sizeof(unsigned int), range.indices)) {
+			format.allocator->free(range.vertices);
+			return false;
+		}
+		//The element buffer binding belongs to the VAO, so this is uploaded through another target
+		glBindBuffer(GL_COPY_WRITE_BUFFER, m_indexBuffer);
+		RenderStats::bufferSubData(GL_COPY_WRITE_BUFFER, range.indices.offset, indices.size() * sizeof(unsigned int), &indices.front());
+	}
+	return true;
+}
+
+void MeshBuffers::remove(MeshBufferRange& range) {
+	if (range.format >= m_formats.size())
+		return;
+	m_formats[range.format].allocator->free(range.vertices);
+	if (m_indexAllocator != NULL)
+		m_indexAllocator->free(range.indices);
+}
+
+void MeshBuffers::destroy() {
+	for (unsigned int a = 0; a < m_formats.size(); a++) {
+		GLState::deleteVertexArray(m_formats[a].vao);
+		GLState::deleteBuffer(m_formats[a].buffer);
+		delete m_formats[a].allocator;
+	}
+	m_formats.clear();
+	if (m_indexAllocator != NULL) {
+		GLState::deleteBuffer(m_indexBuffer);
+		delete m_indexAllocator;
+		m_indexAllocator = NULL;
+	}
+}
+
+/***************************************************************************************************/
@@ -0,0 +1,109 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+#ifndef CORE_RENDER_MESHBUFFERS_H_
+#define CORE_RENDER_MESHBUFFERS_H_
+
+#include <windows.h>
+#include <GL/GLEW/glew.h>
+#include <vector>
+
+#include "BufferAllocator.h"
+
+class MeshData;
+
+/* The parts of the shared buffers used by a mesh */
+struct MeshBufferRange {
+	unsigned int format;
+	BufferAllocator::Allocation vertices;
+	BufferAllocator::Allocation indices;
+	/* The index of the first vertex within the vertex buffer of the format */
+	GLint baseVertex;
+
+	MeshBufferRange() : format(0), baseVertex(0) {}
+};
+
+/***************************************************************************************************
+ * The MeshBuffers class stores the vertices and indices of static meshes in large shared buffers
+ * instead of each mesh having buffers of its own. There is a vertex buffer and a VAO for each
+ * vertex format, and one index buffer shared by all of them, so meshes with the same format only
+ * differ by their offsets and drawing them doesn't need the VAO changing
+ ***************************************************************************************************/
+
+class MeshBuffers {
+public:
+	/* The attributes a vertex can have, they are interleaved in this order */
+	enum Attribute {
+		ATTRIBUTE_POSITION      = 1,
+		ATTRIBUTE_COLOUR        = 2,
+		ATTRIBUTE_TEXTURE_COORD = 4,
+		ATTRIBUTE_NORMAL        = 8
+	};
+private:
+	/* The attributes of a vertex, along with the shader used as it decides their locations */
+	struct Format {
+		unsigned int attributes;
+		unsigned int shaderHandle;
+		unsigned int stride;
+		GLuint vao;
+		GLuint buffer;
+		BufferAllocator* allocator;
+	};
+
+	/* The sizes the buffers start at, in bytes */
+	static const unsigned int INITIAL_VERTEX_BYTES = 4 * 1024 * 1024;
+	static const unsigned int INITIAL_INDEX_BYTES  = 2 * 1024 * 1024;
+
+	static std::vector<Format> m_formats;
+	static GLuint m_indexBuffer;
+	static BufferAllocator* m_indexAllocator;
+
+	/* Returns the format for a set of attributes and a shader, creating it if needed */
+	static unsigned int getFormat(unsigned int attributes, unsigned int shaderHandle);
+
+	/* Points the attributes of a format's VAO at its vertex buffer and the index buffer */
+	static void setupFormat(Format& format);
+
+	/* Allocates part of a buffer, copying it into a larger one if it is full */
+	static bool allocate(BufferAllocator* allocator, GLuint& buffer, unsigned int size, BufferAllocator::Allocation& allocation);
+
+	/* Puts the values of each vertex next to each other, returns false if the attributes don't
+	 * have a value for every vertex */
+	static bool interleave(MeshData* data, unsigned int attributes, std::vector<float>& vertices);
+public:
+	/* Returns whether base vertex draws and buffer copies are available */
+	static inline bool isSupported() { return GLEW_ARB_draw_elements_base_vertex && GLEW_ARB_copy_buffer; }
+
+	/* Copies the data of a mesh into the buffers for a shader, returning false if it can't be
+	 * stored in them */
+	static bool add(MeshData* data, unsigned int shaderHandle, MeshBufferRange& range);
+
+	/* Frees the parts of the buffers used by a mesh */
+	static void remove(MeshBufferRange& range);
+
+	/* Deletes all of the buffers */
+	static void destroy();
+
+	static inline GLuint getVertexArray(unsigned int format) { return m_formats[format].vao; }
+	static inline unsigned int getNumFormats() { return m_formats.size(); }
+	static inline BufferAllocator* getVertexAllocator(unsigned int format) { return m_formats[format].allocator; }
+	static inline BufferAllocator* getIndexAllocator() { return m_indexAllocator; }
+};
+
+/***************************************************************************************************/
+
+#endif /* CORE_RENDER_MESHBUFFERS_H_ */
@@ -0,0 +1,261 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <cmath>
+#include <algorithm>
+
+#include "Meshlets.h"
+#include "MeshBuffers.h"
+#include "../Mesh.h"
+#include "../Matrix.h"
+
+/***************************************************************************************************
+ * The Meshlets class
+ ***************************************************************************************************/
+
+bool Meshlets::CurveOrder::operator()(unsigned int a, unsigned int b) const {
+	if ((*codes)[a] != (*codes)[b])
+		return (*codes)[a] < (*codes)[b];
+	return a < b;
+}
+
+unsigned int Meshlets::spreadBits(unsigned int value) {
+	value &= 0x3FF;
+	value = (value | (value << 16)) & 0x030000FF;
+	value = (value | (value << 8)) & 0x0300F00F;
+	value = (value | (value << 4)) & 0x030C30C3;
+	value = (value | (value << 2)) & 0x09249249;
+	return value;
+}
+
+void Meshlets::build(MeshData* data) {
+	std::vector<Meshlet>& meshlets = data->getMeshlets();
+	meshlets.clear();
+	unsigned int numTriangles = data->getNumTriangles();
+	if (! data->hasPositions() || numTriangles == 0)
+		return;
+	bool indexed = data->hasIndices();
+
+	//Find where the centre of each triangle is along the curve, within the bounds of the mesh
+	Vector3f min = data->getBoundsMin();
+	Vector3f max = data->getBoundsMax();
+	float scale[3];
+	for (unsigned int a = 0; a < 3; a++)
+		scale[a] = max[a] > min[a] ? 1023.0f / (max[a] - min[a]) : 0.0f;
+
+	std::vector<unsigned int> codes(numTriangles);
+	std::vector<unsigned int> order(numTriangles);
+	for (unsigned int a = 0; a < numTriangles; a++) {
+		float centre[3] = { 0, 0, 0 };
+		for (unsigned int b = 0; b < 3; b++) {
+			const float* p = data->getValues(MeshBuffers::ATTRIBUTE_POSITION, indexed ? data->getIndices()[a * 3 + b] : a * 3 + b);
+			for (unsigned int c = 0; c < 3; c++)
+				centre[c] += p[c] / 3.0f;
+		}
+		unsigned int code = 0;
+		for (unsigned int c = 0; c < 3; c++)
+			code |= spreadBits((unsigned int) ((centre[c] - min[c]) * scale[c])) << c;
+		codes[a] = code;
+		order[a] = a;
+	}
+	CurveOrder curveOrder;
+	curveOrder.codes = &codes;
+	std::sort(order.begin(), order.end(), curveOrder);
+	data->reorderTriangles(order);
+
+	//Split the triangles into meshlets in their new order. Meshes without indices don't share any
+	//vertices, so only the number of triangles is limited
+	std::vector<unsigned int>& indices = data->getIndices();
+	std::vector<unsigned int> vertices;
+	Meshlet meshlet;
+	meshlet.firstTriangle = 0;
+	meshlet.numTriangles = 0;
+	for (unsigned int a = 0; a < numTriangles; a++) {
+		unsigned int newVertices = 0;
+		if (indexed) {
+			for (unsigned int b = 0; b < 3; b++) {
+				unsigned int index = indices[a * 3 + b];
+				bool repeated = (b > 0 && indices[a * 3] == index) || (b > 1 && indices[a * 3 + 1] == index);
+				if (! repeated && std::find(vertices.begin(), vertices.end(), index) == vertices.end())
+					newVertices++;
+			}
+		}
+		if (meshlet.numTriangles == MAX_TRIANGLES || vertices.size() + newVertices > MAX_VERTICES) {
+			computeBounds(data, meshlet);
+			meshlets.push_back(meshlet);
+			meshlet.firstTriangle = a;
+			meshlet.numTriangles = 0;
+			vertices.clear();
+		}
+		if (indexed) {
+			for (unsigned int b = 0; b < 3; b++) {
+				if (std::find(vertices.begin(), vertices.end(), indices[a * 3 + b]) == vertices.end())
+					vertices.push_back(indices[a * 3 + b]);
+			}
+		}
+		meshlet.numTriangles++;
+	}
+	computeBounds(data, meshlet);
+	meshlets.push_back(meshlet);
+}
+
+void Meshlets::computeBounds(MeshData* data, Meshlet& meshlet) {
+	bool indexed = data->hasIndices();
+	std::vector<unsigned int>& indices = data->getIndices();
+	std::vector<float> positions;
+	for (unsigned int a = meshlet.firstTriangle; a < meshlet.firstTriangle + meshlet.numTriangles; a++) {
+		for (unsigned int b = 0; b < 3; b++) {
+			const float* p = data->getValues(MeshBuffers::ATTRIBUTE_POSITION, indexed ? indices[a * 3 + b] : a * 3 + b);
+			positions.insert(positions.end(), p, p + 3);
+		}
+	}
+
+	//The sphere around the bounding box of the vertices
+	float min[3] = { positions[0], positions[1], positions[2] };
+	float max[3] = { positions[0], positions[1], positions[2] };
+	for (unsigned int a = 0; a < positions.size(); a += 3) {
+		for (unsigned int c = 0; c < 3; c++) {
+			min[c] = std::min(min[c], positions[a + c]);
+			max[c] = std::max(max[c], positions[a + c]);
+		}
+	}
+	for (unsigned int c = 0; c < 3; c++)
+		meshlet.centre[c] = (min[c] + max[c]) / 2.0f;
+	meshlet.radius = 0;
+	for (unsigned int a = 0; a < positions.size(); a += 3) {
+		float x = positions[a] - meshlet.centre[0];
+		float y = positions[a + 1] - meshlet.centre[1];
+		float z = positions[a + 2] - meshlet.centre[2];
+		meshlet.radius = std::max(meshlet.radius, sqrtf(x * x + y * y + z * z));
+	}
+
+	//The normals of the triangles, wound anticlockwise
+	std::vector<float> normals;
+	float axis[3] = { 0, 0, 0 };
+	for (unsigned int a = 0; a < positions.size(); a += 9) {
+		const float* p = &positions[a];
+		float e1[3] = { p[3] - p[0], p[4] - p[1], p[5] - p[2] };
+		float e2[3] = { p[6] - p[0], p[7] - p[1], p[8] - p[2] };
+		float n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+		float length = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+		//Triangles without any area can't be seen, so don't affect the cone
+		if (length == 0)
+			continue;
+		for (unsigned int c = 0; c < 3; c++) {
+			n[c] /= length;
+			axis[c] += n[c];
+		}
+		normals.insert(normals.end(), n, n + 3);
+		//The first vertex is kept to find the plane of the triangle
+		normals.insert(normals.end(), p, p + 3);
+	}
+
+	//The cone can't be used when the normals cover half a sphere or more
+	float axisLength = sqrtf(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+	float minDot = 1.0f;
+	for (unsigned int c = 0; c < 3; c++)
+		meshlet.coneAxis[c] = axisLength > 0 ? axis[c] / axisLength : 0.0f;
+	for (unsigned int a = 0; a < normals.size(); a += 6) {
+		const float* n = &normals[a];
+		minDot = std::min(minDot, n[0] * meshlet.coneAxis[0] + n[1] * meshlet.coneAxis[1] + n[2] * meshlet.coneAxis[2]);
+	}
+	if (axisLength == 0 || minDot <= 0.0f) {
+		for (unsigned int c = 0; c < 3; c++)
+			meshlet.coneApex[c] = meshlet.centre[c];
+		meshlet.coneCutoff = 2.0f;
+		return;
+	}
+
+	//Move the apex back along the axis until it is behind the plane of every triangle
+	float distance = 0;
+	for (unsigned int a = 0; a < normals.size(); a += 6) {
+		const float* n = &normals[a];
+		const float* p = &normals[a + 3];
+		float toCentre = (meshlet.centre[0] - p[0]) * n[0] + (meshlet.centre[1] - p[1]) * n[1] + (meshlet.centre[2] - p[2]) * n[2];
+		float alongAxis = n[0] * meshlet.coneAxis[0] + n[1] * meshlet.coneAxis[1] + n[2] * meshlet.coneAxis[2];
+		distance = std::max(distance, toCentre / alongAxis);
+	}
+	for (unsigned int c = 0; c < 3; c++)
+		meshlet.coneApex[c] = meshlet.centre[c] - meshlet.coneAxis[c] * distance;
+	meshlet.coneCutoff = sqrtf(1.0f - minDot * minDot);
+}
+
+void Meshlets::setupView(View& view, const Matrix4f& projectionView, const Matrix4f& modelMatrix, Vector3f cameraPosition, bool cullBackFaces) {
+	Matrix4f pv = projectionView;
+	Matrix4f m = modelMatrix;
+	Matrix4f mvp = pv * m;
+
+	//The planes of the frustum in the space of the mesh
+	mvp.getFrustumPlanes(view.planes);
+
+	Matrix4f inverse = m.inverse();
+	float x = cameraPosition.getX();
+	float y = cameraPosition.getY();
+	float z = cameraPosition.getZ();
+	for (unsigned int c = 0; c < 3; c++)
+		view.cameraPosition[c] = inverse.m_values[c][0] * x + inverse.m_values[c][1] * y + inverse.m_values[c][2] * z + inverse.m_values[c][3];
+
+	//The cones are only right when the mesh is scaled the same way along each axis, and isn't
+	//mirrored as that swaps which side of each triangle is the front
+	float lengths[3];
+	for (unsigned int c = 0; c < 3; c++)
+		lengths[c] = sqrtf(m.m_values[0][c] * m.m_values[0][c] + m.m_values[1][c] * m.m_values[1][c] + m.m_values[2][c] * m.m_values[2][c]);
+	float determinant = m.m_values[0][0] * (m.m_values[1][1] * m.m_values[2][2] - m.m_values[1][2] * m.m_values[2][1]) -
+						m.m_values[0][1] * (m.m_values[1][0] * m.m_values[2][2] - m.m_values[1][2] * m.m_values[2][0]) +
+						m.m_values[0][2] * (m.m_values[1][0] * m.m_values[2][1] - m.m_values[1][1] * m.m_values[2][0]);
+	bool uniform = fabs(lengths[0] - lengths[1]) <= lengths[0] * 0.001f && fabs(lengths[0] - lengths[2]) <= lengths[0] * 0.001f;
+	view.cullBackFaces = cullBackFaces && uniform && determinant > 0;
+}
+
+bool Meshlets::isVisible(const Meshlet& meshlet, const View& view) {
+	for (unsigned int a = 0; a < 6; a++) {
+		const float* plane = view.planes[a];
+		if (plane[0] * meshlet.centre[0] + plane[1] * meshlet.centre[1] + plane[2] * meshlet.centre[2] + plane[3] < -meshlet.radius)
+			return false;
+	}
+	if (view.cullBackFaces && meshlet.coneCutoff <= 1.0f) {
+		float x = meshlet.coneApex[0] - view.cameraPosition[0];
+		float y = meshlet.coneApex[1] - view.cameraPosition[1];
+		float z = meshlet.coneApex[2] - view.cameraPosition[2];
+		float length = sqrtf(x * x + y * y + z * z);
+		if (x * meshlet.coneAxis[0] + y * meshlet.coneAxis[1] + z * meshlet.coneAxis[2] >= meshlet.coneCutoff * length)
+			return false;
+	}
+	return true;
+}
+
+unsigned int Meshlets::cull(const std::vector<Meshlet>& meshlets, const View& view, std::vector<MeshletRange>& ranges) {
+	unsigned int numTriangles = 0;
+	for (unsigned int a = 0; a < meshlets.size(); a++) {
+		const Meshlet& meshlet = meshlets[a];
+		if (! isVisible(meshlet, view))
+			continue;
+		if (! ranges.empty() && ranges.back().firstTriangle + ranges.back().numTriangles == meshlet.firstTriangle)
+			ranges.back().numTriangles += meshlet.numTriangles;
+		else {
+			MeshletRange range;
+			range.firstTriangle = meshlet.firstTriangle;
+			range.numTriangles = meshlet.numTriangles;
+			ranges.push_back(range);
+		}
+		numTriangles += meshlet.numTriangles;
+	}
+	return numTriangles;
+}
+
+/***************************************************************************************************/
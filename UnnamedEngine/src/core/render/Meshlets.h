@@ -0,0 +1,110 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef CORE_RENDER_MESHLETS_H_
+#define CORE_RENDER_MESHLETS_H_
+
+#include <vector>
+
+#include "../Vector.h"
+
+class Matrix4f;
+class MeshData;
+
+/***************************************************************************************************
+ * The Meshlet structure describes a small group of neighbouring triangles within a mesh that can be
+ * culled on its own, along with its bounds in the mesh's space
+ ***************************************************************************************************/
+
+struct Meshlet {
+	unsigned int firstTriangle;
+	unsigned int numTriangles;
+
+	/* The sphere containing every vertex */
+	float centre[3];
+	float radius;
+
+	/* The cone containing the normals of every triangle, all of them face away from a camera
+	 * within the cone behind the apex. The cutoff is above 1 when the normals are too spread out
+	 * for the cone to be used */
+	float coneApex[3];
+	float coneAxis[3];
+	float coneCutoff;
+};
+
+/* A range of triangles left after culling, made of one or more meshlets next to each other */
+struct MeshletRange {
+	unsigned int firstTriangle;
+	unsigned int numTriangles;
+};
+
+/***************************************************************************************************/
+
+/***************************************************************************************************
+ * The Meshlets class splits meshes into meshlets, and culls them against the view so only the
+ * triangles that might be seen are drawn. The triangles of each mesh are sorted along a space
+ * filling curve so the ones in each meshlet are close together, and stored in that order so each
+ * meshlet is a single range. It doesn't need an OpenGL context
+ ***************************************************************************************************/
+
+class Meshlets {
+public:
+	/* The most vertices and triangles in a single meshlet */
+	static const unsigned int MAX_VERTICES = 64;
+	static const unsigned int MAX_TRIANGLES = 124;
+
+	/* What meshlets are culled against, in the space of the mesh */
+	struct View {
+		float planes[6][4];
+		float cameraPosition[3];
+		bool cullBackFaces;
+	};
+private:
+	/* Orders triangles by their position along the curve */
+	struct CurveOrder {
+		const std::vector<unsigned int>* codes;
+
+		bool operator()(unsigned int a, unsigned int b) const;
+	};
+
+	/* Spreads the lowest 10 bits of a value out so there are two zero bits between each */
+	static unsigned int spreadBits(unsigned int value);
+
+	/* Finds the bounding sphere and normal cone of a meshlet */
+	static void computeBounds(MeshData* data, Meshlet& meshlet);
+public:
+	/* Reorders the triangles of a mesh and splits them into meshlets, which are stored in it. This
+	 * has to be done before the mesh is uploaded */
+	static void build(MeshData* data);
+
+	/* Sets up a view from the projection view matrix of a camera and its position, along with the
+	 * model matrix of the mesh. Back faces are only culled when asked to, and the model matrix
+	 * doesn't stretch the mesh */
+	static void setupView(View& view, const Matrix4f& projectionView, const Matrix4f& modelMatrix, Vector3f cameraPosition, bool cullBackFaces);
+
+	/* Returns whether any of the triangles in a meshlet might be seen */
+	static bool isVisible(const Meshlet& meshlet, const View& view);
+
+	/* Adds the ranges of triangles from meshlets that might be seen, joining those next to each
+	 * other. Returns the number of triangles in them */
+	static unsigned int cull(const std::vector<Meshlet>& meshlets, const View& view, std::vector<MeshletRange>& ranges);
+};
+
+/***************************************************************************************************/
+
+#endif /* CORE_RENDER_MESHLETS_H_ */
@@ -0,0 +1,97 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+#include <cstring>
+
+#include "MultiDraw.h"
+#include "Renderer.h"
+#include "../Profiler.h"
+
+/***************************************************************************************************
+ * The MultiDraw class
+ ***************************************************************************************************/
+
+GLuint MultiDraw::m_commandBuffer = 0;
+GLuint MultiDraw::m_dataBuffer = 0;
+unsigned int MultiDraw::m_commandCapacity = 0;
+unsigned int MultiDraw::m_dataCapacity = 0;
+unsigned int MultiDraw::m_arrayCommandsOffset = 0;
+
+void MultiDraw::upload(GLenum target, GLuint& buffer, unsigned int& capacity, unsigned int size, const void* data) {
+	if (buffer == 0)
+		glGenBuffers(1, &buffer);
+	glBindBuffer(target, buffer);
+	//Orphan the buffer each frame, growing it when needed, so the last frame's draws aren't waited for
+	if (size > capacity)
+		capacity = size * 2;
+	RenderStats::bufferData(target, capacity, NULL, GL_STREAM_DRAW);
+	if (size > 0)
+		RenderStats::bufferSubData(target, 0, size, data);
+}
+
+void MultiDraw::upload(IndirectDrawList& list) {
+	PROFILE_SCOPE("MultiDraw::upload");
+	std::vector<DrawElementsIndirectCommand>& elementCommands = list.getElementCommands();
+	std::vector<DrawArraysIndirectCommand>& arrayCommands = list.getArrayCommands();
+	std::vector<DrawData>& drawData = list.getDrawData();
+
+	//Put both types of command in the same buffer so it only has to be bound once
+	m_arrayCommandsOffset = elementCommands.size() * sizeof(DrawElementsIndirectCommand);
+	std::vector<unsigned char> commands(m_arrayCommandsOffset + arrayCommands.size() * sizeof(DrawArraysIndirectCommand));
+	if (! elementCommands.empty())
+		memcpy(&commands.front(), &elementCommands.front(), m_arrayCommandsOffset);
+	if (! arrayCommands.empty())
+		memcpy(&commands.front() + m_arrayCommandsOffset, &arrayCommands.front(), arrayCommands.size() * sizeof(DrawArraysIndirectCommand));
+
+	upload(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer, m_commandCapacity, commands.size(), commands.empty() ? NULL : &commands.front());
+	upload(GL_SHADER_STORAGE_BUFFER, m_dataBuffer, m_dataCapacity, drawData.size() * sizeof(DrawData), drawData.empty() ? NULL : &drawData.front());
+}
+
+void MultiDraw::render(IndirectDrawList& list, Shader* shader) {
+	PROFILE_SCOPE("MultiDraw::render");
+	std::vector<IndirectDrawList::Batch>& batches = list.getBatches();
+	if (batches.empty())
+		return;
+
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, DRAW_DATA_BINDING, m_dataBuffer);
+	for (unsigned int a = 0; a < batches.size(); a++) {
+		IndirectDrawList::Batch& batch = batches[a];
+		GLState::bindVertexArray(MeshBuffers::getVertexArray(batch.format));
+		shader->setUniform("material.diffuseTexture", Renderer::bindTexture(batch.texture == NULL ? Renderer::TEXTURE_BLANK : batch.texture));
+
+		if (batch.indexed)
+			glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (void*) (batch.firstCommand * sizeof(DrawElementsIndirectCommand)), batch.numCommands, 0);
+		else
+			glMultiDrawArraysIndirect(GL_TRIANGLES, (void*) (m_arrayCommandsOffset + batch.firstCommand * sizeof(DrawArraysIndirectCommand)), batch.numCommands, 0);
+		RenderStats::addMultiDraw(batch.indexed, batch.numCommands, batch.numVertices);
+		Renderer::releaseTextures();
+	}
+}
+
+void MultiDraw::destroy() {
+	if (m_commandBuffer != 0)
+		GLState::deleteBuffer(m_commandBuffer);
+	if (m_dataBuffer != 0)
+		GLState::deleteBuffer(m_dataBuffer);
+	m_commandBuffer = 0;
+	m_dataBuffer = 0;
+	m_commandCapacity = 0;
+	m_dataCapacity = 0;
+}
+
+/***************************************************************************************************/
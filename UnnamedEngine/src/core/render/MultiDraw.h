@@ -0,0 +1,63 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+#ifndef CORE_RENDER_MULTIDRAW_H_
+#define CORE_RENDER_MULTIDRAW_H_
+
+#include "IndirectDrawList.h"
+#include "MeshBuffers.h"
+#include "Shader.h"
+
+/***************************************************************************************************
+ * The MultiDraw class submits an IndirectDrawList, with the commands in an indirect buffer and the
+ * data of each draw in a shader storage buffer, so each batch is drawn with a single call
+ ***************************************************************************************************/
+
+class MultiDraw {
+private:
+	/* The binding of the storage buffer the shader reads the data of each draw from */
+	static const GLuint DRAW_DATA_BINDING = 0;
+
+	/* The buffers and their sizes in bytes, the array commands come after the element ones */
+	static GLuint m_commandBuffer;
+	static GLuint m_dataBuffer;
+	static unsigned int m_commandCapacity;
+	static unsigned int m_dataCapacity;
+	static unsigned int m_arrayCommandsOffset;
+
+	/* Uploads data to a buffer, making it larger first if it needs to be */
+	static void upload(GLenum target, GLuint& buffer, unsigned int& capacity, unsigned int size, const void* data);
+public:
+	/* Returns whether indirect multi draws, storage buffers and the draw parameters in shaders are
+	 * available, along with the MeshBuffers the meshes have to be in */
+	static inline bool isSupported() {
+		return GLEW_ARB_multi_draw_indirect && GLEW_ARB_shader_storage_buffer_object && GLEW_ARB_shader_draw_parameters && MeshBuffers::isSupported();
+	}
+
+	/* Uploads the commands and data of a list that has been built */
+	static void upload(IndirectDrawList& list);
+
+	/* Draws every batch in the list last uploaded, using a shader that is already in use */
+	static void render(IndirectDrawList& list, Shader* shader);
+
+	/* Deletes the buffers */
+	static void destroy();
+};
+
+/***************************************************************************************************/
+
+#endif /* CORE_RENDER_MULTIDRAW_H_ */
@@ -0,0 +1,371 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <cmath>
+#include <algorithm>
+
+#include "OcclusionCuller.h"
+#include "MeshBuffers.h"
+#include "../Mesh.h"
+#include "../Matrix.h"
+#include "../Profiler.h"
+#include "../../utils/Time.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OCCLUSION_SSE2
+#endif
+
+/***************************************************************************************************
+ * The OcclusionCuller class
+ ***************************************************************************************************/
+
+OcclusionCuller::OcclusionCuller(unsigned int width, unsigned int height, unsigned int numThreads) {
+	//The buffer is made up of whole tiles so rows can be rasterised four pixels at a time
+	m_tilesX = (width + TILE_SIZE - 1) / TILE_SIZE;
+	m_tilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+	m_width = m_tilesX * TILE_SIZE;
+	m_height = m_tilesY * TILE_SIZE;
+	m_depth.assign(m_width * m_height, 1.0f);
+	m_tileDepth.assign(m_tilesX * m_tilesY, 1.0f);
+	m_bins.resize(m_tilesY);
+	m_nextJob = 0;
+	for (unsigned int a = 0; a < 16; a++)
+		m_projectionView[a] = (a % 5 == 0) ? 1.0f : 0.0f;
+
+	for (unsigned int a = 0; a < numThreads; a++)
+		m_threads.push_back(std::thread(&OcclusionCuller::worker, this));
+}
+
+OcclusionCuller::OcclusionCuller(unsigned int width, unsigned int height) :
+		OcclusionCuller(width, height, std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() - 1 : 0) {}
+
+OcclusionCuller::~OcclusionCuller() {
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_running = false;
+	}
+	m_startCondition.notify_all();
+	for (unsigned int a = 0; a < m_threads.size(); a++)
+		m_threads[a].join();
+}
+
+void OcclusionCuller::worker() {
+	unsigned int generation = 0;
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			while (m_running && m_generation == generation)
+				m_startCondition.wait(lock);
+			if (! m_running)
+				return;
+			generation = m_generation;
+		}
+		work();
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_numBusy--;
+			if (m_numBusy == 0)
+				m_doneCondition.notify_one();
+		}
+	}
+}
+
+void OcclusionCuller::run(Task task, unsigned int numJobs) {
+	//Not worth waking the threads for a single job
+	if (m_threads.empty() || numJobs <= 1) {
+		m_task = task;
+		m_numJobs = numJobs;
+		m_nextJob = 0;
+		work();
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_task = task;
+		m_numJobs = numJobs;
+		m_nextJob = 0;
+		m_numBusy = m_threads.size();
+		m_generation++;
+	}
+	m_startCondition.notify_all();
+	work();
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (m_numBusy > 0)
+		m_doneCondition.wait(lock);
+}
+
+void OcclusionCuller::work() {
+	unsigned int job;
+	while ((job = m_nextJob++) < m_numJobs) {
+		if (m_task == TASK_RASTERISE)
+			rasteriseBand(job);
+		else {
+			unsigned int end = std::min((job + 1) * QUERIES_PER_JOB, (unsigned int) m_queries->size());
+			for (unsigned int a = job * QUERIES_PER_JOB; a < end; a++)
+				(*m_queries)[a].visible = isVisible((*m_queries)[a]);
+		}
+	}
+}
+
+OcclusionCuller::ScreenVertex OcclusionCuller::project(const float* matrix, float x, float y, float z) {
+	float clipX = matrix[0] * x + matrix[1] * y + matrix[2] * z + matrix[3];
+	float clipY = matrix[4] * x + matrix[5] * y + matrix[6] * z + matrix[7];
+	float clipZ = matrix[8] * x + matrix[9] * y + matrix[10] * z + matrix[11];
+	float clipW = matrix[12] * x + matrix[13] * y + matrix[14] * z + matrix[15];
+
+	ScreenVertex vertex;
+	vertex.clipped = clipW <= 0.0001f || clipZ < -clipW;
+	if (! vertex.clipped) {
+		vertex.x = (clipX / clipW * 0.5f + 0.5f) * m_width;
+		vertex.y = (clipY / clipW * 0.5f + 0.5f) * m_height;
+		vertex.z = clipZ / clipW * 0.5f + 0.5f;
+	}
+	return vertex;
+}
+
+void OcclusionCuller::begin(const Matrix4f& projectionView) {
+	for (unsigned int a = 0; a < 4; a++) {
+		for (unsigned int b = 0; b < 4; b++)
+			m_projectionView[a * 4 + b] = projectionView.m_values[a][b];
+	}
+	m_triangles.clear();
+	for (unsigned int a = 0; a < m_bins.size(); a++)
+		m_bins[a].clear();
+	m_numTested = 0;
+	m_numRejected = 0;
+}
+
+void OcclusionCuller::addOccluder(MeshData* data, const Matrix4f& modelMatrix) {
+	if (data == NULL || ! data->hasPositions())
+		return;
+	float matrix[16];
+	for (unsigned int a = 0; a < 4; a++) {
+		for (unsigned int b = 0; b < 4; b++) {
+			matrix[a * 4 + b] = 0;
+			for (unsigned int c = 0; c < 4; c++)
+				matrix[a * 4 + b] += m_projectionView[a * 4 + c] * modelMatrix.m_values[c][b];
+		}
+	}
+
+	m_vertices.resize(data->getNumPositions());
+	for (unsigned int a = 0; a < m_vertices.size(); a++) {
+		const float* p = data->getValues(MeshBuffers::ATTRIBUTE_POSITION, a);
+		m_vertices[a] = project(matrix, p[0], p[1], p[2]);
+	}
+
+	std::vector<unsigned int>& indices = data->getIndices();
+	unsigned int numTriangles = (data->hasIndices() ? indices.size() : m_vertices.size()) / 3;
+	for (unsigned int a = 0; a < numTriangles; a++) {
+		ScreenVertex v[3];
+		for (unsigned int b = 0; b < 3; b++)
+			v[b] = m_vertices[data->hasIndices() ? indices[a * 3 + b] : a * 3 + b];
+		if (v[0].clipped || v[1].clipped || v[2].clipped)
+			continue;
+
+		//Either side of the triangle can hide things, so make them all wind the same way
+		float area = (v[1].x - v[0].x) * (v[2].y - v[0].y) - (v[2].x - v[0].x) * (v[1].y - v[0].y);
+		if (area == 0)
+			continue;
+		if (area < 0)
+			std::swap(v[1], v[2]);
+
+		//The pixels whose centres could be within the triangle
+		Triangle triangle;
+		float minX = std::min(v[0].x, std::min(v[1].x, v[2].x));
+		float maxX = std::max(v[0].x, std::max(v[1].x, v[2].x));
+		float minY = std::min(v[0].y, std::min(v[1].y, v[2].y));
+		float maxY = std::max(v[0].y, std::max(v[1].y, v[2].y));
+		triangle.minX = std::max(0, (int) ceil(minX - 0.5f));
+		triangle.maxX = std::min((int) m_width - 1, (int) floor(maxX - 0.5f));
+		triangle.minY = std::max(0, (int) ceil(minY - 0.5f));
+		triangle.maxY = std::min((int) m_height - 1, (int) floor(maxY - 0.5f));
+		if (triangle.minX > triangle.maxX || triangle.minY > triangle.maxY)
+			continue;
+		for (unsigned int b = 0; b < 3; b++) {
+			triangle.x[b] = v[b].x;
+			triangle.y[b] = v[b].y;
+			triangle.z[b] = v[b].z;
+		}
+
+		unsigned int index = m_triangles.size();
+		m_triangles.push_back(triangle);
+		for (unsigned int b = triangle.minY / TILE_SIZE; b <= triangle.maxY / TILE_SIZE; b++)
+			m_bins[b].push_back(index);
+	}
+}
+
+void OcclusionCuller::rasterise() {
+	PROFILE_SCOPE("OcclusionCuller::rasterise");
+	long long start = Time::getTimeNanoseconds();
+	run(TASK_RASTERISE, m_tilesY);
+	m_rasteriseTime = (Time::getTimeNanoseconds() - start) / 1000000.0;
+}
+
+void OcclusionCuller::rasteriseBand(unsigned int band) {
+	int minY = band * TILE_SIZE;
+	int maxY = minY + TILE_SIZE - 1;
+	for (unsigned int a = minY; a <= (unsigned int) maxY; a++)
+		std::fill(m_depth.begin() + a * m_width, m_depth.begin() + (a + 1) * m_width, 1.0f);
+
+	std::vector<unsigned int>& bin = m_bins[band];
+	for (unsigned int a = 0; a < bin.size(); a++) {
+		const Triangle& triangle = m_triangles[bin[a]];
+		rasterise(triangle, std::max(minY, triangle.minY), std::min(maxY, triangle.maxY));
+	}
+
+	//Keep the farthest depth of each tile in the band
+	for (unsigned int a = 0; a < m_tilesX; a++) {
+		float farthest = 0;
+		for (unsigned int y = minY; y <= (unsigned int) maxY; y++) {
+			const float* row = &m_depth[y * m_width + a * TILE_SIZE];
+			for (unsigned int x = 0; x < TILE_SIZE; x++)
+				farthest = std::max(farthest, row[x]);
+		}
+		m_tileDepth[band * m_tilesX + a] = farthest;
+	}
+}
+
+void OcclusionCuller::rasterise(const Triangle& triangle, int minY, int maxY) {
+	//The edge functions, each of them are positive on the inside of the triangle
+	float edgeA[3];
+	float edgeB[3];
+	float edgeC[3];
+	for (unsigned int a = 0; a < 3; a++) {
+		unsigned int b = (a + 1) % 3;
+		edgeA[a] = triangle.y[a] - triangle.y[b];
+		edgeB[a] = triangle.x[b] - triangle.x[a];
+		edgeC[a] = -(edgeA[a] * triangle.x[a] + edgeB[a] * triangle.y[a]);
+	}
+
+	//The plane the depth lies on
+	float x1 = triangle.x[1] - triangle.x[0];
+	float y1 = triangle.y[1] - triangle.y[0];
+	float x2 = triangle.x[2] - triangle.x[0];
+	float y2 = triangle.y[2] - triangle.y[0];
+	float z1 = triangle.z[1] - triangle.z[0];
+	float z2 = triangle.z[2] - triangle.z[0];
+	float area = x1 * y2 - x2 * y1;
+	float depthX = (z1 * y2 - z2 * y1) / area;
+	float depthY = (z2 * x1 - z1 * x2) / area;
+	float depthC = triangle.z[0] - depthX * triangle.x[0] - depthY * triangle.y[0];
+
+	//Rows are done four pixels at a time, starting from a multiple of four
+	int minX = triangle.minX & ~3;
+	int maxX = triangle.maxX;
+	for (int y = minY; y <= maxY; y++) {
+		float centreY = y + 0.5f;
+		float* row = &m_depth[y * m_width];
+#ifdef OCCLUSION_SSE2
+		__m128 rowEdge0 = _mm_set1_ps(edgeB[0] * centreY + edgeC[0]);
+		__m128 rowEdge1 = _mm_set1_ps(edgeB[1] * centreY + edgeC[1]);
+		__m128 rowEdge2 = _mm_set1_ps(edgeB[2] * centreY + edgeC[2]);
+		__m128 rowDepth = _mm_set1_ps(depthY * centreY + depthC);
+		__m128 a0 = _mm_set1_ps(edgeA[0]);
+		__m128 a1 = _mm_set1_ps(edgeA[1]);
+		__m128 a2 = _mm_set1_ps(edgeA[2]);
+		__m128 dx = _mm_set1_ps(depthX);
+		__m128 zero = _mm_setzero_ps();
+		for (int x = minX; x <= maxX; x += 4) {
+			__m128 centreX = _mm_add_ps(_mm_set1_ps((float) x), _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f));
+			__m128 inside = _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a0, centreX), rowEdge0), zero);
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a1, centreX), rowEdge1), zero));
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a2, centreX), rowEdge2), zero));
+			if (_mm_movemask_ps(inside) == 0)
+				continue;
+			__m128 current = _mm_loadu_ps(row + x);
+			__m128 nearest = _mm_min_ps(current, _mm_add_ps(_mm_mul_ps(dx, centreX), rowDepth));
+			_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, current)));
+		}
+#else
+		for (int x = minX; x <= maxX; x++) {
+			float centreX = x + 0.5f;
+			if (edgeA[0] * centreX + edgeB[0] * centreY + edgeC[0] < 0 ||
+				edgeA[1] * centreX + edgeB[1] * centreY + edgeC[1] < 0 ||
+				edgeA[2] * centreX + edgeB[2] * centreY + edgeC[2] < 0)
+				continue;
+			row[x] = std::min(row[x], depthX * centreX + depthY * centreY + depthC);
+		}
+#endif
+	}
+}
+
+void OcclusionCuller::test(std::vector<OcclusionQuery>& queries) {
+	PROFILE_SCOPE("OcclusionCuller::test");
+	m_queries = &queries;
+	run(TASK_TEST, (queries.size() + QUERIES_PER_JOB - 1) / QUERIES_PER_JOB);
+	m_queries = NULL;
+
+	m_numTested += queries.size();
+	for (unsigned int a = 0; a < queries.size(); a++) {
+		if (! queries[a].visible)
+			m_numRejected++;
+	}
+}
+
+bool OcclusionCuller::isVisible(OcclusionQuery& query) {
+	//Find the area of the screen the box covers, and its nearest depth
+	float minX = m_width;
+	float maxX = 0;
+	float minY = m_height;
+	float maxY = 0;
+	float minDepth = 1.0f;
+	for (unsigned int a = 0; a < 8; a++) {
+		ScreenVertex corner = project(m_projectionView, (a & 1) ? query.max.getX() : query.min.getX(),
+														(a & 2) ? query.max.getY() : query.min.getY(),
+														(a & 4) ? query.max.getZ() : query.min.getZ());
+		//Boxes crossing the near plane are right in front of the camera
+		if (corner.clipped)
+			return true;
+		minX = std::min(minX, corner.x);
+		maxX = std::max(maxX, corner.x);
+		minY = std::min(minY, corner.y);
+		maxY = std::max(maxY, corner.y);
+		minDepth = std::min(minDepth, corner.z);
+	}
+	int startX = std::max(0, (int) floor(minX));
+	int endX = std::min((int) m_width - 1, (int) floor(maxX));
+	int startY = std::max(0, (int) floor(minY));
+	int endY = std::min((int) m_height - 1, (int) floor(maxY));
+	//Boxes off the screen are left to be culled by the frustum
+	if (startX > endX || startY > endY)
+		return true;
+
+	for (int tileY = startY / TILE_SIZE; tileY <= endY / (int) TILE_SIZE; tileY++) {
+		for (int tileX = startX / TILE_SIZE; tileX <= endX / (int) TILE_SIZE; tileX++) {
+			//Only look at the pixels when something in the tile is farther than the box
+			if (minDepth > m_tileDepth[tileY * m_tilesX + tileX])
+				continue;
+			int y0 = std::max(startY, tileY * (int) TILE_SIZE);
+			int y1 = std::min(endY, (tileY + 1) * (int) TILE_SIZE - 1);
+			int x0 = std::max(startX, tileX * (int) TILE_SIZE);
+			int x1 = std::min(endX, (tileX + 1) * (int) TILE_SIZE - 1);
+			for (int y = y0; y <= y1; y++) {
+				const float* row = &m_depth[y * m_width];
+				for (int x = x0; x <= x1; x++) {
+					if (minDepth <= row[x])
+						return true;
+				}
+			}
+		}
+	}
+	return false;
+}
+
+/***************************************************************************************************/
@@ -0,0 +1,180 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef CORE_RENDER_OCCLUSIONCULLER_H_
+#define CORE_RENDER_OCCLUSIONCULLER_H_
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+#include "../Vector.h"
+
+class Matrix4f;
+class MeshData;
+
+/***************************************************************************************************
+ * The OcclusionQuery structure stores a world space bounding box to test against the depth
+ * buffer of an OcclusionCuller, along with the result
+ ***************************************************************************************************/
+
+struct OcclusionQuery {
+	Vector3f min;
+	Vector3f max;
+	bool visible;
+};
+
+/***************************************************************************************************/
+
+/***************************************************************************************************
+ * The OcclusionCuller class rasterises the triangles of occluders into a low resolution depth
+ * buffer on the CPU, so the bounding boxes of objects can be tested against it to find those that
+ * are hidden before they are drawn. The buffer is split into bands of rows that are rasterised on
+ * separate threads, and the farthest depth in each tile is kept so most boxes can be tested
+ * without looking at every pixel they cover. It doesn't need an OpenGL context
+ ***************************************************************************************************/
+
+class OcclusionCuller {
+private:
+	/* The size of the tiles the farthest depth is kept for, and the height of each band */
+	static const unsigned int TILE_SIZE = 8;
+
+	/* The number of queries tested by each job */
+	static const unsigned int QUERIES_PER_JOB = 64;
+
+	/* A triangle in screen space, wound anticlockwise */
+	struct Triangle {
+		float x[3];
+		float y[3];
+		float z[3];
+		int minX;
+		int maxX;
+		int minY;
+		int maxY;
+	};
+
+	/* A vertex in screen space, or one that is behind the near plane */
+	struct ScreenVertex {
+		float x;
+		float y;
+		float z;
+		bool clipped;
+	};
+
+	/* The work the threads can be given */
+	enum Task {
+		TASK_RASTERISE,
+		TASK_TEST
+	};
+
+	unsigned int m_width;
+	unsigned int m_height;
+	unsigned int m_tilesX;
+	unsigned int m_tilesY;
+
+	/* The depth of each pixel between 0 (near) and 1 (far), and the farthest depth in each tile */
+	std::vector<float> m_depth;
+	std::vector<float> m_tileDepth;
+
+	/* The projection view matrix for this frame, with its rows stored one after another */
+	float m_projectionView[16];
+
+	/* The triangles added this frame, and the ones that cross each band */
+	std::vector<Triangle> m_triangles;
+	std::vector<std::vector<unsigned int>> m_bins;
+	std::vector<ScreenVertex> m_vertices;
+
+	/* The queries being tested by the threads */
+	std::vector<OcclusionQuery>* m_queries = NULL;
+
+	/* The threads that help the calling thread, and what they are working on */
+	std::vector<std::thread> m_threads;
+	std::mutex m_mutex;
+	std::condition_variable m_startCondition;
+	std::condition_variable m_doneCondition;
+	unsigned int m_generation = 0;
+	unsigned int m_numBusy = 0;
+	bool m_running = true;
+	Task m_task = TASK_RASTERISE;
+	unsigned int m_numJobs = 0;
+	std::atomic<unsigned int> m_nextJob;
+
+	/* The stats from the last frame */
+	double m_rasteriseTime = 0;
+	unsigned int m_numTested = 0;
+	unsigned int m_numRejected = 0;
+
+	/* Run by each of the threads, waiting for work to be given to them */
+	void worker();
+
+	/* Gives the threads a task split into a number of jobs, and helps with it until it is done */
+	void run(Task task, unsigned int numJobs);
+
+	/* Takes the next job until there are none left */
+	void work();
+
+	/* Rasterises the triangles crossing a band, then finds the farthest depth of its tiles */
+	void rasteriseBand(unsigned int band);
+	void rasterise(const Triangle& triangle, int minY, int maxY);
+
+	/* Tests a query against the depth buffer */
+	bool isVisible(OcclusionQuery& query);
+
+	/* Transforms a point into screen space by a matrix with its rows stored one after another */
+	ScreenVertex project(const float* matrix, float x, float y, float z);
+public:
+	/* Creates a culler with a depth buffer of the given size, and a number of threads to help
+	 * the calling thread */
+	OcclusionCuller(unsigned int width, unsigned int height, unsigned int numThreads);
+	/* Uses a thread for each processor other than the calling thread's */
+	OcclusionCuller(unsigned int width, unsigned int height);
+	virtual ~OcclusionCuller();
+
+	/* Clears the occluders from the last frame and sets the view to use for this one */
+	void begin(const Matrix4f& projectionView);
+
+	/* Adds the triangles of a mesh to be rasterised, triangles crossing the near plane are left out
+	 * as nothing can be known about what they hide without clipping them */
+	void addOccluder(MeshData* data, const Matrix4f& modelMatrix);
+
+	/* Rasterises every occluder added since begin into the depth buffer */
+	void rasterise();
+
+	/* Tests the bounding boxes of queries against the depth buffer, setting whether each of them
+	 * may be visible */
+	void test(std::vector<OcclusionQuery>& queries);
+
+	inline unsigned int getWidth() { return m_width; }
+	inline unsigned int getHeight() { return m_height; }
+	inline const std::vector<float>& getDepth() { return m_depth; }
+	inline unsigned int getNumThreads() { return m_threads.size(); }
+	inline unsigned int getNumTriangles() { return m_triangles.size(); }
+
+	/* Returns the time taken by the last call to rasterise in milliseconds */
+	inline double getRasteriseTime() { return m_rasteriseTime; }
+
+	/* Returns the number of queries tested since begin, and how many of them were hidden */
+	inline unsigned int getNumTested() { return m_numTested; }
+	inline unsigned int getNumRejected() { return m_numRejected; }
+};
+
+/***************************************************************************************************/
+
+#endif /* CORE_RENDER_OCCLUSIONCULLER_H_ */
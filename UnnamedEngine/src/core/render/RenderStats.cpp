@@ -0,0 +1,108 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include "RenderStats.h"
+#include "../../utils/StringUtils.h"
+
+/***************************************************************************************************
+ * The RenderStats class
+ ***************************************************************************************************/
+
+RenderStats::Frame RenderStats::m_current;
+std::vector<RenderStats::Frame> RenderStats::m_window;
+unsigned int RenderStats::m_windowSize = 120;
+unsigned int RenderStats::m_windowStart = 0;
+
+void RenderStats::nextFrame() {
+	if (m_window.size() < m_windowSize)
+		m_window.push_back(m_current);
+	else {
+		m_window[m_windowStart] = m_current;
+		m_windowStart = (m_windowStart + 1) % m_window.size();
+	}
+	for (unsigned int a = 0; a < RENDER_STAT_COUNT; a++)
+		m_current.values[a] = 0;
+}
+
+void RenderStats::setWindowSize(unsigned int windowSize) {
+	m_window.clear();
+	m_windowStart = 0;
+	m_windowSize = windowSize > 0 ? windowSize : 1;
+}
+
+unsigned long long RenderStats::getLast(RenderStat stat) {
+	if (m_window.empty())
+		return 0;
+	//The newest frame is the one before the oldest
+	return m_window[(m_windowStart + m_window.size() - 1) % m_window.size()].values[stat];
+}
+
+unsigned long long RenderStats::getMin(RenderStat stat) {
+	if (m_window.empty())
+		return 0;
+	unsigned long long min = m_window[0].values[stat];
+	for (unsigned int a = 1; a < m_window.size(); a++) {
+		if (m_window[a].values[stat] < min)
+			min = m_window[a].values[stat];
+	}
+	return min;
+}
+
+unsigned long long RenderStats::getMax(RenderStat stat) {
+	unsigned long long max = 0;
+	for (unsigned int a = 0; a < m_window.size(); a++) {
+		if (m_window[a].values[stat] > max)
+			max = m_window[a].values[stat];
+	}
+	return max;
+}
+
+double RenderStats::getAverage(RenderStat stat) {
+	if (m_window.empty())
+		return 0;
+	unsigned long long total = 0;
+	for (unsigned int a = 0; a < m_window.size(); a++)
+		total += m_window[a].values[stat];
+	return (double) total / (double) m_window.size();
+}
+
+std::string RenderStats::getName(RenderStat stat) {
+	switch (stat) {
+		case RENDER_STAT_DRAW_CALLS:         return "Draw Calls";
+		case RENDER_STAT_INDEXED_DRAW_CALLS: return "Indexed Draw Calls";
+		case RENDER_STAT_ARRAY_DRAW_CALLS:   return "Array Draw Calls";
+		case RENDER_STAT_PRIMITIVES:         return "Primitives";
+		case RENDER_STAT_SHADER_SWITCHES:    return "Shader Switches";
+		case RENDER_STAT_TEXTURE_BINDS:      return "Texture Binds";
+		case RENDER_STAT_BUFFER_BYTES:       return "Buffer Bytes";
+		case RENDER_STAT_UNIFORM_UPLOADS:    return "Uniform Uploads";
+		case RENDER_STAT_STATE_CHANGES:      return "State Changes";
+		case RENDER_STAT_STATE_CHANGES_SKIPPED: return "State Changes Skipped";
+		case RENDER_STAT_INDIRECT_COMMANDS:  return "Indirect Commands";
+		case RENDER_STAT_FRUSTUM_CULLED_OBJECTS: return "Frustum Culled Objects";
+		case RENDER_STAT_OCCLUDED_OBJECTS:   return "Occluded Objects";
+		case RENDER_STAT_CULLED_PRIMITIVES:  return "Culled Primitives";
+		default:                             return "Unknown";
+	}
+}
+
+std::string RenderStats::toString(RenderStat stat) {
+	return getName(stat) + ": " + to_string(getLast(stat)) + " (min " + to_string(getMin(stat)) + ", avg " + to_string((long) getAverage(stat)) + ", max " + to_string(getMax(stat)) + ")";
+}
+
+/***************************************************************************************************/
@@ -0,0 +1,124 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef CORE_RENDER_RENDERSTATS_H_
+#define CORE_RENDER_RENDERSTATS_H_
+
+#include <windows.h>
+#include <GL/GLEW/glew.h>
+#include <string>
+#include <vector>
+
+/***************************************************************************************************
+ * The RenderStat enum lists the values counted each frame
+ ***************************************************************************************************/
+
+enum RenderStat {
+	RENDER_STAT_DRAW_CALLS,
+	RENDER_STAT_INDEXED_DRAW_CALLS,
+	RENDER_STAT_ARRAY_DRAW_CALLS,
+	RENDER_STAT_PRIMITIVES,
+	RENDER_STAT_SHADER_SWITCHES,
+	RENDER_STAT_TEXTURE_BINDS,
+	RENDER_STAT_BUFFER_BYTES,
+	RENDER_STAT_UNIFORM_UPLOADS,
+	RENDER_STAT_STATE_CHANGES,
+	RENDER_STAT_STATE_CHANGES_SKIPPED,
+	RENDER_STAT_INDIRECT_COMMANDS,
+	RENDER_STAT_FRUSTUM_CULLED_OBJECTS,
+	RENDER_STAT_OCCLUDED_OBJECTS,
+	RENDER_STAT_CULLED_PRIMITIVES,
+	RENDER_STAT_COUNT
+};
+
+/***************************************************************************************************/
+
+/***************************************************************************************************
+ * The RenderStats class counts the work submitted to OpenGL each frame, and keeps the counts from
+ * a window of recent frames so the minimum, average and maximum can be found
+ ***************************************************************************************************/
+
+class RenderStats {
+private:
+	/* The counts from a single frame */
+	struct Frame {
+		unsigned long long values[RENDER_STAT_COUNT];
+	};
+
+	/* The counts for the frame currently being rendered */
+	static Frame m_current;
+
+	/* The most recent complete frames, used as a ring with m_windowStart being the oldest */
+	static std::vector<Frame> m_window;
+	static unsigned int m_windowSize;
+	static unsigned int m_windowStart;
+public:
+	static inline void add(RenderStat stat, unsigned long long amount) { m_current.values[stat] += amount; }
+	static inline void increment(RenderStat stat) { m_current.values[stat]++; }
+
+	/* Counts a draw call along with the triangles drawn */
+	static inline void addDraw(bool indexed, unsigned long long numVertices) {
+		m_current.values[RENDER_STAT_DRAW_CALLS]++;
+		m_current.values[indexed ? RENDER_STAT_INDEXED_DRAW_CALLS : RENDER_STAT_ARRAY_DRAW_CALLS]++;
+		m_current.values[RENDER_STAT_PRIMITIVES] += numVertices / 3;
+	}
+
+	/* Counts a multi draw call as a single draw, along with the commands within it */
+	static inline void addMultiDraw(bool indexed, unsigned long long numCommands, unsigned long long numVertices) {
+		addDraw(indexed, numVertices);
+		m_current.values[RENDER_STAT_INDIRECT_COMMANDS] += numCommands;
+	}
+
+	/* Wrappers around glBufferData and glBufferSubData that count the bytes uploaded */
+	static inline void bufferData(GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage) {
+		glBufferData(target, size, data, usage);
+		if (data != NULL)
+			m_current.values[RENDER_STAT_BUFFER_BYTES] += size;
+	}
+	static inline void bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid* data) {
+		glBufferSubData(target, offset, size, data);
+		m_current.values[RENDER_STAT_BUFFER_BYTES] += size;
+	}
+
+	/* Adds the counts for the current frame to the window and starts counting the next one */
+	static void nextFrame();
+
+	/* Changes the number of frames in the window, this clears it */
+	static void setWindowSize(unsigned int windowSize);
+
+	/* Returns the counts from the last complete frame and over the window */
+	static unsigned long long getLast(RenderStat stat);
+	static unsigned long long getMin(RenderStat stat);
+	static unsigned long long getMax(RenderStat stat);
+	static double getAverage(RenderStat stat);
+
+	/* Returns the counts so far in the frame being rendered */
+	static inline unsigned long long getCurrent(RenderStat stat) { return m_current.values[stat]; }
+
+	static inline unsigned int getWindowSize() { return m_windowSize; }
+	static inline unsigned int getNumFrames() { return m_window.size(); }
+
+	static std::string getName(RenderStat stat);
+
+	/* Returns a line describing a value, e.g. for an overlay or a log */
+	static std::string toString(RenderStat stat);
+};
+
+/***************************************************************************************************/
+
+#endif /* CORE_RENDER_RENDERSTATS_H_ */
@@ -19,6 +19,9 @@
 #include "../../utils/FileUtils.h"
 #include "../ResourceLoader.h"
 #include "lighting/Light.h"
+#include "ShaderManager.h"
+#include "SpriteBatch.h"
+#include "MultiDraw.h"
 
 #include "Renderer.h"
 
@@ -26,7 +29,8 @@
  * The Renderer class is responsible for rendering
  ***************************************************************************************************/
 std::vector<Camera*> Renderer::m_cameras;
-std::map<std::string, RenderShader*> Renderer::m_shaders;
+std::vector<RenderShader*> Renderer::m_shaders;
+std::map<std::string, unsigned int> Renderer::m_shaderHandles;
 
 Texture* Renderer::TEXTURE_BLANK;
 
@@ -34,7 +38,45 @@ std::vector<Texture*> Renderer::m_boundTextures;
 
 Shader* Renderer::m_overrideShader;
 
-void Renderer::render(Mesh* mesh, Matrix4f modelMatrix, std::string shaderType) {
+UberShader* Renderer::m_lightingShader;
+
+/* The names of the shader types the Renderer sets up, in the order of their handles */
+static const char* BUILT_IN_SHADER_TYPES[SHADER_TYPE_BUILT_IN_COUNT] = {
+	"Basic", "SkyBox", "Material", "Quad", "AmbientLight", "DirectionalLight", "PointLight", "SpotLight"
+};
+
+unsigned int Renderer::getShaderHandle(const std::string& type) {
+	//The built in types are added first so they always have the same handles
+	if (m_shaderHandles.empty()) {
+		for (unsigned int a = 0; a < SHADER_TYPE_BUILT_IN_COUNT; a++) {
+			m_shaderHandles.insert(std::pair<std::string, unsigned int>(BUILT_IN_SHADER_TYPES[a], a));
+			m_shaders.push_back(NULL);
+		}
+	}
+	std::map<std::string, unsigned int>::iterator iterator = m_shaderHandles.find(type);
+	if (iterator != m_shaderHandles.end())
+		return iterator->second;
+
+	unsigned int handle = m_shaders.size();
+	m_shaderHandles.insert(std::pair<std::string, unsigned int>(type, handle));
+	m_shaders.push_back(NULL);
+	return handle;
+}
+
+/* The names of the uniforms set for every draw, kept so they aren't allocated each time */
+static const std::string RENDERER_MVP_MATRIX = "ModelViewProjectionMatrix";
+static const std::string RENDERER_TEXTURE_AREA = "TextureArea";
+
+void Renderer::render(Mesh* mesh, const Matrix4f& modelMatrix, unsigned int shaderType) {
+	//The shared quad has no colours or texture coordinates of its own
+	if (MeshBuilder::isUnitQuad(mesh)) {
+		renderQuad(mesh, modelMatrix, mesh->getTexture(), Colour::WHITE);
+		return;
+	}
+	//Anything waiting to be drawn by a SpriteBatch has to be drawn first to keep the order
+	if (SpriteBatch::isBatching())
+		SpriteBatch::getCurrent()->flush();
+
 	Shader* currentShader = getShader(shaderType);
 	if (currentShader != NULL) {
 		Matrix4f mvp = (getCamera()->getProjectionViewMatrix() * modelMatrix).transpose();
@@ -47,85 +89,137 @@ void Renderer::render(Mesh* mesh, Matrix4f modelMatrix, std::string shaderType)
 			else
 				glUniform1i(currentShader->getUniformLocation("Texture"), Renderer::bindTexture(TEXTURE_BLANK));
 		}
-		glUniformMatrix4fv(currentShader->getUniformLocation("ModelViewProjectionMatrix"), 1, GL_FALSE, &(mvp.m_values[0][0]));
+		glUniformMatrix4fv(currentShader->getUniformLocation(RENDERER_MVP_MATRIX), 1, GL_FALSE, &(mvp.m_values[0][0]));
+		RenderStats::add(RENDER_STAT_UNIFORM_UPLOADS, mesh->getRenderData()->hasMaterial() ? 1 : 2);
 		mesh->render();
-		currentShader->stopUsing();
-		Renderer::unbindTetxures();
+		Renderer::releaseTextures();
+	}
+}
+
+void Renderer::renderQuad(Mesh* mesh, const Matrix4f& modelMatrix, Texture* texture, Colour colour) {
+	if (SpriteBatch::isBatching())
+		SpriteBatch::getCurrent()->flush();
+
+	Shader* currentShader = getShader(SHADER_TYPE_QUAD);
+	if (currentShader != NULL) {
+		if (texture == NULL)
+			texture = TEXTURE_BLANK;
+		Matrix4f mvp = (getCamera()->getProjectionViewMatrix() * modelMatrix).transpose();
+		currentShader->use();
+		glUniform1i(currentShader->getUniformLocation("Texture"), Renderer::bindTexture(texture));
+		glUniformMatrix4fv(currentShader->getUniformLocation(RENDERER_MVP_MATRIX), 1, GL_FALSE, &(mvp.m_values[0][0]));
+		glUniform4f(currentShader->getUniformLocation("Colour"), colour.getR(), colour.getG(), colour.getB(), colour.getA());
+		//The area of the texture to use, which is only part of it when it is in an atlas
+		glUniform4f(currentShader->getUniformLocation(RENDERER_TEXTURE_AREA), texture->left, texture->top, texture->right, texture->bottom);
+		RenderStats::add(RENDER_STAT_UNIFORM_UPLOADS, 4);
+		mesh->render();
+		Renderer::releaseTextures();
 	}
 }
 
 void Renderer::initialise() {
+	//Nothing is known about the state of the context yet
+	GLState::reset();
+
 	//Initialise the textures
 	TEXTURE_BLANK = Texture::loadTexture("resources/textures/blank.png");
 
-	//Add the shaders
-	addShader("Basic", ResourceLoader::loadRenderShader("resources/shaders/", "BasicShader", "Basic"));
-	addShader("SkyBox", ResourceLoader::loadRenderShader("resources/shaders/", "SkyBoxShader", "SkyBox"));
-	addShader("Material", ResourceLoader::loadRenderShader("resources/shaders/", "MaterialShader", "Material"));
-	addShader("DirectionalLight", ResourceLoader::loadRenderShader("resources/shaders/lighting/", "DirectionalLight", "DirectionalLight"));
-	addShader("PointLight", ResourceLoader::loadRenderShader("resources/shaders/lighting/", "PointLight", "PointLight"));
-	addShader("SpotLight", ResourceLoader::loadRenderShader("resources/shaders/lighting/", "SpotLight", "SpotLight"));
-	addShader("AmbientLight", ResourceLoader::loadRenderShader("resources/shaders/lighting/", "AmbientLight", "AmbientLight"));
+	//The shaders that should be loaded (path, name) and their types
+	const char* shaders[][2] = {
+		{ "resources/shaders/", "BasicShader" },
+		{ "resources/shaders/", "SkyBoxShader" },
+		{ "resources/shaders/", "MaterialShader" },
+		{ "resources/shaders/", "QuadShader" }
+	};
+	const unsigned int shaderTypes[] = { SHADER_TYPE_BASIC, SHADER_TYPE_SKYBOX, SHADER_TYPE_MATERIAL, SHADER_TYPE_QUAD };
+	const unsigned int numShaders = sizeof(shaders) / sizeof(shaders[0]);
+
+	//The permutations of the lighting shader used for each type of light
+	const unsigned int lightingFeatures = SHADER_FEATURE_TEXTURE | SHADER_FEATURE_NORMALS;
+	const unsigned int lightingTypes[] = { SHADER_TYPE_AMBIENT_LIGHT, SHADER_TYPE_DIRECTIONAL_LIGHT, SHADER_TYPE_POINT_LIGHT, SHADER_TYPE_SPOT_LIGHT };
+	const unsigned int lightingKeys[] = {
+		SHADER_FEATURE_AMBIENT_LIGHT | lightingFeatures,
+		SHADER_FEATURE_DIRECTIONAL_LIGHT | lightingFeatures,
+		SHADER_FEATURE_POINT_LIGHT | lightingFeatures,
+		SHADER_FEATURE_SPOT_LIGHT | lightingFeatures
+	};
+	const unsigned int numLightingTypes = sizeof(lightingKeys) / sizeof(lightingKeys[0]);
+
+	//Submit all of the shaders before querying any of them so they can be compiled together
+	ShaderManager::initialise("resources/shaders/cache/");
+	std::vector<Shader*> loaded;
+	for (unsigned int a = 0; a < numShaders; a++)
+		loaded.push_back(ShaderManager::loadShader(shaders[a][0], shaders[a][1]));
+
+	m_lightingShader = new UberShader("resources/shaders/lighting/", "Lighting");
+	m_lightingShader->addUniformAlias("ModelViewProjectionMatrix", "mvpMatrix");
+	m_lightingShader->addAttributeAlias("Position", "position");
+	m_lightingShader->addAttributeAlias("TextureCoordinate", "textureCoord");
+	m_lightingShader->addAttributeAlias("Normal", "normal");
+	for (unsigned int a = 0; a < numLightingTypes; a++) {
+		m_lightingShader->prewarm(lightingKeys[a]);
+		//The permutations used by the Scene for meshes drawn together
+		if (MultiDraw::isSupported())
+			m_lightingShader->prewarm(lightingKeys[a] | SHADER_FEATURE_MULTI_DRAW);
+	}
+
+	ShaderManager::finish();
+
+	//Add the shaders, making sure the table has room for the built in types
+	getShaderHandle(BUILT_IN_SHADER_TYPES[0]);
+	for (unsigned int a = 0; a < numShaders; a++) {
+		setupShader(loaded[a], shaderTypes[a]);
+		addShader(shaderTypes[a], new RenderShader(loaded[a]));
+	}
+	for (unsigned int a = 0; a < numLightingTypes; a++)
+		addShader(lightingTypes[a], new RenderShader(m_lightingShader->getShader(lightingKeys[a])));
 }
 
-void Renderer::setupShader(Shader* shader, const char* type) {
-	if (std::string(type) == "Basic") {
+void Renderer::setupShader(Shader* shader, unsigned int type) {
+	//Anything used directly by its name in the shader is found by reflection, the rest are the
+	//names the engine uses for each shader type
+	shader->reflect();
+
+	if (type == SHADER_TYPE_BASIC) {
 		shader->addUniform("ModelViewProjectionMatrix", "mvpMatrix");
 		shader->addUniform("Texture", "tex");
 		shader->addAttribute("Position", "position");
 		shader->addAttribute("Colour", "colour");
 		shader->addAttribute("TextureCoordinate", "textureCoord");
-	} else if (std::string(type) == "Material") {
+	} else if (type == SHADER_TYPE_MATERIAL) {
 		shader->addUniform("ModelViewProjectionMatrix", "mvpMatrix");
 		shader->addAttribute("Position", "position");
 		shader->addAttribute("Colour", "colour");
 		shader->addAttribute("TextureCoordinate", "textureCoord");
-
-		Material::addUniforms(shader);
-	} else if (std::string(type) == "SkyBox") {
+	} else if (type == SHADER_TYPE_QUAD) {
 		shader->addUniform("ModelViewProjectionMatrix", "mvpMatrix");
 		shader->addUniform("Texture", "tex");
+		shader->addUniform("Colour", "colour");
+		shader->addUniform("TextureArea", "textureArea");
 		shader->addAttribute("Position", "position");
-	} else if (std::string(type).find("Light") != std::string::npos) {
-		shader->addUniform("NormalMatrix", "nMatrix");
+	} else if (type == SHADER_TYPE_SKYBOX) {
 		shader->addUniform("ModelViewProjectionMatrix", "mvpMatrix");
-
-		shader->addUniform("AmbientLight", "ambientLight");
-		shader->addUniform("SpecularIntensity", "specularIntensity");
-		shader->addUniform("EyePosition", "eyePosition");
-
-		Material::addUniforms(shader);
-
+		shader->addUniform("Texture", "tex");
 		shader->addAttribute("Position", "position");
-		shader->addAttribute("TextureCoordinate", "textureCoord");
-		shader->addAttribute("Normal", "normal");
-
-		if (std::string(type) == "DirectionalLight") {
-			DirectionalLight::addUniforms(shader, "", "directionalLight.");
-		} else if (std::string(type) == "PointLight") {
-			PointLight::addUniforms(shader, "", "pointLight.");
-		} else if (std::string(type) == "SpotLight") {
-			SpotLight::addUniforms(shader, "", "spotLight.");
-		}
 	} else {
-		logError("Unknown shader type '" + to_string(type) + "'");
+		logError("Unknown shader type " + to_string(type));
 	}
 }
 
 GLuint Renderer::bindTexture(Texture* texture) {
-	glActiveTexture(GL_TEXTURE0 + m_boundTextures.size());
+	GLState::activeTexture(m_boundTextures.size());
 	texture->bind();
+	//Without sampler objects the texture's own parameters are used, set when it was created
+	if (SamplerCache::isSupported())
+		GLState::bindSampler(m_boundTextures.size(), texture->getSampler());
 	m_boundTextures.push_back(texture);
 
 	return m_boundTextures.size() - 1;
 }
 
-void Renderer::unbindTetxures() {
-	while (m_boundTextures.size() > 0) {
-		glActiveTexture(GL_TEXTURE0 + m_boundTextures.size());
-		m_boundTextures.at(m_boundTextures.size() - 1)->unbind();
-		m_boundTextures.pop_back();
-	}
+void Renderer::releaseTextures() {
+	//The textures are left bound, so the next draw using the same ones doesn't have to bind them
+	m_boundTextures.clear();
 }
 
 /***************************************************************************************************/
@@ -22,6 +22,7 @@
 #include "../Mesh.h"
 #include "../Camera.h"
 #include "Shader.h"
+#include "UberShader.h"
 #include "Material.h"
 
 /***************************************************************************************************
@@ -31,34 +32,63 @@
 class Renderer {
 private:
 	static std::vector<Camera*> m_cameras;
-	static std::map<std::string, RenderShader*> m_shaders;
+
+	/* The shaders indexed by the handle of their type, the names of the types are only looked up
+	 * when a handle is needed */
+	static std::vector<RenderShader*> m_shaders;
+	static std::map<std::string, unsigned int> m_shaderHandles;
 
 	static std::vector<Texture*> m_boundTextures;
 
 	static Shader* m_overrideShader;
+
+	/* The shader used for all of the lighting, each type of light is a permutation of it */
+	static UberShader* m_lightingShader;
 public:
 	static Texture* TEXTURE_BLANK;
 	virtual ~Renderer() {}
 	static inline void addCamera(Camera* camera) { m_cameras.push_back(camera); }
-	static inline void addShader(std::string type, RenderShader* shader) { m_shaders.insert(std::pair<std::string, RenderShader*>(type, shader)); }
+	static inline void addShader(unsigned int handle, RenderShader* shader) { m_shaders[handle] = shader; }
+	static inline void addShader(const std::string& type, RenderShader* shader) { addShader(getShaderHandle(type), shader); }
 	static inline void removeCamera() { m_cameras.pop_back(); }
-	static inline void removeShader() { m_shaders.erase(m_shaders.end()); }
+	static inline void removeShader(unsigned int handle) { m_shaders[handle] = NULL; }
 	static inline void setShader(Shader* overrideShader) { m_overrideShader = overrideShader; }
 	static inline void resetShader() { m_overrideShader = NULL; }
 	static inline Camera* getCamera() { return m_cameras.back(); }
-	static inline RenderShader* getRenderShader(std::string type) { return m_shaders.at(type); }
-	static inline Shader* getShader(std::string type) {
-		if (m_overrideShader == NULL)
-			return m_shaders.at(type)->getShader();
+	static inline RenderShader* getRenderShader(unsigned int handle) { return m_shaders[handle]; }
+	static inline RenderShader* getRenderShader(const std::string& type) { return m_shaders[getShaderHandle(type)]; }
+	static inline UberShader* getLightingShader() { return m_lightingShader; }
+	static inline Shader* getOverrideShader() { return m_overrideShader; }
+	static inline Shader* getShader(unsigned int handle) {
+		if (m_overrideShader != NULL)
+			return m_overrideShader;
+		else if (m_shaders[handle] != NULL)
+			return m_shaders[handle]->getShader();
 		else
+			return NULL;
+	}
+	static inline Shader* getShader(const std::string& type) {
+		if (m_overrideShader != NULL)
 			return m_overrideShader;
+		return getShader(getShaderHandle(type));
 	}
+
+	/* Returns the handle of a shader type, giving it the next handle available if it hasn't been
+	 * used before. This should only be needed when loading, as the handle can be kept */
+	static unsigned int getShaderHandle(const std::string& type);
+
 	static void initialise();
-	static void setupShader(Shader* shader, const char* type);
-	static void render(Mesh* mesh, Matrix4f modelMatrix, std::string shaderType);
-	static inline void render(Mesh* mesh, Matrix4f modelMatrix) { render(mesh, modelMatrix, mesh->getRenderData()->getShaderType()); }
+	static void setupShader(Shader* shader, unsigned int type);
+	static void render(Mesh* mesh, const Matrix4f& modelMatrix, unsigned int shaderType);
+	static inline void render(Mesh* mesh, const Matrix4f& modelMatrix, const std::string& shaderType) { render(mesh, modelMatrix, getShaderHandle(shaderType)); }
+	static inline void render(Mesh* mesh, const Matrix4f& modelMatrix) { render(mesh, modelMatrix, mesh->getRenderData()->getShaderHandle()); }
+	/* Renders a mesh created by MeshBuilder::createUnitQuad with the given texture and colour */
+	static void renderQuad(Mesh* mesh, const Matrix4f& modelMatrix, Texture* texture, Colour colour);
+	/* Binds a texture to the next texture unit free for the current draw, returning the unit */
 	static GLuint bindTexture(Texture* texture);
-	static void unbindTetxures();
+
+	/* Frees the texture units used by the current draw */
+	static void releaseTextures();
 };
 
 /***************************************************************************************************/
@@ -0,0 +1,96 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include "SamplerCache.h"
+#include "GLState.h"
+
+/***************************************************************************************************
+ * The SamplerDescriptor class
+ ***************************************************************************************************/
+
+bool SamplerDescriptor::usesMipmaps() const {
+	return m_minFilter == GL_NEAREST_MIPMAP_NEAREST || m_minFilter == GL_NEAREST_MIPMAP_LINEAR ||
+		   m_minFilter == GL_LINEAR_MIPMAP_NEAREST || m_minFilter == GL_LINEAR_MIPMAP_LINEAR;
+}
+
+bool SamplerDescriptor::operator==(const SamplerDescriptor& other) const {
+	return m_minFilter == other.m_minFilter && m_magFilter == other.m_magFilter && m_wrapS == other.m_wrapS &&
+		   m_wrapT == other.m_wrapT && m_wrapR == other.m_wrapR && m_maxAnisotropy == other.m_maxAnisotropy;
+}
+
+bool SamplerDescriptor::operator<(const SamplerDescriptor& other) const {
+	if (m_minFilter != other.m_minFilter)
+		return m_minFilter < other.m_minFilter;
+	if (m_magFilter != other.m_magFilter)
+		return m_magFilter < other.m_magFilter;
+	if (m_wrapS != other.m_wrapS)
+		return m_wrapS < other.m_wrapS;
+	if (m_wrapT != other.m_wrapT)
+		return m_wrapT < other.m_wrapT;
+	if (m_wrapR != other.m_wrapR)
+		return m_wrapR < other.m_wrapR;
+	return m_maxAnisotropy < other.m_maxAnisotropy;
+}
+
+/***************************************************************************************************/
+
+/***************************************************************************************************
+ * The SamplerCache class
+ ***************************************************************************************************/
+
+std::map<SamplerDescriptor, GLuint> SamplerCache::m_samplers;
+float SamplerCache::m_maxAnisotropy = 0;
+
+GLuint SamplerCache::getSampler(const SamplerDescriptor& descriptor) {
+	if (! isSupported())
+		return 0;
+	std::map<SamplerDescriptor, GLuint>::iterator iterator = m_samplers.find(descriptor);
+	if (iterator != m_samplers.end())
+		return iterator->second;
+
+	GLuint sampler;
+	glGenSamplers(1, &sampler);
+	glSamplerParameteri(sampler, GL_TEXTURE_MIN_FILTER, descriptor.getMinFilter());
+	glSamplerParameteri(sampler, GL_TEXTURE_MAG_FILTER, descriptor.getMagFilter());
+	glSamplerParameteri(sampler, GL_TEXTURE_WRAP_S, descriptor.getWrapS());
+	glSamplerParameteri(sampler, GL_TEXTURE_WRAP_T, descriptor.getWrapT());
+	glSamplerParameteri(sampler, GL_TEXTURE_WRAP_R, descriptor.getWrapR());
+	if (descriptor.getMaxAnisotropy() > 1.0f)
+		glSamplerParameterf(sampler, GL_TEXTURE_MAX_ANISOTROPY_EXT, descriptor.getMaxAnisotropy());
+	m_samplers.insert(std::pair<SamplerDescriptor, GLuint>(descriptor, sampler));
+	return sampler;
+}
+
+void SamplerCache::destroy() {
+	for (std::map<SamplerDescriptor, GLuint>::iterator iterator = m_samplers.begin(); iterator != m_samplers.end(); iterator++)
+		GLState::deleteSampler(iterator->second);
+	m_samplers.clear();
+}
+
+void SamplerCache::applyToTexture(const SamplerDescriptor& descriptor, GLenum target) {
+	glTexParameteri(target, GL_TEXTURE_MIN_FILTER, descriptor.getMinFilter());
+	glTexParameteri(target, GL_TEXTURE_MAG_FILTER, descriptor.getMagFilter());
+	glTexParameteri(target, GL_TEXTURE_WRAP_S, descriptor.getWrapS());
+	glTexParameteri(target, GL_TEXTURE_WRAP_T, descriptor.getWrapT());
+	if (target == GL_TEXTURE_CUBE_MAP)
+		glTexParameteri(target, GL_TEXTURE_WRAP_R, descriptor.getWrapR());
+	if (descriptor.getMaxAnisotropy() > 1.0f)
+		glTexParameterf(target, GL_TEXTURE_MAX_ANISOTROPY_EXT, descriptor.getMaxAnisotropy());
+}
+
+/***************************************************************************************************/
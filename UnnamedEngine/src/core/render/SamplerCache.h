@@ -0,0 +1,93 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef CORE_RENDER_SAMPLERCACHE_H_
+#define CORE_RENDER_SAMPLERCACHE_H_
+
+#include <windows.h>
+#include <GL/GLEW/glew.h>
+#include <map>
+
+/***************************************************************************************************
+ * The SamplerDescriptor class describes how a texture is sampled, it can't be changed once it has
+ * been created so it can be used to find an existing sampler
+ ***************************************************************************************************/
+
+class SamplerDescriptor {
+private:
+	GLenum m_minFilter;
+	GLenum m_magFilter;
+	GLenum m_wrapS;
+	GLenum m_wrapT;
+	GLenum m_wrapR;
+	float m_maxAnisotropy;
+public:
+	SamplerDescriptor(GLenum minFilter, GLenum magFilter, GLenum wrap, float maxAnisotropy) :
+		m_minFilter(minFilter), m_magFilter(magFilter), m_wrapS(wrap), m_wrapT(wrap), m_wrapR(wrap), m_maxAnisotropy(maxAnisotropy) {}
+	SamplerDescriptor(GLenum minFilter, GLenum magFilter, GLenum wrapS, GLenum wrapT, GLenum wrapR, float maxAnisotropy) :
+		m_minFilter(minFilter), m_magFilter(magFilter), m_wrapS(wrapS), m_wrapT(wrapT), m_wrapR(wrapR), m_maxAnisotropy(maxAnisotropy) {}
+
+	/* Returns whether the minifying filter uses mipmaps */
+	bool usesMipmaps() const;
+
+	bool operator==(const SamplerDescriptor& other) const;
+	inline bool operator!=(const SamplerDescriptor& other) const { return ! (*this == other); }
+	bool operator<(const SamplerDescriptor& other) const;
+
+	inline GLenum getMinFilter() const { return m_minFilter; }
+	inline GLenum getMagFilter() const { return m_magFilter; }
+	inline GLenum getWrapS() const { return m_wrapS; }
+	inline GLenum getWrapT() const { return m_wrapT; }
+	inline GLenum getWrapR() const { return m_wrapR; }
+	inline float getMaxAnisotropy() const { return m_maxAnisotropy; }
+};
+
+/***************************************************************************************************/
+
+/***************************************************************************************************
+ * The SamplerCache class creates a single sampler object for each different descriptor, so
+ * textures with the same parameters share one. When sampler objects aren't supported, the
+ * parameters are set on each texture instead
+ ***************************************************************************************************/
+
+class SamplerCache {
+private:
+	static std::map<SamplerDescriptor, GLuint> m_samplers;
+
+	/* The most anisotropic samples used by samplers with mipmaps, taken from the settings */
+	static float m_maxAnisotropy;
+public:
+	/* Returns the sampler for a descriptor, creating it if there isn't one yet. Returns 0 when
+	 * sampler objects aren't supported */
+	static GLuint getSampler(const SamplerDescriptor& descriptor);
+
+	/* Deletes all of the samplers */
+	static void destroy();
+
+	/* Sets the parameters of a texture bound to a target, used when samplers aren't supported */
+	static void applyToTexture(const SamplerDescriptor& descriptor, GLenum target);
+
+	static inline bool isSupported() { return GLEW_ARB_sampler_objects; }
+	static inline void setMaxAnisotropy(float maxAnisotropy) { m_maxAnisotropy = maxAnisotropy; }
+	static inline float getMaxAnisotropy() { return m_maxAnisotropy; }
+	static inline unsigned int getNumSamplers() { return m_samplers.size(); }
+};
+
+/***************************************************************************************************/
+
+#endif /* CORE_RENDER_SAMPLERCACHE_H_ */
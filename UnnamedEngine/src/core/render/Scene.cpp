@@ -16,60 +16,528 @@
  *
  *****************************************************************************/
 
+#include <cstring>
+#include <cmath>
+#include <map>
+#include <typeinfo>
+
 #include "Scene.h"
 #include "Renderer.h"
+#include "MultiDraw.h"
+#include "../Model.h"
+#include "TextureStreamer.h"
+#include "../Profiler.h"
 
 /***************************************************************************************************
  * The Scene class
  ***************************************************************************************************/
 
+Scene::~Scene() {
+	for (unsigned int a = 0; a < m_staticBatches.size(); a++) {
+		Mesh* mesh = m_staticBatches[a].object->getMesh();
+		delete mesh->getRenderData();
+		delete mesh->getData();
+		delete mesh;
+		delete m_staticBatches[a].object;
+	}
+	if (m_occlusionCuller != NULL)
+		delete m_occlusionCuller;
+}
+
+void Scene::add(RenderableObject3D* object) {
+	m_objects.push_back(object);
+	m_indexedVersions.push_back(object->getTransformVersion());
+	addToIndex(object);
+}
+
+void Scene::remove(RenderableObject3D* object) {
+	for (unsigned int a = 0; a < m_objects.size(); a++) {
+		if (m_objects[a] == object) {
+			m_objects.erase(m_objects.begin() + a);
+			m_indexedVersions.erase(m_indexedVersions.begin() + a);
+			a--;
+		}
+	}
+	m_unbounded.erase(std::remove(m_unbounded.begin(), m_unbounded.end(), object), m_unbounded.end());
+	m_index.remove(object);
+	removeOccluder(object);
+}
+
+void Scene::addToIndex(RenderableObject3D* object) {
+	Vector3f min;
+	Vector3f max;
+	//There are usually very few objects without bounds
+	std::vector<RenderableObject3D*>::iterator unbounded = std::find(m_unbounded.begin(), m_unbounded.end(), object);
+	if (getWorldBounds(object, min, max)) {
+		m_index.update(object, min, max);
+		if (unbounded != m_unbounded.end())
+			m_unbounded.erase(unbounded);
+	} else {
+		m_index.remove(object);
+		if (unbounded == m_unbounded.end())
+			m_unbounded.push_back(object);
+	}
+}
+
+void Scene::reindex() {
+	m_index.clear();
+	m_unbounded.clear();
+	m_indexedVersions.clear();
+	for (unsigned int a = 0; a < m_objects.size(); a++) {
+		m_indexedVersions.push_back(m_objects.at(a)->getTransformVersion());
+		addToIndex(m_objects.at(a));
+	}
+}
+
 void Scene::update() {
-	for (unsigned int a = 0; a < m_objects.size(); a++)
-		m_objects.at(a)->update();
+	PROFILE_SCOPE("Scene::update");
+	//Only the objects that have moved need their bounds found again, and they are only moved
+	//within the index when they leave the bounds they were given
+	for (unsigned int a = 0; a < m_objects.size(); a++) {
+		RenderableObject3D* object = m_objects.at(a);
+		object->update();
+		if (object->getTransformVersion() != m_indexedVersions[a]) {
+			m_indexedVersions[a] = object->getTransformVersion();
+			addToIndex(object);
+		}
+	}
+}
+
+bool Scene::canMultiDraw() {
+	if (! m_multiDrawEnabled || ! MultiDraw::isSupported())
+		return false;
+	//Every light has to have a permutation of the lighting shader that can draw the list
+	for (unsigned int a = 0; a < m_lights.size(); a++) {
+		if (m_lights.at(a)->getShaderFeature() == 0)
+			return false;
+	}
+	return true;
+}
+
+void Scene::buildDrawList(Vector3f cameraPosition) {
+	PROFILE_SCOPE("Scene::buildDrawList");
+	m_drawList.clear();
+	m_multiDrawn.assign(m_visible.size(), false);
+
+	for (unsigned int a = 0; a < m_visible.size(); a++) {
+		//Only models are known to draw nothing but their meshes
+		Model* model = dynamic_cast<Model*>(m_visible.at(a));
+		if (model == NULL || model->getNumMeshes() == 0 || m_occluded[a])
+			continue;
+		bool shared = true;
+		for (unsigned int b = 0; b < model->getNumMeshes(); b++) {
+			MeshRenderData* renderData = model->getMesh(b)->getRenderData();
+			if (! renderData->isShared() || ! renderData->hasMaterial())
+				shared = false;
+		}
+		if (! shared)
+			continue;
+
+		//The matrices are stored the same way they are uploaded as uniforms
+		Matrix4f modelMatrix = model->getModelMatrix();
+		Matrix4f transposed = modelMatrix.transpose();
+		Matrix4f normalMatrix = modelMatrix.inverse().transpose();
+		DrawData data;
+		memcpy(data.modelMatrix, &transposed.m_values[0][0], sizeof(data.modelMatrix));
+		memcpy(data.normalMatrix, &normalMatrix.m_values[0][0], sizeof(data.normalMatrix));
+		data.padding[0] = data.padding[1] = data.padding[2] = 0.0f;
+
+		Meshlets::View view;
+		Meshlets::setupView(view, Renderer::getCamera()->getProjectionViewMatrix(), modelMatrix, cameraPosition, GLState::isEnabled(GL_CULL_FACE));
+
+		for (unsigned int b = 0; b < model->getNumMeshes(); b++) {
+			MeshRenderData* renderData = model->getMesh(b)->getRenderData();
+			Material* material = renderData->getMaterial();
+			Colour colour = material->getDiffuseColour();
+			data.diffuseColour[0] = colour.getR();
+			data.diffuseColour[1] = colour.getG();
+			data.diffuseColour[2] = colour.getB();
+			data.diffuseColour[3] = colour.getA();
+			data.shininess = material->getShininess();
+
+			const MeshBufferRange& range = renderData->getBufferRange();
+			MeshData* meshData = model->getMesh(b)->getData();
+			if (meshData != NULL && meshData->getMeshlets().size() > 1) {
+				//Every range left uses the same data
+				m_meshletRanges.clear();
+				unsigned int numTriangles = Meshlets::cull(meshData->getMeshlets(), view, m_meshletRanges);
+				RenderStats::add(RENDER_STAT_CULLED_PRIMITIVES, meshData->getNumTriangles() - numTriangles);
+				unsigned int index = m_meshletRanges.empty() ? 0 : m_drawList.addData(data);
+				for (unsigned int c = 0; c < m_meshletRanges.size(); c++) {
+					unsigned int first = m_meshletRanges[c].firstTriangle * 3;
+					unsigned int count = m_meshletRanges[c].numTriangles * 3;
+					if (renderData->hasIndices())
+						m_drawList.addElements(range.format, material->getDiffuseTexture(), count, range.indices.offset / sizeof(unsigned int) + first, range.baseVertex, index);
+					else
+						m_drawList.addArrays(range.format, material->getDiffuseTexture(), count, range.baseVertex + first, index);
+				}
+			} else if (renderData->hasIndices())
+				m_drawList.addElements(range.format, material->getDiffuseTexture(), renderData->getNumVertices(), range.indices.offset / sizeof(unsigned int), range.baseVertex, data);
+			else
+				m_drawList.addArrays(range.format, material->getDiffuseTexture(), renderData->getNumVertices(), range.baseVertex, data);
+		}
+		m_multiDrawn[a] = true;
+	}
+	m_drawList.build();
+	MultiDraw::upload(m_drawList);
+}
+
+void Scene::renderDrawList(Shader* shader) {
+	//The model matrix of each draw is applied in the shader
+	shader->setUniform("ModelViewProjectionMatrix", Renderer::getCamera()->getProjectionViewMatrix().transpose());
+	MultiDraw::render(m_drawList, shader);
+}
+
+bool Scene::StaticBatchKey::operator<(const StaticBatchKey& other) const {
+	if (shaderHandle != other.shaderHandle)
+		return shaderHandle < other.shaderHandle;
+	if (attributes != other.attributes)
+		return attributes < other.attributes;
+	if (texture != other.texture)
+		return std::less<Texture*>()(texture, other.texture);
+	if (material != other.material)
+		return std::less<Material*>()(material, other.material);
+	if (x != other.x)
+		return x < other.x;
+	if (y != other.y)
+		return y < other.y;
+	return z < other.z;
+}
+
+bool Scene::canBake(RenderableObject3D* object) {
+	//Only objects the game has said won't move are merged, as moving them afterwards would do nothing
+	if (! object->isStatic())
+		return false;
+	//Classes extending RenderableObject3D may render more than their mesh
+	if (typeid(*object) != typeid(RenderableObject3D))
+		return false;
+	Mesh* mesh = object->getMesh();
+	return mesh != NULL && mesh->getData() != NULL && mesh->getData()->hasPositions() && ! MeshBuilder::isUnitQuad(mesh);
+}
+
+void Scene::addBaked(MeshData* data, RenderableObject3D* object) {
+	MeshData* source = object->getMesh()->getData();
+	Matrix4f m = object->getModelMatrix();
+	Matrix4f n = m.inverse().transpose();
+	unsigned int first = data->getNumPositions();
+
+	for (unsigned int a = 0; a < source->getNumPositions(); a++) {
+		const float* p = source->getValues(MeshBuffers::ATTRIBUTE_POSITION, a);
+		data->addPosition(Vector3f(m.m_values[0][0] * p[0] + m.m_values[0][1] * p[1] + m.m_values[0][2] * p[2] + m.m_values[0][3],
+								   m.m_values[1][0] * p[0] + m.m_values[1][1] * p[1] + m.m_values[1][2] * p[2] + m.m_values[1][3],
+								   m.m_values[2][0] * p[0] + m.m_values[2][1] * p[1] + m.m_values[2][2] * p[2] + m.m_values[2][3]));
+		if (source->hasColours()) {
+			const float* c = source->getValues(MeshBuffers::ATTRIBUTE_COLOUR, a);
+			data->addColour(Vector4f(c[0], c[1], c[2], c[3]));
+		}
+		if (source->hasTextureCoords()) {
+			const float* t = source->getValues(MeshBuffers::ATTRIBUTE_TEXTURE_COORD, a);
+			data->addTextureCoord(Vector2f(t[0], t[1]));
+		}
+		if (source->hasNormals()) {
+			//Normals are transformed by the inverse transpose so scaling doesn't skew them
+			const float* v = source->getValues(MeshBuffers::ATTRIBUTE_NORMAL, a);
+			float x = n.m_values[0][0] * v[0] + n.m_values[0][1] * v[1] + n.m_values[0][2] * v[2];
+			float y = n.m_values[1][0] * v[0] + n.m_values[1][1] * v[1] + n.m_values[1][2] * v[2];
+			float z = n.m_values[2][0] * v[0] + n.m_values[2][1] * v[1] + n.m_values[2][2] * v[2];
+			float length = sqrt(x * x + y * y + z * z);
+			if (length > 0)
+				data->addNormal(Vector3f(x / length, y / length, z / length));
+			else
+				data->addNormal(Vector3f(x, y, z));
+		}
+	}
+
+	//Merged meshes are always indexed, so meshes without indices are given them
+	if (source->hasIndices()) {
+		std::vector<unsigned int>& indices = source->getIndices();
+		for (unsigned int a = 0; a < indices.size(); a++)
+			data->addIndex(first + indices[a]);
+	} else {
+		for (unsigned int a = 0; a < source->getNumPositions(); a++)
+			data->addIndex(first + a);
+	}
+}
+
+unsigned int Scene::bakeStatic(float cellSize) {
+	PROFILE_SCOPE("Scene::bakeStatic");
+	//Group the objects that can be drawn together by the cell the centre of their bounds is in
+	std::map<StaticBatchKey, std::vector<RenderableObject3D*>> groups;
+	std::vector<RenderableObject3D*> remaining;
+	for (unsigned int a = 0; a < m_objects.size(); a++) {
+		RenderableObject3D* object = m_objects.at(a);
+		if (! canBake(object)) {
+			remaining.push_back(object);
+			continue;
+		}
+		Mesh* mesh = object->getMesh();
+		MeshData* data = mesh->getData();
+		Matrix4f m = object->getModelMatrix();
+		Vector3f centre = (data->getBoundsMin() + data->getBoundsMax()) * 0.5f;
+		float x = m.m_values[0][0] * centre.getX() + m.m_values[0][1] * centre.getY() + m.m_values[0][2] * centre.getZ() + m.m_values[0][3];
+		float y = m.m_values[1][0] * centre.getX() + m.m_values[1][1] * centre.getY() + m.m_values[1][2] * centre.getZ() + m.m_values[1][3];
+		float z = m.m_values[2][0] * centre.getX() + m.m_values[2][1] * centre.getY() + m.m_values[2][2] * centre.getZ() + m.m_values[2][3];
+
+		StaticBatchKey key;
+		key.shaderHandle = mesh->getRenderData()->getShaderHandle();
+		key.attributes = (data->hasColours() ? MeshBuffers::ATTRIBUTE_COLOUR : 0) | (data->hasTextureCoords() ? MeshBuffers::ATTRIBUTE_TEXTURE_COORD : 0) |
+						 (data->hasNormals() ? MeshBuffers::ATTRIBUTE_NORMAL : 0);
+		key.texture = mesh->getTexture();
+		key.material = mesh->getRenderData()->getMaterial();
+		key.x = (int) floor(x / cellSize);
+		key.y = (int) floor(y / cellSize);
+		key.z = (int) floor(z / cellSize);
+		groups[key].push_back(object);
+	}
+
+	unsigned int numBatches = 0;
+	for (std::map<StaticBatchKey, std::vector<RenderableObject3D*>>::iterator it = groups.begin(); it != groups.end(); it++) {
+		std::vector<RenderableObject3D*>& objects = it->second;
+		//Merging a single object wouldn't save anything
+		if (objects.size() == 1) {
+			remaining.push_back(objects[0]);
+			continue;
+		}
+
+		StaticBatch batch;
+		MeshData* data = new MeshData();
+		for (unsigned int a = 0; a < objects.size(); a++) {
+			batch.sources.push_back(objects[a]);
+			batch.firstTriangles.push_back(data->getNumIndices() / 3);
+			addBaked(data, objects[a]);
+		}
+
+		MeshRenderData* source = objects[0]->getMesh()->getRenderData();
+		Mesh* mesh = new Mesh(data, source->getShaderType(), MeshBuffers::isSupported());
+		mesh->setTexture(it->first.texture);
+		mesh->getRenderData()->setMaterial(it->first.material);
+		//The merged object keeps an identity model matrix, so its vertices are lit at the same
+		//world positions as the objects they came from
+		batch.object = new RenderableObject3D(mesh);
+		batch.object->update();
+
+		m_staticBatches.push_back(batch);
+		remaining.push_back(batch.object);
+		numBatches++;
+	}
+	m_objects = remaining;
+	reindex();
+	return numBatches;
+}
+
+RenderableObject3D* Scene::getBakedObject(RenderableObject3D* object, unsigned int triangle) {
+	for (unsigned int a = 0; a < m_staticBatches.size(); a++) {
+		StaticBatch& batch = m_staticBatches[a];
+		if (batch.object != object)
+			continue;
+		//The first triangles are in order, so find the last one at or before the triangle
+		std::vector<unsigned int>::iterator it = std::upper_bound(batch.firstTriangles.begin(), batch.firstTriangles.end(), triangle);
+		if (it == batch.firstTriangles.begin())
+			return NULL;
+		return batch.sources[(it - batch.firstTriangles.begin()) - 1];
+	}
+	return NULL;
+}
+
+bool Scene::raycast(Vector3f origin, Vector3f direction, float maxDistance, RayHit& hit) {
+	PROFILE_SCOPE("Scene::raycast");
+	//Only the objects whose bounds the ray passes through need their triangles tested
+	FrameVector<RenderableObject3D*> candidates;
+	m_index.queryRay(origin, direction, maxDistance, candidates);
+	bool found = false;
+	for (unsigned int a = 0; a < candidates.size(); a++) {
+		if (candidates[a]->raycast(origin, direction, found ? hit.distance : maxDistance, hit))
+			found = true;
+	}
+	if (found)
+		hit.source = getBakedObject(hit.object, hit.triangle);
+	return found;
+}
+
+void Scene::setOcclusionCullingEnabled(bool occlusionCullingEnabled) {
+	if (occlusionCullingEnabled && m_occlusionCuller == NULL)
+		m_occlusionCuller = new OcclusionCuller(OCCLUSION_WIDTH, OCCLUSION_HEIGHT);
+	else if (! occlusionCullingEnabled && m_occlusionCuller != NULL) {
+		delete m_occlusionCuller;
+		m_occlusionCuller = NULL;
+	}
+}
+
+bool Scene::getWorldBounds(RenderableObject3D* object, Vector3f& min, Vector3f& max) {
+	Model* model = dynamic_cast<Model*>(object);
+	unsigned int numMeshes = model != NULL ? model->getNumMeshes() : (object->getMesh() != NULL ? 1 : 0);
+
+	//The bounds of every mesh are combined before they are transformed, so only one box is
+	//transformed for the object
+	bool found = false;
+	float boundsMin[3];
+	float boundsMax[3];
+	for (unsigned int a = 0; a < numMeshes; a++) {
+		MeshData* data = model != NULL ? model->getMesh(a)->getData() : object->getMesh()->getData();
+		if (data == NULL || ! data->hasPositions())
+			continue;
+		Vector3f meshMin = data->getBoundsMin();
+		Vector3f meshMax = data->getBoundsMax();
+		for (unsigned int b = 0; b < 3; b++) {
+			boundsMin[b] = found ? std::min(boundsMin[b], meshMin[b]) : meshMin[b];
+			boundsMax[b] = found ? std::max(boundsMax[b], meshMax[b]) : meshMax[b];
+		}
+		found = true;
+	}
+	if (! found)
+		return false;
+
+	//The box around the transformed corners of the bounds
+	Matrix4f m = object->getModelMatrix();
+	for (unsigned int a = 0; a < 8; a++) {
+		float x = (a & 1) ? boundsMax[0] : boundsMin[0];
+		float y = (a & 2) ? boundsMax[1] : boundsMin[1];
+		float z = (a & 4) ? boundsMax[2] : boundsMin[2];
+		for (unsigned int b = 0; b < 3; b++) {
+			float value = m.m_values[b][0] * x + m.m_values[b][1] * y + m.m_values[b][2] * z + m.m_values[b][3];
+			min[b] = a == 0 ? value : std::min(min[b], value);
+			max[b] = a == 0 ? value : std::max(max[b], value);
+		}
+	}
+	return true;
+}
+
+void Scene::cullOccluded() {
+	m_occluded.assign(m_visible.size(), false);
+	if (m_occlusionCuller == NULL || m_occluders.empty())
+		return;
+	PROFILE_SCOPE("Scene::cullOccluded");
+
+	m_occlusionCuller->begin(Renderer::getCamera()->getProjectionViewMatrix());
+	for (unsigned int a = 0; a < m_occluders.size(); a++) {
+		RenderableObject3D* occluder = m_occluders.at(a);
+		Model* model = dynamic_cast<Model*>(occluder);
+		if (model != NULL) {
+			for (unsigned int b = 0; b < model->getNumMeshes(); b++)
+				m_occlusionCuller->addOccluder(model->getMesh(b)->getData(), model->getModelMatrix());
+		} else if (occluder->getMesh() != NULL)
+			m_occlusionCuller->addOccluder(occluder->getMesh()->getData(), occluder->getModelMatrix());
+	}
+	m_occlusionCuller->rasterise();
+
+	//Objects without any bounds are always drawn
+	std::vector<unsigned int> tested;
+	m_occlusionQueries.clear();
+	for (unsigned int a = 0; a < m_visible.size(); a++) {
+		OcclusionQuery query;
+		if (m_index.getBounds(m_visible.at(a), query.min, query.max)) {
+			query.visible = true;
+			m_occlusionQueries.push_back(query);
+			tested.push_back(a);
+		}
+	}
+	m_occlusionCuller->test(m_occlusionQueries);
+
+	for (unsigned int a = 0; a < tested.size(); a++)
+		m_occluded[tested[a]] = ! m_occlusionQueries[a].visible;
+	RenderStats::add(RENDER_STAT_OCCLUDED_OBJECTS, m_occlusionCuller->getNumRejected());
 }
 
 void Scene::render(Vector3f cameraPosition) {
+	PROFILE_SCOPE("Scene::render");
+	PROFILE_GPU_SCOPE("Scene::render");
+	//Only the objects in the camera's frustum are looked at from here on
+	{
+		PROFILE_SCOPE("Scene::cullFrustum");
+		FrameVector<RenderableObject3D*> visible;
+		m_index.queryFrustum(Renderer::getCamera()->getProjectionViewMatrix(), visible);
+		//Only objects in the index can be culled, the ones without bounds are always drawn
+		RenderStats::add(RENDER_STAT_FRUSTUM_CULLED_OBJECTS, m_index.getNumObjects() - visible.size());
+		m_visible.assign(visible.begin(), visible.end());
+		m_visible.insert(m_visible.end(), m_unbounded.begin(), m_unbounded.end());
+	}
+	cullOccluded();
+	//Request the detail needed for the textures of each object from this view
+	if (TextureStreamer::isEnabled()) {
+		TextureStreamer::setView(Renderer::getCamera(), cameraPosition);
+		for (unsigned int a = 0; a < m_visible.size(); a++) {
+			if (! m_occluded[a])
+				TextureStreamer::request(m_visible.at(a));
+		}
+	}
 	if (m_lightingEnabled) {
-		Renderer::setShader(Renderer::getShader("AmbientLight"));
-		Shader* shader = Renderer::getShader("");
+		bool multiDraw = canMultiDraw();
+		if (multiDraw)
+			buildDrawList(cameraPosition);
+		else
+			m_multiDrawn.assign(m_visible.size(), false);
+
+		Renderer::setShader(Renderer::getShader(SHADER_TYPE_AMBIENT_LIGHT));
+		Shader* shader = Renderer::getOverrideShader();
 		shader->use();
-		shader->setUniform("AmbientLight", m_ambientLight);
+		shader->setUniform("ambientLight", m_ambientLight);
 
-		for (unsigned int a = 0; a < m_objects.size(); a++)
-			m_objects.at(a)->render();
+		for (unsigned int a = 0; a < m_visible.size(); a++) {
+			if (! m_multiDrawn[a] && ! m_occluded[a])
+				m_visible.at(a)->render();
+		}
 
 		Renderer::resetShader();
 
+		if (multiDraw) {
+			shader = Renderer::getLightingShader()->getShader(MULTI_DRAW_FEATURES | SHADER_FEATURE_AMBIENT_LIGHT);
+			shader->use();
+			shader->setUniform("ambientLight", m_ambientLight);
+			renderDrawList(shader);
+		}
+
 		if (m_lights.size() > 0) {
 
-			glEnable(GL_BLEND);
-			glBlendFunc(GL_ONE, GL_ONE);
-			glDepthMask(false);
-			glDepthFunc(GL_EQUAL);
+			GLState::enable(GL_BLEND);
+			GLState::blendFunc(GL_ONE, GL_ONE);
+			GLState::depthMask(false);
+			GLState::depthFunc(GL_EQUAL);
 
 			for (unsigned int a = 0; a < m_lights.size(); a++) {
 				m_lights.at(a)->apply();
 
-				Shader* shader = Renderer::getShader("");
+				Shader* shader = Renderer::getOverrideShader();
+
+				//Objects outside of the light's range don't need to be drawn for it. The world space
+				//bounds in the index are compared as the lighting shader works in world space too
+				Vector3f lightCentre;
+				float lightRadius = 0;
+				bool bounded = m_lights.at(a)->getBounds(lightCentre, lightRadius);
 
-				for (unsigned int b = 0; b < m_objects.size(); b++) {
+				for (unsigned int b = 0; b < m_visible.size(); b++) {
+					if (m_multiDrawn[b] || m_occluded[b])
+						continue;
+					if (bounded && ! m_index.overlapsSphere(m_visible.at(b), lightCentre, lightRadius))
+						continue;
 
-					Matrix4f normalMatrix = m_objects.at(b)->getModelMatrix().inverse().transpose();
+					//The positions are lit in world space, the same space as the lights
+					Matrix4f modelMatrix = m_visible.at(b)->getModelMatrix();
+					Matrix4f normalMatrix = modelMatrix.inverse().transpose();
 
-					shader->setUniform("NormalMatrix", normalMatrix);
-					shader->setUniform("SpecularIntensity", m_specularIntensity);
-					shader->setUniform("EyePosition", cameraPosition);
+					shader->setUniform("modelMatrix", modelMatrix.transpose());
+					shader->setUniform("nMatrix", normalMatrix);
+					shader->setUniform("specularIntensity", m_specularIntensity);
+					shader->setUniform("eyePosition", cameraPosition);
 
-					m_objects.at(b)->render();
+					m_visible.at(b)->render();
 
 				}
 
 				Renderer::resetShader();
+
+				if (multiDraw) {
+					shader = Renderer::getLightingShader()->getShader(MULTI_DRAW_FEATURES | m_lights.at(a)->getShaderFeature());
+					m_lights.at(a)->apply(shader);
+					shader->setUniform("specularIntensity", m_specularIntensity);
+					shader->setUniform("eyePosition", cameraPosition);
+					renderDrawList(shader);
+					Renderer::resetShader();
+				}
 			}
 
-			glDepthFunc(GL_LESS);
-			glDepthMask(true);
-			glDisable(GL_BLEND);
+			GLState::depthFunc(GL_LESS);
+			GLState::depthMask(true);
+			GLState::disable(GL_BLEND);
 
 		}
 	}
@@ -22,6 +22,10 @@
 #include <algorithm>
 
 #include "lighting/Light.h"
+#include "IndirectDrawList.h"
+#include "OcclusionCuller.h"
+#include "SceneSpatialIndex.h"
+#include "UberShader.h"
 #include "../Object.h"
 
 /***************************************************************************************************
@@ -32,30 +36,154 @@
 class Scene {
 private:
 	std::vector<RenderableObject3D*> m_objects;
+
+	/* The transform version of each object when its bounds were last added to the index */
+	std::vector<unsigned int> m_indexedVersions;
 	std::vector<LightSource*> m_lights;
 
+	/* The bounds of the objects in world space, used to find the ones that can be seen, and the
+	 * objects without any bounds which are always drawn */
+	SceneSpatialIndex m_index;
+	std::vector<RenderableObject3D*> m_unbounded;
+
+	/* The objects found in the camera's frustum this frame, which are the only ones rendered */
+	std::vector<RenderableObject3D*> m_visible;
+
+	/* Adds an object to the index, or to the unbounded objects if it has no bounds. Its bounds are
+	 * updated when it has been added before */
+	void addToIndex(RenderableObject3D* object);
+
+	/* Adds every object to the index again */
+	void reindex();
+
 	bool m_lightingEnabled = true;
 	Colour m_ambientLight = Colour(0.1, 0.1, 0.1, 1.0);
 	float m_specularIntensity = 0.2f;
+
+	/* States whether models whose meshes are all in the MeshBuffers are drawn together using multi
+	 * draw calls, when they are supported */
+	bool m_multiDrawEnabled = true;
+	IndirectDrawList m_drawList;
+	/* Whether each visible object is in the draw list, so it isn't drawn on its own */
+	std::vector<bool> m_multiDrawn;
+
+	/* The features of the lighting shader used by every multi draw */
+	static const unsigned int MULTI_DRAW_FEATURES = SHADER_FEATURE_TEXTURE | SHADER_FEATURE_NORMALS | SHADER_FEATURE_MULTI_DRAW;
+
+	/* Returns whether multi draws can be used for this frame */
+	bool canMultiDraw();
+
+	/* The ranges of a mesh's triangles left after culling its meshlets */
+	std::vector<MeshletRange> m_meshletRanges;
+
+	/* Adds the draws of every object that can be in the draw list, and uploads it. Meshes split
+	 * into meshlets only have the ones that can be seen from the camera added */
+	void buildDrawList(Vector3f cameraPosition);
+
+	/* Draws the draw list with a shader that is in use and has its lighting uniforms set */
+	void renderDrawList(Shader* shader);
+
+	/* An object made by merging static objects, along with the first triangle each of them became
+	 * so they can still be found when picking */
+	struct StaticBatch {
+		RenderableObject3D* object;
+		std::vector<RenderableObject3D*> sources;
+		std::vector<unsigned int> firstTriangles;
+	};
+	std::vector<StaticBatch> m_staticBatches;
+
+	/* What static objects need to share to be merged, including the cell of the grid they are in */
+	struct StaticBatchKey {
+		unsigned int shaderHandle;
+		unsigned int attributes;
+		Texture* texture;
+		Material* material;
+		int x;
+		int y;
+		int z;
+
+		bool operator<(const StaticBatchKey& other) const;
+	};
+
+	/* Returns whether an object is static and only draws its mesh, so it can be merged with others */
+	static bool canBake(RenderableObject3D* object);
+
+	/* Adds the vertices and indices of an object to a mesh, transformed by its model matrix */
+	static void addBaked(MeshData* data, RenderableObject3D* object);
+
+	/* The culler used to find the objects hidden behind the occluders, when occlusion culling
+	 * is enabled */
+	OcclusionCuller* m_occlusionCuller = NULL;
+	std::vector<RenderableObject3D*> m_occluders;
+	std::vector<OcclusionQuery> m_occlusionQueries;
+	/* Whether each visible object was found to be hidden this frame, so it isn't drawn */
+	std::vector<bool> m_occluded;
+
+	/* The size of the depth buffer used for occlusion culling */
+	static const unsigned int OCCLUSION_WIDTH = 256;
+	static const unsigned int OCCLUSION_HEIGHT = 128;
+
+	/* Rasterises the occluders and tests the objects against them */
+	void cullOccluded();
+
+	/* Returns the bounding box of an object in world space, or false if it has no bounds */
+	static bool getWorldBounds(RenderableObject3D* object, Vector3f& min, Vector3f& max);
 public:
-	virtual ~Scene() {}
+	virtual ~Scene();
 
-	inline void add(RenderableObject3D* object) { m_objects.push_back(object); }
+	void add(RenderableObject3D* object);
 	inline void add(LightSource* light) { m_lights.push_back(light); }
-	inline void remove(RenderableObject3D* object) { m_objects.erase(std::remove(m_objects.begin(), m_objects.end(), object), m_objects.end()); }
+	/* Removes an object from the scene, and from the occluders if it was one */
+	void remove(RenderableObject3D* object);
 	inline void remove(LightSource* light) { m_lights.erase(std::remove(m_lights.begin(), m_lights.end(), light), m_lights.end()); }
 
+	/* Objects added as occluders are drawn into the depth buffer used for occlusion culling, so
+	 * they should be large and simple, such as walls. They still have to be added to the scene to
+	 * be rendered */
+	inline void addOccluder(RenderableObject3D* object) { m_occluders.push_back(object); }
+	inline void removeOccluder(RenderableObject3D* object) { m_occluders.erase(std::remove(m_occluders.begin(), m_occluders.end(), object), m_occluders.end()); }
+
 	void update();
 	void render(Vector3f cameraPosition);
 
+	/* Merges the objects in the scene marked with setStatic(true) that are drawn the same way into
+	 * fewer objects, transforming their vertices into world space. Objects are only merged with others
+	 * in the same cell of a grid with cells of a given size, so the merged ones can still be
+	 * culled. Objects can't be changed once merged, and are no longer updated or rendered. Merged
+	 * objects are lit the same as before, as lighting is always done in world space.
+	 * Returns the number of objects created */
+	unsigned int bakeStatic(float cellSize);
+
+	/* Returns the object a triangle of a merged object came from, or NULL if it wasn't merged */
+	RenderableObject3D* getBakedObject(RenderableObject3D* object, unsigned int triangle);
+
+	inline unsigned int getNumStaticBatches() { return m_staticBatches.size(); }
+
+	/* Finds the closest triangle of any object hit by a ray in world space, within a distance in
+	 * multiples of the ray's direction. When the object hit was made by bakeStatic, the source of
+	 * the hit is the object the triangle came from. Returns false when nothing is hit */
+	bool raycast(Vector3f origin, Vector3f direction, float maxDistance, RayHit& hit);
+
+	/* The same as raycast for the segment between two points */
+	inline bool raycastSegment(Vector3f start, Vector3f end, RayHit& hit) { return raycast(start, end - start, 1.0f, hit); }
+
+	/* Returns the index of the objects' bounds, which is kept up to date by update, so the
+	 * objects in an area or along a ray can be found */
+	inline SceneSpatialIndex& getSpatialIndex() { return m_index; }
+
 	/* The setters and getters */
 	inline void setLightingEnabled(bool lightingEnabled) { m_lightingEnabled = lightingEnabled; }
 	inline void setAmbientLight(Colour ambientLight) { m_ambientLight = ambientLight; }
 	inline void setSpecularIntensity(float specularIntensity) { m_specularIntensity = specularIntensity; }
+	inline void setMultiDrawEnabled(bool multiDrawEnabled) { m_multiDrawEnabled = multiDrawEnabled; }
+	void setOcclusionCullingEnabled(bool occlusionCullingEnabled);
 
 	inline bool isLightingEnabled() { return m_lightingEnabled; }
 	inline Colour getAmbientLight() { return m_ambientLight; }
 	inline float getSpecularIntensity() { return m_specularIntensity; }
+	inline bool isMultiDrawEnabled() { return m_multiDrawEnabled; }
+	inline bool isOcclusionCullingEnabled() { return m_occlusionCuller != NULL; }
+	inline OcclusionCuller* getOcclusionCuller() { return m_occlusionCuller; }
 };
 
 /***************************************************************************************************/
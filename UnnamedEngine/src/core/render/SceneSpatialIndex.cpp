@@ -0,0 +1,437 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <cmath>
+#include <algorithm>
+
+#include "SceneSpatialIndex.h"
+#include "../Matrix.h"
+
+/***************************************************************************************************
+ * The tests used by the queries of the SceneSpatialIndex class
+ ***************************************************************************************************/
+
+struct SpatialBoxTest {
+	Vector3f min;
+	Vector3f max;
+};
+
+struct SpatialSphereTest {
+	Vector3f centre;
+	float radius;
+};
+
+struct SpatialFrustumTest {
+	float planes[6][4];
+};
+
+struct SpatialRayTest {
+	Vector3f origin;
+	Vector3f inverseDirection;
+	float maxDistance;
+};
+
+/***************************************************************************************************/
+
+/***************************************************************************************************
+ * The SceneSpatialIndex class
+ ***************************************************************************************************/
+
+SceneSpatialIndex::SceneSpatialIndex(float margin) {
+	m_margin = margin;
+}
+
+unsigned int SceneSpatialIndex::allocateNode() {
+	unsigned int node;
+	if (m_free == NULL_NODE) {
+		node = m_nodes.size();
+		m_nodes.push_back(Node());
+	} else {
+		node = m_free;
+		m_free = m_nodes[node].parent;
+	}
+	m_nodes[node].parent = NULL_NODE;
+	m_nodes[node].left = NULL_NODE;
+	m_nodes[node].right = NULL_NODE;
+	m_nodes[node].height = 0;
+	m_nodes[node].object = NULL;
+	return node;
+}
+
+void SceneSpatialIndex::freeNode(unsigned int node) {
+	m_nodes[node].parent = m_free;
+	m_nodes[node].height = -1;
+	m_nodes[node].object = NULL;
+	m_free = node;
+}
+
+float SceneSpatialIndex::getArea(const Vector3f& min, const Vector3f& max) {
+	float x = max[0] - min[0];
+	float y = max[1] - min[1];
+	float z = max[2] - min[2];
+	return 2.0f * (x * y + y * z + z * x);
+}
+
+float SceneSpatialIndex::getCombinedArea(const Vector3f& min1, const Vector3f& max1, const Vector3f& min2, const Vector3f& max2) {
+	return getArea(Vector3f(std::min(min1[0], min2[0]), std::min(min1[1], min2[1]), std::min(min1[2], min2[2])),
+				   Vector3f(std::max(max1[0], max2[0]), std::max(max1[1], max2[1]), std::max(max1[2], max2[2])));
+}
+
+void SceneSpatialIndex::fit(unsigned int node) {
+	Node& current = m_nodes[node];
+	Node& left = m_nodes[current.left];
+	Node& right = m_nodes[current.right];
+	current.min = Vector3f(std::min(left.min[0], right.min[0]), std::min(left.min[1], right.min[1]), std::min(left.min[2], right.min[2]));
+	current.max = Vector3f(std::max(left.max[0], right.max[0]), std::max(left.max[1], right.max[1]), std::max(left.max[2], right.max[2]));
+	current.height = 1 + std::max(left.height, right.height);
+}
+
+void SceneSpatialIndex::insertLeaf(unsigned int leaf) {
+	if (m_root == NULL_NODE) {
+		m_root = leaf;
+		m_nodes[leaf].parent = NULL_NODE;
+		return;
+	}
+
+	//Go down the tree to the node the leaf would add the least area to by being its sibling
+	Vector3f min = m_nodes[leaf].min;
+	Vector3f max = m_nodes[leaf].max;
+	unsigned int index = m_root;
+	while (! m_nodes[index].isLeaf()) {
+		Node& node = m_nodes[index];
+		float area = getArea(node.min, node.max);
+		float combinedArea = getCombinedArea(node.min, node.max, min, max);
+
+		//The cost of making a new parent for this node and the leaf, and the cost added to
+		//every node above if the leaf goes further down
+		float cost = 2.0f * combinedArea;
+		float inheritedCost = 2.0f * (combinedArea - area);
+
+		Node& left = m_nodes[node.left];
+		Node& right = m_nodes[node.right];
+		float leftCost = getCombinedArea(left.min, left.max, min, max) + inheritedCost;
+		float rightCost = getCombinedArea(right.min, right.max, min, max) + inheritedCost;
+		if (! left.isLeaf())
+			leftCost -= getArea(left.min, left.max);
+		if (! right.isLeaf())
+			rightCost -= getArea(right.min, right.max);
+
+		if (cost < leftCost && cost < rightCost)
+			break;
+		index = leftCost < rightCost ? node.left : node.right;
+	}
+
+	//Make a new parent for the sibling and the leaf
+	unsigned int sibling = index;
+	unsigned int oldParent = m_nodes[sibling].parent;
+	unsigned int newParent = allocateNode();
+	m_nodes[newParent].parent = oldParent;
+	m_nodes[newParent].left = sibling;
+	m_nodes[newParent].right = leaf;
+	m_nodes[sibling].parent = newParent;
+	m_nodes[leaf].parent = newParent;
+	fit(newParent);
+	if (oldParent == NULL_NODE)
+		m_root = newParent;
+	else if (m_nodes[oldParent].left == sibling)
+		m_nodes[oldParent].left = newParent;
+	else
+		m_nodes[oldParent].right = newParent;
+
+	//Balance and refit the nodes above
+	index = m_nodes[leaf].parent;
+	while (index != NULL_NODE) {
+		index = balance(index);
+		fit(index);
+		index = m_nodes[index].parent;
+	}
+}
+
+void SceneSpatialIndex::removeLeaf(unsigned int leaf) {
+	if (leaf == m_root) {
+		m_root = NULL_NODE;
+		return;
+	}
+	//The sibling takes the place of the parent
+	unsigned int parent = m_nodes[leaf].parent;
+	unsigned int grandParent = m_nodes[parent].parent;
+	unsigned int sibling = m_nodes[parent].left == leaf ? m_nodes[parent].right : m_nodes[parent].left;
+	freeNode(parent);
+	m_nodes[sibling].parent = grandParent;
+	if (grandParent == NULL_NODE) {
+		m_root = sibling;
+		return;
+	}
+	if (m_nodes[grandParent].left == parent)
+		m_nodes[grandParent].left = sibling;
+	else
+		m_nodes[grandParent].right = sibling;
+
+	unsigned int index = grandParent;
+	while (index != NULL_NODE) {
+		index = balance(index);
+		fit(index);
+		index = m_nodes[index].parent;
+	}
+}
+
+unsigned int SceneSpatialIndex::balance(unsigned int node) {
+	Node& a = m_nodes[node];
+	if (a.isLeaf() || a.height < 2)
+		return node;
+
+	unsigned int b = a.left;
+	unsigned int c = a.right;
+	int difference = m_nodes[c].height - m_nodes[b].height;
+	if (difference >= -1 && difference <= 1)
+		return node;
+
+	//The taller child takes the place of the node, which takes the taller child's shorter child
+	unsigned int taller = difference > 1 ? c : b;
+	Node& up = m_nodes[taller];
+	unsigned int first = up.left;
+	unsigned int second = up.right;
+	bool firstTaller = m_nodes[first].height > m_nodes[second].height;
+	unsigned int kept = firstTaller ? first : second;
+	unsigned int given = firstTaller ? second : first;
+
+	up.left = node;
+	up.parent = a.parent;
+	a.parent = taller;
+	if (up.parent == NULL_NODE)
+		m_root = taller;
+	else if (m_nodes[up.parent].left == node)
+		m_nodes[up.parent].left = taller;
+	else
+		m_nodes[up.parent].right = taller;
+
+	up.right = kept;
+	if (taller == c)
+		a.right = given;
+	else
+		a.left = given;
+	m_nodes[given].parent = node;
+	fit(node);
+	fit(taller);
+	return taller;
+}
+
+void SceneSpatialIndex::update(RenderableObject3D* object, Vector3f min, Vector3f max) {
+	std::map<RenderableObject3D*, unsigned int>::iterator iterator = m_leaves.find(object);
+	unsigned int leaf;
+	if (iterator == m_leaves.end()) {
+		leaf = allocateNode();
+		m_nodes[leaf].object = object;
+		m_leaves.insert(std::pair<RenderableObject3D*, unsigned int>(object, leaf));
+	} else {
+		leaf = iterator->second;
+		m_nodes[leaf].objectMin = min;
+		m_nodes[leaf].objectMax = max;
+		//Nothing needs to change while the object is still within its enlarged bounds
+		Node& node = m_nodes[leaf];
+		if (node.min[0] <= min[0] && node.min[1] <= min[1] && node.min[2] <= min[2] &&
+			node.max[0] >= max[0] && node.max[1] >= max[1] && node.max[2] >= max[2])
+			return;
+		removeLeaf(leaf);
+	}
+	Node& node = m_nodes[leaf];
+	node.objectMin = min;
+	node.objectMax = max;
+	node.min = Vector3f(min[0] - m_margin, min[1] - m_margin, min[2] - m_margin);
+	node.max = Vector3f(max[0] + m_margin, max[1] + m_margin, max[2] + m_margin);
+	insertLeaf(leaf);
+}
+
+void SceneSpatialIndex::remove(RenderableObject3D* object) {
+	std::map<RenderableObject3D*, unsigned int>::iterator iterator = m_leaves.find(object);
+	if (iterator == m_leaves.end())
+		return;
+	removeLeaf(iterator->second);
+	freeNode(iterator->second);
+	m_leaves.erase(iterator);
+}
+
+void SceneSpatialIndex::clear() {
+	m_nodes.clear();
+	m_leaves.clear();
+	m_root = NULL_NODE;
+	m_free = NULL_NODE;
+}
+
+bool SceneSpatialIndex::overlapsBox(const Vector3f& min1, const Vector3f& max1, const Vector3f& min2, const Vector3f& max2) {
+	return min1[0] <= max2[0] && max1[0] >= min2[0] && min1[1] <= max2[1] && max1[1] >= min2[1] && min1[2] <= max2[2] && max1[2] >= min2[2];
+}
+
+bool SceneSpatialIndex::overlapsSphere(const Vector3f& min, const Vector3f& max, const Vector3f& centre, float radius) {
+	//The distance from the centre to the closest point in the box
+	float distance = 0;
+	for (unsigned int a = 0; a < 3; a++) {
+		float closest = std::max(min[a], std::min(centre[a], max[a]));
+		distance += (centre[a] - closest) * (centre[a] - closest);
+	}
+	return distance <= radius * radius;
+}
+
+bool SceneSpatialIndex::overlapsFrustum(const Vector3f& min, const Vector3f& max, const float planes[6][4]) {
+	//The box is outside when the corner farthest along the normal of any plane is behind it
+	for (unsigned int a = 0; a < 6; a++) {
+		float x = planes[a][0] >= 0 ? max[0] : min[0];
+		float y = planes[a][1] >= 0 ? max[1] : min[1];
+		float z = planes[a][2] >= 0 ? max[2] : min[2];
+		if (planes[a][0] * x + planes[a][1] * y + planes[a][2] * z + planes[a][3] < 0)
+			return false;
+	}
+	return true;
+}
+
+bool SceneSpatialIndex::overlapsRay(const Vector3f& min, const Vector3f& max, const Vector3f& origin, const Vector3f& inverseDirection, float maxDistance) {
+	float near = 0;
+	float far = maxDistance;
+	for (unsigned int a = 0; a < 3; a++) {
+		float t1 = (min[a] - origin[a]) * inverseDirection[a];
+		float t2 = (max[a] - origin[a]) * inverseDirection[a];
+		near = std::max(near, std::min(t1, t2));
+		far = std::min(far, std::max(t1, t2));
+	}
+	return near <= far;
+}
+
+template<typename Test>
+void SceneSpatialIndex::query(const Test& test, FrameVector<RenderableObject3D*>& objects) {
+	if (m_root == NULL_NODE)
+		return;
+	m_stack.clear();
+	m_stack.push_back(m_root);
+	while (! m_stack.empty()) {
+		const Node& node = m_nodes[m_stack.back()];
+		m_stack.pop_back();
+		if (! overlaps(node.min, node.max, test))
+			continue;
+		if (node.isLeaf()) {
+			//The enlarged bounds may overlap when the object's own don't
+			if (overlaps(node.objectMin, node.objectMax, test))
+				objects.push_back(node.object);
+		} else if (encloses(node.min, node.max, test)) {
+			addAll(node.left, objects);
+			addAll(node.right, objects);
+		} else {
+			m_stack.push_back(node.left);
+			m_stack.push_back(node.right);
+		}
+	}
+}
+
+void SceneSpatialIndex::addAll(unsigned int node, FrameVector<RenderableObject3D*>& objects) {
+	if (m_nodes[node].isLeaf())
+		objects.push_back(m_nodes[node].object);
+	else {
+		addAll(m_nodes[node].left, objects);
+		addAll(m_nodes[node].right, objects);
+	}
+}
+
+bool SceneSpatialIndex::overlaps(const Vector3f& min, const Vector3f& max, const SpatialBoxTest& test) {
+	return overlapsBox(min, max, test.min, test.max);
+}
+
+bool SceneSpatialIndex::overlaps(const Vector3f& min, const Vector3f& max, const SpatialSphereTest& test) {
+	return overlapsSphere(min, max, test.centre, test.radius);
+}
+
+bool SceneSpatialIndex::overlaps(const Vector3f& min, const Vector3f& max, const SpatialFrustumTest& test) {
+	return overlapsFrustum(min, max, test.planes);
+}
+
+bool SceneSpatialIndex::overlaps(const Vector3f& min, const Vector3f& max, const SpatialRayTest& test) {
+	return overlapsRay(min, max, test.origin, test.inverseDirection, test.maxDistance);
+}
+
+bool SceneSpatialIndex::encloses(const Vector3f& min, const Vector3f& max, const SpatialBoxTest& test) {
+	return test.min[0] <= min[0] && test.min[1] <= min[1] && test.min[2] <= min[2] && test.max[0] >= max[0] && test.max[1] >= max[1] && test.max[2] >= max[2];
+}
+
+bool SceneSpatialIndex::encloses(const Vector3f& min, const Vector3f& max, const SpatialSphereTest& test) {
+	//The distance from the centre to the farthest point in the box
+	float distance = 0;
+	for (unsigned int a = 0; a < 3; a++) {
+		float farthest = std::max(test.centre[a] - min[a], max[a] - test.centre[a]);
+		distance += farthest * farthest;
+	}
+	return distance <= test.radius * test.radius;
+}
+
+bool SceneSpatialIndex::encloses(const Vector3f& min, const Vector3f& max, const SpatialFrustumTest& test) {
+	//The box is inside when the corner nearest along the normal of every plane is in front of it
+	for (unsigned int a = 0; a < 6; a++) {
+		float x = test.planes[a][0] >= 0 ? min[0] : max[0];
+		float y = test.planes[a][1] >= 0 ? min[1] : max[1];
+		float z = test.planes[a][2] >= 0 ? min[2] : max[2];
+		if (test.planes[a][0] * x + test.planes[a][1] * y + test.planes[a][2] * z + test.planes[a][3] < 0)
+			return false;
+	}
+	return true;
+}
+
+void SceneSpatialIndex::queryBox(Vector3f min, Vector3f max, FrameVector<RenderableObject3D*>& objects) {
+	SpatialBoxTest test;
+	test.min = min;
+	test.max = max;
+	query(test, objects);
+}
+
+void SceneSpatialIndex::querySphere(Vector3f centre, float radius, FrameVector<RenderableObject3D*>& objects) {
+	SpatialSphereTest test;
+	test.centre = centre;
+	test.radius = radius;
+	query(test, objects);
+}
+
+void SceneSpatialIndex::queryFrustum(const Matrix4f& projectionView, FrameVector<RenderableObject3D*>& objects) {
+	SpatialFrustumTest test;
+	Matrix4f matrix = projectionView;
+	matrix.getFrustumPlanes(test.planes);
+	query(test, objects);
+}
+
+void SceneSpatialIndex::queryRay(Vector3f origin, Vector3f direction, float maxDistance, FrameVector<RenderableObject3D*>& objects) {
+	//Directions of zero become infinite, so the ray never leaves the slab it starts in
+	SpatialRayTest test;
+	test.origin = origin;
+	test.inverseDirection = Vector3f(1.0f / direction[0], 1.0f / direction[1], 1.0f / direction[2]);
+	test.maxDistance = maxDistance;
+	query(test, objects);
+}
+
+bool SceneSpatialIndex::overlapsSphere(RenderableObject3D* object, Vector3f centre, float radius) {
+	std::map<RenderableObject3D*, unsigned int>::iterator iterator = m_leaves.find(object);
+	if (iterator == m_leaves.end())
+		return true;
+	Node& node = m_nodes[iterator->second];
+	return overlapsSphere(node.objectMin, node.objectMax, centre, radius);
+}
+
+bool SceneSpatialIndex::getBounds(RenderableObject3D* object, Vector3f& min, Vector3f& max) {
+	std::map<RenderableObject3D*, unsigned int>::iterator iterator = m_leaves.find(object);
+	if (iterator == m_leaves.end())
+		return false;
+	min = m_nodes[iterator->second].objectMin;
+	max = m_nodes[iterator->second].objectMax;
+	return true;
+}
+
+/***************************************************************************************************/
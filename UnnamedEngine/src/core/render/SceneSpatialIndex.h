@@ -0,0 +1,150 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef CORE_RENDER_SCENESPATIALINDEX_H_
+#define CORE_RENDER_SCENESPATIALINDEX_H_
+
+#include <vector>
+#include <map>
+
+#include "../Vector.h"
+#include "../Memory.h"
+
+class Matrix4f;
+class RenderableObject3D;
+struct SpatialBoxTest;
+struct SpatialSphereTest;
+struct SpatialFrustumTest;
+struct SpatialRayTest;
+
+/***************************************************************************************************
+ * The SceneSpatialIndex class stores the bounds of objects in a dynamic bounding volume tree, so
+ * the objects within a frustum, sphere, box or along a ray can be found by only looking at the
+ * branches that overlap it. Each object is kept with bounds slightly larger than its own, so it is
+ * only moved within the tree once it has moved out of them. The tree is kept balanced by rotating
+ * nodes as objects are added
+ ***************************************************************************************************/
+
+class SceneSpatialIndex {
+private:
+	/* The value used for a node that doesn't exist */
+	static const unsigned int NULL_NODE = 0xFFFFFFFF;
+
+	/* A node of the tree, leaves have an object while the others have two children */
+	struct Node {
+		/* The bounds around the children, or the enlarged bounds of the object in a leaf */
+		Vector3f min;
+		Vector3f max;
+		/* The actual bounds of the object in a leaf */
+		Vector3f objectMin;
+		Vector3f objectMax;
+		/* The parent of the node, or the next free node when it isn't being used */
+		unsigned int parent;
+		unsigned int left;
+		unsigned int right;
+		/* The height of the node above the leaves below it, or -1 when it isn't being used */
+		int height;
+		RenderableObject3D* object;
+
+		inline bool isLeaf() const { return left == NULL_NODE; }
+	};
+
+	/* The amount the bounds of the objects are enlarged by in each direction */
+	float m_margin;
+
+	std::vector<Node> m_nodes;
+	unsigned int m_root = NULL_NODE;
+	unsigned int m_free = NULL_NODE;
+
+	/* The leaf of each object */
+	std::map<RenderableObject3D*, unsigned int> m_leaves;
+
+	/* The nodes waiting to be looked at by a query, kept to avoid allocating them each time */
+	std::vector<unsigned int> m_stack;
+
+	unsigned int allocateNode();
+	void freeNode(unsigned int node);
+	void insertLeaf(unsigned int leaf);
+	void removeLeaf(unsigned int leaf);
+
+	/* Rotates the children of a node when one is more than one level taller than the other,
+	 * returning the node now in its place */
+	unsigned int balance(unsigned int node);
+
+	/* Sets the bounds and height of a node from its children */
+	void fit(unsigned int node);
+
+	/* Returns the surface area of a box, which is used as the cost of a node */
+	static float getArea(const Vector3f& min, const Vector3f& max);
+
+	/* Returns the area of the box containing two boxes */
+	static float getCombinedArea(const Vector3f& min1, const Vector3f& max1, const Vector3f& min2, const Vector3f& max2);
+
+	/* Adds the objects in the leaves passing a test, only looking below the nodes that pass it.
+	 * Everything below a node entirely within the area tested is added without testing it */
+	template<typename Test> void query(const Test& test, FrameVector<RenderableObject3D*>& objects);
+
+	/* Adds the objects of every leaf below a node */
+	void addAll(unsigned int node, FrameVector<RenderableObject3D*>& objects);
+
+	/* The tests used by the queries */
+	static bool overlapsBox(const Vector3f& min1, const Vector3f& max1, const Vector3f& min2, const Vector3f& max2);
+	static bool overlapsSphere(const Vector3f& min, const Vector3f& max, const Vector3f& centre, float radius);
+	static bool overlapsFrustum(const Vector3f& min, const Vector3f& max, const float planes[6][4]);
+	static bool overlapsRay(const Vector3f& min, const Vector3f& max, const Vector3f& origin, const Vector3f& inverseDirection, float maxDistance);
+	static bool overlaps(const Vector3f& min, const Vector3f& max, const SpatialBoxTest& test);
+	static bool overlaps(const Vector3f& min, const Vector3f& max, const SpatialSphereTest& test);
+	static bool overlaps(const Vector3f& min, const Vector3f& max, const SpatialFrustumTest& test);
+	static bool overlaps(const Vector3f& min, const Vector3f& max, const SpatialRayTest& test);
+	static bool encloses(const Vector3f& min, const Vector3f& max, const SpatialBoxTest& test);
+	static bool encloses(const Vector3f& min, const Vector3f& max, const SpatialSphereTest& test);
+	static bool encloses(const Vector3f& min, const Vector3f& max, const SpatialFrustumTest& test);
+	static bool encloses(const Vector3f& min, const Vector3f& max, const SpatialRayTest& test) { return false; }
+public:
+	SceneSpatialIndex(float margin);
+	SceneSpatialIndex() : SceneSpatialIndex(0.25f) {}
+	virtual ~SceneSpatialIndex() {}
+
+	/* Adds an object with its bounds in world space, or moves it if it has been added before */
+	void update(RenderableObject3D* object, Vector3f min, Vector3f max);
+	void remove(RenderableObject3D* object);
+	void clear();
+
+	/* Add every object whose bounds overlap a box, sphere, the frustum of a projection view
+	 * matrix or a ray to the list given. The ray's direction doesn't have to be normalised, the
+	 * maximum distance is in multiples of it */
+	void queryBox(Vector3f min, Vector3f max, FrameVector<RenderableObject3D*>& objects);
+	void querySphere(Vector3f centre, float radius, FrameVector<RenderableObject3D*>& objects);
+	void queryFrustum(const Matrix4f& projectionView, FrameVector<RenderableObject3D*>& objects);
+	void queryRay(Vector3f origin, Vector3f direction, float maxDistance, FrameVector<RenderableObject3D*>& objects);
+
+	/* Returns whether an object's bounds overlap a sphere, or true if it hasn't been added */
+	bool overlapsSphere(RenderableObject3D* object, Vector3f centre, float radius);
+
+	/* Gets the bounds an object was last given, returning false if it hasn't been added */
+	bool getBounds(RenderableObject3D* object, Vector3f& min, Vector3f& max);
+
+	inline bool contains(RenderableObject3D* object) { return m_leaves.count(object) > 0; }
+	inline unsigned int getNumObjects() { return m_leaves.size(); }
+	inline int getHeight() { return m_root == NULL_NODE ? 0 : m_nodes[m_root].height; }
+	inline float getMargin() { return m_margin; }
+};
+
+/***************************************************************************************************/
+
+#endif /* CORE_RENDER_SCENESPATIALINDEX_H_ */
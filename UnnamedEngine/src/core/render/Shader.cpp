@@ -24,42 +24,93 @@
  * Define the Shader class's methods
  ***************************************************************************************************/
 
+std::map<std::string, std::string> Shader::m_includeCache;
+
+Shader::Shader(GLuint program) {
+	m_program = program;
+	m_vertexShader = 0;
+	m_fragmentShader = 0;
+}
+
 Shader::Shader(GLuint vertexShader, GLuint fragmentShader) {
 	m_program = glCreateProgram();
 	m_vertexShader = vertexShader;
 	m_fragmentShader = fragmentShader;
 
+	//Allow the linked program to be cached by the ShaderManager
+	if (GLEW_ARB_get_program_binary)
+		glProgramParameteri(m_program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
 	attach(m_vertexShader);
 	attach(m_fragmentShader);
+	link();
 }
 
 Shader::~Shader() {
 	glDeleteShader(m_vertexShader);
 	glDeleteShader(m_fragmentShader);
-	glDeleteProgram(m_program);
+	GLState::deleteProgram(m_program);
 }
 
 void Shader::attach(GLuint shader) {
 	glAttachShader(m_program, shader);
+}
+
+void Shader::link() {
+	//The status is not queried here so that the driver is free to link in the background
 	glLinkProgram(m_program);
+	m_statusChecked = false;
+	m_linked = false;
+}
+
+bool Shader::isLinkComplete() {
+	if (m_statusChecked || ! GLEW_ARB_parallel_shader_compile)
+		return true;
+	GLint complete = 0;
+	glGetProgramiv(m_program, GL_COMPLETION_STATUS_ARB, &complete);
+	return complete == GL_TRUE;
+}
+
+bool Shader::checkStatus() {
+	if (! m_statusChecked) {
+		GLint status = 0;
+		glGetProgramiv(m_program, GL_LINK_STATUS, &status);
+		m_linked = status == GL_TRUE;
+		m_statusChecked = true;
+
+		if (! m_linked) {
+			//Report any compile errors first as they are the most likely cause
+			if (m_vertexShader != 0)
+				checkShaderStatus(m_vertexShader);
+			if (m_fragmentShader != 0)
+				checkShaderStatus(m_fragmentShader);
+
+			GLchar error[1024];
+			glGetProgramInfoLog(m_program, sizeof(error), NULL, error);
+			logError("Error linking shader " + to_string(error));
+		}
+	}
+	return m_linked;
+}
+
+void Shader::validate() {
+	glValidateProgram(m_program);
 
 	GLint status = 0;
-	glGetProgramiv(m_program, GL_LINK_STATUS, &status);
+	glGetProgramiv(m_program, GL_VALIDATE_STATUS, &status);
 	if (! status) {
 		GLchar error[1024];
 		glGetProgramInfoLog(m_program, sizeof(error), NULL, error);
-		logError("Error linking shader " + to_string(error));
+		logError("Error validating shader " + to_string(error));
 	}
-
-	glValidateProgram(m_program);
 }
 
 void Shader::use() {
-	glUseProgram(m_program);
+	GLState::useProgram(m_program);
 }
 
 void Shader::stopUsing() {
-	glUseProgram(0);
+	GLState::useProgram(0);
 }
 
 void Shader::detach(GLuint shader) {
@@ -80,12 +131,46 @@ void Shader::addAttribute(std::string id, std::string name) {
 	m_attributes.insert(std::pair<std::string, GLint>(id, location));
 }
 
+void Shader::reflect() {
+	GLint count = 0;
+	GLint size = 0;
+	GLenum type = 0;
+	GLchar name[256];
+
+	//Add every active uniform using the name it has within the shader
+	glGetProgramiv(m_program, GL_ACTIVE_UNIFORMS, &count);
+	for (GLint a = 0; a < count; a++) {
+		glGetActiveUniform(m_program, a, sizeof(name), NULL, &size, &type, name);
+		std::string uniform = std::string(name);
+		//Arrays are named after their first element
+		if (uniform.length() > 3 && uniform.compare(uniform.length() - 3, 3, "[0]") == 0)
+			uniform = uniform.substr(0, uniform.length() - 3);
+		m_uniforms[uniform] = glGetUniformLocation(m_program, name);
+	}
+
+	//Add every active attribute in the same way
+	glGetProgramiv(m_program, GL_ACTIVE_ATTRIBUTES, &count);
+	for (GLint a = 0; a < count; a++) {
+		glGetActiveAttrib(m_program, a, sizeof(name), NULL, &size, &type, name);
+		m_attributes[std::string(name)] = glGetAttribLocation(m_program, name);
+	}
+
+	m_reflected = true;
+}
+
 std::string Shader::loadShaderData(const char* path, const char* fileName) {
+	std::string   file = std::string(path) + std::string(fileName);
+
+	//Check whether the file has already been read and preprocessed
+	std::map<std::string, std::string>::iterator cached = m_includeCache.find(file);
+	if (cached != m_includeCache.end())
+		return cached->second;
+
 	std::ifstream input;
 	std::string   output;
 	std::string   current;
 
-	input.open((std::string(path) + std::string(fileName)).c_str());
+	input.open(file.c_str());
 
 	if (input.is_open()) {
 		while (input.good()) {
@@ -95,9 +180,12 @@ std::string Shader::loadShaderData(const char* path, const char* fileName) {
 			else if (current.find("#include") != std::string::npos) {
 				std::string includeFile = split_string_last(current, ' ');
 				output += loadShaderData(path, includeFile.substr(1, includeFile.size() - 2).c_str());
-			}
+			} else if (isConditionalDirective(current))
+				//Kept so that permutations of a shader can be selected with defines
+				output.append(current + "\n");
 		}
 		input.close();
+		m_includeCache.insert(std::pair<std::string, std::string>(file, output));
 	} else
 		logError("Unable to read the file '" + to_string(fileName) + "'");
 
@@ -108,7 +196,7 @@ GLuint Shader::loadShaderFromPath(const char* path, const char* fileName, GLenum
 	return Shader::loadShader(Shader::loadShaderData(path, fileName), type);
 }
 
-GLuint Shader::loadShader(std::string data, GLenum type) {
+GLuint Shader::loadShader(std::string data, GLenum type, bool checkStatus) {
 	GLuint shader = glCreateShader(type);
 
 	const GLchar* sdata[1];
@@ -118,6 +206,13 @@ GLuint Shader::loadShader(std::string data, GLenum type) {
 
 	glShaderSource(shader, 1, sdata, length);
 	glCompileShader(shader);
+	//Querying the status here waits for the compile to finish, so it can be left until the program is linked
+	if (checkStatus)
+		checkShaderStatus(shader);
+	return shader;
+}
+
+bool Shader::checkShaderStatus(GLuint shader) {
 	GLint status = 0;
 	glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
 	if (! status) {
@@ -125,9 +220,16 @@ GLuint Shader::loadShader(std::string data, GLenum type) {
 		glGetShaderInfoLog(shader, sizeof(error), NULL, error);
 		logError("Error compiling shader " + to_string(error));
 	}
-	return shader;
+	return status == GL_TRUE;
+}
+
+bool Shader::isConditionalDirective(std::string line) {
+	std::stringstream ss(line);
+	std::string directive;
+	ss >> directive;
+	return directive == "#ifdef" || directive == "#ifndef" || directive == "#else" || directive == "#endif";
 }
 
-void Shader::setUniform(std::string name, Matrix4f value) { glUniformMatrix4fv(getUniformLocation(name), 1, GL_FALSE, &(value.m_values[0][0])); }
+void Shader::setUniform(const std::string& name, Matrix4f value) { glUniformMatrix4fv(getUniformLocation(name), 1, GL_FALSE, &(value.m_values[0][0])); RenderStats::increment(RENDER_STAT_UNIFORM_UPLOADS); }
 
 /***************************************************************************************************/
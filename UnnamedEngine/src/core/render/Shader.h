@@ -30,6 +30,8 @@
 #include "../Vector.h"
 #include "../../utils/StringUtils.h"
 #include "../../utils/Logging.h"
+#include "RenderStats.h"
+#include "GLState.h"
 
 class Matrix4f;
 
@@ -45,22 +47,44 @@ private:
 	GLuint m_fragmentShader = -1;
 	std::map<std::string, GLint> m_uniforms;
 	std::map<std::string, GLint> m_attributes;
+
+	/* The status of the last link, checked once it has been requested */
+	bool m_statusChecked = false;
+	bool m_linked        = false;
+
+	/* States whether the uniforms and attributes have been found using reflection, in which
+	 * case any that are missing have been optimised out and can be ignored */
+	bool m_reflected = false;
+
+	/* The cache of shader sources read in by loadShaderData, so files that are included many
+	 * times are only read from the disk once */
+	static std::map<std::string, std::string> m_includeCache;
 public:
 	Shader() {}
+	Shader(GLuint program);
 	Shader(GLuint vertexShader, GLuint fragmentShader);
 	virtual ~Shader();
 
 	void attach(GLuint shader);
+	void link();
+	bool isLinkComplete();
+	bool checkStatus();
+	void validate();
 	void use();
 	void stopUsing();
 	void detach(GLuint shader);
 	void addUniform(std::string id, std::string name);
 	void addAttribute(std::string id, std::string name);
-	inline GLint getUniformLocation(std::string name) {
-		if (m_uniforms.count(name)) {
-			return m_uniforms.at(name);
+	void reflect();
+	inline bool hasUniform(const std::string& name) { return m_uniforms.count(name) > 0; }
+	inline bool hasAttribute(std::string name) { return m_attributes.count(name) > 0; }
+	inline GLint getUniformLocation(const std::string& name) {
+		std::map<std::string, GLint>::iterator iterator = m_uniforms.find(name);
+		if (iterator != m_uniforms.end()) {
+			return iterator->second;
 		} else {
-			logError(std::string("The uniform with the name ") + name + std::string(" could not be located"));
+			if (! m_reflected)
+				logError(std::string("The uniform with the name ") + name + std::string(" could not be located"));
 			return -1;
 		}
 	}
@@ -68,27 +92,46 @@ public:
 		if (m_attributes.count(name)) {
 			return m_attributes.at(name);
 		} else {
-			logError(std::string("The attribute with the name ") + name + std::string(" could not be located"));
+			if (! m_reflected)
+				logError(std::string("The attribute with the name ") + name + std::string(" could not be located"));
 			return -1;
 		}
 	}
 
 	/* Various methods used to assign specific values */
-	inline void setUniform(std::string name, int value) { glUniform1i(getUniformLocation(name), value); }
-	inline void setUniform(std::string name, GLuint value) { glUniform1i(getUniformLocation(name), value); }
-	inline void setUniform(std::string name, float value) { glUniform1f(getUniformLocation(name), value); }
-	inline void setUniform(std::string name, Colour value) { glUniform4f(getUniformLocation(name), value.getR(), value.getG(), value.getB(), value.getA()); }
-	void setUniform(std::string name, Matrix4f value);
-	inline void setUniform(std::string name, Vector3f value) { glUniform3f(getUniformLocation(name), value.getX(), value.getY(), value.getZ()); }
+	inline void setUniform(const std::string& name, int value) { glUniform1i(getUniformLocation(name), value); RenderStats::increment(RENDER_STAT_UNIFORM_UPLOADS); }
+	inline void setUniform(const std::string& name, GLuint value) { glUniform1i(getUniformLocation(name), value); RenderStats::increment(RENDER_STAT_UNIFORM_UPLOADS); }
+	inline void setUniform(const std::string& name, float value) { glUniform1f(getUniformLocation(name), value); RenderStats::increment(RENDER_STAT_UNIFORM_UPLOADS); }
+	inline void setUniform(const std::string& name, Colour value) { glUniform4f(getUniformLocation(name), value.getR(), value.getG(), value.getB(), value.getA()); RenderStats::increment(RENDER_STAT_UNIFORM_UPLOADS); }
+	void setUniform(const std::string& name, Matrix4f value);
+	inline void setUniform(const std::string& name, Vector3f value) { glUniform3f(getUniformLocation(name), value.getX(), value.getY(), value.getZ()); RenderStats::increment(RENDER_STAT_UNIFORM_UPLOADS); }
 
 	GLuint getProgram() { return m_program; }
 	static std::string loadShaderData(const char* path, const char* fileName);
+	static inline void clearIncludeCache() { m_includeCache.clear(); }
 	static GLuint loadShaderFromPath(const char* path, const char* fileName,  GLenum type);
-	static GLuint loadShader(std::string data, GLenum type);
+	static GLuint loadShader(std::string data, GLenum type, bool checkStatus);
+	static inline GLuint loadShader(std::string data, GLenum type) { return loadShader(data, type, true); }
+	static bool checkShaderStatus(GLuint shader);
+	static bool isConditionalDirective(std::string line);
 };
 
 /***************************************************************************************************/
 
+/* The handles of the shader types the Renderer sets up, any others are given the next handle
+ * available when they are first used */
+enum ShaderType {
+	SHADER_TYPE_BASIC,
+	SHADER_TYPE_SKYBOX,
+	SHADER_TYPE_MATERIAL,
+	SHADER_TYPE_QUAD,
+	SHADER_TYPE_AMBIENT_LIGHT,
+	SHADER_TYPE_DIRECTIONAL_LIGHT,
+	SHADER_TYPE_POINT_LIGHT,
+	SHADER_TYPE_SPOT_LIGHT,
+	SHADER_TYPE_BUILT_IN_COUNT
+};
+
 /***************************************************************************************************
  * The RenderShader class provides a way to manage shaders for rendering
  ***************************************************************************************************/
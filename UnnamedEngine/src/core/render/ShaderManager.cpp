@@ -0,0 +1,144 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <fstream>
+
+#include "ShaderManager.h"
+
+/***************************************************************************************************
+ * The ShaderManager class
+ ***************************************************************************************************/
+
+std::string ShaderManager::m_cachePath;
+std::string ShaderManager::m_driver;
+std::vector<ShaderManager::PendingShader> ShaderManager::m_pending;
+
+void ShaderManager::initialise(std::string cachePath) {
+	m_cachePath = cachePath;
+	m_driver = to_string(glGetString(GL_VENDOR)) + to_string(glGetString(GL_RENDERER)) + to_string(glGetString(GL_VERSION));
+
+	//Let the driver use as many threads as it wants to compile shaders
+	if (GLEW_ARB_parallel_shader_compile)
+		glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+}
+
+Shader* ShaderManager::loadShader(const char* path, const char* vertexShaderName, const char* fragmentShaderName) {
+	return loadShaderFromSource(Shader::loadShaderData(path, vertexShaderName), Shader::loadShaderData(path, fragmentShaderName));
+}
+
+Shader* ShaderManager::loadShader(const char* path, const char* name) {
+	std::string p = std::string(name);
+	return loadShader(path, (p + ".vs").c_str(), (p + ".fs").c_str());
+}
+
+Shader* ShaderManager::loadShaderFromSource(std::string vertexSource, std::string fragmentSource) {
+	std::string cacheFile = "";
+	if (isCacheEnabled()) {
+		cacheFile = getCacheFile(vertexSource, fragmentSource);
+
+		//Use the cached binary if there is one
+		Shader* shader = loadProgramBinary(cacheFile);
+		if (shader != NULL)
+			return shader;
+	}
+	//Compile without checking the status so that the compiles can run in parallel
+	Shader* shader = new Shader(Shader::loadShader(vertexSource, GL_VERTEX_SHADER, false),
+								Shader::loadShader(fragmentSource, GL_FRAGMENT_SHADER, false));
+	PendingShader pending;
+	pending.shader = shader;
+	pending.cacheFile = cacheFile;
+	m_pending.push_back(pending);
+	return shader;
+}
+
+void ShaderManager::finish() {
+	for (unsigned int a = 0; a < m_pending.size(); a++) {
+		if (m_pending[a].shader->checkStatus() && m_pending[a].cacheFile.length() > 0)
+			saveProgramBinary(m_pending[a].shader, m_pending[a].cacheFile);
+	}
+	m_pending.clear();
+}
+
+bool ShaderManager::isFinished() {
+	for (unsigned int a = 0; a < m_pending.size(); a++) {
+		if (! m_pending[a].shader->isLinkComplete())
+			return false;
+	}
+	return true;
+}
+
+std::string ShaderManager::getCacheFile(std::string& vertexSource, std::string& fragmentSource) {
+	std::stringstream ss;
+	ss << std::hex << hash_string(m_driver + "\n" + vertexSource + "\n" + fragmentSource);
+	return m_cachePath + ss.str() + ".bin";
+}
+
+Shader* ShaderManager::loadProgramBinary(std::string cacheFile) {
+	std::ifstream input(cacheFile.c_str(), std::ios::in | std::ios::binary);
+	if (! input.is_open())
+		return NULL;
+
+	GLenum format = 0;
+	GLint length = 0;
+	input.read((char*) &format, sizeof(format));
+	input.read((char*) &length, sizeof(length));
+	if (! input.good() || length <= 0)
+		return NULL;
+	std::vector<char> binary(length);
+	input.read(&binary.front(), length);
+	if (! input.good())
+		return NULL;
+	input.close();
+
+	GLuint program = glCreateProgram();
+	glProgramBinary(program, format, &binary.front(), length);
+
+	//The driver is free to reject binaries, in which case the shader is compiled as normal
+	GLint status = 0;
+	glGetProgramiv(program, GL_LINK_STATUS, &status);
+	if (! status) {
+		logDebug("The cached shader '" + cacheFile + "' was rejected by the driver");
+		GLState::deleteProgram(program);
+		return NULL;
+	}
+	Shader* shader = new Shader(program);
+	shader->checkStatus();
+	return shader;
+}
+
+void ShaderManager::saveProgramBinary(Shader* shader, std::string cacheFile) {
+	GLint length = 0;
+	glGetProgramiv(shader->getProgram(), GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0)
+		return;
+
+	std::vector<char> binary(length);
+	GLenum format = 0;
+	glGetProgramBinary(shader->getProgram(), length, NULL, &format, &binary.front());
+
+	std::ofstream output(cacheFile.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+	if (output.is_open()) {
+		output.write((char*) &format, sizeof(format));
+		output.write((char*) &length, sizeof(length));
+		output.write(&binary.front(), length);
+		output.close();
+	} else
+		logDebug("Unable to write the shader cache file '" + cacheFile + "'");
+}
+
+/***************************************************************************************************/
@@ -0,0 +1,75 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef CORE_RENDER_SHADERMANAGER_H_
+#define CORE_RENDER_SHADERMANAGER_H_
+
+#include "Shader.h"
+
+/***************************************************************************************************
+ * The ShaderManager class loads shaders in batches, linking each program once and only checking
+ * its status when all of the programs have been submitted so the driver can compile them in
+ * parallel. Linked programs are cached to the disk as binaries keyed by a hash of their source
+ * and the driver so that later runs can skip compiling them entirely
+ ***************************************************************************************************/
+
+class ShaderManager {
+private:
+	/* A shader that has been submitted but has not had its status checked yet */
+	struct PendingShader {
+		Shader* shader;
+		std::string cacheFile;
+	};
+
+	/* The directory program binaries are cached in, caching is disabled when this is empty */
+	static std::string m_cachePath;
+
+	/* The string identifying the current driver, included in the cache key so binaries are
+	 * rebuilt whenever the driver changes */
+	static std::string m_driver;
+
+	/* The shaders waiting to be finished */
+	static std::vector<PendingShader> m_pending;
+
+	static std::string getCacheFile(std::string& vertexSource, std::string& fragmentSource);
+	static Shader* loadProgramBinary(std::string cacheFile);
+	static void saveProgramBinary(Shader* shader, std::string cacheFile);
+public:
+	/* Should be called once the OpenGL context has been created */
+	static void initialise(std::string cachePath);
+
+	/* Loads a shader, the returned shader may still be linking until finish() is called */
+	static Shader* loadShader(const char* path, const char* vertexShaderName, const char* fragmentShaderName);
+	static Shader* loadShader(const char* path, const char* name);
+	static Shader* loadShaderFromSource(std::string vertexSource, std::string fragmentSource);
+
+	/* Waits for all of the loaded shaders to finish linking, reporting any errors and caching
+	 * the resulting binaries */
+	static void finish();
+
+	/* Returns whether all of the loaded shaders have finished linking without waiting */
+	static bool isFinished();
+
+	inline static void setCachePath(std::string cachePath) { m_cachePath = cachePath; }
+	inline static std::string getCachePath() { return m_cachePath; }
+	inline static bool isCacheEnabled() { return m_cachePath.length() > 0 && GLEW_ARB_get_program_binary; }
+};
+
+/***************************************************************************************************/
+
+#endif /* CORE_RENDER_SHADERMANAGER_H_ */
@@ -0,0 +1,204 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include "SpriteBatch.h"
+#include "Renderer.h"
+#include "../Profiler.h"
+
+/***************************************************************************************************
+ * The SpriteBatch class
+ ***************************************************************************************************/
+
+SpriteBatch* SpriteBatch::m_current;
+
+SpriteBatch::SpriteBatch() {
+	m_vboSize = 0;
+	m_iboSize = 0;
+	m_texture = NULL;
+	m_numDraws = 0;
+	m_numSprites = 0;
+
+	glGenVertexArrays(1, &m_vao);
+	glGenBuffers(1, &m_vbo);
+	glGenBuffers(1, &m_ibo);
+
+	//Setup the attributes using the same locations as the basic shader
+	Shader* shader = Renderer::getShader(SHADER_TYPE_BASIC);
+	GLState::bindVertexArray(m_vao);
+	GLState::bindBuffer(GL_ARRAY_BUFFER, m_vbo);
+	GLint position = shader->getAttributeLocation("Position");
+	GLint colour = shader->getAttributeLocation("Colour");
+	GLint textureCoord = shader->getAttributeLocation("TextureCoordinate");
+	glEnableVertexAttribArray(position);
+	glVertexAttribPointer(position, 3, GL_FLOAT, GL_FALSE, VERTEX_SIZE * sizeof(float), (void*) 0);
+	glEnableVertexAttribArray(colour);
+	glVertexAttribPointer(colour, 4, GL_FLOAT, GL_FALSE, VERTEX_SIZE * sizeof(float), (void*) (3 * sizeof(float)));
+	glEnableVertexAttribArray(textureCoord);
+	glVertexAttribPointer(textureCoord, 2, GL_FLOAT, GL_FALSE, VERTEX_SIZE * sizeof(float), (void*) (7 * sizeof(float)));
+	GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ibo);
+	GLState::bindVertexArray(0);
+}
+
+SpriteBatch::~SpriteBatch() {
+	if (m_current == this)
+		m_current = NULL;
+	GLState::deleteBuffer(m_vbo);
+	GLState::deleteBuffer(m_ibo);
+	GLState::deleteVertexArray(m_vao);
+}
+
+void SpriteBatch::begin() {
+	if (m_current != NULL && m_current != this)
+		m_current->end();
+	m_current = this;
+	m_numDraws = 0;
+	m_numSprites = 0;
+}
+
+void SpriteBatch::end() {
+	flush();
+	if (m_current == this)
+		m_current = NULL;
+}
+
+/* The name of the uniform set for every flush, kept so it isn't allocated each time */
+static const std::string SPRITEBATCH_MVP_MATRIX = "ModelViewProjectionMatrix";
+
+void SpriteBatch::flush() {
+	if (m_indices.size() == 0)
+		return;
+	PROFILE_SCOPE("SpriteBatch::flush");
+	PROFILE_GPU_SCOPE("SpriteBatch::flush");
+
+	//Grow the buffers when needed, otherwise orphan them so the driver does not have to wait
+	//for the last draw to finish before they can be written to
+	unsigned int vertexBytes = m_vertices.size() * sizeof(float);
+	unsigned int indexBytes = m_indices.size() * sizeof(unsigned int);
+	if (vertexBytes > m_vboSize)
+		m_vboSize = vertexBytes * 2;
+	if (indexBytes > m_iboSize)
+		m_iboSize = indexBytes * 2;
+
+	GLState::bindVertexArray(m_vao);
+	GLState::bindBuffer(GL_ARRAY_BUFFER, m_vbo);
+	glBufferData(GL_ARRAY_BUFFER, m_vboSize, NULL, GL_STREAM_DRAW);
+	RenderStats::bufferSubData(GL_ARRAY_BUFFER, 0, vertexBytes, &m_vertices.front());
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_iboSize, NULL, GL_STREAM_DRAW);
+	RenderStats::bufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, indexBytes, &m_indices.front());
+
+	//The vertices have already been transformed, so only the camera is needed
+	Shader* shader = Renderer::getShader(SHADER_TYPE_BASIC);
+	Matrix4f mvp = Renderer::getCamera()->getProjectionViewMatrix().transpose();
+	shader->use();
+	glUniform1i(shader->getUniformLocation("Texture"), Renderer::bindTexture(m_texture == NULL ? Renderer::TEXTURE_BLANK : m_texture));
+	glUniformMatrix4fv(shader->getUniformLocation(SPRITEBATCH_MVP_MATRIX), 1, GL_FALSE, &(mvp.m_values[0][0]));
+	RenderStats::add(RENDER_STAT_UNIFORM_UPLOADS, 2);
+	glDrawElements(GL_TRIANGLES, m_indices.size(), GL_UNSIGNED_INT, (void*) 0);
+	RenderStats::addDraw(true, m_indices.size());
+	Renderer::releaseTextures();
+
+	m_numDraws++;
+	m_vertices.clear();
+	m_indices.clear();
+}
+
+void SpriteBatch::setTexture(Texture* texture) {
+	//Textures from the same atlas share the same OpenGL texture, so can be drawn together
+	GLuint current = m_texture == NULL ? Renderer::TEXTURE_BLANK->getTexture() : m_texture->getTexture();
+	GLuint next = texture == NULL ? Renderer::TEXTURE_BLANK->getTexture() : texture->getTexture();
+	if (current != next)
+		flush();
+	m_texture = texture;
+}
+
+void SpriteBatch::addVertex(Matrix4f& modelMatrix, float x, float y, float z, Colour colour, float u, float v) {
+	m_vertices.push_back(modelMatrix.m_values[0][0] * x + modelMatrix.m_values[0][1] * y + modelMatrix.m_values[0][2] * z + modelMatrix.m_values[0][3]);
+	m_vertices.push_back(modelMatrix.m_values[1][0] * x + modelMatrix.m_values[1][1] * y + modelMatrix.m_values[1][2] * z + modelMatrix.m_values[1][3]);
+	m_vertices.push_back(modelMatrix.m_values[2][0] * x + modelMatrix.m_values[2][1] * y + modelMatrix.m_values[2][2] * z + modelMatrix.m_values[2][3]);
+	m_vertices.push_back(colour.getR());
+	m_vertices.push_back(colour.getG());
+	m_vertices.push_back(colour.getB());
+	m_vertices.push_back(colour.getA());
+	m_vertices.push_back(u);
+	m_vertices.push_back(v);
+}
+
+void SpriteBatch::add(Mesh* mesh, Matrix4f modelMatrix) {
+	//The shared quad has no colours or texture coordinates of its own
+	if (MeshBuilder::isUnitQuad(mesh)) {
+		addQuad(mesh, modelMatrix, mesh->getTexture(), Colour::WHITE);
+		return;
+	}
+	setTexture(mesh->getTexture());
+
+	MeshData* data = mesh->getData();
+	std::vector<float>& positions = data->getPositions();
+	std::vector<float>& colours = data->getColours();
+	std::vector<float>& textureCoords = data->getTextureCoords();
+	std::vector<unsigned int>& indices = data->getIndices();
+
+	unsigned int first = m_vertices.size() / VERTEX_SIZE;
+	unsigned int numVertices = positions.size() / 3;
+	for (unsigned int a = 0; a < numVertices; a++) {
+		Colour colour = Colour::WHITE;
+		if ((a + 1) * 4 <= colours.size())
+			colour = Colour(colours[a * 4], colours[a * 4 + 1], colours[a * 4 + 2], colours[a * 4 + 3]);
+		float u = 0;
+		float v = 0;
+		if ((a + 1) * 2 <= textureCoords.size()) {
+			u = textureCoords[a * 2];
+			v = textureCoords[a * 2 + 1];
+		}
+		addVertex(modelMatrix, positions[a * 3], positions[a * 3 + 1], positions[a * 3 + 2], colour, u, v);
+	}
+	if (indices.size() > 0) {
+		for (unsigned int a = 0; a < indices.size(); a++)
+			m_indices.push_back(first + indices[a]);
+	} else {
+		for (unsigned int a = 0; a < numVertices; a++)
+			m_indices.push_back(first + a);
+	}
+	m_numSprites++;
+}
+
+void SpriteBatch::addQuad(Mesh* mesh, Matrix4f modelMatrix, Texture* texture, Colour colour) {
+	std::vector<float>& positions = mesh->getData()->getPositions();
+	if (positions.size() < 12) {
+		logError("SpriteBatch::addQuad requires a mesh with four vertices");
+		return;
+	}
+	setTexture(texture);
+
+	Texture* area = texture == NULL ? Renderer::TEXTURE_BLANK : texture;
+	unsigned int first = m_vertices.size() / VERTEX_SIZE;
+	addVertex(modelMatrix, positions[0], positions[1], positions[2], colour, area->left, area->top);
+	addVertex(modelMatrix, positions[3], positions[4], positions[5], colour, area->right, area->top);
+	addVertex(modelMatrix, positions[6], positions[7], positions[8], colour, area->right, area->bottom);
+	addVertex(modelMatrix, positions[9], positions[10], positions[11], colour, area->left, area->bottom);
+
+	//The same order as MeshBuilder::addQuadI
+	m_indices.push_back(first + 0);
+	m_indices.push_back(first + 1);
+	m_indices.push_back(first + 2);
+	m_indices.push_back(first + 3);
+	m_indices.push_back(first + 0);
+	m_indices.push_back(first + 2);
+	m_numSprites++;
+}
+
+/***************************************************************************************************/
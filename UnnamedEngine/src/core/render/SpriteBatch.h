@@ -0,0 +1,86 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef CORE_RENDER_SPRITEBATCH_H_
+#define CORE_RENDER_SPRITEBATCH_H_
+
+#include "../Object.h"
+
+/***************************************************************************************************
+ * The SpriteBatch class collects 2D meshes that have been transformed on the CPU into a single
+ * streaming vertex buffer, and draws them with as few draw calls as possible. A new draw call is
+ * only needed when the texture changes, so GUI components sharing a TextureAtlas are drawn
+ * together. While a batch is active anything drawn by the Renderer flushes it first, so the order
+ * things are drawn in is kept
+ ***************************************************************************************************/
+
+class SpriteBatch {
+private:
+	/* The number of floats in each vertex, the position, colour and texture coordinate */
+	static const unsigned int VERTEX_SIZE = 9;
+
+	/* The batch that is currently active */
+	static SpriteBatch* m_current;
+
+	GLuint m_vao;
+	GLuint m_vbo;
+	GLuint m_ibo;
+
+	/* The sizes of the buffers on the GPU, they are only resized when they need to grow */
+	unsigned int m_vboSize;
+	unsigned int m_iboSize;
+
+	std::vector<float> m_vertices;
+	std::vector<unsigned int> m_indices;
+
+	/* The texture used by everything in the batch */
+	Texture* m_texture;
+
+	/* The statistics since begin() was last called */
+	unsigned int m_numDraws;
+	unsigned int m_numSprites;
+
+	void setTexture(Texture* texture);
+	void addVertex(Matrix4f& modelMatrix, float x, float y, float z, Colour colour, float u, float v);
+public:
+	SpriteBatch();
+	virtual ~SpriteBatch();
+
+	void begin();
+	void end();
+
+	/* Draws everything that has been added so far */
+	void flush();
+
+	/* Adds a mesh using its own colours, texture coordinates and texture */
+	void add(Mesh* mesh, Matrix4f modelMatrix);
+
+	/* Adds a quad mesh with its texture and colour replaced, the texture coordinates are taken
+	 * from the area of the texture in the same way as MeshBuilder::addQuadT */
+	void addQuad(Mesh* mesh, Matrix4f modelMatrix, Texture* texture, Colour colour);
+
+	inline unsigned int getNumDraws() { return m_numDraws; }
+	inline unsigned int getNumSprites() { return m_numSprites; }
+
+	static inline SpriteBatch* getCurrent() { return m_current; }
+	static inline bool isBatching() { return m_current != NULL; }
+};
+
+/***************************************************************************************************/
+
+#endif /* CORE_RENDER_SPRITEBATCH_H_ */
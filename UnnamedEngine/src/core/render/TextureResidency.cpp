@@ -0,0 +1,212 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+
+#include "TextureResidency.h"
+
+/***************************************************************************************************
+ * The TextureResidency class
+ ***************************************************************************************************/
+
+TextureResidency::TextureResidency(long long budget) {
+	m_budget = budget;
+	m_residentBytes = 0;
+	m_maxPendingLoads = 4;
+	m_frame = 1;
+	m_numEvictions = 0;
+}
+
+unsigned int TextureResidency::add(int width, int height, int bytesPerPixel, int minimumSize) {
+	Entry entry;
+	entry.width = width;
+	entry.height = height;
+	entry.bytesPerPixel = bytesPerPixel;
+	entry.numMips = getNumMips(width, height);
+	entry.minimumMip = 0;
+	while (entry.minimumMip < entry.numMips - 1 && std::max(width >> entry.minimumMip, height >> entry.minimumMip) > minimumSize)
+		entry.minimumMip++;
+	entry.residentMip = entry.numMips;
+	entry.pendingMip = -1;
+	entry.requestedMip = entry.numMips;
+	entry.priority = 0;
+	entry.lastUsed = 0;
+	entry.failed = false;
+	m_entries.push_back(entry);
+	return m_entries.size() - 1;
+}
+
+void TextureResidency::request(unsigned int id, int mip, float priority) {
+	Entry& entry = m_entries[id];
+	if (mip < entry.requestedMip)
+		entry.requestedMip = std::max(mip, 0);
+	if (priority > entry.priority)
+		entry.priority = priority;
+	entry.lastUsed = m_frame;
+}
+
+/* Used to sort the textures to load, the highest priority first */
+struct TextureResidencyCandidate {
+	unsigned int id;
+	float priority;
+	bool operator<(const TextureResidencyCandidate& other) const {
+		return priority > other.priority || (priority == other.priority && id < other.id);
+	}
+};
+
+void TextureResidency::update(std::vector<Change>& loads, std::vector<Change>& evictions) {
+	unsigned int numPending = 0;
+	std::vector<TextureResidencyCandidate> candidates;
+	for (unsigned int a = 0; a < m_entries.size(); a++) {
+		Entry& entry = m_entries[a];
+		if (entry.pendingMip >= 0) {
+			numPending++;
+			continue;
+		} else if (entry.failed)
+			continue;
+		//Every texture keeps its least detailed level, so that is loaded even if not requested
+		int wanted = std::min(entry.requestedMip, entry.minimumMip);
+		if (wanted < entry.residentMip) {
+			TextureResidencyCandidate candidate;
+			candidate.id = a;
+			candidate.priority = entry.priority;
+			candidates.push_back(candidate);
+		}
+	}
+	std::sort(candidates.begin(), candidates.end());
+
+	long long committed = getCommittedBytes();
+	for (unsigned int a = 0; a < candidates.size() && numPending < m_maxPendingLoads; a++) {
+		Entry& entry = m_entries[candidates[a].id];
+		int mip = std::min(entry.requestedMip, entry.minimumMip);
+		long long current = getEntryBytes(entry, entry.residentMip);
+
+		//Make room by evicting unused textures, settling for a less detailed level if there
+		//isn't enough, apart from the least detailed level which is always loaded
+		while (mip < entry.minimumMip && committed + getEntryBytes(entry, mip) - current > m_budget) {
+			if (evict(committed + getEntryBytes(entry, mip) - current - m_budget, entry.priority, evictions) > 0)
+				committed = getCommittedBytes();
+			else
+				mip++;
+		}
+		if (mip < entry.residentMip) {
+			committed += getEntryBytes(entry, mip) - current;
+			entry.pendingMip = mip;
+			numPending++;
+			Change load;
+			load.id = candidates[a].id;
+			load.mip = mip;
+			loads.push_back(load);
+		}
+	}
+
+	//Start the next frame
+	for (unsigned int a = 0; a < m_entries.size(); a++) {
+		m_entries[a].requestedMip = m_entries[a].numMips;
+		m_entries[a].priority = 0;
+	}
+	m_frame++;
+}
+
+long long TextureResidency::evict(long long bytes, float priority, std::vector<Change>& evictions) {
+	long long freed = 0;
+	while (freed < bytes) {
+		//Find the least recently used texture that has more than its least detailed level, or
+		//failing that the lowest priority one with more detail than was requested this frame, as
+		//long as it has a lower priority than the texture being loaded
+		int victim = -1;
+		for (unsigned int a = 0; a < m_entries.size(); a++) {
+			Entry& entry = m_entries[a];
+			if (entry.pendingMip >= 0 || entry.residentMip >= entry.minimumMip || (entry.lastUsed == m_frame && (entry.residentMip >= entry.requestedMip || entry.priority >= priority)))
+				continue;
+			if (victim < 0 || entry.lastUsed < m_entries[victim].lastUsed ||
+					(entry.lastUsed == m_entries[victim].lastUsed && entry.priority < m_entries[victim].priority))
+				victim = a;
+		}
+		if (victim < 0)
+			break;
+
+		Entry& entry = m_entries[victim];
+		long long released = getEntryBytes(entry, entry.residentMip) - getEntryBytes(entry, entry.minimumMip);
+		freed += released;
+		m_residentBytes -= released;
+		entry.residentMip = entry.minimumMip;
+		m_numEvictions++;
+
+		Change eviction;
+		eviction.id = victim;
+		eviction.mip = entry.minimumMip;
+		evictions.push_back(eviction);
+	}
+	return freed;
+}
+
+void TextureResidency::loaded(unsigned int id, int mip) {
+	Entry& entry = m_entries[id];
+	if (mip < entry.residentMip) {
+		m_residentBytes += getEntryBytes(entry, mip) - getEntryBytes(entry, entry.residentMip);
+		entry.residentMip = mip;
+	}
+	entry.pendingMip = -1;
+}
+
+void TextureResidency::failed(unsigned int id) {
+	m_entries[id].pendingMip = -1;
+	m_entries[id].failed = true;
+}
+
+long long TextureResidency::getEntryBytes(Entry& entry, int mip) {
+	return getBytes(entry.width, entry.height, entry.bytesPerPixel, mip);
+}
+
+long long TextureResidency::getCommittedBytes() {
+	long long committed = 0;
+	for (unsigned int a = 0; a < m_entries.size(); a++) {
+		Entry& entry = m_entries[a];
+		committed += getEntryBytes(entry, entry.pendingMip >= 0 ? entry.pendingMip : entry.residentMip);
+	}
+	return committed;
+}
+
+int TextureResidency::getNumMips(int width, int height) {
+	int numMips = 1;
+	while ((width >> numMips) > 0 || (height >> numMips) > 0)
+		numMips++;
+	return numMips;
+}
+
+long long TextureResidency::getBytes(int width, int height, int bytesPerPixel, int mip) {
+	long long bytes = 0;
+	int numMips = getNumMips(width, height);
+	for (int a = mip; a < numMips; a++)
+		bytes += (long long) std::max(width >> a, 1) * std::max(height >> a, 1) * bytesPerPixel;
+	return bytes;
+}
+
+int TextureResidency::calculateMip(int width, int height, float screenSize) {
+	int numMips = getNumMips(width, height);
+	float size = (float) std::max(width, height);
+	if (screenSize >= size)
+		return 0;
+	if (screenSize <= 1.0f)
+		return numMips - 1;
+	return std::min((int) floor(log2(size / screenSize)), numMips - 1);
+}
+
+/***************************************************************************************************/
@@ -0,0 +1,126 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef CORE_RENDER_TEXTURERESIDENCY_H_
+#define CORE_RENDER_TEXTURERESIDENCY_H_
+
+#include <vector>
+
+/***************************************************************************************************
+ * The TextureResidency class decides which mip levels of streamed textures should be in GPU
+ * memory. Each frame the levels that are needed are requested, and update() returns the loads to
+ * start (highest priority first) and the textures to evict (least recently used first) to stay
+ * within the budget. It does no loading itself so it can be driven without a GPU
+ ***************************************************************************************************/
+
+class TextureResidency {
+public:
+	/* A change to the mip level of a texture, the level is the most detailed one resident */
+	struct Change {
+		unsigned int id;
+		int mip;
+	};
+private:
+	struct Entry {
+		int width;
+		int height;
+		int bytesPerPixel;
+		int numMips;
+
+		/* The least detailed level, which is always kept once it has been loaded */
+		int minimumMip;
+
+		/* The most detailed level resident, or numMips when nothing has been loaded yet */
+		int residentMip;
+
+		/* The level being loaded, or -1 when nothing is */
+		int pendingMip;
+
+		/* The most detailed level requested this frame and its priority */
+		int requestedMip;
+		float priority;
+
+		/* The frame the texture was last requested in */
+		unsigned long long lastUsed;
+
+		/* States whether loading the texture failed, in which case it isn't loaded again */
+		bool failed;
+	};
+
+	std::vector<Entry> m_entries;
+
+	/* The most bytes that should be resident */
+	long long m_budget;
+
+	/* The bytes resident and the bytes that will be once the loads in progress finish */
+	long long m_residentBytes;
+
+	unsigned int m_maxPendingLoads;
+	unsigned long long m_frame;
+	unsigned int m_numEvictions;
+
+	/* Evicts textures until at least the given number of bytes are freed, those that aren't in use
+	 * go first then those with more detail than they need. Evicted textures drop to their least
+	 * detailed level */
+	long long evict(long long bytes, float priority, std::vector<Change>& evictions);
+
+	long long getEntryBytes(Entry& entry, int mip);
+	long long getCommittedBytes();
+public:
+	TextureResidency(long long budget);
+	virtual ~TextureResidency() {}
+
+	/* Adds a texture, its least detailed level kept is the first no larger than the minimum size */
+	unsigned int add(int width, int height, int bytesPerPixel, int minimumSize);
+
+	/* Requests a mip level for this frame, the most detailed level and highest priority given
+	 * in a frame are used */
+	void request(unsigned int id, int mip, float priority);
+
+	/* Decides what to load and evict, then starts the next frame */
+	void update(std::vector<Change>& loads, std::vector<Change>& evictions);
+
+	/* Called once a load returned by update() has finished, or failed */
+	void loaded(unsigned int id, int mip);
+	void failed(unsigned int id);
+
+	inline void setBudget(long long budget) { m_budget = budget; }
+	inline void setMaxPendingLoads(unsigned int maxPendingLoads) { m_maxPendingLoads = maxPendingLoads; }
+	inline long long getBudget() { return m_budget; }
+	inline long long getResidentBytes() { return m_residentBytes; }
+	inline unsigned int getNumEvictions() { return m_numEvictions; }
+	inline unsigned int getNumTextures() { return m_entries.size(); }
+	inline int getResidentMip(unsigned int id) { return m_entries[id].residentMip; }
+	inline int getPendingMip(unsigned int id) { return m_entries[id].pendingMip; }
+	inline int getMinimumMip(unsigned int id) { return m_entries[id].minimumMip; }
+	inline int getNumMips(unsigned int id) { return m_entries[id].numMips; }
+
+	/* Returns the number of levels in a full mip chain */
+	static int getNumMips(int width, int height);
+
+	/* Returns the bytes needed for a mip level and all of the less detailed ones below it */
+	static long long getBytes(int width, int height, int bytesPerPixel, int mip);
+
+	/* Returns the level whose size best matches the number of pixels the texture covers on the
+	 * screen */
+	static int calculateMip(int width, int height, float screenSize);
+};
+
+/***************************************************************************************************/
+
+#endif /* CORE_RENDER_TEXTURERESIDENCY_H_ */
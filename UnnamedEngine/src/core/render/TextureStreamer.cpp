@@ -0,0 +1,293 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <cmath>
+#include <algorithm>
+
+#include "TextureStreamer.h"
+#include "../Game.h"
+#include "../Camera.h"
+#include "../Model.h"
+#include "../Profiler.h"
+#include <GL/stb_image.h>
+
+/***************************************************************************************************
+ * The TextureStreamer class
+ ***************************************************************************************************/
+
+TextureResidency* TextureStreamer::m_residency;
+std::vector<TextureStreamer::Stream> TextureStreamer::m_streams;
+std::map<Texture*, unsigned int> TextureStreamer::m_ids;
+
+std::thread TextureStreamer::m_thread;
+std::mutex TextureStreamer::m_mutex;
+std::condition_variable TextureStreamer::m_condition;
+std::deque<TextureStreamer::Job> TextureStreamer::m_jobs;
+std::vector<TextureStreamer::Job> TextureStreamer::m_completed;
+bool TextureStreamer::m_running;
+
+Vector3f TextureStreamer::m_viewPosition;
+float TextureStreamer::m_projectionScale;
+
+void TextureStreamer::initialise(long long budget) {
+	if (m_residency != NULL)
+		destroy();
+	m_residency = new TextureResidency(budget);
+	m_projectionScale = 0;
+	m_running = true;
+	m_thread = std::thread(loader);
+}
+
+void TextureStreamer::destroy() {
+	if (m_residency == NULL)
+		return;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_running = false;
+	}
+	m_condition.notify_one();
+	m_thread.join();
+
+	//Anything still waiting to be uploaded is no longer needed
+	for (unsigned int a = 0; a < m_completed.size(); a++) {
+		if (m_completed[a].minimum != m_completed[a].image)
+			delete m_completed[a].minimum;
+		delete m_completed[a].image;
+	}
+	m_completed.clear();
+	m_jobs.clear();
+
+	for (unsigned int a = 0; a < m_streams.size(); a++)
+		delete m_streams[a].minimum;
+	m_streams.clear();
+	m_ids.clear();
+
+	delete m_residency;
+	m_residency = NULL;
+}
+
+Texture* TextureStreamer::load(const char* path, TextureParameters parameters) {
+	//Only the header is read here, the image itself is decoded once it is needed
+	int width, height, numComponents;
+	if (! stbi_info(path, &width, &height, &numComponents)) {
+		logError("Failed to load the image from the path '" + to_string(path) + "'");
+		return NULL;
+	}
+
+	Texture* texture = new Texture(parameters);
+	texture->setWidth(width);
+	texture->setHeight(height);
+	texture->setNumComponents(numComponents);
+
+	//Show a single white pixel until the first level has loaded
+	unsigned char blank[] = { 255, 255, 255, 255 };
+	texture->bind();
+	glTexImage2D(parameters.getTarget(), 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, blank);
+	texture->generateMipmaps();
+	texture->applyParameters(false, true);
+
+	//Images with 3 components are expanded to 4 when they are uploaded
+	int bytesPerPixel = numComponents == 3 ? 4 : numComponents;
+
+	Stream stream;
+	stream.texture = texture;
+	stream.path = path;
+	stream.flags = IMAGE_EXPAND_RGBA;
+	stream.minimum = NULL;
+	m_streams.push_back(stream);
+	m_ids[texture] = m_residency->add(width, height, bytesPerPixel, MINIMUM_SIZE);
+
+	return texture;
+}
+
+void TextureStreamer::setView(Camera* camera, Vector3f position) {
+	//The projection matrix scales the height of the view by the cotangent of half the field of
+	//view, so this is the height in pixels of something 1 unit tall at a distance of 1
+	m_viewPosition = position;
+	m_projectionScale = camera->getProjectionMatrix().m_values[1][1] * Game::current->getSettings()->getWindowHeight() / 2.0f;
+}
+
+void TextureStreamer::request(Texture* texture, Vector3f centre, float radius) {
+	if (m_residency == NULL || texture == NULL)
+		return;
+	std::map<Texture*, unsigned int>::iterator iterator = m_ids.find(texture);
+	if (iterator == m_ids.end())
+		return;
+
+	float x = centre.getX() - m_viewPosition.getX();
+	float y = centre.getY() - m_viewPosition.getY();
+	float z = centre.getZ() - m_viewPosition.getZ();
+	float distance = sqrt(x * x + y * y + z * z);
+
+	//Without any bounds, or when the view is inside them, the whole texture may be visible
+	float screenSize = (float) std::max(texture->getWidth(), texture->getHeight());
+	if (radius > 0 && distance > radius && m_projectionScale > 0)
+		screenSize = std::min(screenSize, (radius * 2.0f * m_projectionScale) / distance);
+
+	m_residency->request(iterator->second, TextureResidency::calculateMip(texture->getWidth(), texture->getHeight(), screenSize), screenSize);
+}
+
+void TextureStreamer::request(RenderableObject3D* object) {
+	if (m_residency == NULL)
+		return;
+	Matrix4f modelMatrix = object->getModelMatrix();
+	Vector3f s = object->getScale();
+	float scale = std::max(fabs(s.getX()), std::max(fabs(s.getY()), fabs(s.getZ())));
+
+	Model* model = dynamic_cast<Model*>(object);
+	if (model != NULL) {
+		for (unsigned int a = 0; a < model->getNumMeshes(); a++)
+			request(model->getMesh(a), modelMatrix, scale);
+	} else if (object->getMesh() != NULL)
+		request(object->getMesh(), modelMatrix, scale);
+}
+
+void TextureStreamer::request(Mesh* mesh, Matrix4f& modelMatrix, float scale) {
+	//Use a sphere around the bounding box of the mesh
+	Vector3f centre;
+	float radius = 0;
+	MeshData* data = mesh->getData();
+	if (data != NULL && data->hasPositions()) {
+		Vector3f min = data->getBoundsMin();
+		Vector3f max = data->getBoundsMax();
+		float x = (min.getX() + max.getX()) / 2.0f;
+		float y = (min.getY() + max.getY()) / 2.0f;
+		float z = (min.getZ() + max.getZ()) / 2.0f;
+		centre = Vector3f(modelMatrix.m_values[0][0] * x + modelMatrix.m_values[0][1] * y + modelMatrix.m_values[0][2] * z + modelMatrix.m_values[0][3],
+						  modelMatrix.m_values[1][0] * x + modelMatrix.m_values[1][1] * y + modelMatrix.m_values[1][2] * z + modelMatrix.m_values[1][3],
+						  modelMatrix.m_values[2][0] * x + modelMatrix.m_values[2][1] * y + modelMatrix.m_values[2][2] * z + modelMatrix.m_values[2][3]);
+		x = max.getX() - x;
+		y = max.getY() - y;
+		z = max.getZ() - z;
+		radius = sqrt(x * x + y * y + z * z) * scale;
+	}
+
+	if (mesh->hasTexture())
+		request(mesh->getTexture(), centre, radius);
+	MeshRenderData* renderData = mesh->getRenderData();
+	if (renderData != NULL && renderData->hasMaterial() && renderData->getMaterial()->hasDiffuseTexture())
+		request(renderData->getMaterial()->getDiffuseTexture(), centre, radius);
+}
+
+void TextureStreamer::update() {
+	if (m_residency == NULL)
+		return;
+	PROFILE_SCOPE("TextureStreamer::update");
+
+	//Upload the levels that have finished loading, this has to be done on the thread with the
+	//OpenGL context
+	std::vector<Job> completed;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		completed.swap(m_completed);
+	}
+	for (unsigned int a = 0; a < completed.size(); a++) {
+		Job& job = completed[a];
+		Stream& stream = m_streams[job.id];
+		if (job.image->isLoaded()) {
+			Texture* texture = stream.texture;
+			texture->bind();
+			ImageLoader::upload(job.image, texture->getParameters().getTarget());
+			texture->generateMipmaps();
+			texture->applyParameters(false, true);
+			m_residency->loaded(job.id, job.mip);
+			if (job.minimum != NULL)
+				stream.minimum = job.minimum;
+		} else
+			m_residency->failed(job.id);
+		if (job.image != stream.minimum)
+			delete job.image;
+	}
+
+	std::vector<TextureResidency::Change> loads;
+	std::vector<TextureResidency::Change> evictions;
+	m_residency->update(loads, evictions);
+
+	//Evicted textures go back to the least detailed level which is still in memory
+	for (unsigned int a = 0; a < evictions.size(); a++) {
+		Stream& stream = m_streams[evictions[a].id];
+		if (stream.minimum != NULL) {
+			stream.texture->bind();
+			ImageLoader::upload(stream.minimum, stream.texture->getParameters().getTarget());
+			stream.texture->generateMipmaps();
+			stream.texture->applyParameters(false, true);
+		}
+	}
+
+	if (loads.size() > 0) {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		for (unsigned int a = 0; a < loads.size(); a++) {
+			Stream& stream = m_streams[loads[a].id];
+			Job job;
+			job.id = loads[a].id;
+			job.path = stream.path;
+			job.flags = stream.flags;
+			job.mip = loads[a].mip;
+			job.minimumMip = m_residency->getMinimumMip(job.id);
+			job.keepMinimum = stream.minimum == NULL;
+			job.image = NULL;
+			job.minimum = NULL;
+			m_jobs.push_back(job);
+		}
+	}
+	m_condition.notify_one();
+}
+
+void TextureStreamer::loader() {
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (true) {
+		while (m_running && m_jobs.empty())
+			m_condition.wait(lock);
+		if (! m_running)
+			return;
+
+		//The jobs were added in order of priority
+		Job job = m_jobs.front();
+		m_jobs.pop_front();
+
+		lock.unlock();
+		load(job);
+		lock.lock();
+
+		m_completed.push_back(job);
+	}
+}
+
+void TextureStreamer::load(Job& job) {
+	//The image has to be decoded in full as stb_image can't decode a single level
+	Image* image = ImageLoader::decode(job.path, job.flags);
+	for (int a = 0; a < job.mip && image->isLoaded(); a++) {
+		Image* next = ImageLoader::downsample(image);
+		delete image;
+		image = next;
+	}
+	job.image = image;
+
+	if (job.keepMinimum && image->isLoaded()) {
+		Image* minimum = image;
+		for (int a = job.mip; a < job.minimumMip; a++) {
+			Image* next = ImageLoader::downsample(minimum);
+			if (minimum != image)
+				delete minimum;
+			minimum = next;
+		}
+		job.minimum = minimum;
+	}
+}
+
+/***************************************************************************************************/
@@ -0,0 +1,130 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef CORE_RENDER_TEXTURESTREAMER_H_
+#define CORE_RENDER_TEXTURESTREAMER_H_
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "../Texture.h"
+#include "../ImageLoader.h"
+#include "../Vector.h"
+#include "TextureResidency.h"
+
+class Camera;
+class Mesh;
+class Matrix4f;
+class RenderableObject3D;
+
+/***************************************************************************************************
+ * The TextureStreamer class loads textures a mip level at a time, only loading the detail needed
+ * for how large the objects using them appear on the screen. The textures are kept within a
+ * budget by dropping the detail of those that haven't been used recently, while the images are
+ * decoded on a separate thread in order of priority
+ ***************************************************************************************************/
+
+class TextureStreamer {
+private:
+	/* A texture being streamed */
+	struct Stream {
+		Texture* texture;
+		std::string path;
+		int flags;
+
+		/* The least detailed level kept in memory so it can be uploaded again when the texture
+		 * is evicted, without having to decode it again */
+		Image* minimum;
+	};
+
+	/* A mip level to load on the loader thread */
+	struct Job {
+		unsigned int id;
+		std::string path;
+		int flags;
+		int mip;
+		int minimumMip;
+		bool keepMinimum;
+
+		/* The images created by the loader thread */
+		Image* image;
+		Image* minimum;
+	};
+
+	/* Textures are never streamed below this size */
+	static const int MINIMUM_SIZE = 64;
+
+	static TextureResidency* m_residency;
+	static std::vector<Stream> m_streams;
+	static std::map<Texture*, unsigned int> m_ids;
+
+	/* The loader thread and the jobs passed to and from it */
+	static std::thread m_thread;
+	static std::mutex m_mutex;
+	static std::condition_variable m_condition;
+	static std::deque<Job> m_jobs;
+	static std::vector<Job> m_completed;
+	static bool m_running;
+
+	/* The view textures are requested from, the scale converts a size at a distance of 1 into
+	 * pixels on the screen */
+	static Vector3f m_viewPosition;
+	static float m_projectionScale;
+
+	/* Run by the loader thread */
+	static void loader();
+
+	/* Decodes the image for a job and reduces it to the levels needed */
+	static void load(Job& job);
+
+	/* Requests the textures used by a mesh, using its bounds transformed by the model matrix */
+	static void request(Mesh* mesh, Matrix4f& modelMatrix, float scale);
+public:
+	/* Starts streaming with a budget given in bytes */
+	static void initialise(long long budget);
+	static void destroy();
+
+	/* Creates a texture that is streamed, it is blank until its first level has loaded */
+	static Texture* load(const char* path, TextureParameters parameters);
+
+	/* Sets the view used to work out the detail needed for the textures requested */
+	static void setView(Camera* camera, Vector3f position);
+
+	/* Requests the detail needed for a texture used on an object with the bounding sphere given */
+	static void request(Texture* texture, Vector3f centre, float radius);
+
+	/* Requests the textures used by an object */
+	static void request(RenderableObject3D* object);
+
+	/* Uploads the levels that have loaded, then decides what to load and evict next. Called once
+	 * per frame */
+	static void update();
+
+	static inline bool isEnabled() { return m_residency != NULL; }
+	static inline bool isStreamed(Texture* texture) { return m_ids.count(texture) > 0; }
+	static inline TextureResidency* getResidency() { return m_residency; }
+};
+
+/***************************************************************************************************/
+
+#endif /* CORE_RENDER_TEXTURESTREAMER_H_ */
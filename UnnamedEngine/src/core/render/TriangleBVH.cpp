@@ -0,0 +1,376 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <thread>
+
+#include "TriangleBVH.h"
+#include "../Mesh.h"
+
+/***************************************************************************************************
+ * The TriangleBVH class
+ ***************************************************************************************************/
+
+TriangleBVH::TriangleBVH(MeshData* data) {
+	for (unsigned int a = 0; a < 3; a++) {
+		m_origin[a] = 0;
+		m_scale[a] = 0;
+	}
+	unsigned int numTriangles = data->getNumTriangles();
+	if (numTriangles == 0 || ! data->hasPositions())
+		return;
+
+	//Gather the vertices of each triangle, wherever they are stored in the mesh
+	std::vector<unsigned int>& indices = data->getIndices();
+	std::vector<float> positions(numTriangles * 9);
+	m_buildTriangles.resize(numTriangles);
+	m_triangles.resize(numTriangles);
+	for (unsigned int a = 0; a < numTriangles; a++) {
+		BuildTriangle& triangle = m_buildTriangles[a];
+		for (unsigned int b = 0; b < 3; b++) {
+			unsigned int vertex = data->hasIndices() ? indices[a * 3 + b] : a * 3 + b;
+			const float* position = data->getValues(MeshBuffers::ATTRIBUTE_POSITION, vertex);
+			for (unsigned int c = 0; c < 3; c++) {
+				positions[a * 9 + b * 3 + c] = position[c];
+				triangle.min[c] = b == 0 ? position[c] : std::min(triangle.min[c], position[c]);
+				triangle.max[c] = b == 0 ? position[c] : std::max(triangle.max[c], position[c]);
+			}
+		}
+		for (unsigned int b = 0; b < 3; b++)
+			triangle.centre[b] = (triangle.min[b] + triangle.max[b]) * 0.5f;
+		m_triangles[a] = a;
+	}
+
+	//Enough levels are built on separate threads for every thread to have a branch
+	unsigned int numThreads = std::thread::hardware_concurrency();
+	m_parallelDepth = 0;
+	while ((1u << m_parallelDepth) < numThreads)
+		m_parallelDepth++;
+	BuildNode* root = build(0, numTriangles, 0);
+
+	//The bounds are quantised within the root's, made slightly larger so rounding can't make
+	//them smaller
+	for (unsigned int a = 0; a < 3; a++) {
+		m_origin[a] = root->min[a];
+		m_scale[a] = (root->max[a] - root->min[a]) * 1.0001f / 65535.0f;
+	}
+	flatten(root);
+
+	//The triangles are stored as a vertex and two edges, which is what the ray test uses
+	m_vertices.resize(numTriangles * 9);
+	for (unsigned int a = 0; a < numTriangles; a++) {
+		const float* source = &positions[m_triangles[a] * 9];
+		float* destination = &m_vertices[a * 9];
+		for (unsigned int b = 0; b < 3; b++) {
+			destination[b] = source[b];
+			destination[3 + b] = source[3 + b] - source[b];
+			destination[6 + b] = source[6 + b] - source[b];
+		}
+	}
+	std::vector<BuildTriangle>().swap(m_buildTriangles);
+}
+
+bool TriangleBVH::CentreOrder::operator()(unsigned int a, unsigned int b) const {
+	return (*triangles)[a].centre[axis] < (*triangles)[b].centre[axis];
+}
+
+bool TriangleBVH::BinPredicate::operator()(unsigned int triangle) const {
+	unsigned int bin = std::min(NUM_BINS - 1, (unsigned int) (((*triangles)[triangle].centre[axis] - min) * scale));
+	return bin < split;
+}
+
+float TriangleBVH::getArea(const float min[3], const float max[3]) {
+	float x = max[0] - min[0];
+	float y = max[1] - min[1];
+	float z = max[2] - min[2];
+	return 2.0f * (x * y + y * z + z * x);
+}
+
+TriangleBVH::BuildNode* TriangleBVH::build(unsigned int first, unsigned int count, unsigned int depth) {
+	BuildNode* node = new BuildNode();
+	node->first = first;
+	node->count = count;
+	node->children[0] = NULL;
+	node->children[1] = NULL;
+
+	//The bounds of the triangles, and of their centres which are what is split
+	float centreMin[3];
+	float centreMax[3];
+	for (unsigned int a = 0; a < count; a++) {
+		const BuildTriangle& triangle = m_buildTriangles[m_triangles[first + a]];
+		for (unsigned int b = 0; b < 3; b++) {
+			node->min[b] = a == 0 ? triangle.min[b] : std::min(node->min[b], triangle.min[b]);
+			node->max[b] = a == 0 ? triangle.max[b] : std::max(node->max[b], triangle.max[b]);
+			centreMin[b] = a == 0 ? triangle.centre[b] : std::min(centreMin[b], triangle.centre[b]);
+			centreMax[b] = a == 0 ? triangle.centre[b] : std::max(centreMax[b], triangle.centre[b]);
+		}
+	}
+	if (count <= MIN_LEAF_TRIANGLES)
+		return node;
+
+	//Find the split between bins along any axis with the lowest surface area cost
+	struct Bin {
+		float min[3];
+		float max[3];
+		unsigned int count;
+	};
+	float bestCost = std::numeric_limits<float>::max();
+	unsigned int bestAxis = 0;
+	unsigned int bestSplit = 0;
+	for (unsigned int axis = 0; axis < 3 && depth < MAX_DEPTH; axis++) {
+		float extent = centreMax[axis] - centreMin[axis];
+		if (extent <= 0)
+			continue;
+		float scale = NUM_BINS / extent;
+
+		Bin bins[NUM_BINS];
+		for (unsigned int a = 0; a < NUM_BINS; a++)
+			bins[a].count = 0;
+		for (unsigned int a = 0; a < count; a++) {
+			const BuildTriangle& triangle = m_buildTriangles[m_triangles[first + a]];
+			Bin& bin = bins[std::min(NUM_BINS - 1, (unsigned int) ((triangle.centre[axis] - centreMin[axis]) * scale))];
+			for (unsigned int b = 0; b < 3; b++) {
+				bin.min[b] = bin.count == 0 ? triangle.min[b] : std::min(bin.min[b], triangle.min[b]);
+				bin.max[b] = bin.count == 0 ? triangle.max[b] : std::max(bin.max[b], triangle.max[b]);
+			}
+			bin.count++;
+		}
+
+		//The area and number of triangles after each split, found from the right then the left
+		float rightArea[NUM_BINS];
+		unsigned int rightCount[NUM_BINS];
+		Bin total;
+		total.count = 0;
+		for (unsigned int a = NUM_BINS - 1; a > 0; a--) {
+			if (bins[a].count > 0) {
+				for (unsigned int b = 0; b < 3; b++) {
+					total.min[b] = total.count == 0 ? bins[a].min[b] : std::min(total.min[b], bins[a].min[b]);
+					total.max[b] = total.count == 0 ? bins[a].max[b] : std::max(total.max[b], bins[a].max[b]);
+				}
+				total.count += bins[a].count;
+			}
+			rightCount[a] = total.count;
+			rightArea[a] = total.count > 0 ? getArea(total.min, total.max) : 0;
+		}
+		total.count = 0;
+		for (unsigned int a = 0; a < NUM_BINS - 1; a++) {
+			if (bins[a].count > 0) {
+				for (unsigned int b = 0; b < 3; b++) {
+					total.min[b] = total.count == 0 ? bins[a].min[b] : std::min(total.min[b], bins[a].min[b]);
+					total.max[b] = total.count == 0 ? bins[a].max[b] : std::max(total.max[b], bins[a].max[b]);
+				}
+				total.count += bins[a].count;
+			}
+			if (total.count == 0 || rightCount[a + 1] == 0)
+				continue;
+			float cost = getArea(total.min, total.max) * total.count + rightArea[a + 1] * rightCount[a + 1];
+			if (cost < bestCost) {
+				bestCost = cost;
+				bestAxis = axis;
+				bestSplit = a + 1;
+			}
+		}
+	}
+
+	unsigned int leftCount;
+	if (bestSplit > 0) {
+		//Small branches are left as leaves when splitting them wouldn't make them cheaper to test,
+		//with testing the children costing about as much as testing a triangle
+		float area = getArea(node->min, node->max);
+		if (count <= MAX_LEAF_TRIANGLES && bestCost + area >= area * count)
+			return node;
+		BinPredicate predicate;
+		predicate.triangles = &m_buildTriangles;
+		predicate.axis = bestAxis;
+		predicate.min = centreMin[bestAxis];
+		predicate.scale = NUM_BINS / (centreMax[bestAxis] - centreMin[bestAxis]);
+		predicate.split = bestSplit;
+		leftCount = std::partition(m_triangles.begin() + first, m_triangles.begin() + first + count, predicate) - (m_triangles.begin() + first);
+	} else {
+		//The centres are all in the same place or the tree is too deep, so split the triangles in
+		//half along the longest axis
+		if (count <= MAX_LEAF_TRIANGLES)
+			return node;
+		CentreOrder order;
+		order.triangles = &m_buildTriangles;
+		order.axis = 0;
+		for (unsigned int a = 1; a < 3; a++) {
+			if (node->max[a] - node->min[a] > node->max[order.axis] - node->min[order.axis])
+				order.axis = a;
+		}
+		leftCount = count / 2;
+		std::nth_element(m_triangles.begin() + first, m_triangles.begin() + first + leftCount, m_triangles.begin() + first + count, order);
+	}
+
+	//Each branch only changes its own range of the triangles, so large ones can be built at the
+	//same time
+	if (depth < m_parallelDepth && count >= PARALLEL_TRIANGLES) {
+		std::thread thread(buildWorker, this, &node->children[0], first, leftCount, depth + 1);
+		node->children[1] = build(first + leftCount, count - leftCount, depth + 1);
+		thread.join();
+	} else {
+		node->children[0] = build(first, leftCount, depth + 1);
+		node->children[1] = build(first + leftCount, count - leftCount, depth + 1);
+	}
+	return node;
+}
+
+void TriangleBVH::buildWorker(TriangleBVH* bvh, BuildNode** node, unsigned int first, unsigned int count, unsigned int depth) {
+	*node = bvh->build(first, count, depth);
+}
+
+unsigned short TriangleBVH::quantise(float value, unsigned int axis, bool roundUp) {
+	if (m_scale[axis] <= 0)
+		return 0;
+	float step = (value - m_origin[axis]) / m_scale[axis];
+	//One more step is added so rounding errors can't make the bounds smaller
+	step = roundUp ? ceil(step) + 1 : floor(step) - 1;
+	return (unsigned short) std::max(0.0f, std::min(65535.0f, step));
+}
+
+unsigned int TriangleBVH::flatten(BuildNode* node) {
+	//The node added may move when the children are added, so it is only used by its index
+	unsigned int index = m_nodes.size();
+	m_nodes.push_back(Node());
+	for (unsigned int a = 0; a < 3; a++) {
+		m_nodes[index].min[a] = quantise(node->min[a], a, false);
+		m_nodes[index].max[a] = quantise(node->max[a], a, true);
+	}
+	if (node->children[0] == NULL) {
+		m_nodes[index].offset = node->first;
+		m_nodes[index].count = node->count;
+	} else {
+		flatten(node->children[0]);
+		unsigned int right = flatten(node->children[1]);
+		m_nodes[index].offset = right;
+		m_nodes[index].count = 0;
+	}
+	delete node;
+	return index;
+}
+
+bool TriangleBVH::intersectNode(const Node& node, const float scale[3], const float offset[3], float maxDistance, float& distance) {
+	float near = 0;
+	float far = maxDistance;
+	for (unsigned int a = 0; a < 3; a++) {
+		float t1 = node.min[a] * scale[a] + offset[a];
+		float t2 = node.max[a] * scale[a] + offset[a];
+		near = std::max(near, std::min(t1, t2));
+		far = std::min(far, std::max(t1, t2));
+	}
+	distance = near;
+	return near <= far;
+}
+
+bool TriangleBVH::intersect(Vector3f origin, Vector3f direction, float maxDistance, RayHit& hit) {
+	if (m_nodes.empty())
+		return false;
+
+	//The distance to the quantised bounds along each axis is the step times the scale plus the
+	//offset. Directions of zero use a large value instead of infinity, so it is never multiplied
+	//by zero
+	float scale[3];
+	float offset[3];
+	for (unsigned int a = 0; a < 3; a++) {
+		float inverse = direction[a] != 0 ? 1.0f / direction[a] : 1e30f;
+		scale[a] = m_scale[a] * inverse;
+		offset[a] = (m_origin[a] - origin[a]) * inverse;
+	}
+
+	struct Entry {
+		unsigned int node;
+		float distance;
+	};
+	Entry stack[STACK_SIZE];
+	unsigned int size = 0;
+	float closest = maxDistance;
+	bool found = false;
+
+	float distance;
+	if (! intersectNode(m_nodes[0], scale, offset, closest, distance))
+		return false;
+	stack[size].node = 0;
+	stack[size].distance = distance;
+	size++;
+
+	while (size > 0) {
+		size--;
+		//Anything hit since this was added may be closer than the node
+		if (stack[size].distance > closest)
+			continue;
+		unsigned int index = stack[size].node;
+		while (true) {
+			const Node& node = m_nodes[index];
+			if (node.count > 0) {
+				for (unsigned int a = node.offset; a < node.offset + node.count; a++) {
+					//Intersect the triangle by solving for the distance and barycentric coordinates
+					const float* v = &m_vertices[a * 9];
+					const float* e1 = v + 3;
+					const float* e2 = v + 6;
+					float p[3] = { direction[1] * e2[2] - direction[2] * e2[1], direction[2] * e2[0] - direction[0] * e2[2], direction[0] * e2[1] - direction[1] * e2[0] };
+					float determinant = e1[0] * p[0] + e1[1] * p[1] + e1[2] * p[2];
+					if (determinant == 0)
+						continue;
+					float inverse = 1.0f / determinant;
+					float t[3] = { origin[0] - v[0], origin[1] - v[1], origin[2] - v[2] };
+					float u = (t[0] * p[0] + t[1] * p[1] + t[2] * p[2]) * inverse;
+					if (u < 0 || u > 1)
+						continue;
+					float q[3] = { t[1] * e1[2] - t[2] * e1[1], t[2] * e1[0] - t[0] * e1[2], t[0] * e1[1] - t[1] * e1[0] };
+					float w = (direction[0] * q[0] + direction[1] * q[1] + direction[2] * q[2]) * inverse;
+					if (w < 0 || u + w > 1)
+						continue;
+					float d = (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]) * inverse;
+					if (d < 0 || d >= closest)
+						continue;
+					closest = d;
+					hit.triangle = m_triangles[a];
+					hit.distance = d;
+					hit.u = u;
+					hit.v = w;
+					found = true;
+				}
+				break;
+			}
+
+			//Go into the closer child first, leaving the other for later
+			float leftDistance;
+			float rightDistance;
+			unsigned int left = index + 1;
+			unsigned int right = node.offset;
+			bool hitLeft = intersectNode(m_nodes[left], scale, offset, closest, leftDistance);
+			bool hitRight = intersectNode(m_nodes[right], scale, offset, closest, rightDistance);
+			if (hitLeft && hitRight) {
+				stack[size].node = leftDistance <= rightDistance ? right : left;
+				stack[size].distance = leftDistance <= rightDistance ? rightDistance : leftDistance;
+				size++;
+				index = leftDistance <= rightDistance ? left : right;
+			} else if (hitLeft)
+				index = left;
+			else if (hitRight)
+				index = right;
+			else
+				break;
+		}
+	}
+	return found;
+}
+
+/***************************************************************************************************/
@@ -0,0 +1,176 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef CORE_RENDER_TRIANGLEBVH_H_
+#define CORE_RENDER_TRIANGLEBVH_H_
+
+#include <vector>
+
+#include "../Vector.h"
+
+class MeshData;
+class RenderableObject3D;
+
+/***************************************************************************************************
+ * The RayHit structure stores the closest triangle a ray hit
+ ***************************************************************************************************/
+
+struct RayHit {
+	/* The object hit, and the object the triangle came from when it was made by merging others */
+	RenderableObject3D* object;
+	RenderableObject3D* source;
+
+	/* The mesh of the object and the triangle within it */
+	unsigned int mesh;
+	unsigned int triangle;
+
+	/* The distance along the ray in multiples of its direction, and the barycentric coordinates
+	 * of the point hit, which are the weights of the triangle's second and third vertices */
+	float distance;
+	float u;
+	float v;
+};
+
+/***************************************************************************************************/
+
+/***************************************************************************************************
+ * The TriangleBVH class stores the triangles of a mesh in a bounding volume hierarchy so rays can
+ * be tested against only the few triangles near them. It is built by splitting the triangles into
+ * bins along each axis and choosing the split with the lowest surface area cost, with the larger
+ * branches built on separate threads. The nodes are stored in a single array with each one's bounds
+ * quantised to 16 bits within the bounds of the mesh, and a copy of the vertices of each triangle is
+ * kept in the order of the leaves. It doesn't need an OpenGL context
+ ***************************************************************************************************/
+
+class TriangleBVH {
+private:
+	/* The number of bins the triangles are split into along each axis when building */
+	static const unsigned int NUM_BINS = 12;
+
+	/* Leaves with at most this many triangles aren't split, and ones with more are split when
+	 * that is cheaper */
+	static const unsigned int MIN_LEAF_TRIANGLES = 2;
+	static const unsigned int MAX_LEAF_TRIANGLES = 16;
+
+	/* Below this depth branches are split in half by the number of triangles, which keeps the
+	 * tree shallow enough for the stack used when tracing rays */
+	static const unsigned int MAX_DEPTH = 64;
+	static const unsigned int STACK_SIZE = 96;
+
+	/* Branches with at least this many triangles are built on another thread */
+	static const unsigned int PARALLEL_TRIANGLES = 4096;
+
+	/* A node in the array, the left child of a branch is the one after it and the offset is the
+	 * right child. Leaves have the offset of their first triangle and the number of them */
+	struct Node {
+		unsigned short min[3];
+		unsigned short max[3];
+		unsigned int offset;
+		unsigned int count;
+	};
+
+	/* A node of the tree while it is being built */
+	struct BuildNode {
+		float min[3];
+		float max[3];
+		BuildNode* children[2];
+		unsigned int first;
+		unsigned int count;
+	};
+
+	/* The bounds and centre of a triangle while it is being built */
+	struct BuildTriangle {
+		float min[3];
+		float max[3];
+		float centre[3];
+	};
+
+	/* Orders triangles by their centre along an axis */
+	struct CentreOrder {
+		const std::vector<BuildTriangle>* triangles;
+		unsigned int axis;
+
+		bool operator()(unsigned int a, unsigned int b) const;
+	};
+
+	/* States whether a triangle's centre is in one of the bins before a split */
+	struct BinPredicate {
+		const std::vector<BuildTriangle>* triangles;
+		unsigned int axis;
+		float min;
+		float scale;
+		unsigned int split;
+
+		bool operator()(unsigned int triangle) const;
+	};
+
+	/* The point the quantised bounds are relative to and the size of each step */
+	float m_origin[3];
+	float m_scale[3];
+
+	std::vector<Node> m_nodes;
+
+	/* The original index of each triangle in the order of the leaves, along with the first
+	 * vertex and the two edges from it */
+	std::vector<unsigned int> m_triangles;
+	std::vector<float> m_vertices;
+
+	/* Used while building */
+	std::vector<BuildTriangle> m_buildTriangles;
+	unsigned int m_parallelDepth;
+
+	/* Builds the branch for a range of the triangles */
+	BuildNode* build(unsigned int first, unsigned int count, unsigned int depth);
+
+	/* Builds a branch on another thread */
+	static void buildWorker(TriangleBVH* bvh, BuildNode** node, unsigned int first, unsigned int count, unsigned int depth);
+
+	/* Adds the nodes of a branch to the array, returning the index of the first */
+	unsigned int flatten(BuildNode* node);
+
+	/* Returns the surface area of a box, used as the cost of testing a node */
+	static float getArea(const float min[3], const float max[3]);
+
+	/* Returns the step a value is at along an axis of the mesh's bounds, rounded down for the
+	 * minimum of a node or up for the maximum so the bounds never get smaller */
+	unsigned short quantise(float value, unsigned int axis, bool roundUp);
+
+	/* Returns whether a ray hits a node closer than a distance, along with the distance it
+	 * enters it. The ray is given as the scale and offset applied to the quantised bounds to find
+	 * the distance to them along each axis */
+	static bool intersectNode(const Node& node, const float scale[3], const float offset[3], float maxDistance, float& distance);
+public:
+	/* Builds the hierarchy for the triangles of a mesh, which needs its positions */
+	TriangleBVH(MeshData* data);
+	virtual ~TriangleBVH() {}
+
+	/* Finds the closest triangle hit by a ray within a distance given in multiples of its
+	 * direction, which doesn't have to be normalised. Returns false when nothing closer is hit,
+	 * otherwise sets the triangle, distance and barycentric coordinates of the hit */
+	bool intersect(Vector3f origin, Vector3f direction, float maxDistance, RayHit& hit);
+
+	inline unsigned int getNumNodes() { return m_nodes.size(); }
+	inline unsigned int getNumTriangles() { return m_triangles.size(); }
+
+	/* Returns the number of bytes used by the nodes and triangles */
+	inline unsigned int getMemoryUsage() { return m_nodes.size() * sizeof(Node) + m_triangles.size() * sizeof(unsigned int) + m_vertices.size() * sizeof(float); }
+};
+
+/***************************************************************************************************/
+
+#endif /* CORE_RENDER_TRIANGLEBVH_H_ */
@@ -0,0 +1,157 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <algorithm>
+
+#include "ShaderManager.h"
+#include "UberShader.h"
+
+/***************************************************************************************************
+ * The UberShader class
+ ***************************************************************************************************/
+
+const char* UberShader::FEATURE_DEFINES[UberShader::NUM_FEATURES] = {
+	"AMBIENT_LIGHT",
+	"DIRECTIONAL_LIGHT",
+	"POINT_LIGHT",
+	"SPOT_LIGHT",
+	"TEXTURE",
+	"NORMALS",
+	"INSTANCING",
+	"SHADOWS",
+	"MULTI_DRAW"
+};
+
+UberShader::UberShader(const char* path, const char* name) {
+	std::string p = std::string(name);
+	m_vertexSource = Shader::loadShaderData(path, (p + ".vs").c_str());
+	m_fragmentSource = Shader::loadShaderData(path, (p + ".fs").c_str());
+}
+
+UberShader::~UberShader() {
+	for (std::map<unsigned int, Shader*>::iterator it = m_permutations.begin(); it != m_permutations.end(); it++)
+		delete it->second;
+}
+
+void UberShader::prewarm(unsigned int key) {
+	if (hasPermutation(key))
+		return;
+	if (! isValidKey(key)) {
+		logError("Invalid shader permutation " + to_string(key) + ", only one type of light can be used");
+		return;
+	}
+
+	std::vector<std::string> defines = getDefines(key);
+	std::string vertexSource = getHeader(key, GL_VERTEX_SHADER) + preprocess(m_vertexSource, defines);
+	std::string fragmentSource = getHeader(key, GL_FRAGMENT_SHADER) + preprocess(m_fragmentSource, defines);
+	m_permutations.insert(std::pair<unsigned int, Shader*>(key, ShaderManager::loadShaderFromSource(vertexSource, fragmentSource)));
+	m_pending.push_back(key);
+}
+
+Shader* UberShader::getShader(unsigned int key) {
+	prewarm(key);
+	if (! hasPermutation(key))
+		return NULL;
+
+	//Wait for every permutation that is still compiling at once, rather than one at a time
+	if (std::find(m_pending.begin(), m_pending.end(), key) != m_pending.end()) {
+		ShaderManager::finish();
+		for (unsigned int a = 0; a < m_pending.size(); a++)
+			setupPermutation(m_permutations.at(m_pending[a]));
+		m_pending.clear();
+	}
+	return m_permutations.at(key);
+}
+
+void UberShader::setupPermutation(Shader* shader) {
+	shader->reflect();
+	for (unsigned int a = 0; a < m_uniformAliases.size(); a++) {
+		if (shader->hasUniform(m_uniformAliases[a].second))
+			shader->addUniform(m_uniformAliases[a].first, m_uniformAliases[a].second);
+	}
+	for (unsigned int a = 0; a < m_attributeAliases.size(); a++) {
+		if (shader->hasAttribute(m_attributeAliases[a].second))
+			shader->addAttribute(m_attributeAliases[a].first, m_attributeAliases[a].second);
+	}
+}
+
+std::vector<std::string> UberShader::getDefines(unsigned int key) {
+	std::vector<std::string> defines;
+	for (unsigned int a = 0; a < NUM_FEATURES; a++) {
+		if (key & (1 << a))
+			defines.push_back(FEATURE_DEFINES[a]);
+	}
+	return defines;
+}
+
+std::string UberShader::getHeader(unsigned int key, GLenum type) {
+	//Multi draws read their data from a storage buffer using the base instance of each draw
+	if (key & SHADER_FEATURE_MULTI_DRAW) {
+		if (type == GL_VERTEX_SHADER)
+			return "#version 430 compatibility\n#extension GL_ARB_shader_draw_parameters : require\n";
+		return "#version 430 compatibility\n";
+	}
+	return "";
+}
+
+bool UberShader::isValidKey(unsigned int key) {
+	unsigned int lights = key & (SHADER_FEATURE_AMBIENT_LIGHT | SHADER_FEATURE_DIRECTIONAL_LIGHT | SHADER_FEATURE_POINT_LIGHT | SHADER_FEATURE_SPOT_LIGHT);
+	//Unknown features or more than one bit set for the lights are invalid
+	return (key >> NUM_FEATURES) == 0 && (lights & (lights - 1)) == 0;
+}
+
+std::string UberShader::preprocess(std::string source, std::vector<std::string> defines) {
+	std::stringstream input(source);
+	std::string output;
+	std::string current;
+
+	//The conditions of the blocks the current line is in, and whether each block is being output
+	std::vector<bool> conditions;
+	std::vector<bool> active;
+
+	while (std::getline(input, current)) {
+		if (Shader::isConditionalDirective(current)) {
+			std::stringstream ss(current);
+			std::string directive;
+			std::string name;
+			ss >> directive >> name;
+
+			bool parentActive = active.size() == 0 || active.back();
+			if (directive == "#ifdef" || directive == "#ifndef") {
+				bool defined = std::find(defines.begin(), defines.end(), name) != defines.end();
+				conditions.push_back(directive == "#ifdef" ? defined : ! defined);
+				active.push_back(parentActive && conditions.back());
+			} else if (conditions.size() == 0) {
+				logError("Unexpected '" + directive + "' in shader source");
+			} else if (directive == "#else") {
+				conditions.back() = ! conditions.back();
+				active.back() = (active.size() == 1 || active[active.size() - 2]) && conditions.back();
+			} else {
+				conditions.pop_back();
+				active.pop_back();
+			}
+		} else if (active.size() == 0 || active.back())
+			output.append(current + "\n");
+	}
+	if (conditions.size() > 0)
+		logError("Missing '#endif' in shader source");
+
+	return output;
+}
+
+/***************************************************************************************************/
@@ -0,0 +1,106 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef CORE_RENDER_UBERSHADER_H_
+#define CORE_RENDER_UBERSHADER_H_
+
+#include "Shader.h"
+
+/***************************************************************************************************
+ * The ShaderFeature enum lists the features an UberShader can be compiled with, a permutation is
+ * keyed by the bitmask of the features it uses
+ ***************************************************************************************************/
+
+enum ShaderFeature {
+	SHADER_FEATURE_AMBIENT_LIGHT     = 1 << 0,
+	SHADER_FEATURE_DIRECTIONAL_LIGHT = 1 << 1,
+	SHADER_FEATURE_POINT_LIGHT       = 1 << 2,
+	SHADER_FEATURE_SPOT_LIGHT        = 1 << 3,
+	SHADER_FEATURE_TEXTURE           = 1 << 4,
+	SHADER_FEATURE_NORMALS           = 1 << 5,
+	SHADER_FEATURE_INSTANCING        = 1 << 6,
+	SHADER_FEATURE_SHADOWS           = 1 << 7,
+	SHADER_FEATURE_MULTI_DRAW        = 1 << 8
+};
+
+/***************************************************************************************************/
+
+/***************************************************************************************************
+ * The UberShader class compiles permutations of a single shader source, each one having the
+ * defines for its features set. Permutations are compiled when they are first requested, or can be
+ * prewarmed so that they are compiled together, and their uniforms and attributes are found using
+ * reflection
+ ***************************************************************************************************/
+
+class UberShader {
+private:
+	/* The sources of the shader before any of the defines have been applied */
+	std::string m_vertexSource;
+	std::string m_fragmentSource;
+
+	/* The compiled permutations, keyed by the bitmask of their features */
+	std::map<unsigned int, Shader*> m_permutations;
+
+	/* The permutations that have been submitted but have not been set up yet */
+	std::vector<unsigned int> m_pending;
+
+	/* The names the engine uses for uniforms and attributes, and the names they are given in the
+	 * shader, added to every permutation */
+	std::vector<std::pair<std::string, std::string>> m_uniformAliases;
+	std::vector<std::pair<std::string, std::string>> m_attributeAliases;
+
+	void setupPermutation(Shader* shader);
+public:
+	/* The names of the defines for each feature, in the order of their bits */
+	static const unsigned int NUM_FEATURES = 9;
+	static const char* FEATURE_DEFINES[NUM_FEATURES];
+
+	UberShader(const char* path, const char* name);
+	virtual ~UberShader();
+
+	/* Starts compiling a permutation without waiting for it to finish, nothing is compiled for an
+	 * invalid key */
+	void prewarm(unsigned int key);
+
+	/* Returns a permutation, compiling it if it has not been prewarmed. Returns NULL for an
+	 * invalid key */
+	Shader* getShader(unsigned int key);
+
+	inline void addUniformAlias(std::string id, std::string name) { m_uniformAliases.push_back(std::pair<std::string, std::string>(id, name)); }
+	inline void addAttributeAlias(std::string id, std::string name) { m_attributeAliases.push_back(std::pair<std::string, std::string>(id, name)); }
+	inline bool hasPermutation(unsigned int key) { return m_permutations.count(key) > 0; }
+	inline unsigned int getNumPermutations() { return m_permutations.size(); }
+
+	/* Returns the defines that should be set for a key */
+	static std::vector<std::string> getDefines(unsigned int key);
+
+	/* Returns the lines that have to come before anything else in a permutation's source, for
+	 * features that need a newer version of GLSL */
+	static std::string getHeader(unsigned int key, GLenum type);
+
+	/* Returns whether a key is valid, at most one type of light can be used at once */
+	static bool isValidKey(unsigned int key);
+
+	/* Applies defines to a source, resolving #ifdef, #ifndef, #else and #endif directives and
+	 * removing them from the output */
+	static std::string preprocess(std::string source, std::vector<std::string> defines);
+};
+
+/***************************************************************************************************/
+
+#endif /* CORE_RENDER_UBERSHADER_H_ */
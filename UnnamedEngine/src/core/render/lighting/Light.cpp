@@ -23,14 +23,9 @@
  * The BaseLight class
  ***************************************************************************************************/
 
-void BaseLight::addUniforms(Shader* shader, std::string prefix, std::string location) {
-	shader->addUniform(prefix + "BaseLight_Colour", location + "colour");
-	shader->addUniform(prefix + "BaseLight_Intensity", location + "intensity");
-}
-
-void BaseLight::setUniforms(Shader* shader, std::string prefix) {
-	shader->setUniform(prefix + "BaseLight_Colour", Vector3f(m_colour.getR(), m_colour.getG(), m_colour.getB()));
-	shader->setUniform(prefix + "BaseLight_Intensity", m_intensity);
+void BaseLight::setUniforms(Shader* shader, std::string location) {
+	shader->setUniform(location + "colour", Vector3f(m_colour.getR(), m_colour.getG(), m_colour.getB()));
+	shader->setUniform(location + "intensity", m_intensity);
 }
 
 /***************************************************************************************************/
@@ -39,23 +34,24 @@ void BaseLight::setUniforms(Shader* shader, std::string prefix) {
  * The DirectionalLight class
  ***************************************************************************************************/
 
-void DirectionalLight::addUniforms(Shader* shader, std::string prefix, std::string location) {
-	shader->addUniform(prefix + "DirectionalLight_Direction", location + "direction");
+void DirectionalLight::setUniforms(Shader* shader, std::string location) {
+	shader->setUniform(location + "direction", m_direction);
 
-	BaseLight::addUniforms(shader, prefix + "DirectionalLight_", location + "base.");
+	m_baseLight->setUniforms(shader, location + "base.");
 }
 
-void DirectionalLight::setUniforms(Shader* shader, std::string prefix) {
-	shader->setUniform(prefix + "DirectionalLight_Direction", m_direction);
-
-	m_baseLight->setUniforms(shader, prefix + "DirectionalLight_");
+void DirectionalLight::apply() {
+	apply(Renderer::getShader(SHADER_TYPE_DIRECTIONAL_LIGHT));
 }
 
-void DirectionalLight::apply() {
-	Shader* shader = Renderer::getShader("DirectionalLight");
+void DirectionalLight::apply(Shader* shader) {
 	shader->use();
 	Renderer::setShader(shader);
-	setUniforms(shader, "");
+	setUniforms(shader, "directionalLight.");
+}
+
+unsigned int DirectionalLight::getShaderFeature() {
+	return SHADER_FEATURE_DIRECTIONAL_LIGHT;
 }
 
 /***************************************************************************************************/
@@ -64,16 +60,10 @@ void DirectionalLight::apply() {
  * The Attenuation class
  ***************************************************************************************************/
 
-void Attenuation::addUniforms(Shader* shader, std::string prefix, std::string location) {
-	shader->addUniform(prefix + "Attenuation_Constant", location + "constant");
-	shader->addUniform(prefix + "Attenuation_Linear", location + "linear");
-	shader->addUniform(prefix + "Attenuation_Exponent", location + "exponent");
-}
-
-void Attenuation::setUniforms(Shader* shader, std::string prefix) {
-	shader->setUniform(prefix + "Attenuation_Constant", m_constant);
-	shader->setUniform(prefix + "Attenuation_Linear", m_linear);
-	shader->setUniform(prefix + "Attenuation_Exponent", m_exponent);
+void Attenuation::setUniforms(Shader* shader, std::string location) {
+	shader->setUniform(location + "constant", m_constant);
+	shader->setUniform(location + "linear", m_linear);
+	shader->setUniform(location + "exponent", m_exponent);
 }
 
 /***************************************************************************************************/
@@ -82,27 +72,26 @@ void Attenuation::setUniforms(Shader* shader, std::string prefix) {
  * The PointLight class
  ***************************************************************************************************/
 
-void PointLight::addUniforms(Shader* shader, std::string prefix, std::string location) {
-	shader->addUniform(prefix + "PointLight_Position", location + "position");
-	shader->addUniform(prefix + "PointLight_Range", location + "range");
+void PointLight::setUniforms(Shader* shader, std::string location) {
+	shader->setUniform(location + "position", m_position);
+	shader->setUniform(location + "range", m_range);
 
-	BaseLight::addUniforms(shader, prefix + "PointLight_", location + "base.");
-	Attenuation::addUniforms(shader, prefix + "PointLight_", location + "attenuation.");
+	m_baseLight->setUniforms(shader, location + "base.");
+	m_attenuation.setUniforms(shader, location + "attenuation.");
 }
 
-void PointLight::setUniforms(Shader* shader, std::string prefix) {
-	shader->setUniform(prefix + "PointLight_Position", m_position);
-	shader->setUniform(prefix + "PointLight_Range", m_range);
-
-	m_baseLight->setUniforms(shader, prefix + "PointLight_");
-	m_attenuation.setUniforms(shader, prefix + "PointLight_");
+void PointLight::apply() {
+	apply(Renderer::getShader(SHADER_TYPE_POINT_LIGHT));
 }
 
-void PointLight::apply() {
-	Shader* shader = Renderer::getShader("PointLight");
+void PointLight::apply(Shader* shader) {
 	shader->use();
 	Renderer::setShader(shader);
-	setUniforms(shader, "");
+	setUniforms(shader, "pointLight.");
+}
+
+unsigned int PointLight::getShaderFeature() {
+	return SHADER_FEATURE_POINT_LIGHT;
 }
 
 /***************************************************************************************************/
@@ -111,25 +100,25 @@ void PointLight::apply() {
  * The SpotLight class
  ***************************************************************************************************/
 
-void SpotLight::addUniforms(Shader* shader, std::string prefix, std::string location) {
-	shader->addUniform(prefix + "SpotLight_Direction", location + "direction");
-	shader->addUniform(prefix + "SpotLight_Cutoff", location + "cutoff");
+void SpotLight::setUniforms(Shader* shader, std::string location) {
+	shader->setUniform(location + "direction", m_direction);
+	shader->setUniform(location + "cutoff", m_cutoff);
 
-	PointLight::addUniforms(shader, prefix + "SpotLight_", location + "pointLight.");
+	m_pointLight->setUniforms(shader, location + "pointLight.");
 }
 
-void SpotLight::setUniforms(Shader* shader, std::string prefix) {
-	shader->setUniform(prefix + "SpotLight_Direction", m_direction);
-	shader->setUniform(prefix + "SpotLight_Cutoff", m_cutoff);
-
-	m_pointLight->setUniforms(shader, prefix + "SpotLight_");
+void SpotLight::apply() {
+	apply(Renderer::getShader(SHADER_TYPE_SPOT_LIGHT));
 }
 
-void SpotLight::apply() {
-	Shader* shader = Renderer::getShader("SpotLight");
+void SpotLight::apply(Shader* shader) {
 	shader->use();
 	Renderer::setShader(shader);
-	setUniforms(shader, "");
+	setUniforms(shader, "spotLight.");
+}
+
+unsigned int SpotLight::getShaderFeature() {
+	return SHADER_FEATURE_SPOT_LIGHT;
 }
 
 /***************************************************************************************************/
@@ -38,9 +38,7 @@ public:
 	inline Colour getColour() { return m_colour; }
 	inline float getIntensity() { return m_intensity; }
 
-	void setUniforms(Shader* shader, std::string prefix);
-
-	static void addUniforms(Shader* shader, std::string prefix, std::string location);
+	void setUniforms(Shader* shader, std::string location);
 };
 
 /***************************************************************************************************/
@@ -54,6 +52,17 @@ public:
 	virtual ~LightSource() {}
 
 	virtual void apply() {}
+
+	/* Uses a shader for the light and sets its uniforms, for shaders that aren't the default one
+	 * for the type of light */
+	virtual void apply(Shader* shader) {}
+
+	/* Returns the feature of the lighting UberShader used for the light, or 0 if it doesn't use it */
+	virtual unsigned int getShaderFeature() { return 0; }
+
+	/* Gets the sphere in world space outside of which the light has no effect, returning false if
+	 * it lights everything */
+	virtual bool getBounds(Vector3f& centre, float& radius) { return false; }
 };
 
 /***************************************************************************************************/
@@ -80,11 +89,11 @@ public:
 	inline BaseLight* getBaseLight() { return m_baseLight; }
 	inline Vector3f getDirection() { return m_direction; }
 
-	void setUniforms(Shader* shader, std::string prefix);
+	void setUniforms(Shader* shader, std::string location);
 
 	void apply();
-
-	static void addUniforms(Shader* shader, std::string prefix, std::string location);
+	void apply(Shader* shader);
+	unsigned int getShaderFeature();
 };
 
 /***************************************************************************************************/
@@ -112,9 +121,7 @@ public:
 	inline float getLinear()   { return m_linear; }
 	inline float getExponent() { return m_exponent; }
 
-	void setUniforms(Shader* shader, std::string prefix);
-
-	static void addUniforms(Shader* shader, std::string prefix, std::string location);
+	void setUniforms(Shader* shader, std::string location);
 };
 
 /***************************************************************************************************/
@@ -157,11 +164,12 @@ public:
 	inline Vector3f getPosition() { return m_position; }
 	inline float getRange() { return m_range; }
 
-	void setUniforms(Shader* shader, std::string prefix);
+	void setUniforms(Shader* shader, std::string location);
 
 	void apply();
-
-	static void addUniforms(Shader* shader, std::string prefix, std::string location);
+	void apply(Shader* shader);
+	unsigned int getShaderFeature();
+	inline bool getBounds(Vector3f& centre, float& radius) { centre = m_position; radius = m_range; return true; }
 };
 
 /***************************************************************************************************/
@@ -193,11 +201,12 @@ public:
 	inline Vector3f getDirection() { return m_direction; }
 	inline float getCutoff() { return m_cutoff; }
 
-	void setUniforms(Shader* shader, std::string prefix);
+	void setUniforms(Shader* shader, std::string location);
 
 	void apply();
-
-	static void addUniforms(Shader* shader, std::string prefix, std::string location);
+	void apply(Shader* shader);
+	unsigned int getShaderFeature();
+	inline bool getBounds(Vector3f& centre, float& radius) { return m_pointLight->getBounds(centre, radius); }
 };
 
 /***************************************************************************************************/
@@ -46,22 +46,22 @@ FPSCalculator::FPSCalculator(unsigned int mode) {
 
 void FPSCalculator::update() {
 	if (! m_started) {
-		m_lastFrameTime = Time::getTimeMilliseconds();
-		m_lastDeltaFrameTime = Time::getTimeMilliseconds();
+		m_lastFrameTime = Time::getTimeNanoseconds();
+		m_lastDeltaFrameTime = m_lastFrameTime;
 		m_started = true;
 	}
 	if (m_mode != MODE_FPS_OFF) {
-		long current = Time::getTimeMilliseconds();
+		long long current = Time::getTimeNanoseconds();
 		if (m_mode == MODE_FPS_PER_FRAME) {
 			m_currentDeltaTime = current - m_lastDeltaFrameTime;
 			m_lastDeltaFrameTime = current;
 			if (m_currentDeltaTime != 0)
-				m_currentFPS = (int) (1000.0f / m_currentDeltaTime);
+				m_currentFPS = (int) (1000000000.0 / m_currentDeltaTime);
 		} else if (m_mode == MODE_FPS_PER_SECOND) {
 			m_currentDeltaTime = current - m_lastDeltaFrameTime;
 			m_lastDeltaFrameTime = current;
 			m_fpsCount ++;
-			if ((current - m_lastFrameTime) >= 1000) {
+			if ((current - m_lastFrameTime) >= 1000000000) {
 				m_lastFrameTime = current;
 				m_currentFPS = m_fpsCount;
 				m_fpsCount = 0;
@@ -26,9 +26,10 @@
 class FPSCalculator {
 private:
 	unsigned int m_mode;
-	long m_lastFrameTime;
-	long m_lastDeltaFrameTime;
-	long m_currentDeltaTime;
+	/* The times are all in nanoseconds */
+	long long m_lastFrameTime;
+	long long m_lastDeltaFrameTime;
+	long long m_currentDeltaTime;
 	int m_currentFPS;
 	int m_fpsCount;
 	bool m_started;
@@ -42,7 +43,10 @@ public:
 	void reset();
 	void setMode(unsigned int mode) { m_mode = mode; }
 	int getMode() { return m_mode; }
-	long getDelta() { return m_currentDeltaTime; }
+	/* Returns the time between the last two frames in milliseconds */
+	long getDelta() { return (long) (m_currentDeltaTime / 1000000); }
+	double getDeltaSeconds() { return m_currentDeltaTime / 1000000000.0; }
+	long long getDeltaNanoseconds() { return m_currentDeltaTime; }
 	int getFPS() { return m_currentFPS; }
 };
 
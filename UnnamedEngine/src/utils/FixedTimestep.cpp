@@ -0,0 +1,51 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include "FixedTimestep.h"
+
+/***************************************************************************************************
+ * The FixedTimestep class
+ ***************************************************************************************************/
+
+FixedTimestep::FixedTimestep(unsigned int rate, unsigned int maxSteps) {
+	setRate(rate);
+	m_maxSteps = maxSteps;
+	m_accumulator = 0;
+	m_totalSteps = 0;
+	m_numDropped = 0;
+}
+
+unsigned int FixedTimestep::advance(long long elapsed) {
+	if (elapsed > 0)
+		m_accumulator += elapsed;
+
+	unsigned int steps = (unsigned int) (m_accumulator / m_step);
+	if (steps > m_maxSteps) {
+		//Drop the time that can't be caught up on, but keep the fraction of a step so the
+		//interpolation stays smooth
+		steps = m_maxSteps;
+		m_accumulator = m_accumulator % m_step;
+		m_numDropped++;
+	} else
+		m_accumulator -= steps * m_step;
+
+	m_totalSteps += steps;
+	return steps;
+}
+
+/***************************************************************************************************/
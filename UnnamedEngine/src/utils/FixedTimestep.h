@@ -0,0 +1,71 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef UTILS_FIXEDTIMESTEP_H_
+#define UTILS_FIXEDTIMESTEP_H_
+
+/***************************************************************************************************
+ * The FixedTimestep class works out how many fixed size steps to simulate for the time that has
+ * passed, keeping the time left over for the next frame so the simulation runs at the same rate
+ * whatever the frame rate is
+ ***************************************************************************************************/
+
+class FixedTimestep {
+private:
+	/* The length of each step in nanoseconds */
+	long long m_step;
+
+	/* The most steps that can be taken at once, when more are needed the extra time is dropped
+	 * so a slow frame can't cause more and more steps to be needed */
+	unsigned int m_maxSteps;
+
+	/* The time that has passed but not been simulated yet */
+	long long m_accumulator;
+
+	/* The total number of steps taken, and the number of times time has been dropped */
+	unsigned long long m_totalSteps;
+	unsigned int m_numDropped;
+public:
+	FixedTimestep(unsigned int rate, unsigned int maxSteps);
+	virtual ~FixedTimestep() {}
+
+	/* Adds the time that has passed (in nanoseconds) and returns the number of steps to take */
+	unsigned int advance(long long elapsed);
+
+	inline void reset() { m_accumulator = 0; }
+
+	/* Sets the number of steps per second */
+	inline void setRate(unsigned int rate) { m_step = 1000000000LL / rate; }
+	inline void setMaxSteps(unsigned int maxSteps) { m_maxSteps = maxSteps; }
+
+	inline unsigned int getRate() { return (unsigned int) (1000000000LL / m_step); }
+	inline unsigned int getMaxSteps() { return m_maxSteps; }
+	inline long long getStepNanoseconds() { return m_step; }
+	inline double getStepSeconds() { return m_step / 1000000000.0; }
+
+	/* Returns how far between the last step and the next one the current time is, from 0 to 1,
+	 * used to interpolate what is rendered */
+	inline float getAlpha() { return (float) ((double) m_accumulator / (double) m_step); }
+
+	inline unsigned long long getTotalSteps() { return m_totalSteps; }
+	inline unsigned int getNumDropped() { return m_numDropped; }
+};
+
+/***************************************************************************************************/
+
+#endif /* UTILS_FIXEDTIMESTEP_H_ */
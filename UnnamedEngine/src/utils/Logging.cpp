@@ -0,0 +1,251 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <chrono>
+#include <mutex>
+#include <cstring>
+#include <algorithm>
+
+#include "Logging.h"
+
+/* The various values that determine which logs will be printed */
+bool LOGGER_DEBUG_ENABLED       = true;
+bool LOGGER_INFORMATION_ENABLED = true;
+bool LOGGER_WARNING_ENABLED     = true;
+bool LOGGER_ERROR_ENABLED       = true;
+
+/***************************************************************************************************
+ * The Logger class
+ ***************************************************************************************************/
+
+Logger::Record* Logger::m_records = NULL;
+unsigned int Logger::m_mask = 0;
+std::atomic<unsigned int> Logger::m_enqueuePosition(0);
+unsigned int Logger::m_dequeuePosition = 0;
+std::atomic<unsigned int> Logger::m_numDropped(0);
+
+std::thread Logger::m_thread;
+std::atomic<bool> Logger::m_running(false);
+
+bool Logger::m_consoleOutput = true;
+std::ofstream Logger::m_binaryOutput;
+
+int Logger::m_lastType = -1;
+std::string Logger::m_lastMessage;
+unsigned int Logger::m_repeats = 0;
+double Logger::m_repeatsTime = 0;
+
+/* Used to write logs before the background thread has been started */
+static std::mutex logger_outputMutex;
+
+void Logger::start(unsigned int capacity) {
+	if (m_running.load())
+		return;
+	//The queue is only ever created once as a thread may still be writing to it after stopping
+	if (m_records == NULL) {
+		unsigned int size = 2;
+		while (size < capacity)
+			size *= 2;
+		m_records = new Record[size];
+		m_mask = size - 1;
+		for (unsigned int a = 0; a < size; a++)
+			m_records[a].sequence.store(a, std::memory_order_relaxed);
+		m_enqueuePosition.store(0);
+		m_dequeuePosition = 0;
+	}
+	m_running.store(true);
+	m_thread = std::thread(run);
+}
+
+void Logger::stop() {
+	if (! m_running.load())
+		return;
+	m_running.store(false);
+	m_thread.join();
+	//Write anything that was added while the thread was stopping
+	std::lock_guard<std::mutex> lock(logger_outputMutex);
+	drain();
+	outputRepeats();
+	std::cout.flush();
+	if (m_binaryOutput.is_open())
+		m_binaryOutput.flush();
+}
+
+void Logger::write(int type, const std::string& message) {
+	if (! m_running.load(std::memory_order_relaxed)) {
+		std::lock_guard<std::mutex> lock(logger_outputMutex);
+		output(type, getTime(), message);
+		std::cout.flush();
+		return;
+	}
+
+	//Long messages take as many records as they need, up to the whole queue
+	const unsigned int partLength = sizeof(m_records[0].message);
+	const unsigned int capacity = m_mask + 1;
+	unsigned int length = message.length();
+	unsigned int parts = length == 0 ? 1 : (length + partLength - 1) / partLength;
+	bool truncated = parts > capacity;
+	if (truncated) {
+		parts = capacity;
+		length = capacity * partLength;
+	}
+
+	//Claim the records in the queue, if there isn't room the log is dropped rather than waiting.
+	//Records are released in order so the last one being free means all of them are
+	unsigned int position = m_enqueuePosition.load(std::memory_order_relaxed);
+	while (true) {
+		unsigned int sequence = m_records[(position + parts - 1) & m_mask].sequence.load(std::memory_order_acquire);
+		int difference = (int) (sequence - (position + parts - 1));
+		if (difference == 0) {
+			if (m_enqueuePosition.compare_exchange_weak(position, position + parts, std::memory_order_relaxed))
+				break;
+		} else if (difference < 0) {
+			m_numDropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		} else
+			position = m_enqueuePosition.load(std::memory_order_relaxed);
+	}
+
+	const char* text = message.c_str();
+	std::string shortened;
+	if (truncated) {
+		shortened = message.substr(0, length - strlen(LOGGER_TRUNCATED)) + LOGGER_TRUNCATED;
+		text = shortened.c_str();
+	}
+	//Hand the records to the background thread, the first one last so that the rest are ready
+	//by the time it is read
+	double time = getTime();
+	for (int a = parts - 1; a >= 0; a--) {
+		Record& record = m_records[(position + a) & m_mask];
+		record.type = type;
+		record.time = time;
+		record.parts = parts;
+		record.length = std::min(length - a * partLength, partLength);
+		memcpy(record.message, text + a * partLength, record.length);
+		record.sequence.store(position + a + 1, std::memory_order_release);
+	}
+}
+
+bool Logger::setBinaryOutput(std::string path) {
+	std::lock_guard<std::mutex> lock(logger_outputMutex);
+	if (m_binaryOutput.is_open())
+		m_binaryOutput.close();
+	m_binaryOutput.open(path.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+	if (! m_binaryOutput.is_open()) {
+		m_binaryOutput.clear();
+		return false;
+	}
+	return true;
+}
+
+void Logger::run() {
+	while (m_running.load()) {
+		{
+			std::lock_guard<std::mutex> lock(logger_outputMutex);
+			//Write out repeats of the same message at most once a second
+			if (drain() || m_repeats > 0) {
+				if (m_repeats > 0 && getTime() - m_repeatsTime >= 1.0)
+					outputRepeats();
+				std::cout.flush();
+				if (m_binaryOutput.is_open())
+					m_binaryOutput.flush();
+			}
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+}
+
+bool Logger::drain() {
+	if (m_records == NULL)
+		return false;
+	bool written = false;
+	std::string message;
+	while (true) {
+		Record& record = m_records[m_dequeuePosition & m_mask];
+		unsigned int sequence = record.sequence.load(std::memory_order_acquire);
+		if ((int) (sequence - (m_dequeuePosition + 1)) < 0)
+			break;
+		message.assign(record.message, record.length);
+		int type = record.type;
+		double time = record.time;
+		unsigned int parts = record.parts;
+		//Release the records for reuse before writing the log as the output may be slow
+		record.sequence.store(m_dequeuePosition + m_mask + 1, std::memory_order_release);
+		m_dequeuePosition++;
+		for (unsigned int a = 1; a < parts; a++) {
+			Record& part = m_records[m_dequeuePosition & m_mask];
+			message.append(part.message, part.length);
+			part.sequence.store(m_dequeuePosition + m_mask + 1, std::memory_order_release);
+			m_dequeuePosition++;
+		}
+
+		output(type, time, message);
+		written = true;
+	}
+	return written;
+}
+
+void Logger::output(int type, double time, const std::string& message) {
+	if (m_binaryOutput.is_open()) {
+		unsigned int length = message.length();
+		m_binaryOutput.write((const char*) &type, sizeof(type));
+		m_binaryOutput.write((const char*) &time, sizeof(time));
+		m_binaryOutput.write((const char*) &length, sizeof(length));
+		m_binaryOutput.write(message.c_str(), length);
+	}
+
+	if (! m_consoleOutput)
+		return;
+
+	//Count repeats of the last message instead of writing them out again
+	if (type == m_lastType && message == m_lastMessage) {
+		if (m_repeats == 0)
+			m_repeatsTime = time;
+		m_repeats++;
+		return;
+	}
+	outputRepeats();
+	m_lastType = type;
+	m_lastMessage = message;
+
+	if (type == LOG_DEBUG)
+		std::cout << "[DEBUG] ";
+	else if (type == LOG_INFORMATION)
+		std::cout << "[INFORMATION] ";
+	else if (type == LOG_WARNING)
+		std::cout << "[WARNING] ";
+	else if (type == LOG_ERROR)
+		std::cout << "[ERROR] ";
+	std::cout << message << '\n';
+}
+
+void Logger::outputRepeats() {
+	if (m_repeats > 0) {
+		std::cout << "(repeated " << m_repeats << " times)" << '\n';
+		m_repeats = 0;
+		//Allow the message to be written again once the repeats have been reported
+		m_lastType = -1;
+		m_lastMessage.clear();
+	}
+}
+
+double Logger::getTime() {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/***************************************************************************************************/
@@ -21,6 +21,9 @@
 
 #include <string>
 #include <iostream>
+#include <fstream>
+#include <atomic>
+#include <thread>
 
 /* Define the types of logs */
 enum {
@@ -30,12 +33,21 @@ enum {
 	LOG_DEBUG
 };
 
-/* The various values that determine which logs will be printed */
-static bool LOGGER_DEBUG_ENABLED       = true;
-static bool LOGGER_INFORMATION_ENABLED = true;
-static bool LOGGER_WARNING_ENABLED     = true;
-static bool LOGGER_ERROR_ENABLED       = true;
+/* The types of logs that are compiled in, a log whose type isn't included is removed entirely
+ * along with the code building its message. This can be defined before including this file, e.g.
+ * as (1 << LOG_WARNING) | (1 << LOG_ERROR) for a release build */
+#ifndef LOGGER_COMPILED_TYPES
+#define LOGGER_COMPILED_TYPES ((1 << LOG_INFORMATION) | (1 << LOG_WARNING) | (1 << LOG_ERROR) | (1 << LOG_DEBUG))
+#endif
 
+/* Added to the end of a message that was too long to be queued whole */
+#define LOGGER_TRUNCATED " (truncated)"
+
+/* The various values that determine which logs will be printed */
+extern bool LOGGER_DEBUG_ENABLED;
+extern bool LOGGER_INFORMATION_ENABLED;
+extern bool LOGGER_WARNING_ENABLED;
+extern bool LOGGER_ERROR_ENABLED;
 
 /***************************************************************************************************
  * The Log class stores data that can be print a log
@@ -56,37 +68,96 @@ public:
 
 /***************************************************************************************************/
 
+/***************************************************************************************************
+ * The Logger class writes logs out, once it has been started this is done by a background thread
+ * so the threads logging only have to copy their message into a lock free queue. Repeats of the
+ * same message are collapsed into one line, and logs can also be written to a binary file
+ ***************************************************************************************************/
+
+class Logger {
+private:
+	/* Part of a log waiting in the queue, longer messages are split across consecutive records and
+	 * the first one stores how many there are */
+	struct Record {
+		std::atomic<unsigned int> sequence;
+		int type;
+		double time;
+		unsigned int parts;
+		unsigned int length;
+		char message[240];
+	};
+
+	/* The queue of logs, any thread can add to it but only the background thread removes them */
+	static Record* m_records;
+	static unsigned int m_mask;
+	static std::atomic<unsigned int> m_enqueuePosition;
+	static unsigned int m_dequeuePosition;
+	static std::atomic<unsigned int> m_numDropped;
+
+	static std::thread m_thread;
+	static std::atomic<bool> m_running;
+
+	/* Where the logs are written */
+	static bool m_consoleOutput;
+	static std::ofstream m_binaryOutput;
+
+	/* The last log written and the number of times it has been repeated since */
+	static int m_lastType;
+	static std::string m_lastMessage;
+	static unsigned int m_repeats;
+	static double m_repeatsTime;
+
+	static void run();
+	static bool drain();
+	static void output(int type, double time, const std::string& message);
+	static void outputRepeats();
+	static double getTime();
+public:
+	/* Starts the background thread, until this is called logs are written straight away */
+	static void start(unsigned int capacity);
+	static inline void start() { start(4096); }
+
+	/* Writes any logs left in the queue and stops the background thread */
+	static void stop();
+
+	/* Adds a log to be written, a message longer than the whole queue is cut short and ends with
+	 * LOGGER_TRUNCATED */
+	static void write(int type, const std::string& message);
+
+	static inline void setConsoleOutput(bool consoleOutput) { m_consoleOutput = consoleOutput; }
+	static inline bool getConsoleOutput() { return m_consoleOutput; }
+
+	/* Starts writing every log to a binary file as well, each log is its type (int), the time in
+	 * seconds (double), the length of the message (unsigned int) and then the message */
+	static bool setBinaryOutput(std::string path);
+
+	static inline bool isStarted() { return m_running.load(); }
+	static inline unsigned int getNumDropped() { return m_numDropped.load(); }
+	static inline bool isEnabled(int type) {
+		return ((LOGGER_COMPILED_TYPES & (1 << type)) != 0) &&
+			   ((type == LOG_DEBUG && LOGGER_DEBUG_ENABLED) || (type == LOG_INFORMATION && LOGGER_INFORMATION_ENABLED) ||
+			    (type == LOG_WARNING && LOGGER_WARNING_ENABLED) || (type == LOG_ERROR && LOGGER_ERROR_ENABLED));
+	}
+};
+
+/***************************************************************************************************/
+
 /* The methods used to print out a message */
 inline void print(std::string message)   { std::cout << message;              }
 inline void println(std::string message) { std::cout << message << std::endl; }
 
 /* Define the methods to print out a log */
 static void log(Log log) {
-	if (log.isDebug() && LOGGER_DEBUG_ENABLED)
-		println("[DEBUG] " + log.getMessage());
-	else if (log.isInformation() && LOGGER_INFORMATION_ENABLED)
-		println("[INFORMATION] " + log.getMessage());
-	else if (log.isWarning() && LOGGER_WARNING_ENABLED)
-		println("[WARNING] " + log.getMessage());
-	else if (log.isError() && LOGGER_ERROR_ENABLED)
-		println("[ERROR] " + log.getMessage());
+	if (Logger::isEnabled(log.getType()))
+		Logger::write(log.getType(), log.getMessage());
 }
 
-/* The various other utility methods to construct and print a log */
-inline void logDebug(std::string message) {
-	log(Log(message, LOG_DEBUG));
-}
-
-inline void logInformation(std::string message) {
-	log(Log(message, LOG_INFORMATION));
-}
-
-inline void logWarning(std::string message) {
-	log(Log(message, LOG_WARNING));
-}
-
-inline void logError(std::string message) {
-	log(Log(message, LOG_ERROR));
-}
+/* The various other utility methods to construct and print a log, these are macros so that the
+ * message is only built when the log is enabled */
+#define LOGGER_WRITE(type, message) do { if (Logger::isEnabled(type)) Logger::write(type, message); } while (0)
+#define logDebug(message) LOGGER_WRITE(LOG_DEBUG, message)
+#define logInformation(message) LOGGER_WRITE(LOG_INFORMATION, message)
+#define logWarning(message) LOGGER_WRITE(LOG_WARNING, message)
+#define logError(message) LOGGER_WRITE(LOG_ERROR, message)
 
 #endif
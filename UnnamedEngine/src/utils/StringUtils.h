@@ -60,6 +60,17 @@ inline std::string split_string_last(const std::string &s, char delimeter) {
 	return split.at(split.size() - 1);
 }
 
+/* Returns the 64-bit FNV-1a hash of a string, this is stable between runs so can be used to
+ * name cached files */
+inline unsigned long long hash_string(const std::string &s) {
+	unsigned long long hash = 14695981039346656037ULL;
+	for (unsigned int a = 0; a < s.length(); a++) {
+		hash ^= (unsigned char) s[a];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
 /***************************************************************************************************/
 
 #endif
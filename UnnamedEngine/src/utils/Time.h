@@ -20,6 +20,8 @@
 #define UTILS_TIME_H_
 
 #include <GL/GLFW/glfw3.h>
+#include <chrono>
+#include <thread>
 
 /***************************************************************************************************
  * The Time class
@@ -35,6 +37,29 @@ public:
 	static inline long getTimeMilliseconds() {
 		return (long) (glfwGetTime() * 1000);
 	}
+
+	/* NOTE: These methods use a monotonic clock that isn't tied to the window, they should be
+	 *       used for measuring intervals rather than the time since the window was created */
+	static inline long long getTimeNanoseconds() {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	static inline double getTimeSecondsPrecise() {
+		return getTimeNanoseconds() / 1000000000.0;
+	}
+
+	/* Waits until the time given by getTimeNanoseconds(), sleeping for most of it and then
+	 * spinning for the rest as the scheduler can wake threads up much later than asked */
+	static inline void waitUntil(long long time) {
+		long long remaining = time - getTimeNanoseconds();
+		if (remaining > SLEEP_SPIN_TIME)
+			std::this_thread::sleep_for(std::chrono::nanoseconds(remaining - SLEEP_SPIN_TIME));
+		while (getTimeNanoseconds() < time)
+			std::this_thread::yield();
+	}
+
+	/* The time left (in nanoseconds) at which waitUntil() stops sleeping and starts spinning */
+	static const long long SLEEP_SPIN_TIME = 2000000;
 };
 
 /***************************************************************************************************/
@@ -0,0 +1,56 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <random>
+
+#include "Test.h"
+#include "core/TextureAtlas.h"
+
+TEST(AtlasPackerNoOverlaps) {
+	std::mt19937 random(1);
+	std::uniform_int_distribution<int> sizes(1, 40);
+	AtlasPacker packer(256, 256);
+	std::vector<int> rectangles;
+	int area = 0;
+	int x;
+	int y;
+	for (unsigned int a = 0; a < 1000; a++) {
+		int width = sizes(random);
+		int height = sizes(random);
+		if (! packer.pack(width, height, x, y))
+			continue;
+		CHECK(x >= 0 && y >= 0 && x + width <= 256 && y + height <= 256);
+		for (unsigned int b = 0; b < rectangles.size(); b += 4)
+			CHECK(x >= rectangles[b] + rectangles[b + 2] || rectangles[b] >= x + width || y >= rectangles[b + 1] + rectangles[b + 3] || rectangles[b + 1] >= y + height);
+		rectangles.push_back(x);
+		rectangles.push_back(y);
+		rectangles.push_back(width);
+		rectangles.push_back(height);
+		area += width * height;
+	}
+	CHECK_EQUAL(area, packer.getUsedArea());
+	CHECK(packer.getOccupancy() > 0.5f);
+
+	//Too large to ever fit
+	CHECK(! packer.pack(257, 1, x, y));
+	packer.clear();
+	CHECK_EQUAL(0, packer.getUsedArea());
+	CHECK(packer.pack(256, 256, x, y));
+	CHECK_EQUAL(0, x);
+	CHECK_EQUAL(0, y);
+}
@@ -0,0 +1,143 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <algorithm>
+#include <random>
+
+#include "Test.h"
+#include "core/render/BufferAllocator.h"
+
+/* Orders allocations by where they start in the buffer */
+struct AllocationOffsetOrder {
+	bool operator()(const BufferAllocator::Allocation& a, const BufferAllocator::Allocation& b) const { return a.offset < b.offset; }
+};
+
+/* Checks that the allocations are aligned, inside the buffer and don't overlap, and that they add
+ * up to the space the allocator says is used */
+static void checkAllocations(BufferAllocator& allocator, std::vector<BufferAllocator::Allocation> allocations) {
+	std::sort(allocations.begin(), allocations.end(), AllocationOffsetOrder());
+	unsigned int used = 0;
+	for (unsigned int a = 0; a < allocations.size(); a++) {
+		CHECK_EQUAL(0u, allocations[a].offset % allocator.getAlignment());
+		CHECK(allocations[a].offset + allocations[a].size <= allocator.getCapacity());
+		if (a > 0)
+			CHECK(allocations[a - 1].offset + allocations[a - 1].size <= allocations[a].offset);
+		used += allocations[a].size;
+	}
+	CHECK_EQUAL(used, allocator.getUsed());
+	CHECK_EQUAL(allocations.size(), allocator.getNumAllocations());
+}
+
+TEST(BufferAllocatorRoundsToAlignment) {
+	BufferAllocator allocator(1024, 16);
+	BufferAllocator::Allocation a;
+	BufferAllocator::Allocation b;
+	CHECK(allocator.allocate(1, a));
+	CHECK(allocator.allocate(17, b));
+	CHECK_EQUAL(16u, a.size);
+	CHECK_EQUAL(32u, b.size);
+	CHECK_EQUAL(48u, allocator.getUsed());
+	CHECK(a.offset != b.offset);
+}
+
+TEST(BufferAllocatorCoalescesFreedNeighbours) {
+	BufferAllocator allocator(4096, 16);
+	BufferAllocator::Allocation allocations[4];
+	for (unsigned int a = 0; a < 4; a++)
+		CHECK(allocator.allocate(1024, allocations[a]));
+	CHECK_EQUAL(0u, allocator.getLargestFree());
+	BufferAllocator::Allocation full;
+	CHECK(! allocator.allocate(16, full));
+
+	//Two ranges that aren't next to each other stay separate
+	allocator.free(allocations[0]);
+	allocator.free(allocations[2]);
+	CHECK(! allocations[0].isValid());
+	CHECK_EQUAL(2u, allocator.getNumFreeBlocks());
+	CHECK_EQUAL(1024u, allocator.getLargestFree());
+	CHECK_NEAR(0.5f, allocator.getFragmentation(), 0.0001);
+
+	//Freeing the range between them merges all three
+	allocator.free(allocations[1]);
+	CHECK_EQUAL(1u, allocator.getNumFreeBlocks());
+	CHECK_EQUAL(3072u, allocator.getLargestFree());
+	CHECK_NEAR(0.0f, allocator.getFragmentation(), 0.0001);
+
+	allocator.free(allocations[3]);
+	CHECK_EQUAL(1u, allocator.getNumFreeBlocks());
+	CHECK_EQUAL(4096u, allocator.getLargestFree());
+	CHECK_EQUAL(0u, allocator.getUsed());
+}
+
+TEST(BufferAllocatorGrows) {
+	BufferAllocator allocator(1024, 16);
+	BufferAllocator::Allocation a;
+	BufferAllocator::Allocation b;
+	CHECK(allocator.allocate(1024, a));
+	CHECK(! allocator.allocate(512, b));
+
+	//The new space is a separate range after the last allocation
+	allocator.grow(2048);
+	CHECK_EQUAL(2048u, allocator.getCapacity());
+	CHECK(allocator.allocate(512, b));
+	CHECK_EQUAL(1024u, b.offset);
+
+	//Growing again extends the free range at the end rather than adding another
+	allocator.grow(4096);
+	CHECK_EQUAL(1u, allocator.getNumFreeBlocks());
+	CHECK_EQUAL(2560u, allocator.getLargestFree());
+
+	//Shrinking isn't possible
+	allocator.grow(512);
+	CHECK_EQUAL(4096u, allocator.getCapacity());
+}
+
+TEST(BufferAllocatorRandomAllocations) {
+	std::mt19937 random(1);
+	std::uniform_int_distribution<unsigned int> sizes(1, 4096);
+	BufferAllocator allocator(1 << 20, 256);
+	std::vector<BufferAllocator::Allocation> allocations;
+	for (unsigned int a = 0; a < 20000; a++) {
+		if (allocations.empty() || random() % 3 != 0) {
+			unsigned int size = sizes(random);
+			BufferAllocator::Allocation allocation;
+			if (allocator.allocate(size, allocation)) {
+				CHECK(allocation.size >= size);
+				allocations.push_back(allocation);
+			} else
+				//Sizes are rounded up to the start of the next list, so only a range a little
+				//larger than the size is guaranteed to be found
+				CHECK(allocator.getLargestFree() < size + (size / 8) + allocator.getAlignment());
+		} else {
+			unsigned int index = random() % allocations.size();
+			allocator.free(allocations[index]);
+			allocations[index] = allocations.back();
+			allocations.pop_back();
+		}
+		if (a % 1000 == 0)
+			checkAllocations(allocator, allocations);
+	}
+	checkAllocations(allocator, allocations);
+
+	//Everything is merged back into one range once it has all been freed
+	for (unsigned int a = 0; a < allocations.size(); a++)
+		allocator.free(allocations[a]);
+	CHECK_EQUAL(0u, allocator.getUsed());
+	CHECK_EQUAL(1u, allocator.getNumFreeBlocks());
+	CHECK_EQUAL(allocator.getCapacity(), allocator.getLargestFree());
+}
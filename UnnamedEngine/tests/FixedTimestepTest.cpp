@@ -0,0 +1,80 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <random>
+
+#include "Test.h"
+#include "utils/FixedTimestep.h"
+
+TEST(FixedTimestepSteps) {
+	FixedTimestep timestep(100, 5);
+	CHECK_EQUAL(100u, timestep.getRate());
+	CHECK_EQUAL(10000000LL, timestep.getStepNanoseconds());
+
+	//Less than a step is kept for later
+	CHECK_EQUAL(0u, timestep.advance(4000000));
+	CHECK_NEAR(0.4f, timestep.getAlpha(), 0.0001);
+	CHECK_EQUAL(1u, timestep.advance(7000000));
+	CHECK_NEAR(0.1f, timestep.getAlpha(), 0.0001);
+	CHECK_EQUAL(3u, timestep.advance(29000000));
+	CHECK_NEAR(0.0f, timestep.getAlpha(), 0.0001);
+	CHECK_EQUAL(4u, timestep.getTotalSteps());
+
+	//Time going backwards is ignored
+	CHECK_EQUAL(0u, timestep.advance(-5000000));
+	CHECK_NEAR(0.0f, timestep.getAlpha(), 0.0001);
+
+	timestep.advance(5000000);
+	timestep.reset();
+	CHECK_NEAR(0.0f, timestep.getAlpha(), 0.0001);
+}
+
+TEST(FixedTimestepMaxSteps) {
+	FixedTimestep timestep(100, 5);
+	//A long frame only takes the most steps allowed, dropping the rest but keeping the fraction
+	CHECK_EQUAL(5u, timestep.advance(1000000000LL + 2500000));
+	CHECK_EQUAL(1u, timestep.getNumDropped());
+	CHECK_NEAR(0.25f, timestep.getAlpha(), 0.0001);
+	//After that it carries on as normal
+	CHECK_EQUAL(1u, timestep.advance(7500000));
+	CHECK_NEAR(0.0f, timestep.getAlpha(), 0.0001);
+	CHECK_EQUAL(5u, timestep.advance(50000000));
+	CHECK_EQUAL(1u, timestep.getNumDropped());
+	CHECK_EQUAL(11u, timestep.getTotalSteps());
+
+	timestep.setMaxSteps(2);
+	CHECK_EQUAL(2u, timestep.advance(50000000));
+	CHECK_EQUAL(2u, timestep.getNumDropped());
+}
+
+TEST(FixedTimestepKeepsUp) {
+	//Frames of random lengths around the step never drift from the time that has passed
+	std::mt19937 random(1);
+	std::uniform_int_distribution<long long> frames(1000000, 30000000);
+	FixedTimestep timestep(60, 10);
+	long long elapsed = 0;
+	for (unsigned int a = 0; a < 100000; a++) {
+		long long frame = frames(random);
+		elapsed += frame;
+		timestep.advance(frame);
+		long long simulated = (long long) timestep.getTotalSteps() * timestep.getStepNanoseconds();
+		CHECK(elapsed - simulated >= 0 && elapsed - simulated < timestep.getStepNanoseconds());
+		CHECK(timestep.getAlpha() >= 0.0f && timestep.getAlpha() < 1.0f);
+	}
+	CHECK_EQUAL(0u, timestep.getNumDropped());
+}
@@ -0,0 +1,107 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include "Test.h"
+#include "core/render/GLState.h"
+
+/* The number of calls made to the OpenGL functions replaced below */
+static unsigned int numUseProgram;
+static unsigned int numBindTexture;
+static unsigned int numEnable;
+static unsigned int numBlendFunc;
+static unsigned int numIsEnabled;
+
+static void APIENTRY countUseProgram(GLuint program) { numUseProgram++; }
+static void APIENTRY countBindTexture(GLenum target, GLuint texture) { numBindTexture++; }
+static void APIENTRY countEnable(GLenum capability) { numEnable++; }
+static void APIENTRY countBlendFunc(GLenum source, GLenum destination) { numBlendFunc++; }
+static GLboolean APIENTRY countIsEnabled(GLenum capability) { numIsEnabled++; return GL_TRUE; }
+
+static void setupStubs() {
+	glewResetStubs();
+	__glewUseProgram = countUseProgram;
+	__glewBindTexture = countBindTexture;
+	__glewEnable = countEnable;
+	__glewBlendFunc = countBlendFunc;
+	__glewIsEnabled = countIsEnabled;
+	numUseProgram = 0;
+	numBindTexture = 0;
+	numEnable = 0;
+	numBlendFunc = 0;
+	numIsEnabled = 0;
+	GLState::reset();
+}
+
+TEST(GLStateSkipsRedundantCalls) {
+	setupStubs();
+	unsigned long long changes = RenderStats::getCurrent(RENDER_STAT_STATE_CHANGES);
+	unsigned long long skipped = RenderStats::getCurrent(RENDER_STAT_STATE_CHANGES_SKIPPED);
+
+	//Only the first of the same calls is made
+	CHECK(GLState::useProgram(3));
+	CHECK(! GLState::useProgram(3));
+	CHECK(GLState::useProgram(4));
+	CHECK(GLState::bindTexture(0, GL_TEXTURE_2D, 7));
+	CHECK(! GLState::bindTexture(0, GL_TEXTURE_2D, 7));
+	//The units and targets are shadowed separately
+	CHECK(GLState::bindTexture(1, GL_TEXTURE_2D, 7));
+	CHECK(GLState::bindTexture(1, GL_TEXTURE_CUBE_MAP, 7));
+	CHECK(GLState::enable(GL_BLEND));
+	CHECK(! GLState::enable(GL_BLEND));
+	CHECK(GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
+	CHECK(! GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
+	CHECK(GLState::blendFunc(GL_SRC_ALPHA, GL_ONE));
+
+	CHECK_EQUAL(2u, numUseProgram);
+	CHECK_EQUAL(3u, numBindTexture);
+	CHECK_EQUAL(1u, numEnable);
+	CHECK_EQUAL(2u, numBlendFunc);
+	//Known capabilities aren't asked for
+	CHECK(GLState::isEnabled(GL_BLEND));
+	CHECK_EQUAL(0u, numIsEnabled);
+
+	//Binding a texture to a unit also counts whether the active unit changed
+	CHECK_EQUAL(changes + 10, RenderStats::getCurrent(RENDER_STAT_STATE_CHANGES));
+	CHECK_EQUAL(skipped + 6, RenderStats::getCurrent(RENDER_STAT_STATE_CHANGES_SKIPPED));
+	glewResetStubs();
+}
+
+TEST(GLStateReset) {
+	setupStubs();
+	GLState::useProgram(3);
+	GLState::bindTexture(0, GL_TEXTURE_2D, 7);
+
+	//Once the state is forgotten the calls are made again
+	GLState::reset();
+	CHECK(GLState::useProgram(3));
+	CHECK(GLState::bindTexture(0, GL_TEXTURE_2D, 7));
+	CHECK_EQUAL(2u, numUseProgram);
+	CHECK_EQUAL(2u, numBindTexture);
+	//Unknown capabilities are asked for
+	CHECK(GLState::isEnabled(GL_DEPTH_TEST));
+	CHECK_EQUAL(1u, numIsEnabled);
+
+	//Deleting something that is bound forgets it, as OpenGL unbinds it
+	GLState::deleteProgram(3);
+	GLState::deleteTexture(7);
+	CHECK(GLState::useProgram(3));
+	CHECK(GLState::bindTexture(0, GL_TEXTURE_2D, 7));
+	CHECK_EQUAL(3u, numUseProgram);
+	CHECK_EQUAL(3u, numBindTexture);
+	glewResetStubs();
+}
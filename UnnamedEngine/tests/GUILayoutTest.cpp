@@ -0,0 +1,143 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include "Test.h"
+#include "core/gui/GUIComponent.h"
+
+/* Counts the times layout visits the children of a component */
+class LayoutCounter : public GUIComponent {
+protected:
+	void layoutChildren() override {
+		numVisits++;
+		GUIComponent::layoutChildren();
+	}
+public:
+	static unsigned int numVisits;
+
+	LayoutCounter(float width, float height) : GUIComponent(NULL, width, height) {}
+};
+
+unsigned int LayoutCounter::numVisits = 0;
+
+/* Deletes a tree that was created with new */
+static void deleteTree(GUIComponent* component) {
+	for (unsigned int a = 0; a < component->components.size(); a++)
+		deleteTree(component->components[a]);
+	delete component;
+}
+
+/* Components are stacked along the edge they prefer, and move when the ones before them are
+ * resized */
+TEST(GUILayoutPositions) {
+	GUIComponent* root = new GUIComponent(NULL, 100.0f, 100.0f);
+	GUIComponent* top = new GUIComponent(NULL, 10.0f, 20.0f);
+	GUIComponent* below = new GUIComponent(NULL, 10.0f, 30.0f);
+	GUIComponent* right = new GUIComponent(NULL, 40.0f, 10.0f);
+	GUIComponent* centre = new GUIComponent(NULL, 20.0f, 20.0f);
+	root->add(top, GUIPosition::TOP, Vector2f(0, 0));
+	root->add(below, GUIPosition::TOP, Vector2f(0, 0));
+	root->add(right, GUIPosition::RIGHT, Vector2f(-5.0f, 0));
+	root->add(centre, GUIPosition::CENTRE, Vector2f(0, 0));
+
+	//Added components are positioned straight away
+	CHECK(! root->needsLayout());
+	CHECK_NEAR(45.0f, top->position.getX(), 0.0001f);
+	CHECK_NEAR(0.0f, top->position.getY(), 0.0001f);
+	CHECK_NEAR(20.0f, below->position.getY(), 0.0001f);
+	CHECK_NEAR(55.0f, right->position.getX(), 0.0001f);
+	CHECK_NEAR(45.0f, right->position.getY(), 0.0001f);
+	CHECK_NEAR(40.0f, centre->position.getX(), 0.0001f);
+
+	//Resizing marks the parent as needing a layout, which only happens when asked for
+	top->setHeight(40.0f);
+	CHECK(root->needsLayout());
+	CHECK_NEAR(20.0f, below->position.getY(), 0.0001f);
+	root->layout();
+	CHECK(! root->needsLayout());
+	CHECK_NEAR(40.0f, below->position.getY(), 0.0001f);
+
+	//So does resizing the parent
+	root->setSize(200.0f, 100.0f);
+	root->layout();
+	CHECK_NEAR(95.0f, top->position.getX(), 0.0001f);
+	CHECK_NEAR(155.0f, right->position.getX(), 0.0001f);
+
+	//Components without a position preference keep the position they are given
+	GUIComponent* placed = new GUIComponent(NULL, 10.0f, 10.0f);
+	placed->setPosition(3.0f, 4.0f);
+	root->add(placed);
+	root->layout();
+	CHECK_NEAR(3.0f, placed->position.getX(), 0.0001f);
+	CHECK_NEAR(4.0f, placed->position.getY(), 0.0001f);
+
+	deleteTree(root);
+}
+
+/* Only the branch containing a changed component is visited */
+TEST(GUILayoutDirtyBranch) {
+	LayoutCounter* root = new LayoutCounter(1000.0f, 1000.0f);
+	std::vector<LayoutCounter*> panels;
+	std::vector<LayoutCounter*> leaves;
+	for (unsigned int a = 0; a < 10; a++) {
+		LayoutCounter* panel = new LayoutCounter(100.0f, 1000.0f);
+		root->add(panel, GUIPosition::LEFT, Vector2f(0, 0));
+		panels.push_back(panel);
+		for (unsigned int b = 0; b < 10; b++) {
+			LayoutCounter* leaf = new LayoutCounter(100.0f, 10.0f);
+			panel->add(leaf, GUIPosition::TOP, Vector2f(0, 0));
+			leaves.push_back(leaf);
+		}
+	}
+	root->layout();
+	CHECK(! root->needsLayout());
+
+	//Nothing has changed
+	LayoutCounter::numVisits = 0;
+	root->layout();
+	CHECK_EQUAL(0u, LayoutCounter::numVisits);
+
+	//A leaf in the fourth panel, only the root and that panel visit their children
+	leaves[35]->setHeight(50.0f);
+	CHECK(root->needsLayout());
+	CHECK(panels[3]->needsLayout());
+	CHECK(! panels[2]->needsLayout());
+	CHECK(! leaves[36]->needsLayout());
+	root->layout();
+	CHECK_EQUAL(2u, LayoutCounter::numVisits);
+	CHECK_NEAR(50.0f, leaves[35]->position.getY(), 0.0001f);
+	CHECK_NEAR(100.0f, leaves[36]->position.getY(), 0.0001f);
+	CHECK_NEAR(50.0f, leaves[25]->position.getY(), 0.0001f);
+
+	//Two panels changing
+	LayoutCounter::numVisits = 0;
+	leaves[0]->setHeight(20.0f);
+	leaves[99]->setHeight(20.0f);
+	root->layout();
+	CHECK_EQUAL(3u, LayoutCounter::numVisits);
+	CHECK_NEAR(20.0f, leaves[1]->position.getY(), 0.0001f);
+
+	//Resizing a panel moves the ones after it without visiting any children
+	LayoutCounter::numVisits = 0;
+	panels[0]->setWidth(150.0f);
+	root->layout();
+	CHECK_EQUAL(1u, LayoutCounter::numVisits);
+	CHECK_NEAR(150.0f, panels[1]->position.getX(), 0.0001f);
+	CHECK_NEAR(1050.0f - 100.0f, panels[9]->position.getX(), 0.0001f);
+
+	deleteTree(root);
+}
@@ -0,0 +1,157 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <random>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include "Test.h"
+#include "core/ImageLoader.h"
+
+/* The conversions written as plainly as possible to compare the kernels with */
+static void referenceExpand(const std::vector<unsigned char>& source, std::vector<unsigned char>& destination) {
+	for (unsigned int a = 0; a < source.size() / 3; a++) {
+		destination[a * 4]     = source[a * 3];
+		destination[a * 4 + 1] = source[a * 3 + 1];
+		destination[a * 4 + 2] = source[a * 3 + 2];
+		destination[a * 4 + 3] = 255;
+	}
+}
+
+static void referencePremultiply(std::vector<unsigned char>& pixels) {
+	for (unsigned int a = 0; a < pixels.size(); a += 4) {
+		//Rounded to the nearest value
+		for (unsigned int b = 0; b < 3; b++)
+			pixels[a + b] = (unsigned char) ((pixels[a + b] * pixels[a + 3] * 2 + 255) / 510);
+	}
+}
+
+/* Writes a binary PGM or PPM image, the formats the stubs can decode */
+static void writeImage(const std::string& path, int width, int height, int numComponents, const std::vector<unsigned char>& pixels) {
+	FILE* file = fopen(path.c_str(), "wb");
+	fprintf(file, "%s %d %d 255\n", numComponents == 1 ? "P5" : "P6", width, height);
+	fwrite(&pixels.front(), 1, pixels.size(), file);
+	fclose(file);
+}
+
+/* The kernels handle any number of pixels, including the ones left over after the SIMD loops,
+ * with buffers of exactly the size needed */
+TEST(ImageLoaderKernels) {
+	std::mt19937 random(1);
+	std::uniform_int_distribution<int> bytes(0, 255);
+	for (unsigned int numPixels = 1; numPixels < 40; numPixels++) {
+		std::vector<unsigned char> source(numPixels * 3);
+		for (unsigned int a = 0; a < source.size(); a++)
+			source[a] = (unsigned char) bytes(random);
+		std::vector<unsigned char> expanded(numPixels * 4);
+		std::vector<unsigned char> expected(numPixels * 4);
+		//With and without SSSE3, where it is supported
+		referenceExpand(source, expected);
+		ImageLoader::setSSSE3Enabled(false);
+		ImageLoader::expandRGBToRGBA(&source.front(), &expanded.front(), numPixels);
+		CHECK(expanded == expected);
+		ImageLoader::setSSSE3Enabled(true);
+		std::fill(expanded.begin(), expanded.end(), 0);
+		ImageLoader::expandRGBToRGBA(&source.front(), &expanded.front(), numPixels);
+		CHECK(expanded == expected);
+
+		for (unsigned int a = 0; a < expanded.size(); a++)
+			expanded[a] = (unsigned char) bytes(random);
+		expected = expanded;
+		ImageLoader::premultiplyAlpha(&expanded.front(), numPixels);
+		referencePremultiply(expected);
+		CHECK(expanded == expected);
+	}
+
+	//Every colour and alpha
+	std::vector<unsigned char> pixels;
+	for (unsigned int alpha = 0; alpha < 256; alpha++) {
+		for (unsigned int colour = 0; colour < 256; colour++) {
+			pixels.push_back((unsigned char) colour);
+			pixels.push_back((unsigned char) (255 - colour));
+			pixels.push_back((unsigned char) colour);
+			pixels.push_back((unsigned char) alpha);
+		}
+	}
+	std::vector<unsigned char> expected = pixels;
+	ImageLoader::premultiplyAlpha(&pixels.front(), pixels.size() / 4);
+	referencePremultiply(expected);
+	CHECK(pixels == expected);
+
+	//Only turned on when the processor has it
+	CHECK_EQUAL(ImageLoader::isSSSE3Supported(), ImageLoader::isSSSE3Enabled());
+}
+
+/* Decoding many images at once gives the same images, in the same order, as decoding each one */
+TEST(ImageLoaderDecode) {
+	std::vector<std::string> paths;
+	for (unsigned int a = 0; a < 8; a++) {
+		int width = 5 + a;
+		int height = 3 + a * 2;
+		int numComponents = a % 2 == 0 ? 3 : 1;
+		std::vector<unsigned char> pixels(width * height * numComponents);
+		for (unsigned int b = 0; b < pixels.size(); b++)
+			pixels[b] = (unsigned char) (a * 31 + b);
+		paths.push_back(std::string(TEST_OUTPUT_PATH) + "ImageLoaderTest" + std::to_string(a) + ".ppm");
+		writeImage(paths.back(), width, height, numComponents, pixels);
+	}
+	paths.push_back(std::string(TEST_OUTPUT_PATH) + "ImageLoaderTestMissing.ppm");
+
+	std::vector<Image*> images;
+	ImageLoader::decode(paths, 0, images);
+	CHECK_EQUAL(paths.size(), images.size());
+	for (unsigned int a = 0; a < paths.size(); a++) {
+		Image* image = ImageLoader::decode(paths[a], 0);
+		CHECK_EQUAL(paths[a], images[a]->path);
+		CHECK_EQUAL(image->isLoaded(), images[a]->isLoaded());
+		if (image->isLoaded() && images[a]->isLoaded()) {
+			CHECK_EQUAL(image->width, images[a]->width);
+			CHECK_EQUAL(image->height, images[a]->height);
+			CHECK_EQUAL(image->numComponents, images[a]->numComponents);
+			CHECK(memcmp(image->pixels, images[a]->pixels, image->width * image->height * image->numComponents) == 0);
+		}
+		delete image;
+		delete images[a];
+	}
+	CHECK(! images.empty());
+}
+
+/* Each pixel of a downsampled image is the rounded average of four, dropping the last row and
+ * column of odd sizes, and an image a single pixel across keeps its size */
+TEST(ImageLoaderDownsample) {
+	std::vector<unsigned char> pixels = {
+		0,   10,  20,
+		30,  40,  50,
+		100, 101, 255
+	};
+	std::string path = std::string(TEST_OUTPUT_PATH) + "ImageLoaderDownsample.pgm";
+	writeImage(path, 3, 3, 1, pixels);
+	Image* image = ImageLoader::decode(path, 0);
+	CHECK(image->isLoaded());
+	Image* half = ImageLoader::downsample(image);
+	CHECK_EQUAL(1, half->width);
+	CHECK_EQUAL(1, half->height);
+	CHECK_EQUAL(20, (int) half->pixels[0]);
+	Image* same = ImageLoader::downsample(half);
+	CHECK_EQUAL(1, same->width);
+	CHECK_EQUAL(20, (int) same->pixels[0]);
+	delete same;
+	delete half;
+	delete image;
+}
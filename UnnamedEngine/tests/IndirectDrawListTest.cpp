@@ -0,0 +1,122 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <cstddef>
+
+#include "Test.h"
+#include "core/render/IndirectDrawList.h"
+
+/* The list only compares textures, so any distinct addresses can stand in for them */
+static char textures[2];
+
+TEST(IndirectDrawListDrawDataLayout) {
+	//Must match the std430 layout of DrawData in DrawData.glsl, where the struct is padded to a
+	//multiple of the vec4 alignment
+	CHECK_EQUAL(160u, sizeof(DrawData));
+	CHECK_EQUAL(0u, offsetof(DrawData, modelMatrix));
+	CHECK_EQUAL(64u, offsetof(DrawData, normalMatrix));
+	CHECK_EQUAL(128u, offsetof(DrawData, diffuseColour));
+	CHECK_EQUAL(144u, offsetof(DrawData, shininess));
+	CHECK_EQUAL(20u, sizeof(DrawElementsIndirectCommand));
+	CHECK_EQUAL(16u, sizeof(DrawArraysIndirectCommand));
+}
+
+TEST(IndirectDrawListBatchesByFormatAndTexture) {
+	Texture* textureA = (Texture*) &textures[0];
+	Texture* textureB = (Texture*) &textures[1];
+	DrawData data = DrawData();
+
+	IndirectDrawList list;
+	list.addElements(0, textureA, 6, 0, 0, data);
+	list.addElements(1, textureA, 6, 6, 4, data);
+	list.addElements(0, textureB, 3, 12, 8, data);
+	list.addElements(0, textureA, 9, 15, 12, data);
+	list.addArrays(0, textureA, 4, 20, data);
+	list.build();
+
+	//Format 0 and texture A is split in two as indexed and non indexed draws need different calls
+	std::vector<IndirectDrawList::Batch>& batches = list.getBatches();
+	CHECK_EQUAL(5u, list.getNumDraws());
+	CHECK_EQUAL(4u, batches.size());
+	unsigned int numElementCommands = 0;
+	unsigned int numArrayCommands = 0;
+	for (unsigned int a = 0; a < batches.size(); a++) {
+		if (batches[a].indexed)
+			numElementCommands += batches[a].numCommands;
+		else
+			numArrayCommands += batches[a].numCommands;
+		if (a > 0)
+			CHECK(batches[a - 1].format != batches[a].format || batches[a - 1].texture != batches[a].texture || batches[a - 1].indexed != batches[a].indexed);
+	}
+	CHECK_EQUAL(4u, numElementCommands);
+	CHECK_EQUAL(1u, numArrayCommands);
+	CHECK_EQUAL(list.getElementCommands().size(), numElementCommands);
+	CHECK_EQUAL(list.getArrayCommands().size(), numArrayCommands);
+
+	//The two indexed draws with format 0 and texture A share a batch
+	bool found = false;
+	for (unsigned int a = 0; a < batches.size(); a++) {
+		if (batches[a].format == 0 && batches[a].texture == textureA && batches[a].indexed) {
+			CHECK_EQUAL(2u, batches[a].numCommands);
+			CHECK_EQUAL(15u, batches[a].numVertices);
+			found = true;
+		}
+	}
+	CHECK(found);
+}
+
+TEST(IndirectDrawListCommands) {
+	Texture* texture = (Texture*) &textures[0];
+	DrawData data = DrawData();
+
+	IndirectDrawList list;
+	unsigned int shared = list.addData(data);
+	list.addElements(0, texture, 36, 100, -4, shared);
+	list.addElements(0, texture, 12, 136, 24, shared);
+	list.addArrays(0, texture, 3, 7, data);
+	list.build();
+
+	std::vector<DrawElementsIndirectCommand>& elements = list.getElementCommands();
+	CHECK_EQUAL(2u, elements.size());
+	CHECK_EQUAL(36u, elements[0].count);
+	CHECK_EQUAL(1u, elements[0].instanceCount);
+	CHECK_EQUAL(100u, elements[0].firstIndex);
+	CHECK_EQUAL(-4, elements[0].baseVertex);
+	CHECK_EQUAL(shared, elements[0].baseInstance);
+	CHECK_EQUAL(136u, elements[1].firstIndex);
+	CHECK_EQUAL(24, elements[1].baseVertex);
+	CHECK_EQUAL(shared, elements[1].baseInstance);
+
+	//The base instance is the index of the data so the shader can find it
+	std::vector<DrawArraysIndirectCommand>& arrays = list.getArrayCommands();
+	CHECK_EQUAL(1u, arrays.size());
+	CHECK_EQUAL(3u, arrays[0].count);
+	CHECK_EQUAL(7u, arrays[0].first);
+	CHECK_EQUAL(1u, arrays[0].baseInstance);
+	CHECK_EQUAL(2u, list.getDrawData().size());
+
+	//Building again gives the same commands rather than adding to them
+	list.build();
+	CHECK_EQUAL(2u, list.getElementCommands().size());
+	CHECK_EQUAL(2u, list.getBatches().size());
+
+	list.clear();
+	CHECK(list.isEmpty());
+	CHECK(list.getDrawData().empty());
+	CHECK(list.getBatches().empty());
+}
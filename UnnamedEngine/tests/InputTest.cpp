@@ -0,0 +1,202 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <thread>
+#include <cstdio>
+#include <cstring>
+
+#include "Test.h"
+#include "core/input/Input.h"
+#include "core/input/InputRecording.h"
+
+/* Records the calls made to a listener as a string that can be compared */
+class RecordingListener : public InputListener {
+public:
+	std::string calls;
+
+	virtual void onKeyPressed(int code) override { calls += "pressed " + std::to_string(code) + ";"; }
+	virtual void onKeyReleased(int code) override { calls += "released " + std::to_string(code) + ";"; }
+	virtual void onKeyTyped(int code) override { calls += "typed " + std::to_string(code) + ";"; }
+	virtual void onChar(int code, char character) override { calls += std::string("char ") + character + ";"; }
+	virtual void onMousePressed(int button) override { calls += "mousePressed " + std::to_string(button) + ";"; }
+	virtual void onMouseReleased(int button) override { calls += "mouseReleased " + std::to_string(button) + ";"; }
+	virtual void onMouseClicked(int button) override { calls += "mouseClicked " + std::to_string(button) + ";"; }
+	virtual void onMouseMoved(double x, double y, double dx, double dy) override { calls += "moved " + std::to_string((int) x) + " " + std::to_string((int) y) + " " + std::to_string((int) dx) + " " + std::to_string((int) dy) + ";"; }
+	virtual void onMouseDragged(double x, double y, double dx, double dy) override { calls += "dragged " + std::to_string((int) dx) + " " + std::to_string((int) dy) + ";"; }
+	virtual void onMouseEnter() override { calls += "enter;"; }
+	virtual void onMouseLeave() override { calls += "leave;"; }
+	virtual void onScroll(double dx, double dy) override { calls += "scroll " + std::to_string((int) dy) + ";"; }
+};
+
+static InputEvent createEvent(InputEventType type, double time, int code, int action, double x, double y) {
+	InputEvent event;
+	event.type = type;
+	event.time = time;
+	event.code = code;
+	event.action = action;
+	event.x = x;
+	event.y = y;
+	return event;
+}
+
+/* A recording of typing a key, entering the window, dragging with the left button and scrolling */
+static void createRecording(InputRecording& recording) {
+	recording.add(createEvent(INPUT_EVENT_KEY, 1.0, GLFW_KEY_A, GLFW_PRESS, 0, 0));
+	recording.add(createEvent(INPUT_EVENT_CHAR, 1.0, 'a', 0, 0, 0));
+	recording.add(createEvent(INPUT_EVENT_KEY, 1.1, GLFW_KEY_A, GLFW_RELEASE, 0, 0));
+	recording.add(createEvent(INPUT_EVENT_CURSOR_ENTER, 1.2, 1, 0, 0, 0));
+	recording.add(createEvent(INPUT_EVENT_CURSOR_POSITION, 1.3, 0, 0, 10, 10));
+	recording.add(createEvent(INPUT_EVENT_CURSOR_POSITION, 1.4, 0, 0, 12, 15));
+	recording.add(createEvent(INPUT_EVENT_CURSOR_POSITION, 1.5, 0, 0, 20, 30));
+	recording.add(createEvent(INPUT_EVENT_MOUSE_BUTTON, 1.6, GLFW_MOUSE_BUTTON_LEFT, GLFW_PRESS, 0, 0));
+	recording.add(createEvent(INPUT_EVENT_CURSOR_POSITION, 1.7, 0, 0, 25, 30));
+	recording.add(createEvent(INPUT_EVENT_CURSOR_POSITION, 1.8, 0, 0, 30, 35));
+	recording.add(createEvent(INPUT_EVENT_MOUSE_BUTTON, 1.9, GLFW_MOUSE_BUTTON_LEFT, GLFW_RELEASE, 0, 0));
+	recording.add(createEvent(INPUT_EVENT_CURSOR_POSITION, 2.0, 0, 0, 40, 35));
+	recording.add(createEvent(INPUT_EVENT_SCROLL, 2.5, 0, 0, 0, -3));
+}
+
+/* Replays a recording from a known cursor position, returning the calls made to a listener */
+static std::string replay(InputRecording& recording, bool coalesceMouseMoves) {
+	RecordingListener listener;
+	InputManager::addListener(&listener);
+	InputManager::setCoalesceMouseMoves(coalesceMouseMoves);
+	Mouse::lastX = -1;
+	Mouse::lastY = -1;
+	InputManager::replay(&recording);
+	InputManager::removeListener(&listener);
+	InputManager::setCoalesceMouseMoves(true);
+	return listener.calls;
+}
+
+TEST(InputEventQueueOrder) {
+	InputEventQueue queue(5);
+	CHECK_EQUAL(8u, queue.getCapacity());
+	CHECK(queue.isEmpty());
+
+	InputEvent event;
+	for (unsigned int a = 0; a < 8; a++)
+		CHECK(queue.push(createEvent(INPUT_EVENT_KEY, a, a, 0, 0, 0)));
+	CHECK(! queue.push(createEvent(INPUT_EVENT_KEY, 8, 8, 0, 0, 0)));
+	CHECK_EQUAL(1u, queue.getNumDropped());
+
+	//Events come out in the order they went in, including after wrapping around
+	for (unsigned int a = 0; a < 20; a++) {
+		CHECK(queue.pop(event));
+		CHECK_EQUAL((int) a, event.code);
+		CHECK(queue.push(createEvent(INPUT_EVENT_KEY, a + 8, a + 8, 0, 0, 0)));
+	}
+	for (unsigned int a = 20; a < 28; a++) {
+		CHECK(queue.pop(event));
+		CHECK_EQUAL((int) a, event.code);
+	}
+	CHECK(! queue.pop(event));
+	CHECK(queue.isEmpty());
+}
+
+/* Adds events numbered in order to a queue, waiting whenever it is full */
+static void produceEvents(InputEventQueue* queue, unsigned int numEvents) {
+	for (unsigned int a = 0; a < numEvents; a++) {
+		while (! queue->push(createEvent(INPUT_EVENT_KEY, a, a, 0, 0, 0)))
+			std::this_thread::yield();
+	}
+}
+
+TEST(InputEventQueueThreads) {
+	const unsigned int numEvents = 200000;
+	InputEventQueue queue(64);
+	std::thread producer(produceEvents, &queue, numEvents);
+	//Every event arrives once and in order even though the queue is much smaller than them
+	unsigned int next = 0;
+	bool ordered = true;
+	InputEvent event;
+	while (next < numEvents) {
+		if (queue.pop(event)) {
+			ordered &= event.code == (int) next;
+			next++;
+		} else
+			std::this_thread::yield();
+	}
+	producer.join();
+	CHECK(ordered);
+	CHECK(queue.isEmpty());
+}
+
+TEST(InputReplay) {
+	InputRecording recording;
+	createRecording(recording);
+	CHECK_NEAR(1.5, recording.getDuration(), 0.0001);
+
+	//The moves before the button is pressed become one, with the offset from the first position.
+	//The moves while it is held are also drags
+	std::string expected = "pressed 65;char a;released 65;typed 65;enter;"
+			"moved 20 30 0 0;"
+			"mousePressed 0;moved 30 35 10 5;dragged 10 5;mouseReleased 0;mouseClicked 0;"
+			"moved 40 35 10 0;scroll -3;";
+	CHECK_EQUAL(expected, replay(recording, true));
+	CHECK(! Mouse::leftButtonDown);
+
+	//Without coalescing every move is dispatched
+	expected = "pressed 65;char a;released 65;typed 65;enter;"
+			"moved 10 10 0 0;moved 12 15 2 5;moved 20 30 8 15;"
+			"mousePressed 0;moved 25 30 5 0;dragged 5 0;moved 30 35 5 5;dragged 5 5;mouseReleased 0;mouseClicked 0;"
+			"moved 40 35 10 0;scroll -3;";
+	CHECK_EQUAL(expected, replay(recording, false));
+}
+
+TEST(InputRecordingSaveAndLoad) {
+	//Recording the replay gives back the same events
+	InputRecording recording;
+	createRecording(recording);
+	InputRecording recorded;
+	InputManager::startRecording(&recorded);
+	replay(recording, true);
+	InputManager::stopRecording();
+	CHECK_EQUAL(recording.getNumEvents(), recorded.getNumEvents());
+
+	std::string path = std::string(TEST_OUTPUT_PATH) + "InputTest.recording";
+	CHECK(recorded.save(path));
+	InputRecording loaded;
+	CHECK(loaded.load(path));
+	CHECK_EQUAL(recording.getNumEvents(), loaded.getNumEvents());
+	CHECK_EQUAL(replay(recording, true), replay(loaded, true));
+
+	//Anything else is refused
+	CHECK(! loaded.load(std::string(TEST_OUTPUT_PATH) + "InputTest.missing"));
+	std::string invalidPath = std::string(TEST_OUTPUT_PATH) + "InputTest.invalid";
+	FILE* file = fopen(invalidPath.c_str(), "wb");
+	fputs("Not a recording", file);
+	fclose(file);
+	CHECK(! loaded.load(invalidPath));
+
+	//As are recordings with more events than the file holds, without allocating space for them
+	std::vector<char> bytes;
+	file = fopen(path.c_str(), "rb");
+	for (int byte = fgetc(file); byte != EOF; byte = fgetc(file))
+		bytes.push_back((char) byte);
+	fclose(file);
+	unsigned int counts[2] = { 0xFFFFFFFF, recording.getNumEvents() + 1 };
+	for (unsigned int a = 0; a < 2; a++) {
+		memcpy(&bytes[2 * sizeof(unsigned int)], &counts[a], sizeof(unsigned int));
+		file = fopen(invalidPath.c_str(), "wb");
+		fwrite(&bytes.front(), 1, bytes.size(), file);
+		fclose(file);
+		CHECK(! loaded.load(invalidPath));
+		CHECK_EQUAL(0u, loaded.getNumEvents());
+	}
+}
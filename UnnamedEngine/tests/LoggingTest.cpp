@@ -0,0 +1,102 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <fstream>
+#include <cstring>
+
+#include "Test.h"
+#include "utils/Logging.h"
+
+/* A log read back from the binary output */
+struct LoggedMessage {
+	int type;
+	double time;
+	std::string message;
+};
+
+static std::vector<LoggedMessage> readBinaryLogs(const std::string& path) {
+	std::vector<LoggedMessage> logs;
+	std::ifstream input(path.c_str(), std::ios::in | std::ios::binary);
+	LoggedMessage log;
+	unsigned int length;
+	while (input.read((char*) &log.type, sizeof(log.type)) && input.read((char*) &log.time, sizeof(log.time)) && input.read((char*) &length, sizeof(length))) {
+		log.message.resize(length);
+		if (length > 0 && ! input.read(&log.message[0], length))
+			break;
+		logs.push_back(log);
+	}
+	return logs;
+}
+
+/* Logs written through the queue come out whole and in order, long ones are split across records
+ * and joined back together, and those longer than the whole queue are cut short */
+TEST(LoggingQueue) {
+	std::string path = std::string(TEST_OUTPUT_PATH) + "LoggingTest.bin";
+	bool consoleOutput = Logger::getConsoleOutput();
+	Logger::setConsoleOutput(false);
+	CHECK(Logger::setBinaryOutput(path));
+	//The tests turn every log off
+	LOGGER_INFORMATION_ENABLED = true;
+	LOGGER_WARNING_ENABLED = true;
+	LOGGER_ERROR_ENABLED = true;
+
+	//The queue holds 16 records, each a few hundred bytes
+	Logger::start(16);
+	CHECK(Logger::isStarted());
+	std::string longMessage;
+	for (unsigned int a = 0; a < 1000; a++)
+		longMessage += (char) ('a' + a % 26);
+	std::string tooLong(100000, 'x');
+	logInformation("First");
+	logWarning(longMessage);
+	//The queue has to be empty for a message filling all of it
+	Logger::stop();
+	Logger::start(16);
+	logError(tooLong);
+	Logger::stop();
+
+	//Disabled logs aren't written at all. Stopping writes out the queue and flushes the output
+	Logger::start(16);
+	LOGGER_DEBUG_ENABLED = false;
+	logDebug("Hidden");
+	LOGGER_DEBUG_ENABLED = true;
+	logDebug("Last");
+	Logger::stop();
+	CHECK(! Logger::isStarted());
+
+	LOGGER_INFORMATION_ENABLED = false;
+	LOGGER_WARNING_ENABLED = false;
+	LOGGER_ERROR_ENABLED = false;
+	LOGGER_DEBUG_ENABLED = false;
+	Logger::setConsoleOutput(consoleOutput);
+	std::vector<LoggedMessage> logs = readBinaryLogs(path);
+	CHECK_EQUAL(4u, logs.size());
+	if (logs.size() == 4) {
+		CHECK_EQUAL((int) LOG_INFORMATION, logs[0].type);
+		CHECK_EQUAL(std::string("First"), logs[0].message);
+		CHECK_EQUAL((int) LOG_WARNING, logs[1].type);
+		CHECK_EQUAL(longMessage, logs[1].message);
+		CHECK(logs[0].time <= logs[1].time);
+		CHECK_EQUAL((int) LOG_ERROR, logs[2].type);
+		CHECK(logs[2].message.size() < tooLong.size());
+		CHECK_EQUAL(tooLong.substr(0, 100), logs[2].message.substr(0, 100));
+		CHECK_EQUAL(std::string(LOGGER_TRUNCATED), logs[2].message.substr(logs[2].message.size() - strlen(LOGGER_TRUNCATED)));
+		CHECK_EQUAL(std::string("Last"), logs[3].message);
+	}
+	CHECK_EQUAL(0u, Logger::getNumDropped());
+}
@@ -0,0 +1,110 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include "Test.h"
+#include "core/Memory.h"
+
+/* Allocations are aligned, and the blocks added when the arena fills up are merged on reset */
+TEST(MemoryArenaGrowth) {
+	long long liveBytes = Memory::getLiveBytes(MEMORY_GENERAL);
+	MemoryArena arena(1024, MEMORY_GENERAL);
+
+	arena.allocate(1, 1);
+	void* aligned = arena.allocate(8, 64);
+	CHECK_EQUAL((uintptr_t) 0, reinterpret_cast<uintptr_t>(aligned) % 64);
+	double* values = arena.allocateArray<double>(3);
+	CHECK_EQUAL((uintptr_t) 0, reinterpret_cast<uintptr_t>(values) % alignof(double));
+	CHECK_EQUAL(1u, arena.getNumBlocks());
+
+	//Larger than a block, so one is added that fits it
+	arena.allocate(4000);
+	CHECK_EQUAL(2u, arena.getNumBlocks());
+	for (unsigned int a = 0; a < 100; a++)
+		arena.allocate(100);
+	CHECK(arena.getNumBlocks() > 2);
+	size_t capacity = arena.getCapacity();
+	CHECK(arena.getUsed() <= capacity);
+	CHECK_EQUAL(104u, arena.getNumAllocations());
+
+	//Afterwards the same work fits into a single block without any more being added
+	arena.reset();
+	CHECK_EQUAL(1u, arena.getNumBlocks());
+	CHECK_EQUAL((size_t) 0, arena.getUsed());
+	CHECK_EQUAL(0u, arena.getNumAllocations());
+	CHECK_EQUAL(capacity, arena.getCapacity());
+	arena.allocate(1, 1);
+	arena.allocate(8, 64);
+	arena.allocateArray<double>(3);
+	arena.allocate(4000);
+	for (unsigned int a = 0; a < 100; a++)
+		arena.allocate(100);
+	CHECK_EQUAL(1u, arena.getNumBlocks());
+	CHECK_EQUAL((long long) capacity, Memory::getLiveBytes(MEMORY_GENERAL) - liveBytes);
+}
+
+/* Freed elements are reused before the pool grows, and other sizes come from the heap */
+TEST(MemoryPoolReuse) {
+	MemoryPool pool(24, 4, MEMORY_GENERAL);
+	CHECK_EQUAL((size_t) 0, pool.getElementSize() % alignof(std::max_align_t));
+
+	std::vector<void*> elements;
+	for (unsigned int a = 0; a < 6; a++)
+		elements.push_back(pool.allocate());
+	CHECK_EQUAL(6u, pool.getNumAllocated());
+	CHECK_EQUAL(2 * 4 * pool.getElementSize(), pool.getCapacity());
+	for (unsigned int a = 0; a < elements.size(); a++) {
+		CHECK_EQUAL((uintptr_t) 0, reinterpret_cast<uintptr_t>(elements[a]) % alignof(std::max_align_t));
+		for (unsigned int b = 0; b < a; b++)
+			CHECK(elements[a] != elements[b]);
+	}
+
+	//The last one freed is the first one reused
+	pool.free(elements[2]);
+	pool.free(elements[4]);
+	CHECK_EQUAL(4u, pool.getNumAllocated());
+	CHECK(pool.allocate() == elements[4]);
+	CHECK(pool.allocate() == elements[2]);
+	pool.allocate();
+	pool.allocate();
+	CHECK_EQUAL(2 * 4 * pool.getElementSize(), pool.getCapacity());
+	pool.allocate();
+	CHECK_EQUAL(3 * 4 * pool.getElementSize(), pool.getCapacity());
+
+	long long liveAllocations = Memory::getLiveAllocations(MEMORY_GENERAL);
+	void* other = pool.allocate(100);
+	CHECK_EQUAL(9u, pool.getNumAllocated());
+	CHECK_EQUAL(liveAllocations + 1, Memory::getLiveAllocations(MEMORY_GENERAL));
+	pool.free(other, 100);
+	CHECK_EQUAL(liveAllocations, Memory::getLiveAllocations(MEMORY_GENERAL));
+}
+
+/* Containers using the frame arena take their memory from it */
+TEST(MemoryFrameVector) {
+	Memory::nextFrame();
+	MemoryArena* arena = Memory::getFrameArena();
+	size_t used = arena->getUsed();
+	{
+		FrameVector<int> values;
+		for (int a = 0; a < 1000; a++)
+			values.push_back(a);
+		CHECK_EQUAL(999, values.back());
+		CHECK(arena->getUsed() >= used + 1000 * sizeof(int));
+	}
+	Memory::nextFrame();
+	CHECK_EQUAL((size_t) 0, arena->getUsed());
+}
@@ -0,0 +1,218 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <cmath>
+#include <algorithm>
+#include <random>
+#include <set>
+
+#include "Test.h"
+#include "core/Mesh.h"
+#include "core/Matrix.h"
+#include "core/render/Meshlets.h"
+
+/* Creates a sphere with its triangles wound anticlockwise when seen from outside */
+static MeshData* createSphere(unsigned int rings, unsigned int segments, bool indexed) {
+	MeshData* data = new MeshData(true, true, true, true);
+	std::vector<Vector3f> points;
+	for (unsigned int y = 0; y <= rings; y++) {
+		float latitude = (float) y / rings * 3.14159265f;
+		for (unsigned int x = 0; x <= segments; x++) {
+			float longitude = (float) x / segments * 2.0f * 3.14159265f;
+			points.push_back(Vector3f(sinf(latitude) * cosf(longitude), cosf(latitude), sinf(latitude) * sinf(longitude)) * 10.0f);
+		}
+	}
+	if (indexed) {
+		for (unsigned int a = 0; a < points.size(); a++)
+			data->addPosition(points[a]);
+	}
+	for (unsigned int y = 0; y < rings; y++) {
+		for (unsigned int x = 0; x < segments; x++) {
+			unsigned int corner = y * (segments + 1) + x;
+			unsigned int quad[6] = { corner, corner + 1, corner + segments + 1, corner + 1, corner + segments + 2, corner + segments + 1 };
+			for (unsigned int a = 0; a < 6; a++) {
+				if (indexed)
+					data->addIndex(quad[a]);
+				else
+					data->addPosition(points[quad[a]]);
+			}
+		}
+	}
+	return data;
+}
+
+/* Returns the position of one of the vertices of a triangle */
+static const float* getVertex(MeshData* data, unsigned int triangle, unsigned int vertex) {
+	return data->getValues(MeshBuffers::ATTRIBUTE_POSITION, data->hasIndices() ? data->getIndices()[triangle * 3 + vertex] : triangle * 3 + vertex);
+}
+
+/* Returns the positions of every triangle, with each one's vertices rotated so the smallest is
+ * first, sorted so meshes can be compared regardless of the order of their triangles */
+static std::vector<std::vector<float> > getTriangles(MeshData* data) {
+	std::vector<std::vector<float> > triangles;
+	for (unsigned int a = 0; a < data->getNumTriangles(); a++) {
+		std::vector<float> triangle;
+		for (unsigned int b = 0; b < 3; b++)
+			triangle.insert(triangle.end(), getVertex(data, a, b), getVertex(data, a, b) + 3);
+		std::vector<float> rotated = triangle;
+		for (unsigned int b = 1; b < 3; b++) {
+			std::vector<float> next(triangle.begin() + b * 3, triangle.end());
+			next.insert(next.end(), triangle.begin(), triangle.begin() + b * 3);
+			rotated = std::min(rotated, next);
+		}
+		triangles.push_back(rotated);
+	}
+	std::sort(triangles.begin(), triangles.end());
+	return triangles;
+}
+
+/* Checks every triangle is in exactly one meshlet, that the meshlets stay within the limits and
+ * their spheres contain their vertices */
+static void checkMeshlets(MeshData* data) {
+	std::vector<Meshlet>& meshlets = data->getMeshlets();
+	CHECK(! meshlets.empty());
+	unsigned int next = 0;
+	for (unsigned int a = 0; a < meshlets.size(); a++) {
+		const Meshlet& meshlet = meshlets[a];
+		CHECK_EQUAL(next, meshlet.firstTriangle);
+		CHECK(meshlet.numTriangles > 0);
+		CHECK(meshlet.numTriangles <= Meshlets::MAX_TRIANGLES);
+		next += meshlet.numTriangles;
+
+		std::set<unsigned int> vertices;
+		for (unsigned int b = meshlet.firstTriangle; b < meshlet.firstTriangle + meshlet.numTriangles; b++) {
+			for (unsigned int c = 0; c < 3; c++) {
+				if (data->hasIndices())
+					vertices.insert(data->getIndices()[b * 3 + c]);
+				const float* p = getVertex(data, b, c);
+				float x = p[0] - meshlet.centre[0];
+				float y = p[1] - meshlet.centre[1];
+				float z = p[2] - meshlet.centre[2];
+				CHECK(sqrtf(x * x + y * y + z * z) <= meshlet.radius * 1.0001f);
+			}
+		}
+		CHECK(vertices.size() <= Meshlets::MAX_VERTICES);
+	}
+	CHECK_EQUAL(data->getNumTriangles(), next);
+}
+
+/* Checks that no meshlet with a triangle facing the camera is culled, from cameras all around the
+ * mesh, and returns the number of meshlets culled */
+static unsigned int checkCones(MeshData* data, std::mt19937& random) {
+	std::uniform_real_distribution<float> positions(-40.0f, 40.0f);
+	std::vector<Meshlet>& meshlets = data->getMeshlets();
+	Meshlets::View view;
+	//Planes every point is in front of, so only the cones are tested
+	for (unsigned int a = 0; a < 6; a++) {
+		view.planes[a][0] = 0;
+		view.planes[a][1] = 0;
+		view.planes[a][2] = 0;
+		view.planes[a][3] = 1;
+	}
+	view.cullBackFaces = true;
+	unsigned int numCulled = 0;
+	for (unsigned int a = 0; a < 200; a++) {
+		for (unsigned int b = 0; b < 3; b++)
+			view.cameraPosition[b] = positions(random);
+		for (unsigned int b = 0; b < meshlets.size(); b++) {
+			if (Meshlets::isVisible(meshlets[b], view))
+				continue;
+			numCulled++;
+			for (unsigned int c = meshlets[b].firstTriangle; c < meshlets[b].firstTriangle + meshlets[b].numTriangles; c++) {
+				const float* v0 = getVertex(data, c, 0);
+				const float* v1 = getVertex(data, c, 1);
+				const float* v2 = getVertex(data, c, 2);
+				float e1[3] = { v1[0] - v0[0], v1[1] - v0[1], v1[2] - v0[2] };
+				float e2[3] = { v2[0] - v0[0], v2[1] - v0[1], v2[2] - v0[2] };
+				float n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+				float facing = n[0] * (view.cameraPosition[0] - v0[0]) + n[1] * (view.cameraPosition[1] - v0[1]) + n[2] * (view.cameraPosition[2] - v0[2]);
+				CHECK(facing <= 0);
+			}
+		}
+	}
+	return numCulled;
+}
+
+TEST(MeshletsIndexed) {
+	MeshData* data = createSphere(48, 96, true);
+	std::vector<std::vector<float> > triangles = getTriangles(data);
+	Meshlets::build(data);
+	checkMeshlets(data);
+	//The triangles are only reordered
+	CHECK(getTriangles(data) == triangles);
+	//Neighbouring triangles share most of their vertices, so meshlets are mostly limited by them
+	CHECK(data->getMeshlets().size() < data->getNumTriangles() / 40);
+
+	std::mt19937 random(1);
+	CHECK(checkCones(data, random) > 0);
+	delete data;
+}
+
+TEST(MeshletsNotIndexed) {
+	MeshData* data = createSphere(32, 64, false);
+	std::vector<std::vector<float> > triangles = getTriangles(data);
+	Meshlets::build(data);
+	checkMeshlets(data);
+	CHECK(getTriangles(data) == triangles);
+
+	std::mt19937 random(2);
+	CHECK(checkCones(data, random) > 0);
+	delete data;
+}
+
+TEST(MeshletsCull) {
+	MeshData* data = createSphere(48, 96, true);
+	Meshlets::build(data);
+	std::vector<Meshlet>& meshlets = data->getMeshlets();
+
+	//Looking at the whole sphere from outside, the back half is culled by the cones
+	Matrix4f projection = Matrix4f().initPerspective(90.0f, 1.0f, 1.0f, 100.0f);
+	Matrix4f view = Matrix4f().initTranslation(Vector3f(0.0f, 0.0f, -50.0f));
+	Matrix4f identity = Matrix4f().initIdentity();
+	Meshlets::View meshletView;
+	Meshlets::setupView(meshletView, projection * view, identity, Vector3f(0.0f, 0.0f, 50.0f), true);
+	CHECK(meshletView.cullBackFaces);
+	std::vector<MeshletRange> ranges;
+	unsigned int numTriangles = Meshlets::cull(meshlets, meshletView, ranges);
+	CHECK(numTriangles > 0);
+	CHECK(numTriangles < data->getNumTriangles() * 3 / 4);
+	unsigned int total = 0;
+	for (unsigned int a = 0; a < ranges.size(); a++) {
+		total += ranges[a].numTriangles;
+		//Ranges next to each other are joined
+		if (a > 0)
+			CHECK(ranges[a - 1].firstTriangle + ranges[a - 1].numTriangles < ranges[a].firstTriangle);
+	}
+	CHECK_EQUAL(numTriangles, total);
+
+	//Nothing is culled by the cones when asked not to, or when the model is mirrored
+	ranges.clear();
+	Meshlets::setupView(meshletView, projection * view, identity, Vector3f(0.0f, 0.0f, 50.0f), false);
+	CHECK_EQUAL(data->getNumTriangles(), Meshlets::cull(meshlets, meshletView, ranges));
+	CHECK_EQUAL(1u, ranges.size());
+	Meshlets::setupView(meshletView, projection * view, Matrix4f().initScale(Vector3f(-1.0f, 1.0f, 1.0f)), Vector3f(0.0f, 0.0f, 50.0f), true);
+	CHECK(! meshletView.cullBackFaces);
+
+	//Looking away from the sphere culls everything
+	ranges.clear();
+	view = Matrix4f().initTranslation(Vector3f(0.0f, 0.0f, 50.0f));
+	Meshlets::setupView(meshletView, projection * view, identity, Vector3f(0.0f, 0.0f, -50.0f), false);
+	CHECK_EQUAL(0u, Meshlets::cull(meshlets, meshletView, ranges));
+	CHECK(ranges.empty());
+	delete data;
+}
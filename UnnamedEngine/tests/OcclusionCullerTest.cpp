@@ -0,0 +1,128 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include "Test.h"
+#include "core/Mesh.h"
+#include "core/Matrix.h"
+#include "core/render/OcclusionCuller.h"
+
+/* Creates a square facing along the z axis, wound either way */
+static MeshData* createWall(float size, bool clockwise) {
+	MeshData* data = new MeshData(true, true, true, true);
+	data->addPosition(Vector3f(-size, -size, 0.0f));
+	data->addPosition(Vector3f(size, -size, 0.0f));
+	data->addPosition(Vector3f(size, size, 0.0f));
+	data->addPosition(Vector3f(-size, size, 0.0f));
+	unsigned int indices[6] = { 0, 1, 2, 2, 3, 0 };
+	for (unsigned int a = 0; a < 6; a++)
+		data->addIndex(indices[clockwise ? 5 - a : a]);
+	return data;
+}
+
+static OcclusionQuery createQuery(Vector3f min, Vector3f max) {
+	OcclusionQuery query;
+	query.min = min;
+	query.max = max;
+	query.visible = false;
+	return query;
+}
+
+/* Tests boxes around a wall 10 units in front of a camera at the origin looking along -z */
+static void checkWall(OcclusionCuller& culler, bool clockwise) {
+	MeshData* wall = createWall(5.0f, clockwise);
+	culler.begin(Matrix4f().initPerspective(90.0f, 1.0f, 1.0f, 100.0f));
+	culler.addOccluder(wall, Matrix4f().initTranslation(Vector3f(0.0f, 0.0f, -10.0f)));
+	CHECK_EQUAL(2u, culler.getNumTriangles());
+	culler.rasterise();
+
+	std::vector<OcclusionQuery> queries;
+	//Hidden behind the wall
+	queries.push_back(createQuery(Vector3f(-1.0f, -1.0f, -20.0f), Vector3f(1.0f, 1.0f, -18.0f)));
+	//In front of the wall
+	queries.push_back(createQuery(Vector3f(-1.0f, -1.0f, -6.0f), Vector3f(1.0f, 1.0f, -5.0f)));
+	//Behind the wall but reaching past its edge
+	queries.push_back(createQuery(Vector3f(2.0f, -1.0f, -20.0f), Vector3f(20.0f, 1.0f, -18.0f)));
+	//Going through the wall
+	queries.push_back(createQuery(Vector3f(-1.0f, -1.0f, -12.0f), Vector3f(1.0f, 1.0f, -8.0f)));
+	//Crossing the near plane
+	queries.push_back(createQuery(Vector3f(-1.0f, -1.0f, -20.0f), Vector3f(1.0f, 1.0f, 1.0f)));
+	//Behind the camera, which is left to the frustum to cull
+	queries.push_back(createQuery(Vector3f(-1.0f, -1.0f, 18.0f), Vector3f(1.0f, 1.0f, 20.0f)));
+	//Many boxes hidden behind the wall, enough to be split between the threads
+	for (unsigned int a = 0; a < 200; a++) {
+		float x = (a % 20) * 0.3f - 3.0f;
+		float y = (a / 20) * 0.6f - 3.0f;
+		queries.push_back(createQuery(Vector3f(x, y, -30.0f), Vector3f(x + 0.2f, y + 0.2f, -25.0f)));
+	}
+	culler.test(queries);
+
+	CHECK(! queries[0].visible);
+	CHECK(queries[1].visible);
+	CHECK(queries[2].visible);
+	CHECK(queries[3].visible);
+	CHECK(queries[4].visible);
+	CHECK(queries[5].visible);
+	unsigned int numHidden = 0;
+	for (unsigned int a = 6; a < queries.size(); a++) {
+		if (! queries[a].visible)
+			numHidden++;
+	}
+	CHECK_EQUAL(200u, numHidden);
+	CHECK_EQUAL(queries.size(), culler.getNumTested());
+	CHECK_EQUAL(201u, culler.getNumRejected());
+
+	//The centre of the screen is covered by the wall and the corners aren't
+	const std::vector<float>& depth = culler.getDepth();
+	unsigned int width = culler.getWidth();
+	unsigned int height = culler.getHeight();
+	CHECK(depth[(height / 2) * width + width / 2] < 1.0f);
+	CHECK_EQUAL(1.0f, depth[0]);
+	CHECK_EQUAL(1.0f, depth[depth.size() - 1]);
+	delete wall;
+}
+
+TEST(OcclusionCullerWall) {
+	OcclusionCuller culler(256, 128, 0);
+	checkWall(culler, false);
+	//Both sides of a triangle hide what is behind it
+	checkWall(culler, true);
+}
+
+TEST(OcclusionCullerThreaded) {
+	OcclusionCuller culler(256, 128, 3);
+	CHECK_EQUAL(3u, culler.getNumThreads());
+	checkWall(culler, false);
+}
+
+TEST(OcclusionCullerNoOccluders) {
+	OcclusionCuller culler(64, 64, 0);
+	culler.begin(Matrix4f().initPerspective(90.0f, 1.0f, 1.0f, 100.0f));
+	culler.rasterise();
+	std::vector<OcclusionQuery> queries;
+	queries.push_back(createQuery(Vector3f(-1.0f, -1.0f, -20.0f), Vector3f(1.0f, 1.0f, -18.0f)));
+	culler.test(queries);
+	CHECK(queries[0].visible);
+	CHECK_EQUAL(0u, culler.getNumRejected());
+
+	//Occluders crossing the near plane are left out
+	MeshData* wall = createWall(5.0f, false);
+	culler.begin(Matrix4f().initPerspective(90.0f, 1.0f, 1.0f, 100.0f));
+	culler.addOccluder(wall, Matrix4f().initRotation(90.0f, 1, 0, 0));
+	CHECK_EQUAL(0u, culler.getNumTriangles());
+	delete wall;
+}
@@ -0,0 +1,166 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <fstream>
+#include <sstream>
+
+#include "Test.h"
+#include "core/Profiler.h"
+
+static void profilerTest_inner() {
+	PROFILE_SCOPE("ProfilerTest Inner");
+}
+
+static void profilerTest_outer() {
+	PROFILE_SCOPE("ProfilerTest Outer");
+	profilerTest_inner();
+	profilerTest_inner();
+}
+
+/* Returns the events with a name in a frame */
+static std::vector<ProfilerEvent> getEvents(ProfilerFrame& frame, const std::string& name) {
+	std::vector<ProfilerEvent> events;
+	for (unsigned int a = 0; a < frame.events.size(); a++) {
+		if (name == frame.events[a].name)
+			events.push_back(frame.events[a]);
+	}
+	return events;
+}
+
+/* Nested scopes are recorded with their depth within the frame they happened in */
+TEST(ProfilerScopes) {
+	Profiler::setHistorySize(3);
+	//Start a frame, collecting anything left from other tests into the one before
+	Profiler::nextFrame();
+	Profiler::nextFrame();
+	Profiler::clear();
+
+	profilerTest_outer();
+	Profiler::nextFrame();
+	CHECK_EQUAL(1u, Profiler::getNumFrames());
+	ProfilerFrame& frame = Profiler::getFrameAt(0);
+	std::vector<ProfilerEvent> outer = getEvents(frame, "ProfilerTest Outer");
+	std::vector<ProfilerEvent> inner = getEvents(frame, "ProfilerTest Inner");
+	CHECK_EQUAL(1u, outer.size());
+	CHECK_EQUAL(2u, inner.size());
+	if (outer.size() == 1 && inner.size() == 2) {
+		CHECK_EQUAL(inner[0].depth, outer[0].depth + 1);
+		CHECK_EQUAL(outer[0].thread, inner[0].thread);
+		CHECK(outer[0].thread != 0);
+		CHECK(frame.start <= outer[0].start && outer[0].end <= frame.end);
+		for (unsigned int a = 0; a < 2; a++)
+			CHECK(outer[0].start <= inner[a].start && inner[a].end <= outer[0].end && inner[a].start <= inner[a].end);
+		CHECK(inner[0].end <= inner[1].start);
+		CHECK_EQUAL(inner[0].end - inner[0].start + inner[1].end - inner[1].start, Profiler::getLastFrameTime("ProfilerTest Inner"));
+	}
+	CHECK_EQUAL(0LL, Profiler::getLastFrameTime("ProfilerTest Missing"));
+
+	//Only the most recent frames are kept, oldest first
+	unsigned long long number = frame.number;
+	for (unsigned int a = 0; a < 4; a++)
+		Profiler::nextFrame();
+	CHECK_EQUAL(3u, Profiler::getNumFrames());
+	CHECK_EQUAL(number + 2, Profiler::getFrameAt(0).number);
+	CHECK_EQUAL(number + 4, Profiler::getFrameAt(2).number);
+
+	//Nothing is recorded while disabled
+	Profiler::setEnabled(false);
+	profilerTest_outer();
+	Profiler::setEnabled(true);
+	Profiler::nextFrame();
+	CHECK_EQUAL(0LL, Profiler::getLastFrameTime("ProfilerTest Outer"));
+	CHECK_EQUAL(0u, getEvents(Profiler::getFrameAt(2), "ProfilerTest Inner").size());
+
+	Profiler::setHistorySize(300);
+}
+
+/* The trace has an event for every scope */
+TEST(ProfilerChromeTrace) {
+	Profiler::setHistorySize(2);
+	Profiler::nextFrame();
+	Profiler::clear();
+	profilerTest_outer();
+	Profiler::nextFrame();
+	profilerTest_inner();
+	Profiler::nextFrame();
+
+	std::string path = std::string(TEST_OUTPUT_PATH) + "ProfilerTest.json";
+	CHECK(Profiler::exportChromeTrace(path));
+	std::ifstream input(path.c_str());
+	std::stringstream contents;
+	contents << input.rdbuf();
+	std::string trace = contents.str();
+	CHECK_EQUAL(0u, trace.find("{\"traceEvents\":["));
+	unsigned int numInner = 0;
+	size_t position = 0;
+	while ((position = trace.find("\"ProfilerTest Inner\"", position)) != std::string::npos) {
+		numInner++;
+		position++;
+	}
+	CHECK_EQUAL(3u, numInner);
+	CHECK(trace.find("\"ProfilerTest Outer\"") != std::string::npos);
+	CHECK_EQUAL(trace.size() - 3, trace.rfind("]}"));
+
+	Profiler::setHistorySize(300);
+}
+
+/* Frames with more events than the ring holds keep every event, in order */
+TEST(ProfilerOverflow) {
+	Profiler::setHistorySize(2);
+	Profiler::nextFrame();
+	Profiler::clear();
+	{
+		PROFILE_SCOPE("ProfilerTest Outer");
+		for (unsigned int a = 0; a < 20000; a++)
+			profilerTest_inner();
+	}
+	Profiler::nextFrame();
+	ProfilerFrame& frame = Profiler::getFrameAt(0);
+	CHECK_EQUAL(20000u, getEvents(frame, "ProfilerTest Inner").size());
+	CHECK_EQUAL(1u, getEvents(frame, "ProfilerTest Outer").size());
+	CHECK_EQUAL(0u, frame.dropped);
+	bool ordered = true;
+	for (unsigned int a = 1; a < frame.events.size(); a++)
+		ordered = ordered && frame.events[a - 1].end <= frame.events[a].end;
+	CHECK(ordered);
+
+	//Once the overflow is full the newest events are dropped and counted
+	ProfilerThreadBuffer buffer(1, 4, 8);
+	ProfilerEvent event;
+	event.name = "ProfilerTest Event";
+	event.depth = 0;
+	event.thread = 1;
+	for (unsigned int a = 0; a < 20; a++) {
+		event.start = a;
+		event.end = a;
+		buffer.add(event);
+	}
+	std::vector<ProfilerEvent> events;
+	CHECK_EQUAL(8u, buffer.collect(events));
+	CHECK_EQUAL(12u, events.size());
+	for (unsigned int a = 0; a < events.size(); a++)
+		CHECK_EQUAL((long long) a, events[a].start);
+
+	//Everything is stored again after being collected
+	buffer.add(event);
+	events.clear();
+	CHECK_EQUAL(0u, buffer.collect(events));
+	CHECK_EQUAL(1u, events.size());
+
+	Profiler::setHistorySize(300);
+}
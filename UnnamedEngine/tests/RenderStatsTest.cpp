@@ -0,0 +1,75 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include "Test.h"
+#include "core/render/RenderStats.h"
+
+/* Draws are split by type, and buffer uploads only count when data is given */
+TEST(RenderStatsCounts) {
+	RenderStats::nextFrame();
+	RenderStats::addDraw(true, 300);
+	RenderStats::addDraw(false, 3);
+	RenderStats::addMultiDraw(true, 25, 600);
+	RenderStats::bufferData(GL_ARRAY_BUFFER, 1024, NULL, GL_STREAM_DRAW);
+	char data[64];
+	RenderStats::bufferData(GL_ARRAY_BUFFER, 64, data, GL_STREAM_DRAW);
+	RenderStats::bufferSubData(GL_ARRAY_BUFFER, 0, 32, data);
+	RenderStats::increment(RENDER_STAT_SHADER_SWITCHES);
+	RenderStats::add(RENDER_STAT_UNIFORM_UPLOADS, 5);
+
+	CHECK_EQUAL(3ULL, RenderStats::getCurrent(RENDER_STAT_DRAW_CALLS));
+	CHECK_EQUAL(2ULL, RenderStats::getCurrent(RENDER_STAT_INDEXED_DRAW_CALLS));
+	CHECK_EQUAL(1ULL, RenderStats::getCurrent(RENDER_STAT_ARRAY_DRAW_CALLS));
+	CHECK_EQUAL(301ULL, RenderStats::getCurrent(RENDER_STAT_PRIMITIVES));
+	CHECK_EQUAL(25ULL, RenderStats::getCurrent(RENDER_STAT_INDIRECT_COMMANDS));
+	CHECK_EQUAL(96ULL, RenderStats::getCurrent(RENDER_STAT_BUFFER_BYTES));
+	CHECK_EQUAL(1ULL, RenderStats::getCurrent(RENDER_STAT_SHADER_SWITCHES));
+	CHECK_EQUAL(5ULL, RenderStats::getCurrent(RENDER_STAT_UNIFORM_UPLOADS));
+
+	//Ending the frame makes them the last frame's counts and starts again from zero
+	RenderStats::nextFrame();
+	CHECK_EQUAL(3ULL, RenderStats::getLast(RENDER_STAT_DRAW_CALLS));
+	CHECK_EQUAL(0ULL, RenderStats::getCurrent(RENDER_STAT_DRAW_CALLS));
+	CHECK_EQUAL("Draw Calls: 3", RenderStats::toString(RENDER_STAT_DRAW_CALLS).substr(0, 13));
+}
+
+/* The minimum, average and maximum are over the most recent frames in the window */
+TEST(RenderStatsWindow) {
+	unsigned int windowSize = RenderStats::getWindowSize();
+	RenderStats::setWindowSize(4);
+	CHECK_EQUAL(0u, RenderStats::getNumFrames());
+	CHECK_EQUAL(0ULL, RenderStats::getLast(RENDER_STAT_TEXTURE_BINDS));
+	CHECK_EQUAL(0ULL, RenderStats::getMin(RENDER_STAT_TEXTURE_BINDS));
+	CHECK_NEAR(0.0, RenderStats::getAverage(RENDER_STAT_TEXTURE_BINDS), 0.0001);
+
+	//Frames with 1 to 6 binds, so only 3 to 6 are left. Anything counted before the test is
+	//discarded first
+	RenderStats::nextFrame();
+	RenderStats::setWindowSize(4);
+	for (unsigned int a = 1; a <= 6; a++) {
+		RenderStats::add(RENDER_STAT_TEXTURE_BINDS, a);
+		RenderStats::nextFrame();
+	}
+	CHECK_EQUAL(4u, RenderStats::getNumFrames());
+	CHECK_EQUAL(6ULL, RenderStats::getLast(RENDER_STAT_TEXTURE_BINDS));
+	CHECK_EQUAL(3ULL, RenderStats::getMin(RENDER_STAT_TEXTURE_BINDS));
+	CHECK_EQUAL(6ULL, RenderStats::getMax(RENDER_STAT_TEXTURE_BINDS));
+	CHECK_NEAR(4.5, RenderStats::getAverage(RENDER_STAT_TEXTURE_BINDS), 0.0001);
+
+	RenderStats::setWindowSize(windowSize);
+}
@@ -0,0 +1,157 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include "Test.h"
+#include "core/render/SamplerCache.h"
+#include "core/render/Renderer.h"
+
+/* The number of calls made to the OpenGL functions replaced below */
+static unsigned int numGenSamplers;
+static unsigned int numDeleteSamplers;
+static unsigned int numTexParameters;
+static unsigned int numTexParametersF;
+static unsigned int numBindSamplers;
+
+static void APIENTRY countGenSamplers(GLsizei count, GLuint* samplers) {
+	for (GLsizei a = 0; a < count; a++)
+		samplers[a] = ++numGenSamplers;
+}
+
+static void APIENTRY countDeleteSamplers(GLsizei count, const GLuint* samplers) {
+	numDeleteSamplers += count;
+}
+
+static void APIENTRY countTexParameteri(GLenum target, GLenum name, GLint value) {
+	numTexParameters++;
+}
+
+static void APIENTRY countTexParameterf(GLenum target, GLenum name, GLfloat value) {
+	numTexParametersF++;
+}
+
+static void APIENTRY countBindSampler(GLuint unit, GLuint sampler) {
+	numBindSamplers++;
+}
+
+static void setupStubs(bool supported) {
+	glewResetStubs();
+	__GLEW_ARB_sampler_objects = supported ? GL_TRUE : GL_FALSE;
+	__glewGenSamplers = countGenSamplers;
+	__glewDeleteSamplers = countDeleteSamplers;
+	__glewTexParameteri = countTexParameteri;
+	__glewTexParameterf = countTexParameterf;
+	__glewBindSampler = countBindSampler;
+	numGenSamplers = 0;
+	numDeleteSamplers = 0;
+	numTexParameters = 0;
+	numTexParametersF = 0;
+	numBindSamplers = 0;
+}
+
+TEST(SamplerDescriptorOrder) {
+	SamplerDescriptor descriptors[] = {
+		SamplerDescriptor(GL_LINEAR, GL_LINEAR, GL_REPEAT, 0.0f),
+		SamplerDescriptor(GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR, GL_REPEAT, 0.0f),
+		SamplerDescriptor(GL_LINEAR, GL_NEAREST, GL_REPEAT, 0.0f),
+		SamplerDescriptor(GL_LINEAR, GL_LINEAR, GL_CLAMP_TO_EDGE, 0.0f),
+		SamplerDescriptor(GL_LINEAR, GL_LINEAR, GL_REPEAT, GL_REPEAT, GL_CLAMP_TO_EDGE, 0.0f),
+		SamplerDescriptor(GL_LINEAR, GL_LINEAR, GL_REPEAT, 16.0f)
+	};
+	unsigned int numDescriptors = sizeof(descriptors) / sizeof(descriptors[0]);
+	//Every value is part of the order, and descriptors are only equal when neither is before the
+	//other
+	for (unsigned int a = 0; a < numDescriptors; a++) {
+		for (unsigned int b = 0; b < numDescriptors; b++) {
+			CHECK_EQUAL(a == b, descriptors[a] == descriptors[b]);
+			CHECK_EQUAL(a != b, descriptors[a] != descriptors[b]);
+			CHECK_EQUAL(a == b, ! (descriptors[a] < descriptors[b]) && ! (descriptors[b] < descriptors[a]));
+		}
+	}
+	CHECK(SamplerDescriptor(GL_LINEAR, GL_LINEAR, GL_REPEAT, 0.0f) == SamplerDescriptor(GL_LINEAR, GL_LINEAR, GL_REPEAT, GL_REPEAT, GL_REPEAT, 0.0f));
+	CHECK(descriptors[1].usesMipmaps());
+	CHECK(! descriptors[0].usesMipmaps());
+}
+
+TEST(SamplerCacheShares) {
+	setupStubs(true);
+	SamplerCache::destroy();
+	CHECK_EQUAL(0u, SamplerCache::getNumSamplers());
+
+	//The same parameters give the same sampler, only creating it once
+	GLuint a = SamplerCache::getSampler(SamplerDescriptor(GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR, GL_REPEAT, 4.0f));
+	GLuint b = SamplerCache::getSampler(SamplerDescriptor(GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR, GL_REPEAT, 4.0f));
+	CHECK(a != 0);
+	CHECK_EQUAL(a, b);
+	CHECK_EQUAL(1u, numGenSamplers);
+	CHECK_EQUAL(1u, SamplerCache::getNumSamplers());
+
+	//Any difference gives another one
+	GLuint c = SamplerCache::getSampler(SamplerDescriptor(GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR, GL_REPEAT, 8.0f));
+	GLuint d = SamplerCache::getSampler(SamplerDescriptor(GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR, GL_REPEAT, GL_CLAMP_TO_EDGE, GL_REPEAT, 4.0f));
+	CHECK(c != a && d != a && c != d);
+	CHECK_EQUAL(3u, numGenSamplers);
+	CHECK_EQUAL(3u, SamplerCache::getNumSamplers());
+	CHECK_EQUAL(c, SamplerCache::getSampler(SamplerDescriptor(GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR, GL_REPEAT, 8.0f)));
+	CHECK_EQUAL(3u, numGenSamplers);
+
+	SamplerCache::destroy();
+	CHECK_EQUAL(3u, numDeleteSamplers);
+	CHECK_EQUAL(0u, SamplerCache::getNumSamplers());
+	glewResetStubs();
+}
+
+TEST(SamplerCacheUnsupported) {
+	setupStubs(false);
+	SamplerCache::destroy();
+	CHECK_EQUAL(0u, SamplerCache::getSampler(SamplerDescriptor(GL_LINEAR, GL_LINEAR, GL_REPEAT, 0.0f)));
+	CHECK_EQUAL(0u, numGenSamplers);
+	CHECK_EQUAL(0u, SamplerCache::getNumSamplers());
+
+	//The parameters are set on the texture instead, with the third wrap only for cube maps
+	SamplerCache::applyToTexture(SamplerDescriptor(GL_LINEAR, GL_LINEAR, GL_REPEAT, 0.0f), GL_TEXTURE_2D);
+	CHECK_EQUAL(4u, numTexParameters);
+	CHECK_EQUAL(0u, numTexParametersF);
+	SamplerCache::applyToTexture(SamplerDescriptor(GL_LINEAR, GL_LINEAR, GL_REPEAT, 16.0f), GL_TEXTURE_CUBE_MAP);
+	CHECK_EQUAL(9u, numTexParameters);
+	CHECK_EQUAL(1u, numTexParametersF);
+	glewResetStubs();
+}
+
+/* Samplers are only bound when the driver has them, otherwise glBindSampler isn't available */
+TEST(SamplerCacheBinding) {
+	setupStubs(true);
+	SamplerCache::destroy();
+	GLState::reset();
+	Texture* texture = new Texture(1000);
+	Renderer::bindTexture(texture);
+	Renderer::releaseTextures();
+	CHECK_EQUAL(1u, numBindSamplers);
+
+	setupStubs(false);
+	SamplerCache::destroy();
+	GLState::reset();
+	Texture* fallback = new Texture(1001);
+	Renderer::bindTexture(fallback);
+	Renderer::releaseTextures();
+	CHECK_EQUAL(0u, numBindSamplers);
+
+	delete texture;
+	delete fallback;
+	GLState::reset();
+	glewResetStubs();
+}
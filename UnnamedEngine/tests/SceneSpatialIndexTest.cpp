@@ -0,0 +1,212 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <algorithm>
+#include <random>
+
+#include "Test.h"
+#include "core/Vector.h"
+#include "core/Matrix.h"
+#include "core/render/SceneSpatialIndex.h"
+
+/* The index only uses objects as keys, so any distinct addresses can stand in for them */
+static const unsigned int NUM_OBJECTS = 500;
+static char objects[NUM_OBJECTS];
+
+/* The bounds each object was last given, or an empty box when it isn't in the index */
+struct SpatialBounds {
+	Vector3f min;
+	Vector3f max;
+	bool added;
+};
+
+static RenderableObject3D* getObject(unsigned int index) {
+	return (RenderableObject3D*) &objects[index];
+}
+
+/* Returns the objects found by a query sorted, so they can be compared with what is expected */
+static std::vector<RenderableObject3D*> sorted(const FrameVector<RenderableObject3D*>& found) {
+	std::vector<RenderableObject3D*> result(found.begin(), found.end());
+	std::sort(result.begin(), result.end());
+	return result;
+}
+
+static bool overlapsBox(const SpatialBounds& bounds, const Vector3f& min, const Vector3f& max) {
+	for (unsigned int a = 0; a < 3; a++) {
+		if (bounds.max[a] < min[a] || bounds.min[a] > max[a])
+			return false;
+	}
+	return true;
+}
+
+static bool overlapsSphere(const SpatialBounds& bounds, const Vector3f& centre, float radius) {
+	float distance = 0;
+	for (unsigned int a = 0; a < 3; a++) {
+		float closest = std::max(bounds.min[a], std::min(centre[a], bounds.max[a]));
+		distance += (centre[a] - closest) * (centre[a] - closest);
+	}
+	return distance <= radius * radius;
+}
+
+static bool overlapsFrustum(const SpatialBounds& bounds, const float planes[6][4]) {
+	for (unsigned int a = 0; a < 6; a++) {
+		float x = planes[a][0] >= 0 ? bounds.max[0] : bounds.min[0];
+		float y = planes[a][1] >= 0 ? bounds.max[1] : bounds.min[1];
+		float z = planes[a][2] >= 0 ? bounds.max[2] : bounds.min[2];
+		if (planes[a][0] * x + planes[a][1] * y + planes[a][2] * z + planes[a][3] < 0)
+			return false;
+	}
+	return true;
+}
+
+/* Compares queries of random boxes, spheres and frustums with checking the bounds of every
+ * object */
+static void checkQueries(SceneSpatialIndex& index, SpatialBounds bounds[], std::mt19937& random) {
+	std::uniform_real_distribution<float> positions(-60.0f, 60.0f);
+	std::uniform_real_distribution<float> sizes(1.0f, 30.0f);
+	for (unsigned int a = 0; a < 20; a++) {
+		Vector3f min(positions(random), positions(random), positions(random));
+		Vector3f max = min + Vector3f(sizes(random), sizes(random), sizes(random));
+		Vector3f centre(positions(random), positions(random), positions(random));
+		float radius = sizes(random);
+		Matrix4f projection = Matrix4f().initPerspective(110.0f, 1.5f, 1.0f, sizes(random) * 3.0f);
+		Matrix4f view = Matrix4f().initTranslation(Vector3f(positions(random), positions(random), positions(random)));
+		Matrix4f projectionView = projection * view;
+		float planes[6][4];
+		projectionView.getFrustumPlanes(planes);
+
+		FrameVector<RenderableObject3D*> boxFound;
+		FrameVector<RenderableObject3D*> sphereFound;
+		FrameVector<RenderableObject3D*> frustumFound;
+		index.queryBox(min, max, boxFound);
+		index.querySphere(centre, radius, sphereFound);
+		index.queryFrustum(projectionView, frustumFound);
+
+		std::vector<RenderableObject3D*> boxExpected;
+		std::vector<RenderableObject3D*> sphereExpected;
+		std::vector<RenderableObject3D*> frustumExpected;
+		for (unsigned int b = 0; b < NUM_OBJECTS; b++) {
+			if (! bounds[b].added)
+				continue;
+			if (overlapsBox(bounds[b], min, max))
+				boxExpected.push_back(getObject(b));
+			if (overlapsSphere(bounds[b], centre, radius))
+				sphereExpected.push_back(getObject(b));
+			if (overlapsFrustum(bounds[b], planes))
+				frustumExpected.push_back(getObject(b));
+		}
+		CHECK(sorted(boxFound) == boxExpected);
+		CHECK(sorted(sphereFound) == sphereExpected);
+		CHECK(sorted(frustumFound) == frustumExpected);
+	}
+	Memory::nextFrame();
+}
+
+/* Gives an object random bounds */
+static void place(SceneSpatialIndex& index, SpatialBounds bounds[], unsigned int object, std::mt19937& random) {
+	std::uniform_real_distribution<float> positions(-50.0f, 50.0f);
+	std::uniform_real_distribution<float> sizes(0.1f, 5.0f);
+	bounds[object].min = Vector3f(positions(random), positions(random), positions(random));
+	bounds[object].max = bounds[object].min + Vector3f(sizes(random), sizes(random), sizes(random));
+	bounds[object].added = true;
+	index.update(getObject(object), bounds[object].min, bounds[object].max);
+}
+
+TEST(SceneSpatialIndexMatchesBruteForce) {
+	std::mt19937 random(1);
+	std::uniform_real_distribution<float> moves(-0.2f, 0.2f);
+	SceneSpatialIndex index;
+	SpatialBounds bounds[NUM_OBJECTS];
+	for (unsigned int a = 0; a < NUM_OBJECTS; a++) {
+		bounds[a].added = false;
+		place(index, bounds, a, random);
+	}
+	CHECK_EQUAL(NUM_OBJECTS, index.getNumObjects());
+	//The tree is kept balanced, so it stays close to the height of a full binary tree of 500
+	CHECK(index.getHeight() <= 14);
+	checkQueries(index, bounds, random);
+
+	for (unsigned int a = 0; a < 10; a++) {
+		for (unsigned int b = 0; b < NUM_OBJECTS; b++) {
+			unsigned int change = random() % 10;
+			if (change == 0)
+				//Move far enough to leave the enlarged bounds
+				place(index, bounds, b, random);
+			else if (change == 1) {
+				index.remove(getObject(b));
+				bounds[b].added = false;
+			} else if (bounds[b].added) {
+				//Move a small amount, which may stay within the enlarged bounds
+				Vector3f move(moves(random), moves(random), moves(random));
+				bounds[b].min += move;
+				bounds[b].max += move;
+				index.update(getObject(b), bounds[b].min, bounds[b].max);
+			}
+		}
+		unsigned int numAdded = 0;
+		for (unsigned int b = 0; b < NUM_OBJECTS; b++) {
+			CHECK_EQUAL(bounds[b].added, index.contains(getObject(b)));
+			if (bounds[b].added) {
+				Vector3f min;
+				Vector3f max;
+				CHECK(index.getBounds(getObject(b), min, max));
+				for (unsigned int c = 0; c < 3; c++) {
+					CHECK_EQUAL(bounds[b].min[c], min[c]);
+					CHECK_EQUAL(bounds[b].max[c], max[c]);
+				}
+				numAdded++;
+			}
+		}
+		CHECK_EQUAL(numAdded, index.getNumObjects());
+		CHECK(index.getHeight() <= 14);
+		checkQueries(index, bounds, random);
+	}
+
+	index.clear();
+	CHECK_EQUAL(0u, index.getNumObjects());
+	CHECK_EQUAL(0, index.getHeight());
+	FrameVector<RenderableObject3D*> found;
+	index.queryBox(Vector3f(-100.0f, -100.0f, -100.0f), Vector3f(100.0f, 100.0f, 100.0f), found);
+	CHECK(found.empty());
+	Memory::nextFrame();
+}
+
+TEST(SceneSpatialIndexRay) {
+	//A row of boxes along the x axis with gaps between them
+	SceneSpatialIndex index(0.5f);
+	for (unsigned int a = 0; a < 10; a++)
+		index.update(getObject(a), Vector3f(a * 4.0f, 0.0f, 0.0f), Vector3f(a * 4.0f + 1.0f, 1.0f, 1.0f));
+
+	//A ray along the row finds the boxes up to its maximum distance
+	FrameVector<RenderableObject3D*> found;
+	index.queryRay(Vector3f(-1.0f, 0.5f, 0.5f), Vector3f(2.0f, 0.0f, 0.0f), 8.0f, found);
+	CHECK(sorted(found) == std::vector<RenderableObject3D*>({ getObject(0), getObject(1), getObject(2), getObject(3) }));
+
+	//One through a gap finds nothing, even though it is within the enlarged bounds
+	found.clear();
+	index.queryRay(Vector3f(2.5f, 1.2f, 0.5f), Vector3f(0.0f, 0.0f, 1.0f), 100.0f, found);
+	CHECK(found.empty());
+
+	//One going down through a box finds only that one
+	found.clear();
+	index.queryRay(Vector3f(8.5f, 10.0f, 0.5f), Vector3f(0.0f, -1.0f, 0.0f), 100.0f, found);
+	CHECK(sorted(found) == std::vector<RenderableObject3D*>({ getObject(2) }));
+	CHECK(index.overlapsSphere(getObject(2), Vector3f(8.5f, 3.0f, 0.5f), 2.5f));
+	CHECK(! index.overlapsSphere(getObject(2), Vector3f(8.5f, 3.0f, 0.5f), 1.5f));
+	Memory::nextFrame();
+}
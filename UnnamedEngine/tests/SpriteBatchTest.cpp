@@ -0,0 +1,145 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include "Test.h"
+#include "core/render/SpriteBatch.h"
+#include "core/render/Renderer.h"
+
+/* The draws made, and the number of indices given to the last one */
+static unsigned int spriteBatchTest_numDraws = 0;
+static GLsizei spriteBatchTest_numIndices = 0;
+
+static void APIENTRY spriteBatchTest_drawElements(GLenum mode, GLsizei count, GLenum type, const void* indices) {
+	spriteBatchTest_numDraws++;
+	spriteBatchTest_numIndices = count;
+}
+
+/* The batch needs the basic shader, the blank texture and a camera from the Renderer */
+static void setupRenderer() {
+	static bool initialised = false;
+	if (initialised)
+		return;
+	Renderer::initialise();
+	//The stubs can't decode the blank texture
+	if (Renderer::TEXTURE_BLANK == NULL)
+		Renderer::TEXTURE_BLANK = new Texture(1000);
+	Renderer::addCamera(new Camera2D(Matrix4f().initIdentity()));
+	initialised = true;
+}
+
+static MeshData* createQuadData() {
+	MeshData* data = new MeshData();
+	MeshBuilder::addQuadV(data, Vector2f(0, 0), Vector2f(10, 10));
+	MeshBuilder::addQuadI(data);
+	return data;
+}
+
+/* Quads using textures from the same atlas are drawn together, anything else needs a new draw
+ * each time the texture changes */
+TEST(SpriteBatchDrawCounts) {
+	glewResetStubs();
+	setupRenderer();
+	__glewDrawElements = spriteBatchTest_drawElements;
+
+	MeshData* data = createQuadData();
+	Mesh mesh(data, (MeshRenderData*) NULL);
+	//Two areas of one atlas, and another texture
+	Texture atlasA(1);
+	Texture atlasB(1);
+	Texture other(2);
+	Matrix4f modelMatrix = Matrix4f().initIdentity();
+	SpriteBatch* batch = new SpriteBatch();
+
+	spriteBatchTest_numDraws = 0;
+	batch->begin();
+	CHECK(SpriteBatch::isBatching());
+	CHECK(SpriteBatch::getCurrent() == batch);
+	for (unsigned int a = 0; a < 100; a++)
+		batch->addQuad(&mesh, modelMatrix, a % 2 == 0 ? &atlasA : &atlasB, Colour::WHITE);
+	CHECK_EQUAL(0u, spriteBatchTest_numDraws);
+	batch->end();
+	CHECK(! SpriteBatch::isBatching());
+	CHECK_EQUAL(1u, spriteBatchTest_numDraws);
+	CHECK_EQUAL(1u, batch->getNumDraws());
+	CHECK_EQUAL(100u, batch->getNumSprites());
+	CHECK_EQUAL(600, spriteBatchTest_numIndices);
+
+	//Alternating between different textures
+	spriteBatchTest_numDraws = 0;
+	batch->begin();
+	for (unsigned int a = 0; a < 100; a++)
+		batch->addQuad(&mesh, modelMatrix, a % 2 == 0 ? &atlasA : &other, Colour::WHITE);
+	batch->end();
+	CHECK_EQUAL(100u, spriteBatchTest_numDraws);
+	CHECK_EQUAL(100u, batch->getNumDraws());
+
+	//The same quads grouped by texture, with untextured ones using the blank texture
+	spriteBatchTest_numDraws = 0;
+	batch->begin();
+	for (unsigned int a = 0; a < 50; a++)
+		batch->addQuad(&mesh, modelMatrix, &atlasA, Colour::WHITE);
+	for (unsigned int a = 0; a < 50; a++)
+		batch->addQuad(&mesh, modelMatrix, &other, Colour::WHITE);
+	for (unsigned int a = 0; a < 10; a++)
+		batch->addQuad(&mesh, modelMatrix, NULL, Colour::WHITE);
+	batch->flush();
+	CHECK_EQUAL(3u, spriteBatchTest_numDraws);
+	CHECK_EQUAL(60, spriteBatchTest_numIndices);
+	CHECK(SpriteBatch::isBatching());
+
+	//Meshes are added with their own texture, and nothing is drawn for an empty batch
+	mesh.setTexture(&atlasB);
+	batch->add(&mesh, modelMatrix);
+	batch->end();
+	CHECK_EQUAL(4u, spriteBatchTest_numDraws);
+	CHECK_EQUAL(6, spriteBatchTest_numIndices);
+	batch->begin();
+	batch->end();
+	CHECK_EQUAL(4u, spriteBatchTest_numDraws);
+	CHECK_EQUAL(0u, batch->getNumDraws());
+
+	delete batch;
+	delete data;
+	glewResetStubs();
+}
+
+/* Beginning a batch ends the one that was active, drawing what it had */
+TEST(SpriteBatchNesting) {
+	glewResetStubs();
+	setupRenderer();
+	__glewDrawElements = spriteBatchTest_drawElements;
+
+	MeshData* data = createQuadData();
+	Mesh mesh(data, (MeshRenderData*) NULL);
+	Matrix4f modelMatrix = Matrix4f().initIdentity();
+	SpriteBatch* first = new SpriteBatch();
+	SpriteBatch* second = new SpriteBatch();
+
+	spriteBatchTest_numDraws = 0;
+	first->begin();
+	first->addQuad(&mesh, modelMatrix, NULL, Colour::WHITE);
+	second->begin();
+	CHECK_EQUAL(1u, spriteBatchTest_numDraws);
+	CHECK(SpriteBatch::getCurrent() == second);
+	delete second;
+	CHECK(! SpriteBatch::isBatching());
+
+	delete first;
+	delete data;
+	glewResetStubs();
+}
@@ -0,0 +1,88 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <iostream>
+
+#include "Test.h"
+#include "utils/Logging.h"
+
+/***************************************************************************************************
+ * The Test class
+ ***************************************************************************************************/
+
+unsigned int Test::m_numFailures = 0;
+
+std::vector<Test*>& Test::getTests() {
+	//Created when it is first used, as tests are registered while statics are being initialised
+	static std::vector<Test*> tests;
+	return tests;
+}
+
+Test::Test(const char* name, Function function, bool benchmark) {
+	m_name = name;
+	m_function = function;
+	m_benchmark = benchmark;
+	getTests().push_back(this);
+}
+
+void Test::check(bool passed, const std::string& expression, const char* file, int line) {
+	if (! passed) {
+		std::cout << "    " << file << ":" << line << ": check failed: " << expression << std::endl;
+		m_numFailures++;
+	}
+}
+
+void Test::report(const std::string& name, double value, const std::string& unit) {
+	std::cout << "    " << name << ": " << value << " " << unit << std::endl;
+}
+
+unsigned int Test::run(const std::string& filter) {
+	unsigned int numFailed = 0;
+	unsigned int numRun = 0;
+	std::vector<Test*>& tests = getTests();
+	for (unsigned int a = 0; a < tests.size(); a++) {
+		if (std::string(tests[a]->m_name).find(filter) == std::string::npos)
+			continue;
+		std::cout << (tests[a]->m_benchmark ? "[BENCHMARK] " : "[TEST] ") << tests[a]->m_name << std::endl;
+		m_numFailures = 0;
+		double start = getTime();
+		tests[a]->m_function();
+		double time = getTime() - start;
+		numRun++;
+		if (m_numFailures > 0) {
+			std::cout << "    FAILED (" << m_numFailures << " checks)" << std::endl;
+			numFailed++;
+		} else
+			std::cout << "    passed in " << (time * 1000.0) << "ms" << std::endl;
+	}
+	std::cout << (numRun - numFailed) << " of " << numRun << " passed" << std::endl;
+	return numFailed;
+}
+
+/***************************************************************************************************/
+
+/* Runs the tests linked into the executable, only the ones whose names contain the first argument
+ * if one is given */
+int main(int argc, char** argv) {
+	//Errors logged on purpose by the tests are not interesting
+	LOGGER_ERROR_ENABLED = false;
+	LOGGER_WARNING_ENABLED = false;
+	LOGGER_INFORMATION_ENABLED = false;
+	LOGGER_DEBUG_ENABLED = false;
+	return Test::run(argc > 1 ? argv[1] : "") > 0 ? 1 : 0;
+}
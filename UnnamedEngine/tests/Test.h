@@ -0,0 +1,76 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef TESTS_TEST_H_
+#define TESTS_TEST_H_
+
+#include <cmath>
+#include <string>
+#include <vector>
+#include <chrono>
+
+/***************************************************************************************************
+ * The Test class registers a test or benchmark so it is run by the test executable it is linked
+ * into, and counts the checks that fail. Tests are written with the TEST and BENCHMARK macros
+ ***************************************************************************************************/
+
+class Test {
+public:
+	typedef void (*Function)();
+private:
+	const char* m_name;
+	Function m_function;
+	bool m_benchmark;
+
+	/* The number of checks that have failed in the test being run */
+	static unsigned int m_numFailures;
+
+	static std::vector<Test*>& getTests();
+public:
+	Test(const char* name, Function function, bool benchmark);
+
+	/* Records the result of a check, printing where it was when it fails */
+	static void check(bool passed, const std::string& expression, const char* file, int line);
+
+	/* Prints a measurement taken by a benchmark */
+	static void report(const std::string& name, double value, const std::string& unit);
+
+	/* Runs every test whose name contains the filter, returning the number that failed */
+	static unsigned int run(const std::string& filter);
+
+	/* Returns the time in seconds from an arbitrary point, for timing benchmarks */
+	static inline double getTime() { return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count(); }
+};
+
+/***************************************************************************************************/
+
+#define TEST(name) \
+	static void test_##name(); \
+	static Test test_##name##_registration(#name, test_##name, false); \
+	static void test_##name()
+
+#define BENCHMARK(name) \
+	static void benchmark_##name(); \
+	static Test benchmark_##name##_registration(#name, benchmark_##name, true); \
+	static void benchmark_##name()
+
+#define CHECK(condition) Test::check((condition), #condition, __FILE__, __LINE__)
+#define CHECK_EQUAL(expected, actual) Test::check((expected) == (actual), #actual " == " #expected, __FILE__, __LINE__)
+#define CHECK_NEAR(expected, actual, tolerance) Test::check(std::fabs((double) (expected) - (double) (actual)) <= (tolerance), #actual " is close to " #expected, __FILE__, __LINE__)
+
+#endif /* TESTS_TEST_H_ */
@@ -0,0 +1,190 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <cmath>
+
+#include "Test.h"
+#include "core/render/TextureResidency.h"
+
+/* Runs a frame, finishing every load straight away */
+static void runFrame(TextureResidency& residency, std::vector<TextureResidency::Change>& evictions) {
+	std::vector<TextureResidency::Change> loads;
+	residency.update(loads, evictions);
+	for (unsigned int a = 0; a < loads.size(); a++)
+		residency.loaded(loads[a].id, loads[a].mip);
+}
+
+TEST(TextureResidencyMips) {
+	CHECK_EQUAL(1, TextureResidency::getNumMips(1, 1));
+	CHECK_EQUAL(9, TextureResidency::getNumMips(256, 256));
+	CHECK_EQUAL(9, TextureResidency::getNumMips(300, 100));
+	CHECK_EQUAL(84LL, TextureResidency::getBytes(4, 4, 4, 0));
+	CHECK_EQUAL(20LL, TextureResidency::getBytes(4, 4, 4, 1));
+	//The shorter side stays at one pixel
+	CHECK_EQUAL(7LL, TextureResidency::getBytes(4, 1, 1, 0));
+
+	CHECK_EQUAL(0, TextureResidency::calculateMip(1024, 1024, 2000.0f));
+	CHECK_EQUAL(0, TextureResidency::calculateMip(1024, 1024, 1024.0f));
+	CHECK_EQUAL(1, TextureResidency::calculateMip(1024, 1024, 512.0f));
+	CHECK_EQUAL(1, TextureResidency::calculateMip(1024, 1024, 300.0f));
+	CHECK_EQUAL(3, TextureResidency::calculateMip(1024, 512, 128.0f));
+	CHECK_EQUAL(10, TextureResidency::calculateMip(1024, 1024, 0.5f));
+
+	TextureResidency residency(0);
+	unsigned int id = residency.add(1024, 1024, 4, 64);
+	CHECK_EQUAL(11, residency.getNumMips(id));
+	CHECK_EQUAL(4, residency.getMinimumMip(id));
+	CHECK_EQUAL(11, residency.getResidentMip(id));
+	CHECK_EQUAL(0, residency.getMinimumMip(residency.add(32, 32, 4, 64)));
+}
+
+/* Textures that haven't been used for the longest are evicted first, down to their least detailed
+ * level, and those in use are not */
+TEST(TextureResidencyEvictionOrder) {
+	const long long fullBytes = TextureResidency::getBytes(256, 256, 4, 0);
+	const long long minimumBytes = TextureResidency::getBytes(256, 256, 4, 4);
+	TextureResidency residency(fullBytes * 2 + minimumBytes * 2);
+	for (unsigned int a = 0; a < 4; a++)
+		residency.add(256, 256, 4, 16);
+
+	//Only the least detailed levels are loaded when nothing is requested
+	std::vector<TextureResidency::Change> evictions;
+	runFrame(residency, evictions);
+	CHECK_EQUAL(minimumBytes * 4, residency.getResidentBytes());
+	for (unsigned int a = 0; a < 4; a++)
+		CHECK_EQUAL(4, residency.getResidentMip(a));
+
+	//Use each texture in turn, only two fit with all of their detail
+	for (unsigned int a = 0; a < 4; a++) {
+		residency.request(a, 0, 1.0f);
+		runFrame(residency, evictions);
+		CHECK_EQUAL(0, residency.getResidentMip(a));
+		CHECK(residency.getResidentBytes() <= residency.getBudget());
+	}
+	CHECK_EQUAL(2u, evictions.size());
+	CHECK_EQUAL(2u, residency.getNumEvictions());
+	if (evictions.size() == 2) {
+		CHECK_EQUAL(0u, evictions[0].id);
+		CHECK_EQUAL(4, evictions[0].mip);
+		CHECK_EQUAL(1u, evictions[1].id);
+	}
+	CHECK_EQUAL(4, residency.getResidentMip(0));
+	CHECK_EQUAL(4, residency.getResidentMip(1));
+
+	//Using the third again makes the fourth the least recently used
+	evictions.clear();
+	residency.request(2, 0, 1.0f);
+	runFrame(residency, evictions);
+	residency.request(0, 0, 1.0f);
+	runFrame(residency, evictions);
+	CHECK_EQUAL(1u, evictions.size());
+	if (evictions.size() == 1)
+		CHECK_EQUAL(3u, evictions[0].id);
+
+	//Nothing in use with the same priority is evicted, so there is no room for more detail
+	evictions.clear();
+	residency.request(0, 0, 1.0f);
+	residency.request(2, 0, 1.0f);
+	residency.request(1, 0, 1.0f);
+	runFrame(residency, evictions);
+	CHECK_EQUAL(0u, evictions.size());
+	CHECK_EQUAL(4, residency.getResidentMip(1));
+
+	//With a larger budget a less detailed level fits
+	residency.setBudget(fullBytes * 2 + minimumBytes * 2 + TextureResidency::getBytes(256, 256, 4, 2));
+	residency.request(0, 0, 1.0f);
+	residency.request(2, 0, 1.0f);
+	residency.request(1, 0, 1.0f);
+	runFrame(residency, evictions);
+	CHECK_EQUAL(0u, evictions.size());
+	CHECK_EQUAL(2, residency.getResidentMip(1));
+	CHECK(residency.getResidentBytes() <= residency.getBudget());
+}
+
+/* Higher priority textures load first, only a few loads run at once and failed textures aren't
+ * loaded again */
+TEST(TextureResidencyLoads) {
+	TextureResidency residency(1LL << 40);
+	residency.setMaxPendingLoads(2);
+	for (unsigned int a = 0; a < 5; a++)
+		residency.add(64, 64, 4, 64);
+	residency.request(3, 0, 5.0f);
+	residency.request(1, 0, 7.0f);
+	residency.request(4, 0, 1.0f);
+
+	std::vector<TextureResidency::Change> loads;
+	std::vector<TextureResidency::Change> evictions;
+	residency.update(loads, evictions);
+	CHECK_EQUAL(2u, loads.size());
+	if (loads.size() == 2) {
+		CHECK_EQUAL(1u, loads[0].id);
+		CHECK_EQUAL(3u, loads[1].id);
+	}
+	CHECK_EQUAL(0, residency.getPendingMip(1));
+
+	//Nothing more starts until they finish
+	loads.clear();
+	residency.update(loads, evictions);
+	CHECK_EQUAL(0u, loads.size());
+	residency.loaded(1, 0);
+	residency.failed(3);
+	for (unsigned int a = 0; a < 3; a++) {
+		loads.clear();
+		residency.update(loads, evictions);
+		for (unsigned int b = 0; b < loads.size(); b++) {
+			CHECK(loads[b].id != 3);
+			residency.loaded(loads[b].id, loads[b].mip);
+		}
+	}
+	CHECK_EQUAL(residency.getNumMips(3), residency.getResidentMip(3));
+	CHECK_EQUAL(0, residency.getResidentMip(4));
+	CHECK_EQUAL(4 * TextureResidency::getBytes(64, 64, 4, 0), residency.getResidentBytes());
+}
+
+/* A camera moving along a row of textures, loads finish a frame after they start. The budget is
+ * never exceeded and the textures left behind are evicted */
+TEST(TextureResidencyCameraPath) {
+	const unsigned int numTextures = 200;
+	const float spacing = 10.0f;
+	const float viewDistance = 100.0f;
+	const long long fullBytes = TextureResidency::getBytes(512, 512, 4, 0);
+	TextureResidency residency(fullBytes * 6);
+	for (unsigned int a = 0; a < numTextures; a++)
+		residency.add(512, 512, 4, 32);
+
+	std::vector<TextureResidency::Change> pending;
+	std::vector<TextureResidency::Change> evictions;
+	for (float camera = 0.0f; camera < numTextures * spacing; camera += 2.5f) {
+		for (unsigned int a = 0; a < numTextures; a++) {
+			float distance = a * spacing - camera;
+			if (distance >= 0.0f && distance < viewDistance) {
+				float screenSize = 4096.0f / std::max(distance, 1.0f);
+				residency.request(a, TextureResidency::calculateMip(512, 512, screenSize), screenSize);
+			}
+		}
+		for (unsigned int a = 0; a < pending.size(); a++)
+			residency.loaded(pending[a].id, pending[a].mip);
+		pending.clear();
+		residency.update(pending, evictions);
+		CHECK(residency.getResidentBytes() <= residency.getBudget());
+	}
+	CHECK(residency.getNumEvictions() > 0);
+	//Those the camera passed long ago only have their least detailed level
+	for (unsigned int a = 0; a < numTextures / 2; a++)
+		CHECK_EQUAL(residency.getMinimumMip(a), residency.getResidentMip(a));
+}
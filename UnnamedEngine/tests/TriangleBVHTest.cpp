@@ -0,0 +1,201 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <cmath>
+#include <random>
+
+#include "Test.h"
+#include "core/Mesh.h"
+#include "core/render/TriangleBVH.h"
+
+/* Returns the distance a ray hits a triangle at, or a negative value when it misses, worked out
+ * in double precision */
+static double intersectTriangle(const double origin[3], const double direction[3], const float* v0, const float* v1, const float* v2) {
+	double e1[3] = { v1[0] - (double) v0[0], v1[1] - (double) v0[1], v1[2] - (double) v0[2] };
+	double e2[3] = { v2[0] - (double) v0[0], v2[1] - (double) v0[1], v2[2] - (double) v0[2] };
+	double p[3] = { direction[1] * e2[2] - direction[2] * e2[1], direction[2] * e2[0] - direction[0] * e2[2], direction[0] * e2[1] - direction[1] * e2[0] };
+	double determinant = e1[0] * p[0] + e1[1] * p[1] + e1[2] * p[2];
+	if (determinant == 0)
+		return -1;
+	double t[3] = { origin[0] - v0[0], origin[1] - v0[1], origin[2] - v0[2] };
+	double u = (t[0] * p[0] + t[1] * p[1] + t[2] * p[2]) / determinant;
+	if (u < 0 || u > 1)
+		return -1;
+	double q[3] = { t[1] * e1[2] - t[2] * e1[1], t[2] * e1[0] - t[0] * e1[2], t[0] * e1[1] - t[1] * e1[0] };
+	double v = (direction[0] * q[0] + direction[1] * q[1] + direction[2] * q[2]) / determinant;
+	if (v < 0 || u + v > 1)
+		return -1;
+	return (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]) / determinant;
+}
+
+/* Returns the closest distance a ray hits any triangle of a mesh at by testing every one of them,
+ * or a negative value when it misses */
+static double intersectAll(MeshData* data, const double origin[3], const double direction[3]) {
+	double closest = -1;
+	for (unsigned int a = 0; a < data->getNumTriangles(); a++) {
+		const float* v[3];
+		for (unsigned int b = 0; b < 3; b++)
+			v[b] = data->getValues(MeshBuffers::ATTRIBUTE_POSITION, data->hasIndices() ? data->getIndices()[a * 3 + b] : a * 3 + b);
+		double distance = intersectTriangle(origin, direction, v[0], v[1], v[2]);
+		if (distance >= 0 && (closest < 0 || distance < closest))
+			closest = distance;
+	}
+	return closest;
+}
+
+/* Creates a mesh of small triangles scattered through a box */
+static MeshData* createTriangles(unsigned int numTriangles, float size, std::mt19937& random) {
+	std::uniform_real_distribution<float> centres(-size, size);
+	std::uniform_real_distribution<float> offsets(-1.0f, 1.0f);
+	MeshData* data = new MeshData(true, true, true, true);
+	for (unsigned int a = 0; a < numTriangles; a++) {
+		Vector3f centre(centres(random), centres(random), centres(random));
+		for (unsigned int b = 0; b < 3; b++)
+			data->addPosition(centre + Vector3f(offsets(random), offsets(random), offsets(random)));
+	}
+	return data;
+}
+
+/* Compares rays from random points aimed at points on random triangles against testing every
+ * triangle. Aiming close to the corners of triangles checks that the quantised bounds of the
+ * nodes still contain them */
+static void checkRays(MeshData* data, TriangleBVH& bvh, unsigned int numRays, float size, std::mt19937& random) {
+	std::uniform_real_distribution<float> origins(-size * 2.0f, size * 2.0f);
+	std::uniform_real_distribution<float> weights(0.0f, 1.0f);
+	unsigned int numHits = 0;
+	for (unsigned int a = 0; a < numRays; a++) {
+		unsigned int triangle = random() % data->getNumTriangles();
+		float u = weights(random);
+		float v = weights(random) * (1.0f - u);
+		if (a % 4 == 0) {
+			//Just inside a corner
+			u = 0.001f;
+			v = 0.001f;
+		}
+		double target[3];
+		double origin[3];
+		double direction[3];
+		const float* vertices[3];
+		for (unsigned int b = 0; b < 3; b++)
+			vertices[b] = data->getValues(MeshBuffers::ATTRIBUTE_POSITION, data->hasIndices() ? data->getIndices()[triangle * 3 + b] : triangle * 3 + b);
+		for (unsigned int b = 0; b < 3; b++)
+			target[b] = vertices[0][b] * (1.0 - u - v) + vertices[1][b] * u + vertices[2][b] * v;
+
+		//Rays almost parallel to the triangle are skipped, as the distance to it is too sensitive
+		//to rounding to compare
+		double e1[3] = { vertices[1][0] - (double) vertices[0][0], vertices[1][1] - (double) vertices[0][1], vertices[1][2] - (double) vertices[0][2] };
+		double e2[3] = { vertices[2][0] - (double) vertices[0][0], vertices[2][1] - (double) vertices[0][1], vertices[2][2] - (double) vertices[0][2] };
+		double normal[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+		double cosine = 0;
+		while (std::fabs(cosine) < 0.2) {
+			for (unsigned int b = 0; b < 3; b++) {
+				origin[b] = origins(random);
+				direction[b] = target[b] - origin[b];
+			}
+			cosine = (normal[0] * direction[0] + normal[1] * direction[1] + normal[2] * direction[2]) / std::sqrt((normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]) * (direction[0] * direction[0] + direction[1] * direction[1] + direction[2] * direction[2]));
+		}
+
+		double expected = intersectAll(data, origin, direction);
+		RayHit hit;
+		bool found = bvh.intersect(Vector3f(origin[0], origin[1], origin[2]), Vector3f(direction[0], direction[1], direction[2]), 1e30f, hit);
+		CHECK_EQUAL(expected >= 0, found);
+		if (found && expected >= 0) {
+			CHECK_NEAR(expected, hit.distance, 0.0001);
+			//The triangle reported is the one hit at that distance
+			for (unsigned int b = 0; b < 3; b++)
+				vertices[b] = data->getValues(MeshBuffers::ATTRIBUTE_POSITION, data->hasIndices() ? data->getIndices()[hit.triangle * 3 + b] : hit.triangle * 3 + b);
+			CHECK_NEAR(hit.distance, intersectTriangle(origin, direction, vertices[0], vertices[1], vertices[2]), 0.0001);
+			numHits++;
+		}
+
+		//Nothing is found beyond the maximum distance
+		if (expected > 0.01)
+			CHECK(! bvh.intersect(Vector3f(origin[0], origin[1], origin[2]), Vector3f(direction[0], direction[1], direction[2]), expected * 0.99, hit));
+	}
+	//Every ray is aimed at a triangle, so they all hit something
+	CHECK_EQUAL(numRays, numHits);
+}
+
+TEST(TriangleBVHMatchesBruteForce) {
+	std::mt19937 random(1);
+	MeshData* data = createTriangles(2000, 20.0f, random);
+	TriangleBVH bvh(data);
+	CHECK_EQUAL(2000u, bvh.getNumTriangles());
+	CHECK(bvh.getNumNodes() > 1);
+	checkRays(data, bvh, 500, 20.0f, random);
+	delete data;
+}
+
+TEST(TriangleBVHIndexed) {
+	//A grid of quads sharing vertices, which the rays can't get between
+	MeshData* data = new MeshData(true, true, true, true);
+	const unsigned int size = 32;
+	for (unsigned int y = 0; y <= size; y++) {
+		for (unsigned int x = 0; x <= size; x++)
+			data->addPosition(Vector3f(x, y, std::sin(x * 0.3f) * std::cos(y * 0.3f)));
+	}
+	for (unsigned int y = 0; y < size; y++) {
+		for (unsigned int x = 0; x < size; x++) {
+			unsigned int corner = y * (size + 1) + x;
+			data->addIndex(corner);
+			data->addIndex(corner + 1);
+			data->addIndex(corner + size + 1);
+			data->addIndex(corner + 1);
+			data->addIndex(corner + size + 2);
+			data->addIndex(corner + size + 1);
+		}
+	}
+	TriangleBVH bvh(data);
+	CHECK_EQUAL(size * size * 2, bvh.getNumTriangles());
+
+	std::mt19937 random(2);
+	checkRays(data, bvh, 500, size, random);
+
+	//A ray straight down onto the grid hits the triangle below it
+	RayHit hit;
+	CHECK(bvh.intersect(Vector3f(10.75f, 20.5f, 10.0f), Vector3f(0.0f, 0.0f, -1.0f), 100.0f, hit));
+	CHECK_EQUAL((20u * size + 10u) * 2u + 1u, hit.triangle);
+	//One pointing away from it doesn't
+	CHECK(! bvh.intersect(Vector3f(10.75f, 20.5f, 10.0f), Vector3f(0.0f, 0.0f, 1.0f), 100.0f, hit));
+	delete data;
+}
+
+TEST(TriangleBVHThreadedBuild) {
+	//Enough triangles for the first branches to be built on separate threads when there is more
+	//than one core
+	std::mt19937 random(3);
+	MeshData* data = createTriangles(40000, 100.0f, random);
+	TriangleBVH bvh(data);
+	CHECK_EQUAL(40000u, bvh.getNumTriangles());
+	checkRays(data, bvh, 200, 100.0f, random);
+
+	//Building again gives the same tree
+	TriangleBVH other(data);
+	CHECK_EQUAL(bvh.getNumNodes(), other.getNumNodes());
+	CHECK_EQUAL(bvh.getMemoryUsage(), other.getMemoryUsage());
+	delete data;
+}
+
+TEST(TriangleBVHEmpty) {
+	MeshData* data = new MeshData(true, true, true, true);
+	TriangleBVH bvh(data);
+	RayHit hit;
+	CHECK_EQUAL(0u, bvh.getNumNodes());
+	CHECK(! bvh.intersect(Vector3f(), Vector3f(0.0f, 0.0f, 1.0f), 100.0f, hit));
+	delete data;
+}
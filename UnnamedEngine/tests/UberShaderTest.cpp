@@ -0,0 +1,110 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include "Test.h"
+#include "core/render/ShaderManager.h"
+#include "core/render/UberShader.h"
+
+static unsigned int numPrograms;
+
+static GLuint APIENTRY countCreateProgram() {
+	return ++numPrograms;
+}
+
+TEST(UberShaderPreprocess) {
+	std::string source = "a\n"
+			"#ifdef TEXTURE\n"
+			"b\n"
+			"#ifndef NORMALS\n"
+			"c\n"
+			"#else\n"
+			"d\n"
+			"#endif\n"
+			"#else\n"
+			"e\n"
+			"#endif\n"
+			"f\n";
+	std::vector<std::string> defines;
+	CHECK_EQUAL(std::string("a\ne\nf\n"), UberShader::preprocess(source, defines));
+	defines.push_back("TEXTURE");
+	CHECK_EQUAL(std::string("a\nb\nc\nf\n"), UberShader::preprocess(source, defines));
+	defines.push_back("NORMALS");
+	CHECK_EQUAL(std::string("a\nb\nd\nf\n"), UberShader::preprocess(source, defines));
+
+	//A block inside one that isn't output isn't output either, whatever its condition
+	defines.clear();
+	defines.push_back("NORMALS");
+	CHECK_EQUAL(std::string("a\ne\nf\n"), UberShader::preprocess(source, defines));
+}
+
+TEST(UberShaderDefines) {
+	std::vector<std::string> defines = UberShader::getDefines(SHADER_FEATURE_POINT_LIGHT | SHADER_FEATURE_TEXTURE | SHADER_FEATURE_MULTI_DRAW);
+	CHECK_EQUAL(3u, defines.size());
+	CHECK_EQUAL(std::string("POINT_LIGHT"), defines[0]);
+	CHECK_EQUAL(std::string("TEXTURE"), defines[1]);
+	CHECK_EQUAL(std::string("MULTI_DRAW"), defines[2]);
+	CHECK(UberShader::getDefines(0).empty());
+
+	//Multi draws need a newer version of GLSL, which has to come first
+	CHECK(UberShader::getHeader(0, GL_VERTEX_SHADER).empty());
+	CHECK_EQUAL(0u, UberShader::getHeader(SHADER_FEATURE_MULTI_DRAW, GL_VERTEX_SHADER).find("#version 430"));
+	CHECK(UberShader::getHeader(SHADER_FEATURE_MULTI_DRAW, GL_VERTEX_SHADER).find("GL_ARB_shader_draw_parameters") != std::string::npos);
+	CHECK(UberShader::getHeader(SHADER_FEATURE_MULTI_DRAW, GL_FRAGMENT_SHADER).find("GL_ARB_shader_draw_parameters") == std::string::npos);
+}
+
+TEST(UberShaderValidKeys) {
+	CHECK(UberShader::isValidKey(0));
+	CHECK(UberShader::isValidKey(SHADER_FEATURE_SPOT_LIGHT | SHADER_FEATURE_TEXTURE | SHADER_FEATURE_NORMALS | SHADER_FEATURE_SHADOWS | SHADER_FEATURE_MULTI_DRAW));
+	CHECK(UberShader::isValidKey(SHADER_FEATURE_TEXTURE | SHADER_FEATURE_INSTANCING));
+	//Only one type of light can be used at once
+	CHECK(! UberShader::isValidKey(SHADER_FEATURE_AMBIENT_LIGHT | SHADER_FEATURE_POINT_LIGHT));
+	CHECK(! UberShader::isValidKey(SHADER_FEATURE_DIRECTIONAL_LIGHT | SHADER_FEATURE_SPOT_LIGHT | SHADER_FEATURE_TEXTURE));
+	//Features that don't exist
+	CHECK(! UberShader::isValidKey(1 << UberShader::NUM_FEATURES));
+}
+
+TEST(UberShaderPermutations) {
+	glewResetStubs();
+	__glewCreateProgram = countCreateProgram;
+	numPrograms = 0;
+	UberShader* shader = new UberShader("resources/shaders/lighting/", "Lighting");
+
+	//Nothing is compiled or kept for an invalid key
+	unsigned int invalid = SHADER_FEATURE_AMBIENT_LIGHT | SHADER_FEATURE_SPOT_LIGHT;
+	shader->prewarm(invalid);
+	CHECK(! shader->hasPermutation(invalid));
+	CHECK(shader->getShader(invalid) == NULL);
+	CHECK_EQUAL(0u, shader->getNumPermutations());
+	CHECK_EQUAL(0u, numPrograms);
+
+	//A valid key is compiled once, whether it was prewarmed or not
+	unsigned int key = SHADER_FEATURE_POINT_LIGHT | SHADER_FEATURE_TEXTURE;
+	shader->prewarm(key);
+	shader->prewarm(key);
+	CHECK(shader->hasPermutation(key));
+	Shader* permutation = shader->getShader(key);
+	CHECK(permutation != NULL);
+	CHECK(shader->getShader(key) == permutation);
+	Shader* other = shader->getShader(SHADER_FEATURE_SPOT_LIGHT);
+	CHECK(other != NULL && other != permutation);
+	CHECK_EQUAL(2u, shader->getNumPermutations());
+	CHECK_EQUAL(2u, numPrograms);
+
+	delete shader;
+	glewResetStubs();
+}
@@ -0,0 +1,61 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <random>
+
+#include "../Test.h"
+#include "core/render/BufferAllocator.h"
+
+/* The time to allocate and free ranges of random sizes in a buffer that is kept about half full,
+ * and how fragmented the buffer ends up */
+BENCHMARK(BufferAllocatorChurn) {
+	const unsigned int numOperations = 1000000;
+	std::mt19937 random(1);
+	std::uniform_int_distribution<unsigned int> sizes(64, 65536);
+	BufferAllocator allocator(256 << 20, 256);
+	std::vector<BufferAllocator::Allocation> allocations;
+	std::vector<unsigned int> requests(numOperations);
+	for (unsigned int a = 0; a < numOperations; a++)
+		requests[a] = sizes(random);
+
+	unsigned int numFailed = 0;
+	double start = Test::getTime();
+	for (unsigned int a = 0; a < numOperations; a++) {
+		if (allocator.getUsed() < allocator.getCapacity() / 2 || allocations.empty()) {
+			BufferAllocator::Allocation allocation;
+			if (allocator.allocate(requests[a], allocation))
+				allocations.push_back(allocation);
+			else
+				numFailed++;
+		} else {
+			unsigned int index = requests[a] % allocations.size();
+			allocator.free(allocations[index]);
+			allocations[index] = allocations.back();
+			allocations.pop_back();
+		}
+	}
+	double time = Test::getTime() - start;
+
+	Test::report("Operations", numOperations, "");
+	Test::report("Time per operation", time * 1000000000.0 / numOperations, "ns");
+	Test::report("Failed allocations", numFailed, "");
+	Test::report("Live allocations", allocations.size(), "");
+	Test::report("Free ranges", allocator.getNumFreeBlocks(), "");
+	Test::report("Fragmentation", allocator.getFragmentation() * 100.0f, "%");
+	CHECK_EQUAL(0u, numFailed);
+}
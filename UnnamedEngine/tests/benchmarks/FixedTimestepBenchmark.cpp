@@ -0,0 +1,60 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <random>
+#include <cstdlib>
+#include <algorithm>
+
+#include "../Test.h"
+#include "utils/FixedTimestep.h"
+
+/* Reports how evenly steps are spread over frames whose lengths jitter around refresh rates that
+ * aren't all multiples of the step rate, and how far the time simulated in each frame is from its
+ * length, which is the jitter that interpolating with the alpha hides */
+BENCHMARK(FixedTimestepJitter) {
+	const unsigned int numFrames = 100000;
+	const double refreshRates[3] = { 60.0, 144.0, 50.0 };
+	for (unsigned int a = 0; a < 3; a++) {
+		std::mt19937 random(1);
+		long long frame = (long long) (1000000000.0 / refreshRates[a]);
+		std::normal_distribution<double> jitter(0.0, frame * 0.1);
+		FixedTimestep timestep(60, 5);
+
+		unsigned int counts[6] = { 0, 0, 0, 0, 0, 0 };
+		double totalError = 0;
+		double maxError = 0;
+		double start = Test::getTime();
+		for (unsigned int b = 0; b < numFrames; b++) {
+			long long length = std::max(0LL, frame + (long long) jitter(random));
+			unsigned int steps = timestep.advance(length);
+			counts[std::min(steps, 5u)]++;
+			double error = std::abs(length - (long long) steps * timestep.getStepNanoseconds()) / 1000000.0;
+			totalError += error;
+			maxError = std::max(maxError, error);
+		}
+		double time = Test::getTime() - start;
+
+		std::string name = std::to_string((int) refreshRates[a]) + " Hz frames:";
+		for (unsigned int b = 0; b < 4; b++)
+			Test::report(name + " frames with " + std::to_string(b) + " steps", counts[b] * 100.0 / numFrames, "%");
+		Test::report(name + " dropped", timestep.getNumDropped(), "");
+		Test::report(name + " mean step jitter", totalError / numFrames, "ms");
+		Test::report(name + " max step jitter", maxError, "ms");
+		Test::report(name + " time per frame", time * 1000000000.0 / numFrames, "ns");
+	}
+}
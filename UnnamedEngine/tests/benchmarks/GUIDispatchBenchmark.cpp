@@ -0,0 +1,124 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <random>
+
+#include "../Test.h"
+#include "core/gui/GUIComponent.h"
+#include "core/input/Input.h"
+
+/* Counts the times the mouse enters a component */
+class EnterCounter : public GUIComponentListener {
+public:
+	unsigned int numEnters = 0;
+
+	virtual void onMouseEnter(GUIComponent* component) override { numEnters++; }
+};
+
+/* The time to update a GUI of 10,000 buttons in 100 panels as the mouse moves around it, and to
+ * find the buttons under the mouse using the index the update uses compared with testing every
+ * button */
+BENCHMARK(GUIDispatch) {
+	const unsigned int numPanels = 100;
+	const unsigned int buttonsPerPanel = 100;
+	const unsigned int numUpdates = 2000;
+	EnterCounter counter;
+	GUIComponent* root = new GUIComponent(NULL, 2000.0f, 2000.0f);
+	std::vector<GUIComponent*> buttons;
+	for (unsigned int a = 0; a < numPanels; a++) {
+		GUIComponent* panel = new GUIComponent(NULL, 200.0f, 200.0f);
+		panel->setPosition((a % 10) * 200.0f, (a / 10) * 200.0f);
+		root->add(panel);
+		for (unsigned int b = 0; b < buttonsPerPanel; b++) {
+			GUIComponent* button = new GUIComponent(NULL, 18.0f, 18.0f);
+			button->setPosition((b % 10) * 20.0f + 1.0f, (b / 10) * 20.0f + 1.0f);
+			button->addListener(&counter);
+			panel->add(button);
+			buttons.push_back(button);
+		}
+	}
+	//The first update lays out the tree and builds the index
+	root->update();
+	Memory::nextFrame();
+
+	std::mt19937 random(1);
+	std::uniform_real_distribution<double> positions(0.0, 2000.0);
+	std::vector<double> path(numUpdates * 2);
+	for (unsigned int a = 0; a < path.size(); a++)
+		path[a] = positions(random);
+
+	double start = Test::getTime();
+	for (unsigned int a = 0; a < numUpdates; a++) {
+		Mouse::lastX = path[a * 2];
+		Mouse::lastY = path[a * 2 + 1];
+		root->update();
+		Memory::nextFrame();
+	}
+	double indexedTime = Test::getTime() - start;
+
+	//Finding the buttons under the mouse with an index of the same bounds, and by testing every
+	//one of them. Buttons are only entered when the mouse wasn't already inside them
+	GUISpatialIndex index;
+	for (unsigned int a = 0; a < buttons.size(); a++) {
+		Vector2f p = buttons[a]->getPosition();
+		index.update(buttons[a], Rect(p.getX(), p.getY(), buttons[a]->getWidth(), buttons[a]->getHeight()));
+	}
+	unsigned int numFound = 0;
+	start = Test::getTime();
+	for (unsigned int a = 0; a < numUpdates; a++) {
+		FrameVector<GUIComponent*> found;
+		index.query((float) path[a * 2], (float) path[a * 2 + 1], found);
+		numFound += found.size();
+		Memory::nextFrame();
+	}
+	double queryTime = Test::getTime() - start;
+
+	unsigned int numEnters = 0;
+	GUIComponent* last = NULL;
+	start = Test::getTime();
+	for (unsigned int a = 0; a < numUpdates; a++) {
+		float x = (float) path[a * 2];
+		float y = (float) path[a * 2 + 1];
+		GUIComponent* inside = NULL;
+		for (unsigned int b = 0; b < buttons.size(); b++) {
+			Vector2f p = buttons[b]->getPosition();
+			if (x >= p.getX() && y >= p.getY() && x <= p.getX() + buttons[b]->getWidth() && y <= p.getY() + buttons[b]->getHeight())
+				inside = buttons[b];
+		}
+		if (inside != NULL && inside != last)
+			numEnters++;
+		last = inside;
+	}
+	double bruteForceTime = Test::getTime() - start;
+
+	Test::report("Components", buttons.size() + numPanels + 1, "");
+	Test::report("Update time", indexedTime * 1000000.0 / numUpdates, "us");
+	Test::report("Index query time", queryTime * 1000000.0 / numUpdates, "us");
+	Test::report("Testing every button", bruteForceTime * 1000000.0 / numUpdates, "us");
+	Test::report("Enter events", counter.numEnters, "");
+	CHECK_EQUAL(numEnters, counter.numEnters);
+
+	Mouse::lastX = -1;
+	Mouse::lastY = -1;
+	for (unsigned int a = 0; a < root->components.size(); a++) {
+		for (unsigned int b = 0; b < root->components[a]->components.size(); b++)
+			delete root->components[a]->components[b];
+		delete root->components[a];
+	}
+	delete root;
+}
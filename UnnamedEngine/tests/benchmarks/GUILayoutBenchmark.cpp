@@ -0,0 +1,85 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include "../Test.h"
+#include "core/gui/GUIComponent.h"
+
+/* Creates a tree with the given number of children at each level below the component */
+static void createTree(GUIComponent* parent, unsigned int depth, unsigned int numChildren, std::vector<GUIComponent*>& leaves) {
+	for (unsigned int a = 0; a < numChildren; a++) {
+		GUIComponent* child = new GUIComponent(NULL, parent->getWidth() / numChildren, parent->getHeight());
+		parent->add(child, GUIPosition::LEFT, Vector2f(0, 0));
+		if (depth > 1)
+			createTree(child, depth - 1, numChildren, leaves);
+		else
+			leaves.push_back(child);
+	}
+}
+
+static void deleteTree(GUIComponent* component) {
+	for (unsigned int a = 0; a < component->components.size(); a++)
+		deleteTree(component->components[a]);
+	delete component;
+}
+
+/* Marks every component in a tree as needing a layout, as every one would have been laid out
+ * again each frame before */
+static void markTree(GUIComponent* component) {
+	component->markLayoutDirty();
+	for (unsigned int a = 0; a < component->components.size(); a++)
+		markTree(component->components[a]);
+}
+
+/* The time to lay out a GUI of 10,000 leaves after one of them changes size, compared with laying
+ * out all of it */
+BENCHMARK(GUILayout) {
+	const unsigned int numFrames = 1000;
+	GUIComponent* root = new GUIComponent(NULL, 100000.0f, 1000.0f);
+	std::vector<GUIComponent*> leaves;
+	//Four levels of ten, so 10,000 leaves and 11,111 components
+	createTree(root, 4, 10, leaves);
+	root->layout();
+
+	double start = Test::getTime();
+	for (unsigned int a = 0; a < numFrames; a++) {
+		markTree(root);
+		root->layout();
+	}
+	double fullTime = Test::getTime() - start;
+
+	start = Test::getTime();
+	for (unsigned int a = 0; a < numFrames; a++) {
+		GUIComponent* leaf = leaves[(a * 7919) % leaves.size()];
+		leaf->setWidth(leaf->getWidth() == 10.0f ? 9.0f : 10.0f);
+		root->layout();
+	}
+	double dirtyTime = Test::getTime() - start;
+
+	start = Test::getTime();
+	for (unsigned int a = 0; a < numFrames; a++)
+		root->layout();
+	double cleanTime = Test::getTime() - start;
+
+	Test::report("Leaves", leaves.size(), "");
+	Test::report("Laying out everything", fullTime * 1000000.0 / numFrames, "us");
+	Test::report("Laying out one changed leaf", dirtyTime * 1000000.0 / numFrames, "us");
+	Test::report("Nothing changed", cleanTime * 1000000.0 / numFrames, "us");
+	CHECK(! root->needsLayout());
+
+	deleteTree(root);
+}
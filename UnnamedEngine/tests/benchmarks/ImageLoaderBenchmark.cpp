@@ -0,0 +1,135 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <thread>
+#include <cstdio>
+
+#include "../Test.h"
+#include "core/ImageLoader.h"
+
+/* Prevents the work from being optimised away */
+static volatile unsigned int imageLoaderBenchmark_sink = 0;
+
+/* The time to decode the six faces of a 2048x2048 cube map one at a time and all at once. The
+ * stubs read uncompressed images, so this mostly measures reading the files rather than
+ * decompressing them and the difference will be larger with stb_image */
+BENCHMARK(ImageLoaderDecode) {
+	const unsigned int numImages = 6;
+	const int size = 2048;
+	std::vector<unsigned char> pixels(size * size * 3);
+	std::vector<std::string> paths;
+	for (unsigned int a = 0; a < numImages; a++) {
+		//Each face is different so none of them can be read from the same pages
+		for (unsigned int b = 0; b < pixels.size(); b++)
+			pixels[b] = (unsigned char) (b * 7 + a);
+		paths.push_back(std::string(TEST_OUTPUT_PATH) + "ImageLoaderBenchmarkFace" + std::to_string(a) + ".ppm");
+		FILE* file = fopen(paths.back().c_str(), "wb");
+		fprintf(file, "P6 %d %d 255\n", size, size);
+		fwrite(&pixels.front(), 1, pixels.size(), file);
+		fclose(file);
+	}
+
+	//Both keep every image until the end, as a game loading them would
+	std::vector<Image*> images;
+	double start = Test::getTime();
+	for (unsigned int a = 0; a < numImages; a++)
+		images.push_back(ImageLoader::decode(paths[a], 0));
+	double serialTime = Test::getTime() - start;
+	for (unsigned int a = 0; a < images.size(); a++)
+		delete images[a];
+	images.clear();
+
+	start = Test::getTime();
+	ImageLoader::decode(paths, 0, images);
+	double parallelTime = Test::getTime() - start;
+	for (unsigned int a = 0; a < images.size(); a++) {
+		CHECK(images[a]->isLoaded());
+		delete images[a];
+	}
+
+	Test::report("Faces", numImages, "");
+	Test::report("Threads", std::thread::hardware_concurrency(), "");
+	Test::report("One at a time", serialTime * 1000.0, "ms");
+	Test::report("All at once", parallelTime * 1000.0, "ms");
+	Test::report("Speed up", serialTime / parallelTime, "x");
+	for (unsigned int a = 0; a < numImages; a++)
+		remove(paths[a].c_str());
+}
+
+/* The time taken by the conversion kernels compared with plain loops doing the same thing */
+BENCHMARK(ImageLoaderKernels) {
+	const unsigned int numPixels = 2048 * 2048;
+	const unsigned int numRuns = 10;
+	std::vector<unsigned char> source(numPixels * 3);
+	std::vector<unsigned char> destination(numPixels * 4);
+	for (unsigned int a = 0; a < source.size(); a++)
+		source[a] = (unsigned char) (a * 13);
+
+	double start = Test::getTime();
+	for (unsigned int run = 0; run < numRuns; run++)
+		ImageLoader::expandRGBToRGBA(&source.front(), &destination.front(), numPixels);
+	double expandTime = (Test::getTime() - start) / numRuns;
+	imageLoaderBenchmark_sink += destination[numPixels];
+
+	//The same kernel with SSSE3 turned off, which falls back to its plain loop
+	ImageLoader::setSSSE3Enabled(false);
+	start = Test::getTime();
+	for (unsigned int run = 0; run < numRuns; run++)
+		ImageLoader::expandRGBToRGBA(&source.front(), &destination.front(), numPixels);
+	double expandWithoutSSSE3Time = (Test::getTime() - start) / numRuns;
+	imageLoaderBenchmark_sink += destination[numPixels];
+	ImageLoader::setSSSE3Enabled(true);
+
+	start = Test::getTime();
+	for (unsigned int run = 0; run < numRuns; run++) {
+		for (unsigned int a = 0; a < numPixels; a++) {
+			destination[a * 4]     = source[a * 3];
+			destination[a * 4 + 1] = source[a * 3 + 1];
+			destination[a * 4 + 2] = source[a * 3 + 2];
+			destination[a * 4 + 3] = 255;
+		}
+		imageLoaderBenchmark_sink += destination[run];
+	}
+	double scalarExpandTime = (Test::getTime() - start) / numRuns;
+
+	start = Test::getTime();
+	for (unsigned int run = 0; run < numRuns; run++)
+		ImageLoader::premultiplyAlpha(&destination.front(), numPixels);
+	double premultiplyTime = (Test::getTime() - start) / numRuns;
+	imageLoaderBenchmark_sink += destination[numPixels];
+
+	start = Test::getTime();
+	for (unsigned int run = 0; run < numRuns; run++) {
+		for (unsigned int a = 0; a < numPixels * 4; a += 4) {
+			unsigned int alpha = destination[a + 3];
+			for (unsigned int b = 0; b < 3; b++) {
+				unsigned int product = (destination[a + b] * alpha) + 128;
+				destination[a + b] = (unsigned char) ((product + (product >> 8)) >> 8);
+			}
+		}
+		imageLoaderBenchmark_sink += destination[run];
+	}
+	double scalarPremultiplyTime = (Test::getTime() - start) / numRuns;
+
+	Test::report("SSSE3 supported", ImageLoader::isSSSE3Supported(), "");
+	Test::report("Expanding RGB to RGBA", expandTime * 1000.0, "ms");
+	Test::report("Expanding without SSSE3", expandWithoutSSSE3Time * 1000.0, "ms");
+	Test::report("Expanding with a plain loop", scalarExpandTime * 1000.0, "ms");
+	Test::report("Premultiplying alpha", premultiplyTime * 1000.0, "ms");
+	Test::report("Premultiplying with a plain loop", scalarPremultiplyTime * 1000.0, "ms");
+}
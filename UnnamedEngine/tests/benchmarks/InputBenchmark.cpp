@@ -0,0 +1,105 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <thread>
+
+#include "../Test.h"
+#include "core/input/Input.h"
+#include "core/input/InputRecording.h"
+
+/* Counts the calls made to it */
+class CountingListener : public InputListener {
+public:
+	unsigned int numCalls = 0;
+
+	virtual void onMouseMoved(double x, double y, double dx, double dy) override { numCalls++; }
+	virtual void onMousePressed(int button) override { numCalls++; }
+	virtual void onMouseReleased(int button) override { numCalls++; }
+};
+
+static InputEvent createEvent(InputEventType type, int code, int action, double x, double y) {
+	InputEvent event;
+	event.type = type;
+	event.time = 0;
+	event.code = code;
+	event.action = action;
+	event.x = x;
+	event.y = y;
+	return event;
+}
+
+/* Adds mouse moves to a queue, waiting whenever it is full */
+static void produceEvents(InputEventQueue* queue, unsigned int numEvents) {
+	for (unsigned int a = 0; a < numEvents; a++) {
+		while (! queue->push(createEvent(INPUT_EVENT_CURSOR_POSITION, 0, 0, a, a)))
+			std::this_thread::yield();
+	}
+}
+
+/* The time to pass a million events from one thread to another through the queue */
+BENCHMARK(InputEventQueueThroughput) {
+	const unsigned int numEvents = 1000000;
+	InputEventQueue queue(4096);
+	double start = Test::getTime();
+	std::thread producer(produceEvents, &queue, numEvents);
+	unsigned int numReceived = 0;
+	InputEvent event;
+	while (numReceived < numEvents) {
+		if (queue.pop(event))
+			numReceived++;
+		else
+			std::this_thread::yield();
+	}
+	producer.join();
+	double time = Test::getTime() - start;
+
+	Test::report("Events", numEvents, "");
+	Test::report("Time per event", time * 1000000000.0 / numEvents, "ns");
+	Test::report("Events per second", numEvents / time, "");
+}
+
+/* The time to dispatch a million events to a listener, which are mostly mouse moves with a click
+ * every 100 of them, with and without coalescing the moves */
+BENCHMARK(InputDispatch) {
+	const unsigned int numEvents = 1000000;
+	InputRecording recording;
+	for (unsigned int a = 0; a < numEvents; a++) {
+		if (a % 100 == 98)
+			recording.add(createEvent(INPUT_EVENT_MOUSE_BUTTON, GLFW_MOUSE_BUTTON_RIGHT, GLFW_PRESS, 0, 0));
+		else if (a % 100 == 99)
+			recording.add(createEvent(INPUT_EVENT_MOUSE_BUTTON, GLFW_MOUSE_BUTTON_RIGHT, GLFW_RELEASE, 0, 0));
+		else
+			recording.add(createEvent(INPUT_EVENT_CURSOR_POSITION, 0, 0, a % 1000, a % 700));
+	}
+
+	CountingListener listener;
+	InputManager::addListener(&listener);
+	for (unsigned int a = 0; a < 2; a++) {
+		bool coalesce = a == 0;
+		InputManager::setCoalesceMouseMoves(coalesce);
+		listener.numCalls = 0;
+		double start = Test::getTime();
+		InputManager::replay(&recording);
+		double time = Test::getTime() - start;
+		std::string name = coalesce ? "Coalesced" : "Not coalesced";
+		Test::report(name + " time per event", time * 1000000000.0 / numEvents, "ns");
+		Test::report(name + " listener calls", listener.numCalls, "");
+	}
+	InputManager::setCoalesceMouseMoves(true);
+	InputManager::removeListener(&listener);
+}
@@ -0,0 +1,77 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <algorithm>
+#include <thread>
+
+#include "../Test.h"
+#include "utils/Logging.h"
+
+/* Logs a burst of messages each frame, as a game might while loading, and returns the time each
+ * burst took on the calling thread. Individual logs are too quick to time reliably */
+static void logFrames(unsigned int numFrames, unsigned int logsPerFrame, std::vector<double>& times) {
+	for (unsigned int frame = 0; frame < numFrames; frame++) {
+		double start = Test::getTime();
+		for (unsigned int a = 0; a < logsPerFrame; a++)
+			logInformation("Loaded the model 'resources/models/model" + std::to_string(a) + ".obj' with " + std::to_string(frame) + " meshes");
+		times.push_back(Test::getTime() - start);
+		std::this_thread::sleep_for(std::chrono::milliseconds(2));
+	}
+}
+
+static void reportTimes(const std::string& name, std::vector<double>& times, unsigned int logsPerFrame) {
+	std::sort(times.begin(), times.end());
+	double total = 0;
+	for (unsigned int a = 0; a < times.size(); a++)
+		total += times[a];
+	Test::report(name + ": average per log", total * 1000000000.0 / (times.size() * logsPerFrame), "ns");
+	Test::report(name + ": slowest burst per log", times.back() * 1000000000.0 / logsPerFrame, "ns");
+}
+
+/* The time a thread spends logging when the log is written straight away and when it is queued
+ * for the background thread. Logs are written to a file rather than the console so the output of
+ * the benchmarks stays readable */
+BENCHMARK(LoggingLatency) {
+	const unsigned int numFrames = 100;
+	const unsigned int logsPerFrame = 200;
+	bool consoleOutput = Logger::getConsoleOutput();
+	Logger::setConsoleOutput(false);
+	Logger::setBinaryOutput(std::string(TEST_OUTPUT_PATH) + "LoggingBenchmark.bin");
+	//The benchmarks turn every log off
+	LOGGER_INFORMATION_ENABLED = true;
+
+	std::vector<double> times;
+	logFrames(numFrames, logsPerFrame, times);
+	reportTimes("Written straight away", times, logsPerFrame);
+
+	times.clear();
+	Logger::start(4096);
+	unsigned int dropped = Logger::getNumDropped();
+	logFrames(numFrames, logsPerFrame, times);
+	Logger::stop();
+	reportTimes("Queued", times, logsPerFrame);
+	Test::report("Dropped", Logger::getNumDropped() - dropped, "");
+
+	//A disabled log should cost nothing, its message isn't even built
+	LOGGER_INFORMATION_ENABLED = false;
+	times.clear();
+	logFrames(10, logsPerFrame, times);
+	reportTimes("Disabled", times, logsPerFrame);
+
+	Logger::setConsoleOutput(consoleOutput);
+}
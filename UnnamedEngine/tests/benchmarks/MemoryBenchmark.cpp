@@ -0,0 +1,270 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <cstdlib>
+#include <new>
+#include <atomic>
+
+#include "../Test.h"
+#include "core/Memory.h"
+#include "core/Camera.h"
+#include "core/Model.h"
+#include "core/input/Input.h"
+#include "core/gui/Font.h"
+#include "core/gui/GUIButton.h"
+#include "core/gui/GUICheckBox.h"
+#include "core/gui/GUIDropDownMenu.h"
+#include "core/gui/GUIDropDownList.h"
+#include "core/gui/GUIRadioCheckBox.h"
+#include "core/gui/GUITextBox.h"
+#include "core/render/Renderer.h"
+#include "core/render/Scene.h"
+#include "core/render/SpriteBatch.h"
+#include "core/TextureAtlas.h"
+
+/* Every allocation made from the heap by the benchmarks, counted by replacing the global
+ * operator new */
+static std::atomic<unsigned long long> memoryBenchmark_heapAllocations(0);
+
+void* operator new(size_t size) {
+	memoryBenchmark_heapAllocations.fetch_add(1, std::memory_order_relaxed);
+	void* pointer = malloc(size > 0 ? size : 1);
+	if (pointer == NULL)
+		throw std::bad_alloc();
+	return pointer;
+}
+
+void operator delete(void* pointer) noexcept {
+	free(pointer);
+}
+
+static inline unsigned long long getHeapAllocations() {
+	return memoryBenchmark_heapAllocations.load(std::memory_order_relaxed);
+}
+
+/* The allocations made during a number of frames once the first few have warmed up */
+struct FrameAllocationCounts {
+	/* Made from the heap, including any blocks added to the frame arena or chunks to the pools */
+	double heap;
+	/* Made from the frame arena, each of which was made from the heap before it existed */
+	double arena;
+	double time;
+};
+
+/* Runs a frame of a scene */
+class MemoryBenchmarkScene {
+public:
+	virtual ~MemoryBenchmarkScene() {}
+	virtual void frame(unsigned int number) = 0;
+};
+
+static FrameAllocationCounts countFrameAllocations(MemoryBenchmarkScene& scene, unsigned int numFrames) {
+	const unsigned int numWarmFrames = 10;
+	for (unsigned int a = 0; a < numWarmFrames; a++) {
+		scene.frame(a);
+		Memory::nextFrame();
+	}
+	unsigned long long heap = 0;
+	unsigned long long arena = 0;
+	double start = Test::getTime();
+	for (unsigned int a = 0; a < numFrames; a++) {
+		unsigned long long before = getHeapAllocations();
+		scene.frame(numWarmFrames + a);
+		heap += getHeapAllocations() - before;
+		arena += Memory::getFrameArena()->getNumAllocations();
+		Memory::nextFrame();
+	}
+	FrameAllocationCounts counts;
+	counts.heap = (double) heap / numFrames;
+	counts.arena = (double) arena / numFrames;
+	counts.time = (Test::getTime() - start) / numFrames;
+	return counts;
+}
+
+static void reportFrameAllocations(const FrameAllocationCounts& counts) {
+	Test::report("Time per frame", counts.time * 1000000.0, "us");
+	Test::report("Heap allocations per frame without the frame arena", counts.heap + counts.arena, "");
+	Test::report("Heap allocations per frame", counts.heap, "");
+	Test::report("Frame arena allocations per frame", counts.arena, "");
+}
+
+/* Writes an image the stubbed image loader can read, for the font */
+static std::string writeFontImage() {
+	std::string path = std::string(TEST_OUTPUT_PATH) + "MemoryBenchmarkFont.ppm";
+	FILE* file = fopen(path.c_str(), "wb");
+	if (file != NULL) {
+		fprintf(file, "P6 256 256 255\n");
+		std::vector<unsigned char> pixels(256 * 256 * 3, 255);
+		fwrite(&pixels[0], 1, pixels.size(), file);
+		fclose(file);
+	}
+	return path;
+}
+
+/* The widgets of the GUITest game, updated and rendered through a SpriteBatch as the mouse
+ * moves over them */
+class MemoryBenchmarkGUIScene : public MemoryBenchmarkScene {
+private:
+	SpriteBatch* m_batch;
+	std::vector<GUIComponent*> m_components;
+public:
+	MemoryBenchmarkGUIScene() {
+		m_batch = new SpriteBatch();
+
+		std::vector<Colour> colours;
+		colours.push_back(Colour::LIGHT_BLUE);
+		colours.push_back(Colour::BLUE);
+		colours.push_back(Colour::RED);
+
+		GUIButton* button = new GUIButton("Click Me", colours, 100, 20);
+		button->setPosition(20, 100);
+		button->toolTip = new GUIToolTip(button, "Please Click Me!", Colour(Colour::GREY, 0.9f));
+		m_components.push_back(button);
+
+		GUICheckBox* checkBox = new GUICheckBox(colours, 20, 20);
+		checkBox->setPosition(140, 100);
+		m_components.push_back(checkBox);
+
+		GUIDropDownMenu* menu = new GUIDropDownMenu(new GUIButton("File", colours, 100, 20));
+		menu->addButton(new GUIButton("Save", colours, 100, 20));
+		menu->addButton(new GUIButton("Save As", colours, 100, 20));
+		menu->setPosition(180, 100);
+		m_components.push_back(menu);
+
+		GUIDropDownList* list = new GUIDropDownList(new GUIButton("800 x 600", colours, 120, 20));
+		list->addButton(new GUIButton("1024 x 720", colours, 120, 20));
+		list->addButton(new GUIButton("1920 x 1080", colours, 120, 20));
+		list->setPosition(300, 100);
+		m_components.push_back(list);
+
+		GUIGroup* radio = new GUIGroup("RadioButtons");
+		radio->setPosition(20, 200);
+		for (unsigned int a = 0; a < 3; a++) {
+			GUIRadioCheckBox* option = new GUIRadioCheckBox("Option " + to_string(a + 1), colours, 20, 20);
+			option->setPosition(0, a * 30.0f);
+			radio->add(option);
+		}
+		radio->setSize(120, 80);
+		radio->border = new GUIBorder(radio, 1.0f, Colour(Colour::LIGHT_BLUE, 0.3f));
+		radio->borderEnabled = true;
+		m_components.push_back(radio);
+
+		GUITextBox* textBox = new GUITextBox(Colour::WHITE, 200, 20);
+		textBox->setPosition(20, 300);
+		textBox->setDefaultText("Enter something");
+		textBox->border = new GUIBorder(textBox, 1.0f, Colour::LIGHT_BLUE);
+		textBox->borderEnabled = true;
+		m_components.push_back(textBox);
+	}
+
+	virtual ~MemoryBenchmarkGUIScene() {
+		delete m_batch;
+	}
+
+	virtual void frame(unsigned int number) override {
+		//Sweep the mouse back and forth across the widgets
+		Mouse::lastX = (number * 7) % 400;
+		Mouse::lastY = 90 + (number * 3) % 230;
+		for (unsigned int a = 0; a < m_components.size(); a++)
+			m_components[a]->update();
+		m_batch->begin();
+		for (unsigned int a = 0; a < m_components.size(); a++)
+			m_components[a]->render();
+		m_batch->end();
+	}
+};
+
+/* The lighting of the LightingTest game, with a model of a few hundred meshes with materials
+ * standing in for the one it loads, lit by a directional, point and spot light */
+class MemoryBenchmarkLightingScene : public MemoryBenchmarkScene {
+private:
+	MeshData* m_data;
+	Material* m_material;
+	Model* m_model;
+	Scene* m_scene;
+public:
+	MemoryBenchmarkLightingScene() {
+		m_data = new MeshData(true, true, true, true);
+		MeshBuilder::addCubeV(m_data, 0.1f, 0.1f, 0.1f);
+		MeshBuilder::addCubeI(m_data);
+		m_material = new Material();
+		m_model = new Model();
+		for (unsigned int a = 0; a < 200; a++) {
+			Mesh* mesh = new Mesh(m_data, "Material");
+			mesh->getRenderData()->setMaterial(m_material);
+			m_model->addMesh(mesh);
+		}
+		m_model->setPosition(0.0f, 0.0f, -5.0f);
+		m_model->update();
+
+		m_scene = new Scene();
+		m_scene->setMultiDrawEnabled(false);
+		m_scene->add(m_model);
+		m_scene->add(new DirectionalLight(new BaseLight(Colour::WHITE, 1.0f), Vector3f(0.0, 0.0, 1.0)));
+		m_scene->add(new PointLight(new BaseLight(Colour::GREEN, 1.0f), Vector3f(-1.5, 0.0, 0.0), 10.0f));
+		m_scene->add(new SpotLight(new PointLight(new BaseLight(Colour::BLUE, 1.0f), Vector3f(0.0, 0.0, 1.0), 10.0f), Vector3f(0.0, 0.0, -1.0), 0.95f));
+		m_scene->update();
+	}
+
+	virtual ~MemoryBenchmarkLightingScene() {
+		delete m_scene;
+	}
+
+	virtual void frame(unsigned int number) override {
+		m_model->update();
+		m_scene->update();
+		m_scene->render(Vector3f(0.0f, 0.0f, -1.0f));
+	}
+};
+
+/* The allocations made each frame by the scenes of the GUITest and LightingTest games, run with
+ * the OpenGL calls stubbed out. The heap allocations without the frame arena are the ones made
+ * now along with those the arena serves, as each of those was a separate heap allocation */
+BENCHMARK(MemoryGUITestFrame) {
+	glewResetStubs();
+	Renderer::initialise();
+	if (Renderer::TEXTURE_BLANK == NULL)
+		Renderer::TEXTURE_BLANK = new Texture(1000);
+	Renderer::addCamera(new Camera2D(Matrix4f().initOrthographic(0, 1280, 720, 0, -1, 1)));
+	TextureAtlas* atlas = new TextureAtlas(1024, 1024, TextureParameters().setFilter(GL_NEAREST));
+	GUIComponentRenderer::defaultFont = Font::loadFont(atlas, writeFontImage().c_str(), 16, 16);
+
+	MemoryBenchmarkGUIScene scene;
+	FrameAllocationCounts counts = countFrameAllocations(scene, 1000);
+	reportFrameAllocations(counts);
+	//Only the text being laid out again allocates, not the components
+	CHECK(counts.heap < 20);
+	Renderer::removeCamera();
+	glewResetStubs();
+}
+
+BENCHMARK(MemoryLightingTestFrame) {
+	glewResetStubs();
+	Renderer::initialise();
+	if (Renderer::TEXTURE_BLANK == NULL)
+		Renderer::TEXTURE_BLANK = new Texture(1000);
+	Renderer::addCamera(new Camera3D(Matrix4f().initPerspective(80.0f, 16.0f / 9.0f, 1.0f, 100.0f)));
+
+	MemoryBenchmarkLightingScene scene;
+	FrameAllocationCounts counts = countFrameAllocations(scene, 200);
+	reportFrameAllocations(counts);
+	//Drawing the meshes doesn't allocate, only applying each light does
+	CHECK(counts.heap < 200);
+	Renderer::removeCamera();
+	glewResetStubs();
+}
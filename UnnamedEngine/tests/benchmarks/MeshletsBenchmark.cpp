@@ -0,0 +1,93 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <cmath>
+
+#include "../Test.h"
+#include "core/Mesh.h"
+#include "core/Matrix.h"
+#include "core/render/Meshlets.h"
+
+/* Creates a sphere with its triangles wound anticlockwise when seen from outside */
+static MeshData* createSphere(unsigned int rings, unsigned int segments, bool indexed) {
+	MeshData* data = new MeshData(true, true, true, true);
+	std::vector<Vector3f> points;
+	for (unsigned int y = 0; y <= rings; y++) {
+		float latitude = (float) y / rings * 3.14159265f;
+		for (unsigned int x = 0; x <= segments; x++) {
+			float longitude = (float) x / segments * 2.0f * 3.14159265f;
+			points.push_back(Vector3f(sinf(latitude) * cosf(longitude), cosf(latitude), sinf(latitude) * sinf(longitude)) * 10.0f);
+		}
+	}
+	if (indexed) {
+		for (unsigned int a = 0; a < points.size(); a++)
+			data->addPosition(points[a]);
+	}
+	for (unsigned int y = 0; y < rings; y++) {
+		for (unsigned int x = 0; x < segments; x++) {
+			unsigned int corner = y * (segments + 1) + x;
+			unsigned int quad[6] = { corner, corner + 1, corner + segments + 1, corner + 1, corner + segments + 2, corner + segments + 1 };
+			for (unsigned int a = 0; a < 6; a++) {
+				if (indexed)
+					data->addIndex(quad[a]);
+				else
+					data->addPosition(points[quad[a]]);
+			}
+		}
+	}
+	return data;
+}
+
+/* The time to split a large mesh into meshlets, and to cull them from cameras circling it along
+ * with the fraction of triangles left */
+BENCHMARK(MeshletsBuildAndCull) {
+	MeshData* data = createSphere(256, 512, true);
+	double start = Test::getTime();
+	Meshlets::build(data);
+	double buildTime = Test::getTime() - start;
+	std::vector<Meshlet>& meshlets = data->getMeshlets();
+
+	const unsigned int numViews = 1000;
+	Matrix4f projection = Matrix4f().initPerspective(90.0f, 1.0f, 1.0f, 100.0f);
+	Matrix4f identity = Matrix4f().initIdentity();
+	Meshlets::View view;
+	std::vector<MeshletRange> ranges;
+	unsigned long long numTriangles = 0;
+	unsigned long long numRanges = 0;
+	start = Test::getTime();
+	for (unsigned int a = 0; a < numViews; a++) {
+		float angle = (float) a / numViews * 2.0f * 3.14159265f;
+		Vector3f camera(sinf(angle) * 15.0f, 0.0f, cosf(angle) * 15.0f);
+		Matrix4f rotation = Matrix4f().initRotation(-angle * 180.0f / 3.14159265f, 0, 1, 0);
+		Matrix4f translation = Matrix4f().initTranslation(camera * -1.0f);
+		Meshlets::setupView(view, projection * rotation * translation, identity, camera, true);
+		ranges.clear();
+		numTriangles += Meshlets::cull(meshlets, view, ranges);
+		numRanges += ranges.size();
+	}
+	double cullTime = Test::getTime() - start;
+
+	Test::report("Triangles", data->getNumTriangles(), "");
+	Test::report("Meshlets", meshlets.size(), "");
+	Test::report("Triangles per meshlet", (double) data->getNumTriangles() / meshlets.size(), "");
+	Test::report("Build time", buildTime * 1000.0, "ms");
+	Test::report("Cull time per view", cullTime * 1000000.0 / numViews, "us");
+	Test::report("Triangles drawn", numTriangles * 100.0 / ((double) data->getNumTriangles() * numViews), "%");
+	Test::report("Ranges per view", (double) numRanges / numViews, "");
+	delete data;
+}
@@ -0,0 +1,74 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <random>
+
+#include "../Test.h"
+#include "core/Mesh.h"
+#include "core/Matrix.h"
+#include "core/render/OcclusionCuller.h"
+
+/* The time to rasterise a city of box occluders and test the bounds of objects scattered between
+ * them, along with how many of the objects are found to be hidden */
+BENCHMARK(OcclusionCullerCity) {
+	const unsigned int numOccluders = 500;
+	const unsigned int numQueries = 20000;
+	const unsigned int numFrames = 20;
+	std::mt19937 random(1);
+	std::uniform_real_distribution<float> positions(-100.0f, 100.0f);
+	std::uniform_real_distribution<float> sizes(2.0f, 10.0f);
+
+	MeshData* box = new MeshData(true, true, true, true);
+	MeshBuilder::addCubeV(box, 1.0f, 1.0f, 1.0f);
+	MeshBuilder::addCubeI(box);
+	std::vector<Matrix4f> occluders;
+	for (unsigned int a = 0; a < numOccluders; a++) {
+		Matrix4f translation = Matrix4f().initTranslation(Vector3f(positions(random), 0.0f, positions(random) - 110.0f));
+		Matrix4f scale = Matrix4f().initScale(Vector3f(sizes(random), sizes(random) * 3.0f, sizes(random)));
+		occluders.push_back(translation * scale);
+	}
+	std::vector<OcclusionQuery> queries(numQueries);
+	for (unsigned int a = 0; a < numQueries; a++) {
+		queries[a].min = Vector3f(positions(random), positions(random) * 0.1f, positions(random) - 110.0f);
+		queries[a].max = queries[a].min + Vector3f(1.0f, 1.0f, 1.0f);
+	}
+
+	OcclusionCuller culler(320, 180);
+	Matrix4f projection = Matrix4f().initPerspective(110.0f, 16.0f / 9.0f, 0.5f, 300.0f);
+	double rasteriseTime = 0;
+	double testTime = 0;
+	for (unsigned int a = 0; a < numFrames; a++) {
+		double start = Test::getTime();
+		culler.begin(projection * Matrix4f().initTranslation(Vector3f(0.0f, -2.0f, -(float) a)));
+		for (unsigned int b = 0; b < numOccluders; b++)
+			culler.addOccluder(box, occluders[b]);
+		culler.rasterise();
+		double rasterised = Test::getTime();
+		culler.test(queries);
+		rasteriseTime += rasterised - start;
+		testTime += Test::getTime() - rasterised;
+	}
+
+	Test::report("Threads", culler.getNumThreads() + 1, "");
+	Test::report("Occluder triangles", culler.getNumTriangles(), "");
+	Test::report("Rasterise time", rasteriseTime * 1000.0 / numFrames, "ms");
+	Test::report("Test time", testTime * 1000.0 / numFrames, "ms");
+	Test::report("Test time per query", testTime * 1000000000.0 / (numFrames * numQueries), "ns");
+	Test::report("Hidden", culler.getNumRejected() * 100.0 / culler.getNumTested(), "%");
+	delete box;
+}
@@ -0,0 +1,77 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include "../Test.h"
+#include "core/Profiler.h"
+
+/* Prevents the loops from being optimised away */
+static volatile unsigned int profilerBenchmark_sink = 0;
+
+static void profilerBenchmark_work() {
+	profilerBenchmark_sink++;
+}
+
+static void profilerBenchmark_scope() {
+	PROFILE_SCOPE("ProfilerBenchmark");
+	profilerBenchmark_sink++;
+}
+
+/* The cost of a CPU scope, when enabled and disabled at run time, and of ending a frame with
+ * 1,000 scopes in it */
+BENCHMARK(ProfilerScopeOverhead) {
+	const unsigned int scopesPerFrame = 1000;
+	const unsigned int numFrames = 1000;
+	Profiler::nextFrame();
+
+	double start = Test::getTime();
+	for (unsigned int frame = 0; frame < numFrames; frame++) {
+		for (unsigned int a = 0; a < scopesPerFrame; a++)
+			profilerBenchmark_work();
+	}
+	double baseTime = Test::getTime() - start;
+
+	double frameTime = 0;
+	start = Test::getTime();
+	for (unsigned int frame = 0; frame < numFrames; frame++) {
+		for (unsigned int a = 0; a < scopesPerFrame; a++)
+			profilerBenchmark_scope();
+		double frameStart = Test::getTime();
+		Profiler::nextFrame();
+		frameTime += Test::getTime() - frameStart;
+	}
+	double enabledTime = Test::getTime() - start - frameTime;
+	unsigned int numEvents = Profiler::getFrameAt(Profiler::getNumFrames() - 1).events.size();
+
+	Profiler::setEnabled(false);
+	start = Test::getTime();
+	for (unsigned int frame = 0; frame < numFrames; frame++) {
+		for (unsigned int a = 0; a < scopesPerFrame; a++)
+			profilerBenchmark_scope();
+		Profiler::nextFrame();
+	}
+	double disabledTime = Test::getTime() - start;
+	Profiler::setEnabled(true);
+
+	const double numScopes = (double) scopesPerFrame * numFrames;
+	Test::report("Without a scope", baseTime * 1000000000.0 / numScopes, "ns");
+	Test::report("With a scope", enabledTime * 1000000000.0 / numScopes, "ns");
+	Test::report("With the profiler disabled", disabledTime * 1000000000.0 / numScopes, "ns");
+	Test::report("Ending a frame", frameTime * 1000000.0 / numFrames, "us");
+	CHECK_EQUAL(scopesPerFrame, numEvents);
+	Profiler::clear();
+}
@@ -0,0 +1,59 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include "../Test.h"
+#include "core/render/RenderStats.h"
+
+/* Prevents the overlay text from being optimised away */
+static volatile size_t renderStatsBenchmark_sink = 0;
+
+/* The cost of counting a frame of 10,000 draws, and of ending the frame and building the lines
+ * the debug overlay shows over a window of 120 frames */
+BENCHMARK(RenderStatsOverhead) {
+	const unsigned int drawsPerFrame = 10000;
+	const unsigned int numFrames = 1000;
+	RenderStats::setWindowSize(120);
+
+	double countTime = 0;
+	double frameTime = 0;
+	double overlayTime = 0;
+	for (unsigned int frame = 0; frame < numFrames; frame++) {
+		double start = Test::getTime();
+		for (unsigned int a = 0; a < drawsPerFrame; a++) {
+			RenderStats::increment(RENDER_STAT_SHADER_SWITCHES);
+			RenderStats::add(RENDER_STAT_UNIFORM_UPLOADS, 2);
+			RenderStats::addDraw(a % 4 != 0, 36 + a % 100);
+		}
+		countTime += Test::getTime() - start;
+
+		start = Test::getTime();
+		RenderStats::nextFrame();
+		frameTime += Test::getTime() - start;
+
+		start = Test::getTime();
+		for (unsigned int a = 0; a < RENDER_STAT_COUNT; a++)
+			renderStatsBenchmark_sink += RenderStats::toString((RenderStat) a).size();
+		overlayTime += Test::getTime() - start;
+	}
+
+	Test::report("Counting a draw", countTime * 1000000000.0 / ((double) numFrames * drawsPerFrame), "ns");
+	Test::report("Ending a frame", frameTime * 1000000000.0 / numFrames, "ns");
+	Test::report("Building the overlay", overlayTime * 1000000.0 / numFrames, "us");
+	CHECK_EQUAL((unsigned long long) drawsPerFrame, RenderStats::getLast(RENDER_STAT_DRAW_CALLS));
+	CHECK_EQUAL(2ULL * drawsPerFrame, RenderStats::getMax(RENDER_STAT_UNIFORM_UPLOADS));
+}
@@ -0,0 +1,215 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <algorithm>
+#include <random>
+
+#include "../Test.h"
+#include "core/Vector.h"
+#include "core/Matrix.h"
+#include "core/render/SceneSpatialIndex.h"
+
+/* The index only uses objects as keys, so any distinct addresses can stand in for them */
+static const unsigned int NUM_OBJECTS = 100000;
+static char sceneSpatialIndexBenchmark_objects[NUM_OBJECTS];
+
+struct SpatialBenchmarkBounds {
+	Vector3f min;
+	Vector3f max;
+	bool added;
+};
+
+static RenderableObject3D* getObject(unsigned int index) {
+	return (RenderableObject3D*) &sceneSpatialIndexBenchmark_objects[index];
+}
+
+/* The tests made on every object by the linear scan the Scene used before the index */
+static bool overlapsFrustum(const SpatialBenchmarkBounds& bounds, const float planes[6][4]) {
+	for (unsigned int a = 0; a < 6; a++) {
+		float x = planes[a][0] >= 0 ? bounds.max[0] : bounds.min[0];
+		float y = planes[a][1] >= 0 ? bounds.max[1] : bounds.min[1];
+		float z = planes[a][2] >= 0 ? bounds.max[2] : bounds.min[2];
+		if (planes[a][0] * x + planes[a][1] * y + planes[a][2] * z + planes[a][3] < 0)
+			return false;
+	}
+	return true;
+}
+
+static bool overlapsSphere(const SpatialBenchmarkBounds& bounds, const Vector3f& centre, float radius) {
+	float distance = 0;
+	for (unsigned int a = 0; a < 3; a++) {
+		float closest = std::max(bounds.min[a], std::min(centre[a], bounds.max[a]));
+		distance += (centre[a] - closest) * (centre[a] - closest);
+	}
+	return distance <= radius * radius;
+}
+
+static bool overlapsRay(const SpatialBenchmarkBounds& bounds, const Vector3f& origin, const Vector3f& inverseDirection, float maxDistance) {
+	float near = 0.0f;
+	float far = maxDistance;
+	for (unsigned int a = 0; a < 3; a++) {
+		float t1 = (bounds.min[a] - origin[a]) * inverseDirection[a];
+		float t2 = (bounds.max[a] - origin[a]) * inverseDirection[a];
+		near = std::max(near, std::min(t1, t2));
+		far = std::min(far, std::max(t1, t2));
+	}
+	return near <= far;
+}
+
+/* The time to add 100,000 objects, move them around and find the ones in frustums, spheres and
+ * along rays, compared with testing the bounds of every object */
+BENCHMARK(SceneSpatialIndex100k) {
+	const unsigned int numChurns = 10;
+	const unsigned int numQueries = 50;
+	std::mt19937 random(1);
+	std::uniform_real_distribution<float> positions(-500.0f, 500.0f);
+	std::uniform_real_distribution<float> sizes(0.5f, 4.0f);
+	std::uniform_real_distribution<float> moves(-0.1f, 0.1f);
+	std::uniform_real_distribution<float> angles(0.0f, 360.0f);
+	std::vector<SpatialBenchmarkBounds> bounds(NUM_OBJECTS);
+	for (unsigned int a = 0; a < NUM_OBJECTS; a++) {
+		bounds[a].min = Vector3f(positions(random), positions(random), positions(random));
+		bounds[a].max = bounds[a].min + Vector3f(sizes(random), sizes(random), sizes(random));
+		bounds[a].added = true;
+	}
+
+	SceneSpatialIndex index;
+	double start = Test::getTime();
+	for (unsigned int a = 0; a < NUM_OBJECTS; a++)
+		index.update(getObject(a), bounds[a].min, bounds[a].max);
+	double insertTime = Test::getTime() - start;
+	int height = index.getHeight();
+
+	//Each pass moves every object a little, teleports 2% of them and removes and re-adds 1%
+	double churnTime = 0;
+	for (unsigned int a = 0; a < numChurns; a++) {
+		for (unsigned int b = 0; b < NUM_OBJECTS; b++) {
+			unsigned int change = random() % 100;
+			if (change < 2) {
+				bounds[b].min = Vector3f(positions(random), positions(random), positions(random));
+				bounds[b].max = bounds[b].min + Vector3f(sizes(random), sizes(random), sizes(random));
+			} else {
+				Vector3f move(moves(random), moves(random), moves(random));
+				bounds[b].min += move;
+				bounds[b].max += move;
+			}
+			bounds[b].added = change != 2;
+		}
+		start = Test::getTime();
+		for (unsigned int b = 0; b < NUM_OBJECTS; b++) {
+			if (bounds[b].added)
+				index.update(getObject(b), bounds[b].min, bounds[b].max);
+			else
+				index.remove(getObject(b));
+		}
+		churnTime += Test::getTime() - start;
+		//Put the removed objects back for the next pass
+		for (unsigned int b = 0; b < NUM_OBJECTS; b++) {
+			if (! bounds[b].added) {
+				bounds[b].added = true;
+				index.update(getObject(b), bounds[b].min, bounds[b].max);
+			}
+		}
+	}
+
+	//Cameras looking in random directions from random points, along with spheres and rays
+	std::vector<Matrix4f> frustums;
+	std::vector<Vector3f> centres;
+	std::vector<Vector3f> directions;
+	Matrix4f projection = Matrix4f().initPerspective(80.0f, 16.0f / 9.0f, 0.5f, 300.0f);
+	for (unsigned int a = 0; a < numQueries; a++) {
+		Vector3f position(positions(random), positions(random), positions(random));
+		Matrix4f view = Matrix4f().initRotation(angles(random), 0, 1, 0) * Matrix4f().initRotation(angles(random), 1, 0, 0) * Matrix4f().initTranslation(position * -1.0f);
+		frustums.push_back(projection * view);
+		centres.push_back(position);
+		Vector3f direction(moves(random), moves(random), moves(random));
+		float length = direction.length();
+		directions.push_back(Vector3f(direction.getX() / length, direction.getY() / length, direction.getZ() / length));
+	}
+
+	unsigned long long numFound[3] = { 0, 0, 0 };
+	double queryTime[3] = { 0, 0, 0 };
+	for (unsigned int a = 0; a < numQueries; a++) {
+		FrameVector<RenderableObject3D*> found;
+		start = Test::getTime();
+		index.queryFrustum(frustums[a], found);
+		queryTime[0] += Test::getTime() - start;
+		numFound[0] += found.size();
+		found.clear();
+		start = Test::getTime();
+		index.querySphere(centres[a], 50.0f, found);
+		queryTime[1] += Test::getTime() - start;
+		numFound[1] += found.size();
+		found.clear();
+		start = Test::getTime();
+		index.queryRay(centres[a], directions[a], 1000.0f, found);
+		queryTime[2] += Test::getTime() - start;
+		numFound[2] += found.size();
+		Memory::nextFrame();
+	}
+
+	//The scan collects the objects it finds in the same way as the index
+	unsigned long long numScanned[3] = { 0, 0, 0 };
+	double scanTime[3] = { 0, 0, 0 };
+	for (unsigned int a = 0; a < numQueries; a++) {
+		FrameVector<RenderableObject3D*> found;
+		float planes[6][4];
+		start = Test::getTime();
+		frustums[a].getFrustumPlanes(planes);
+		for (unsigned int b = 0; b < NUM_OBJECTS; b++) {
+			if (overlapsFrustum(bounds[b], planes))
+				found.push_back(getObject(b));
+		}
+		scanTime[0] += Test::getTime() - start;
+		numScanned[0] += found.size();
+		found.clear();
+		start = Test::getTime();
+		for (unsigned int b = 0; b < NUM_OBJECTS; b++) {
+			if (overlapsSphere(bounds[b], centres[a], 50.0f))
+				found.push_back(getObject(b));
+		}
+		scanTime[1] += Test::getTime() - start;
+		numScanned[1] += found.size();
+		found.clear();
+		start = Test::getTime();
+		Vector3f inverseDirection(1.0f / directions[a].getX(), 1.0f / directions[a].getY(), 1.0f / directions[a].getZ());
+		for (unsigned int b = 0; b < NUM_OBJECTS; b++) {
+			if (overlapsRay(bounds[b], centres[a], inverseDirection, 1000.0f))
+				found.push_back(getObject(b));
+		}
+		scanTime[2] += Test::getTime() - start;
+		numScanned[2] += found.size();
+		Memory::nextFrame();
+	}
+
+	Test::report("Insert 100,000 objects", insertTime * 1000.0, "ms");
+	Test::report("Tree height", height, "");
+	Test::report("Churn pass (move all, teleport 2%, remove and re-add 1%)", churnTime * 1000.0 / numChurns, "ms");
+	Test::report("Frustum query", queryTime[0] * 1000.0 / numQueries, "ms");
+	Test::report("Frustum linear scan", scanTime[0] * 1000.0 / numQueries, "ms");
+	Test::report("Objects in each frustum", (double) numFound[0] / numQueries, "");
+	Test::report("Sphere query", queryTime[1] * 1000.0 / numQueries, "ms");
+	Test::report("Sphere linear scan", scanTime[1] * 1000.0 / numQueries, "ms");
+	Test::report("Ray query", queryTime[2] * 1000.0 / numQueries, "ms");
+	Test::report("Ray linear scan", scanTime[2] * 1000.0 / numQueries, "ms");
+	//The index finds the same objects as testing every one of them
+	CHECK_EQUAL(numScanned[0], numFound[0]);
+	CHECK_EQUAL(numScanned[1], numFound[1]);
+	CHECK_EQUAL(numScanned[2], numFound[2]);
+	CHECK_EQUAL(NUM_OBJECTS, index.getNumObjects());
+}
@@ -0,0 +1,88 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <map>
+
+#include "../Test.h"
+#include "core/render/Renderer.h"
+
+/* Prevents the lookups from being optimised away */
+static volatile size_t shaderDispatchBenchmark_sink = 0;
+
+/* The time to find the shader for a draw by its handle, by its name as the string overloads do
+ * and through a map of names as every draw did before handles. Then the time to draw 100,000
+ * meshes through the Renderer with the OpenGL calls stubbed out, using handles and names */
+BENCHMARK(ShaderDispatch) {
+	const unsigned int numLookups = 1000000;
+	const unsigned int numDraws = 100000;
+	glewResetStubs();
+	Renderer::initialise();
+	if (Renderer::TEXTURE_BLANK == NULL)
+		Renderer::TEXTURE_BLANK = new Texture(1000);
+	Renderer::addCamera(new Camera2D(Matrix4f().initIdentity()));
+
+	const char* names[] = { "Basic", "Material", "Quad", "SpotLight" };
+	const unsigned int handles[] = { SHADER_TYPE_BASIC, SHADER_TYPE_MATERIAL, SHADER_TYPE_QUAD, SHADER_TYPE_SPOT_LIGHT };
+	std::map<std::string, RenderShader*> shaders;
+	for (unsigned int a = 0; a < 4; a++)
+		shaders.insert(std::pair<std::string, RenderShader*>(names[a], Renderer::getRenderShader(handles[a])));
+
+	double start = Test::getTime();
+	for (unsigned int a = 0; a < numLookups; a++)
+		shaderDispatchBenchmark_sink += (size_t) Renderer::getShader(handles[a % 4]);
+	double handleTime = Test::getTime() - start;
+
+	start = Test::getTime();
+	for (unsigned int a = 0; a < numLookups; a++)
+		shaderDispatchBenchmark_sink += (size_t) Renderer::getShader(names[a % 4]);
+	double nameTime = Test::getTime() - start;
+
+	start = Test::getTime();
+	for (unsigned int a = 0; a < numLookups; a++)
+		shaderDispatchBenchmark_sink += (size_t) shaders.find(names[a % 4])->second->getShader();
+	double mapTime = Test::getTime() - start;
+
+	std::vector<Mesh*> meshes;
+	for (unsigned int a = 0; a < 100; a++)
+		meshes.push_back(MeshBuilder::createQuad(Vector2f(0, 0), Vector2f(10, 10)));
+	Matrix4f modelMatrix = Matrix4f().initIdentity();
+
+	start = Test::getTime();
+	for (unsigned int a = 0; a < numDraws; a++)
+		Renderer::render(meshes[a % meshes.size()], modelMatrix, SHADER_TYPE_BASIC);
+	double handleDrawTime = Test::getTime() - start;
+
+	start = Test::getTime();
+	for (unsigned int a = 0; a < numDraws; a++)
+		Renderer::render(meshes[a % meshes.size()], modelMatrix, "Basic");
+	double nameDrawTime = Test::getTime() - start;
+
+	Test::report("Lookup by handle", handleTime * 1000000000.0 / numLookups, "ns");
+	Test::report("Lookup by name", nameTime * 1000000000.0 / numLookups, "ns");
+	Test::report("Lookup in a map of names", mapTime * 1000000000.0 / numLookups, "ns");
+	Test::report("Drawing 100,000 meshes by handle", handleDrawTime * 1000.0, "ms");
+	Test::report("Drawing 100,000 meshes by name", nameDrawTime * 1000.0, "ms");
+	CHECK(Renderer::getShader(SHADER_TYPE_BASIC) == Renderer::getShader("Basic"));
+
+	for (unsigned int a = 0; a < meshes.size(); a++) {
+		delete meshes[a]->getRenderData();
+		delete meshes[a]->getData();
+		delete meshes[a];
+	}
+	glewResetStubs();
+}
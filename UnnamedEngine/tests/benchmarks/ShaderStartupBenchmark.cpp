@@ -0,0 +1,95 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <thread>
+#include <cstdio>
+
+#include "../Test.h"
+#include "core/render/ShaderManager.h"
+#include "core/render/UberShader.h"
+
+/* There is no driver, so linking is given a fixed cost and binaries are a few bytes */
+static const double LINK_MILLISECONDS = 2.0;
+static const GLint BINARY_LENGTH = 64;
+
+static void APIENTRY benchmark_linkProgram(GLuint program) {
+	std::this_thread::sleep_for(std::chrono::microseconds((long long) (LINK_MILLISECONDS * 1000.0)));
+}
+
+/* Binaries left by an earlier run are rejected until the first run has compiled its own */
+static bool benchmark_acceptBinaries = false;
+static GLuint benchmark_binaryProgram = 0;
+
+static void APIENTRY benchmark_programBinary(GLuint program, GLenum format, const void* binary, GLsizei length) {
+	benchmark_binaryProgram = program;
+}
+
+static void APIENTRY benchmark_getProgramiv(GLuint program, GLenum name, GLint* value) {
+	if (name == GL_PROGRAM_BINARY_LENGTH)
+		*value = BINARY_LENGTH;
+	else if (name == GL_LINK_STATUS && program == benchmark_binaryProgram)
+		*value = benchmark_acceptBinaries ? GL_TRUE : GL_FALSE;
+	else
+		*value = GL_TRUE;
+}
+
+static void APIENTRY benchmark_getProgramBinary(GLuint program, GLsizei size, GLsizei* length, GLenum* format, void* binary) {
+	*format = 1;
+	for (GLsizei a = 0; a < size; a++)
+		((char*) binary)[a] = (char) a;
+}
+
+/* Loads every lighting permutation the Renderer prewarms, returning the time taken in seconds */
+static double loadLightingShaders() {
+	double start = Test::getTime();
+	Shader::clearIncludeCache();
+	UberShader* shader = new UberShader("resources/shaders/lighting/", "Lighting");
+	const unsigned int lights[] = { SHADER_FEATURE_AMBIENT_LIGHT, SHADER_FEATURE_DIRECTIONAL_LIGHT, SHADER_FEATURE_POINT_LIGHT, SHADER_FEATURE_SPOT_LIGHT };
+	for (unsigned int a = 0; a < 4; a++) {
+		unsigned int key = lights[a] | SHADER_FEATURE_TEXTURE | SHADER_FEATURE_NORMALS | SHADER_FEATURE_SHADOWS;
+		shader->prewarm(key);
+		shader->prewarm(key | SHADER_FEATURE_MULTI_DRAW);
+	}
+	ShaderManager::finish();
+	double time = Test::getTime() - start;
+	delete shader;
+	return time;
+}
+
+/* The time to load the lighting shaders on the first run, when they have to be compiled, and on
+ * later runs that use the program binaries cached by the first */
+BENCHMARK(ShaderStartup) {
+	__glewLinkProgram = benchmark_linkProgram;
+	__glewGetProgramiv = benchmark_getProgramiv;
+	__glewGetProgramBinary = benchmark_getProgramBinary;
+	__glewProgramBinary = benchmark_programBinary;
+	__GLEW_ARB_get_program_binary = GL_TRUE;
+	ShaderManager::initialise(TEST_OUTPUT_PATH "shader-");
+
+	benchmark_acceptBinaries = false;
+	double uncached = loadLightingShaders();
+	benchmark_acceptBinaries = true;
+	double cached = loadLightingShaders();
+	Test::report("Simulated link time", LINK_MILLISECONDS, "ms per program");
+	Test::report("First run", uncached * 1000.0, "ms");
+	Test::report("Cached run", cached * 1000.0, "ms");
+	CHECK(cached < uncached);
+
+	ShaderManager::setCachePath("");
+	glewResetStubs();
+}
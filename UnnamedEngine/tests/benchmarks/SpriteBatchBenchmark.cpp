@@ -0,0 +1,73 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include "../Test.h"
+#include "core/render/SpriteBatch.h"
+#include "core/render/Renderer.h"
+
+/* The draws made, so they can be compared with the number of quads */
+static unsigned int spriteBatchBenchmark_numDraws = 0;
+
+static void APIENTRY spriteBatchBenchmark_drawElements(GLenum mode, GLsizei count, GLenum type, const void* indices) {
+	spriteBatchBenchmark_numDraws++;
+}
+
+/* The time taken to submit quads to a batch and draw them, for a GUI using one atlas and for one
+ * where every other quad changes texture. There is no driver so this is only the time spent on the
+ * CPU, which is what the batch replaces one draw call per quad with */
+BENCHMARK(SpriteBatchQuads) {
+	glewResetStubs();
+	__glewDrawElements = spriteBatchBenchmark_drawElements;
+	Renderer::initialise();
+	if (Renderer::TEXTURE_BLANK == NULL)
+		Renderer::TEXTURE_BLANK = new Texture(1000);
+	Renderer::addCamera(new Camera2D(Matrix4f().initIdentity()));
+
+	MeshData* data = new MeshData();
+	MeshBuilder::addQuadV(data, Vector2f(0, 0), Vector2f(10, 10));
+	MeshBuilder::addQuadI(data);
+	Mesh mesh(data, (MeshRenderData*) NULL);
+	Texture atlas(1);
+	Texture other(2);
+	SpriteBatch* batch = new SpriteBatch();
+
+	const unsigned int numQuads = 10000;
+	const unsigned int numFrames = 100;
+	for (unsigned int a = 0; a < 2; a++) {
+		std::string name = a == 0 ? "One atlas: " : "Alternating textures: ";
+		spriteBatchBenchmark_numDraws = 0;
+		double start = Test::getTime();
+		for (unsigned int frame = 0; frame < numFrames; frame++) {
+			batch->begin();
+			for (unsigned int b = 0; b < numQuads; b++) {
+				Matrix4f modelMatrix = Matrix4f().initTranslation(Vector3f((float) (b % 100) * 10.0f, (float) (b / 100) * 10.0f, 0.0f));
+				batch->addQuad(&mesh, modelMatrix, (a == 1 && b % 2 == 1) ? &other : &atlas, Colour::WHITE);
+			}
+			batch->end();
+		}
+		double time = Test::getTime() - start;
+		Test::report(name + "time per frame", time * 1000.0 / numFrames, "ms");
+		Test::report(name + "time per quad", time * 1000000000.0 / (numFrames * numQuads), "ns");
+		Test::report(name + "draws per frame", spriteBatchBenchmark_numDraws / numFrames, "");
+		CHECK_EQUAL(a == 0 ? 1u : numQuads, spriteBatchBenchmark_numDraws / numFrames);
+	}
+
+	delete batch;
+	delete data;
+	glewResetStubs();
+}
@@ -0,0 +1,108 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <random>
+
+#include "../Test.h"
+#include "core/Profiler.h"
+#include "core/render/Renderer.h"
+#include "core/render/Scene.h"
+
+/* Renders the scene a number of times, returning the average time taken in seconds and giving
+ * the draw calls made in a frame */
+static double renderScene(Scene* scene, unsigned int numFrames, unsigned long long& numDraws) {
+	double start = Test::getTime();
+	for (unsigned int a = 0; a < numFrames; a++) {
+		RenderStats::nextFrame();
+		scene->render(Vector3f(0, 0, 0));
+		Memory::nextFrame();
+		Profiler::nextFrame();
+	}
+	double time = (Test::getTime() - start) / numFrames;
+	numDraws = RenderStats::getCurrent(RENDER_STAT_DRAW_CALLS);
+	return time;
+}
+
+/* The time to render 5,000 cubes with the ambient light, one draw each and after the ones marked
+ * as static have been merged by bakeStatic, with the OpenGL calls stubbed out so only the time on
+ * the CPU is seen */
+BENCHMARK(StaticBatching) {
+	const unsigned int numCubes = 5000;
+	const unsigned int numFrames = 20;
+	//Every tenth cube may move, so is left out of the batches
+	const unsigned int numMoving = numCubes / 10;
+	glewResetStubs();
+	Renderer::initialise();
+	if (Renderer::TEXTURE_BLANK == NULL)
+		Renderer::TEXTURE_BLANK = new Texture(1000);
+	//Looking down the z axis at all of the cubes
+	Renderer::addCamera(new Camera3D(Matrix4f().initPerspective(110.0f, 2.0f, 1.0f, 500.0f)));
+
+	MeshData* data = new MeshData(true, false, false, true);
+	MeshBuilder::addCubeV(data, 1.0f, 1.0f, 1.0f);
+	MeshBuilder::addCubeI(data);
+	Mesh* mesh = new Mesh(data, "Basic");
+
+	std::mt19937 random(1);
+	std::uniform_real_distribution<float> angles(0.0f, 360.0f);
+	Scene* scene = new Scene();
+	scene->setMultiDrawEnabled(false);
+	std::vector<RenderableObject3D*> cubes;
+	for (unsigned int a = 0; a < numCubes; a++) {
+		RenderableObject3D* cube = new RenderableObject3D(mesh);
+		cube->setPosition((float) (a % 100) * 3.0f - 150.0f, (float) (a / 100) * 3.0f - 75.0f, -100.0f);
+		cube->setRotation(angles(random), angles(random), 0.0f);
+		cube->setStatic(a % 10 != 0);
+		cube->update();
+		scene->add(cube);
+		cubes.push_back(cube);
+	}
+	scene->update();
+	Profiler::nextFrame();
+
+	unsigned long long drawsBefore = 0;
+	double before = renderScene(scene, numFrames, drawsBefore);
+
+	double start = Test::getTime();
+	unsigned int numBatches = scene->bakeStatic(50.0f);
+	double bakeTime = Test::getTime() - start;
+	scene->update();
+
+	unsigned long long drawsAfter = 0;
+	double after = renderScene(scene, numFrames, drawsAfter);
+
+	Test::report("Cubes", numCubes, "");
+	Test::report("Cubes not marked as static", numMoving, "");
+	Test::report("Draw calls before merging", drawsBefore, "");
+	Test::report("Frame time before merging", before * 1000.0, "ms");
+	Test::report("Merging", bakeTime * 1000.0, "ms");
+	Test::report("Draw calls after merging", drawsAfter, "");
+	Test::report("Frame time after merging", after * 1000.0, "ms");
+	CHECK_EQUAL((unsigned long long) numCubes, drawsBefore);
+	CHECK_EQUAL((unsigned long long) (numBatches + numMoving), drawsAfter);
+	CHECK(numBatches > 1 && numBatches < 50);
+
+	delete scene;
+	for (unsigned int a = 0; a < cubes.size(); a++)
+		delete cubes[a];
+	delete mesh->getRenderData();
+	delete mesh;
+	delete data;
+	Profiler::clear();
+	glewResetStubs();
+}
@@ -0,0 +1,110 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <random>
+#include <algorithm>
+#include <functional>
+
+#include "../Test.h"
+#include "core/TextureAtlas.h"
+
+/* The sizes of the images packed, similar to glyphs and GUI images */
+static void createSizes(std::vector<int>& sizes, unsigned int count, int minSize, int maxSize) {
+	std::mt19937 random(1);
+	std::uniform_int_distribution<int> distribution(minSize, maxSize);
+	sizes.resize(count * 2);
+	for (unsigned int a = 0; a < sizes.size(); a++)
+		sizes[a] = distribution(random);
+}
+
+/* The time to pack rectangles into an area until one doesn't fit, and how much of it they fill,
+ * in the order they come and sorted by height as defragmenting does */
+BENCHMARK(AtlasPackerEfficiency) {
+	const int sizeRanges[3][2] = { { 6, 24 }, { 16, 64 }, { 8, 128 } };
+	for (unsigned int a = 0; a < 3; a++) {
+		std::vector<int> sizes;
+		createSizes(sizes, 100000, sizeRanges[a][0], sizeRanges[a][1]);
+		std::string name = std::to_string(sizeRanges[a][0]) + "-" + std::to_string(sizeRanges[a][1]) + " pixels: ";
+		for (unsigned int b = 0; b < 2; b++) {
+			AtlasPacker packer(2048, 2048);
+			unsigned int numPacked = 0;
+			double start = Test::getTime();
+			int x;
+			int y;
+			while (numPacked * 2 < sizes.size() && packer.pack(sizes[numPacked * 2], sizes[numPacked * 2 + 1], x, y))
+				numPacked++;
+			double time = Test::getTime() - start;
+
+			if (b == 0) {
+				Test::report(name + "packed", numPacked, "");
+				Test::report(name + "time per rectangle", time * 1000000000.0 / numPacked, "ns");
+				Test::report(name + "occupancy", packer.getOccupancy() * 100.0f, "%");
+
+				//Sorting the rectangles by height first
+				std::vector<std::pair<int, int> > sorted;
+				for (unsigned int c = 0; c < sizes.size(); c += 2)
+					sorted.push_back(std::pair<int, int>(sizes[c + 1], sizes[c]));
+				std::stable_sort(sorted.begin(), sorted.end(), std::greater<std::pair<int, int> >());
+				for (unsigned int c = 0; c < sorted.size(); c++) {
+					sizes[c * 2] = sorted[c].second;
+					sizes[c * 2 + 1] = sorted[c].first;
+				}
+			} else {
+				Test::report(name + "sorted packed", numPacked, "");
+				Test::report(name + "sorted occupancy", packer.getOccupancy() * 100.0f, "%");
+			}
+		}
+	}
+}
+
+/* The time to add images to an atlas, and to add more once half of them have been removed, which
+ * defragments it */
+BENCHMARK(TextureAtlasInsertion) {
+	const unsigned int numImages = 2000;
+	std::vector<int> sizes;
+	createSizes(sizes, numImages * 2, 8, 32);
+	std::vector<unsigned char> pixels(32 * 32 * 4, 255);
+	TextureAtlas* atlas = new TextureAtlas(1024, 1024);
+
+	std::vector<Texture*> textures;
+	double start = Test::getTime();
+	for (unsigned int a = 0; a < numImages; a++)
+		textures.push_back(atlas->add(&pixels[0], sizes[a * 2], sizes[a * 2 + 1], 4));
+	double addTime = Test::getTime() - start;
+	CHECK(std::find(textures.begin(), textures.end(), (Texture*) NULL) == textures.end());
+	float occupancy = atlas->getPackedOccupancy();
+
+	for (unsigned int a = 0; a < numImages; a += 2)
+		atlas->remove(textures[a]);
+	unsigned int numAdded = 0;
+	start = Test::getTime();
+	for (unsigned int a = numImages; a < numImages + numImages / 2; a++) {
+		if (atlas->add(&pixels[0], sizes[a * 2], sizes[a * 2 + 1], 4) != NULL)
+			numAdded++;
+	}
+	double refillTime = Test::getTime() - start;
+
+	Test::report("Images", numImages, "");
+	Test::report("Time per image", addTime * 1000000.0 / numImages, "us");
+	Test::report("Occupancy", occupancy * 100.0f, "%");
+	Test::report("Time per image after removing half", refillTime * 1000000.0 / (numImages / 2), "us");
+	Test::report("Images added after removing half", numAdded, "");
+	Test::report("Occupancy after removing half", atlas->getOccupancy() * 100.0f, "%");
+	CHECK_EQUAL(numImages / 2, numAdded);
+	delete atlas;
+}
@@ -0,0 +1,95 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <cmath>
+#include <random>
+
+#include "../Test.h"
+#include "core/render/TextureResidency.h"
+
+/* A camera flying over a grid of 2,500 textured objects with a budget of a 32nd of their full
+ * size. Reports the bytes resident over time, how often the visible textures had the detail they
+ * asked for and the time taken to update each frame. Loads take a few frames to finish */
+BENCHMARK(TextureResidencyCameraPath) {
+	const unsigned int gridSize = 50;
+	const float spacing = 20.0f;
+	const float viewDistance = 200.0f;
+	const unsigned int numFrames = 3000;
+	const unsigned int loadFrames = 3;
+
+	std::mt19937 random(1);
+	std::uniform_int_distribution<int> sizes(7, 11);
+	std::vector<int> textureSizes;
+	long long totalBytes = 0;
+	for (unsigned int a = 0; a < gridSize * gridSize; a++) {
+		textureSizes.push_back(1 << sizes(random));
+		totalBytes += TextureResidency::getBytes(textureSizes.back(), textureSizes.back(), 4, 0);
+	}
+	TextureResidency residency(totalBytes / 32);
+	for (unsigned int a = 0; a < textureSizes.size(); a++)
+		residency.add(textureSizes[a], textureSizes[a], 4, 64);
+
+	std::vector<std::vector<TextureResidency::Change> > inFlight(loadFrames);
+	std::vector<TextureResidency::Change> evictions;
+	long long peakBytes = 0;
+	unsigned int numRequests = 0;
+	unsigned int numSatisfied = 0;
+	double updateTime = 0;
+	for (unsigned int frame = 0; frame < numFrames; frame++) {
+		//Circling the centre of the grid
+		float angle = (float) frame / numFrames * 6.2831853f * 2.0f;
+		float cameraX = gridSize * spacing * (0.5f + 0.35f * cos(angle));
+		float cameraY = gridSize * spacing * (0.5f + 0.35f * sin(angle));
+		for (unsigned int a = 0; a < textureSizes.size(); a++) {
+			float dx = (a % gridSize) * spacing - cameraX;
+			float dy = (a / gridSize) * spacing - cameraY;
+			float distance = sqrt(dx * dx + dy * dy);
+			if (distance < viewDistance) {
+				float screenSize = 8192.0f / std::max(distance, 1.0f);
+				int mip = TextureResidency::calculateMip(textureSizes[a], textureSizes[a], screenSize);
+				residency.request(a, mip, screenSize);
+				numRequests++;
+				if (residency.getResidentMip(a) <= mip)
+					numSatisfied++;
+			}
+		}
+
+		//Finish the loads started a few frames ago
+		std::vector<TextureResidency::Change>& finished = inFlight[frame % loadFrames];
+		for (unsigned int a = 0; a < finished.size(); a++)
+			residency.loaded(finished[a].id, finished[a].mip);
+		finished.clear();
+
+		double start = Test::getTime();
+		residency.update(finished, evictions);
+		updateTime += Test::getTime() - start;
+
+		peakBytes = std::max(peakBytes, residency.getResidentBytes());
+		if (frame % 500 == 0)
+			Test::report("Resident at frame " + std::to_string(frame), residency.getResidentBytes() / (1024.0 * 1024.0), "MB");
+	}
+
+	Test::report("Textures", textureSizes.size(), "");
+	Test::report("All at full detail", totalBytes / (1024.0 * 1024.0), "MB");
+	Test::report("Budget", residency.getBudget() / (1024.0 * 1024.0), "MB");
+	Test::report("Peak resident", peakBytes / (1024.0 * 1024.0), "MB");
+	Test::report("Evictions", residency.getNumEvictions(), "");
+	Test::report("Requests with the detail wanted", numSatisfied * 100.0 / numRequests, "%");
+	Test::report("Update time", updateTime * 1000000.0 / numFrames, "us");
+	CHECK(peakBytes <= residency.getBudget());
+}
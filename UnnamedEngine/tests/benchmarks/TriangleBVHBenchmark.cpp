@@ -0,0 +1,140 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <cmath>
+#include <random>
+
+#include "../Test.h"
+#include "core/Mesh.h"
+#include "core/render/TriangleBVH.h"
+
+/* Returns the distance a ray hits a triangle at, or a negative value when it misses */
+static float intersectTriangle(const Vector3f& origin, const Vector3f& direction, const float* v0, const float* v1, const float* v2) {
+	float e1[3] = { v1[0] - v0[0], v1[1] - v0[1], v1[2] - v0[2] };
+	float e2[3] = { v2[0] - v0[0], v2[1] - v0[1], v2[2] - v0[2] };
+	float p[3] = { direction[1] * e2[2] - direction[2] * e2[1], direction[2] * e2[0] - direction[0] * e2[2], direction[0] * e2[1] - direction[1] * e2[0] };
+	float determinant = e1[0] * p[0] + e1[1] * p[1] + e1[2] * p[2];
+	if (determinant == 0)
+		return -1;
+	float t[3] = { origin[0] - v0[0], origin[1] - v0[1], origin[2] - v0[2] };
+	float u = (t[0] * p[0] + t[1] * p[1] + t[2] * p[2]) / determinant;
+	if (u < 0 || u > 1)
+		return -1;
+	float q[3] = { t[1] * e1[2] - t[2] * e1[1], t[2] * e1[0] - t[0] * e1[2], t[0] * e1[1] - t[1] * e1[0] };
+	float v = (direction[0] * q[0] + direction[1] * q[1] + direction[2] * q[2]) / determinant;
+	if (v < 0 || u + v > 1)
+		return -1;
+	return (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]) / determinant;
+}
+
+/* Creates a bumpy sphere made from a grid of quads, standing in for a high detail model as the
+ * model loader isn't available here */
+static MeshData* createBumpySphere(unsigned int segments) {
+	const float pi = 3.14159265f;
+	MeshData* data = new MeshData(true, true, true, true);
+	for (unsigned int y = 0; y <= segments; y++) {
+		float latitude = pi * y / segments;
+		for (unsigned int x = 0; x <= segments; x++) {
+			float longitude = 2.0f * pi * x / segments;
+			float radius = 1.0f + 0.05f * std::sin(latitude * 23.0f) * std::cos(longitude * 17.0f);
+			data->addPosition(Vector3f(radius * std::sin(latitude) * std::cos(longitude), radius * std::cos(latitude), radius * std::sin(latitude) * std::sin(longitude)));
+		}
+	}
+	for (unsigned int y = 0; y < segments; y++) {
+		for (unsigned int x = 0; x < segments; x++) {
+			unsigned int corner = y * (segments + 1) + x;
+			data->addIndex(corner);
+			data->addIndex(corner + 1);
+			data->addIndex(corner + segments + 1);
+			data->addIndex(corner + 1);
+			data->addIndex(corner + segments + 2);
+			data->addIndex(corner + segments + 1);
+		}
+	}
+	return data;
+}
+
+/* The time to build the hierarchy for a mesh of half a million triangles and the number of rays
+ * traced through it each second, compared with testing every triangle */
+BENCHMARK(TriangleBVHHighPoly) {
+	const unsigned int numRays = 200000;
+	const unsigned int numBruteForceRays = 50;
+	MeshData* data = createBumpySphere(512);
+
+	double start = Test::getTime();
+	TriangleBVH* bvh = new TriangleBVH(data);
+	double buildTime = Test::getTime() - start;
+
+	//Rays from points around the sphere aimed somewhere near its centre, so some of them miss
+	std::mt19937 random(1);
+	std::uniform_real_distribution<float> origins(-3.0f, 3.0f);
+	std::uniform_real_distribution<float> targets(-1.2f, 1.2f);
+	std::vector<Vector3f> rayOrigins;
+	std::vector<Vector3f> rayDirections;
+	for (unsigned int a = 0; a < numRays; a++) {
+		Vector3f origin(origins(random), origins(random), origins(random));
+		if (origin.length() < 1.5f)
+			origin = origin * (1.5f / origin.length());
+		rayOrigins.push_back(origin);
+		rayDirections.push_back(Vector3f(targets(random), targets(random), targets(random)) - origin);
+	}
+
+	unsigned int numHits = 0;
+	std::vector<float> distances(numRays, -1.0f);
+	start = Test::getTime();
+	for (unsigned int a = 0; a < numRays; a++) {
+		RayHit hit;
+		if (bvh->intersect(rayOrigins[a], rayDirections[a], 1e30f, hit)) {
+			distances[a] = hit.distance;
+			numHits++;
+		}
+	}
+	double traceTime = Test::getTime() - start;
+
+	unsigned int numTriangles = data->getNumTriangles();
+	const unsigned int* indices = &data->getIndices()[0];
+	unsigned int numMatching = 0;
+	start = Test::getTime();
+	for (unsigned int a = 0; a < numBruteForceRays; a++) {
+		float closest = -1.0f;
+		for (unsigned int b = 0; b < numTriangles; b++) {
+			float distance = intersectTriangle(rayOrigins[a], rayDirections[a],
+					data->getValues(MeshBuffers::ATTRIBUTE_POSITION, indices[b * 3]),
+					data->getValues(MeshBuffers::ATTRIBUTE_POSITION, indices[b * 3 + 1]),
+					data->getValues(MeshBuffers::ATTRIBUTE_POSITION, indices[b * 3 + 2]));
+			if (distance >= 0 && (closest < 0 || distance < closest))
+				closest = distance;
+		}
+		if ((closest < 0) == (distances[a] < 0) && std::fabs(closest - distances[a]) < 0.0001f)
+			numMatching++;
+	}
+	double bruteForceTime = Test::getTime() - start;
+
+	Test::report("Triangles", numTriangles, "");
+	Test::report("Build time", buildTime * 1000.0, "ms");
+	Test::report("Nodes", bvh->getNumNodes(), "");
+	Test::report("Memory", bvh->getMemoryUsage() / (1024.0 * 1024.0), "MB");
+	Test::report("Rays per second", numRays / traceTime, "");
+	Test::report("Rays per second testing every triangle", numBruteForceRays / bruteForceTime, "");
+	Test::report("Rays hitting the mesh", numHits * 100.0 / numRays, "%");
+	CHECK_EQUAL(numTriangles, bvh->getNumTriangles());
+	//Both find the same closest triangle
+	CHECK_EQUAL(numBruteForceRays, numMatching);
+	delete bvh;
+	delete data;
+}
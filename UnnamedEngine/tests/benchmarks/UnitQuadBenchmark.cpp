@@ -0,0 +1,123 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include "../Test.h"
+#include "core/Object.h"
+#include "core/render/Renderer.h"
+#include "core/render/RenderStats.h"
+
+/* The vertex arrays and buffers created */
+static unsigned int unitQuadBenchmark_numVertexArrays = 0;
+static unsigned int unitQuadBenchmark_numBuffers = 0;
+static GLuint unitQuadBenchmark_lastName = 100000;
+
+/* The bytes of buffer storage allocated */
+static unsigned long long unitQuadBenchmark_bufferBytes = 0;
+
+static void APIENTRY unitQuadBenchmark_genVertexArrays(GLsizei count, GLuint* names) {
+	unitQuadBenchmark_numVertexArrays += count;
+	for (GLsizei a = 0; a < count; a++)
+		names[a] = ++unitQuadBenchmark_lastName;
+}
+
+static void APIENTRY unitQuadBenchmark_genBuffers(GLsizei count, GLuint* names) {
+	unitQuadBenchmark_numBuffers += count;
+	for (GLsizei a = 0; a < count; a++)
+		names[a] = ++unitQuadBenchmark_lastName;
+}
+
+static void APIENTRY unitQuadBenchmark_bufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage) {
+	unitQuadBenchmark_bufferBytes += size;
+}
+
+/* Creating and resizing 1,000 widgets with a quad mesh of their own, as they were before, and
+ * with the unit quad they share now. Reports the OpenGL objects created, the bytes of vertex
+ * memory they use, the bytes uploaded when every widget is resized and the time taken on the CPU */
+BENCHMARK(UnitQuadWidgets) {
+	const unsigned int numWidgets = 1000;
+	glewResetStubs();
+	Renderer::initialise();
+	__glewGenVertexArrays = unitQuadBenchmark_genVertexArrays;
+	__glewGenBuffers = unitQuadBenchmark_genBuffers;
+	__glewBufferData = unitQuadBenchmark_bufferData;
+
+	unsigned long long ownVertexBytes = 0;
+	for (unsigned int a = 0; a < 2; a++) {
+		bool shared = a == 1;
+		std::string name = shared ? "Shared quad: " : "Own quads: ";
+		unitQuadBenchmark_numVertexArrays = 0;
+		unitQuadBenchmark_numBuffers = 0;
+		unitQuadBenchmark_bufferBytes = 0;
+
+		std::vector<RenderableObject2D*> widgets;
+		double start = Test::getTime();
+		for (unsigned int b = 0; b < numWidgets; b++) {
+			Mesh* mesh = shared ? MeshBuilder::createUnitQuad() : MeshBuilder::createQuad(Vector2f(0, 0), Vector2f(100, 20));
+			RenderableObject2D* widget = new RenderableObject2D(mesh, 100.0f, 20.0f);
+			widget->update();
+			widgets.push_back(widget);
+		}
+		double createTime = Test::getTime() - start;
+		unsigned long long vertexBytes = unitQuadBenchmark_bufferBytes;
+
+		//Resizing every widget, before this meant updating the vertices of each mesh
+		RenderStats::nextFrame();
+		start = Test::getTime();
+		for (unsigned int b = 0; b < numWidgets; b++) {
+			RenderableObject2D* widget = widgets[b];
+			widget->setSize(120.0f, 30.0f);
+			if (! shared) {
+				std::vector<float>& positions = widget->getMesh()->getData()->getPositions();
+				for (unsigned int c = 0; c < positions.size(); c += 3) {
+					positions[c] = positions[c] > 0 ? 120.0f : 0.0f;
+					positions[c + 1] = positions[c + 1] > 0 ? 30.0f : 0.0f;
+				}
+				widget->getMesh()->updateVertices();
+			}
+			widget->update();
+		}
+		double resizeTime = Test::getTime() - start;
+		unsigned long long uploaded = RenderStats::getCurrent(RENDER_STAT_BUFFER_BYTES);
+
+		Test::report(name + "vertex arrays", unitQuadBenchmark_numVertexArrays, "");
+		Test::report(name + "buffers", unitQuadBenchmark_numBuffers, "");
+		Test::report(name + "bytes of vertex memory", vertexBytes, "");
+		Test::report(name + "creating a widget", createTime * 1000000000.0 / numWidgets, "ns");
+		Test::report(name + "resizing a widget", resizeTime * 1000000000.0 / numWidgets, "ns");
+		Test::report(name + "bytes uploaded resizing", uploaded, "");
+		if (! shared)
+			ownVertexBytes = vertexBytes;
+		else {
+			//At most the vertices of a single quad
+			CHECK(vertexBytes * numWidgets <= ownVertexBytes);
+			CHECK(unitQuadBenchmark_numVertexArrays <= 1);
+			CHECK_EQUAL(0ULL, uploaded);
+		}
+
+		for (unsigned int b = 0; b < numWidgets; b++) {
+			Mesh* mesh = widgets[b]->getMesh();
+			if (! shared) {
+				delete mesh->getRenderData();
+				delete mesh->getData();
+			}
+			delete mesh;
+			delete widgets[b];
+		}
+	}
+	glewResetStubs();
+}
@@ -0,0 +1,247 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef TESTS_STUBS_GL_GLEW_GLEW_H_
+#define TESTS_STUBS_GL_GLEW_GLEW_H_
+
+/***************************************************************************************************
+ * Stands in for GLEW when the engine is built for the tests, which have no OpenGL context. As with
+ * GLEW every OpenGL function is called through a pointer, here each one points at a stub that does
+ * nothing, so a test can replace any of them to see how the engine uses OpenGL
+ ***************************************************************************************************/
+
+#ifndef GL_GLEXT_PROTOTYPES
+#define GL_GLEXT_PROTOTYPES 1
+#endif
+#include <GL/gl.h>
+#include <GL/glext.h>
+
+#define GLEW_OK 0
+
+/* The OpenGL functions used by the engine, GLEW_STUB_FUNCTION is applied to the name of each one
+ * without its 'gl' prefix */
+#define GLEW_STUB_FUNCTIONS \
+	GLEW_STUB_FUNCTION(ActiveTexture) \
+	GLEW_STUB_FUNCTION(AlphaFunc) \
+	GLEW_STUB_FUNCTION(AttachShader) \
+	GLEW_STUB_FUNCTION(BindBuffer) \
+	GLEW_STUB_FUNCTION(BindBufferBase) \
+	GLEW_STUB_FUNCTION(BindFramebuffer) \
+	GLEW_STUB_FUNCTION(BindSampler) \
+	GLEW_STUB_FUNCTION(BindTexture) \
+	GLEW_STUB_FUNCTION(BindVertexArray) \
+	GLEW_STUB_FUNCTION(BlendFunc) \
+	GLEW_STUB_FUNCTION(BufferData) \
+	GLEW_STUB_FUNCTION(BufferSubData) \
+	GLEW_STUB_FUNCTION(CheckFramebufferStatus) \
+	GLEW_STUB_FUNCTION(Clear) \
+	GLEW_STUB_FUNCTION(CompileShader) \
+	GLEW_STUB_FUNCTION(CopyBufferSubData) \
+	GLEW_STUB_FUNCTION(CreateProgram) \
+	GLEW_STUB_FUNCTION(CreateShader) \
+	GLEW_STUB_FUNCTION(CullFace) \
+	GLEW_STUB_FUNCTION(DeleteBuffers) \
+	GLEW_STUB_FUNCTION(DeleteProgram) \
+	GLEW_STUB_FUNCTION(DeleteSamplers) \
+	GLEW_STUB_FUNCTION(DeleteShader) \
+	GLEW_STUB_FUNCTION(DeleteTextures) \
+	GLEW_STUB_FUNCTION(DeleteVertexArrays) \
+	GLEW_STUB_FUNCTION(DepthFunc) \
+	GLEW_STUB_FUNCTION(DepthMask) \
+	GLEW_STUB_FUNCTION(DetachShader) \
+	GLEW_STUB_FUNCTION(Disable) \
+	GLEW_STUB_FUNCTION(DrawArrays) \
+	GLEW_STUB_FUNCTION(DrawBuffers) \
+	GLEW_STUB_FUNCTION(DrawElements) \
+	GLEW_STUB_FUNCTION(DrawElementsBaseVertex) \
+	GLEW_STUB_FUNCTION(Enable) \
+	GLEW_STUB_FUNCTION(EnableVertexAttribArray) \
+	GLEW_STUB_FUNCTION(FramebufferTexture2D) \
+	GLEW_STUB_FUNCTION(GenBuffers) \
+	GLEW_STUB_FUNCTION(GenFramebuffers) \
+	GLEW_STUB_FUNCTION(GenQueries) \
+	GLEW_STUB_FUNCTION(GenSamplers) \
+	GLEW_STUB_FUNCTION(GenTextures) \
+	GLEW_STUB_FUNCTION(GenVertexArrays) \
+	GLEW_STUB_FUNCTION(GenerateMipmap) \
+	GLEW_STUB_FUNCTION(GetActiveAttrib) \
+	GLEW_STUB_FUNCTION(GetActiveUniform) \
+	GLEW_STUB_FUNCTION(GetAttribLocation) \
+	GLEW_STUB_FUNCTION(GetInteger64v) \
+	GLEW_STUB_FUNCTION(GetProgramBinary) \
+	GLEW_STUB_FUNCTION(GetProgramInfoLog) \
+	GLEW_STUB_FUNCTION(GetProgramiv) \
+	GLEW_STUB_FUNCTION(GetQueryObjectiv) \
+	GLEW_STUB_FUNCTION(GetQueryObjectui64v) \
+	GLEW_STUB_FUNCTION(GetShaderInfoLog) \
+	GLEW_STUB_FUNCTION(GetShaderiv) \
+	GLEW_STUB_FUNCTION(GetString) \
+	GLEW_STUB_FUNCTION(GetUniformLocation) \
+	GLEW_STUB_FUNCTION(IsEnabled) \
+	GLEW_STUB_FUNCTION(LinkProgram) \
+	GLEW_STUB_FUNCTION(MaxShaderCompilerThreadsARB) \
+	GLEW_STUB_FUNCTION(MultiDrawArraysIndirect) \
+	GLEW_STUB_FUNCTION(MultiDrawElementsIndirect) \
+	GLEW_STUB_FUNCTION(PixelStorei) \
+	GLEW_STUB_FUNCTION(PolygonMode) \
+	GLEW_STUB_FUNCTION(ProgramBinary) \
+	GLEW_STUB_FUNCTION(ProgramParameteri) \
+	GLEW_STUB_FUNCTION(QueryCounter) \
+	GLEW_STUB_FUNCTION(SamplerParameterf) \
+	GLEW_STUB_FUNCTION(SamplerParameteri) \
+	GLEW_STUB_FUNCTION(Scissor) \
+	GLEW_STUB_FUNCTION(ShaderSource) \
+	GLEW_STUB_FUNCTION(TexImage2D) \
+	GLEW_STUB_FUNCTION(TexParameterf) \
+	GLEW_STUB_FUNCTION(TexParameteri) \
+	GLEW_STUB_FUNCTION(TexStorage2D) \
+	GLEW_STUB_FUNCTION(TexSubImage2D) \
+	GLEW_STUB_FUNCTION(Uniform1f) \
+	GLEW_STUB_FUNCTION(Uniform1i) \
+	GLEW_STUB_FUNCTION(Uniform3f) \
+	GLEW_STUB_FUNCTION(Uniform4f) \
+	GLEW_STUB_FUNCTION(UniformMatrix4fv) \
+	GLEW_STUB_FUNCTION(UseProgram) \
+	GLEW_STUB_FUNCTION(ValidateProgram) \
+	GLEW_STUB_FUNCTION(VertexAttribPointer) \
+	GLEW_STUB_FUNCTION(Viewport)
+
+/* The pointers the functions are called through */
+#define GLEW_STUB_FUNCTION(name) extern decltype(&::gl##name) __glew##name;
+GLEW_STUB_FUNCTIONS
+#undef GLEW_STUB_FUNCTION
+
+#define glActiveTexture __glewActiveTexture
+#define glAlphaFunc __glewAlphaFunc
+#define glAttachShader __glewAttachShader
+#define glBindBuffer __glewBindBuffer
+#define glBindBufferBase __glewBindBufferBase
+#define glBindFramebuffer __glewBindFramebuffer
+#define glBindSampler __glewBindSampler
+#define glBindTexture __glewBindTexture
+#define glBindVertexArray __glewBindVertexArray
+#define glBlendFunc __glewBlendFunc
+#define glBufferData __glewBufferData
+#define glBufferSubData __glewBufferSubData
+#define glCheckFramebufferStatus __glewCheckFramebufferStatus
+#define glClear __glewClear
+#define glCompileShader __glewCompileShader
+#define glCopyBufferSubData __glewCopyBufferSubData
+#define glCreateProgram __glewCreateProgram
+#define glCreateShader __glewCreateShader
+#define glCullFace __glewCullFace
+#define glDeleteBuffers __glewDeleteBuffers
+#define glDeleteProgram __glewDeleteProgram
+#define glDeleteSamplers __glewDeleteSamplers
+#define glDeleteShader __glewDeleteShader
+#define glDeleteTextures __glewDeleteTextures
+#define glDeleteVertexArrays __glewDeleteVertexArrays
+#define glDepthFunc __glewDepthFunc
+#define glDepthMask __glewDepthMask
+#define glDetachShader __glewDetachShader
+#define glDisable __glewDisable
+#define glDrawArrays __glewDrawArrays
+#define glDrawBuffers __glewDrawBuffers
+#define glDrawElements __glewDrawElements
+#define glDrawElementsBaseVertex __glewDrawElementsBaseVertex
+#define glEnable __glewEnable
+#define glEnableVertexAttribArray __glewEnableVertexAttribArray
+#define glFramebufferTexture2D __glewFramebufferTexture2D
+#define glGenBuffers __glewGenBuffers
+#define glGenFramebuffers __glewGenFramebuffers
+#define glGenQueries __glewGenQueries
+#define glGenSamplers __glewGenSamplers
+#define glGenTextures __glewGenTextures
+#define glGenVertexArrays __glewGenVertexArrays
+#define glGenerateMipmap __glewGenerateMipmap
+#define glGetActiveAttrib __glewGetActiveAttrib
+#define glGetActiveUniform __glewGetActiveUniform
+#define glGetAttribLocation __glewGetAttribLocation
+#define glGetInteger64v __glewGetInteger64v
+#define glGetProgramBinary __glewGetProgramBinary
+#define glGetProgramInfoLog __glewGetProgramInfoLog
+#define glGetProgramiv __glewGetProgramiv
+#define glGetQueryObjectiv __glewGetQueryObjectiv
+#define glGetQueryObjectui64v __glewGetQueryObjectui64v
+#define glGetShaderInfoLog __glewGetShaderInfoLog
+#define glGetShaderiv __glewGetShaderiv
+#define glGetString __glewGetString
+#define glGetUniformLocation __glewGetUniformLocation
+#define glIsEnabled __glewIsEnabled
+#define glLinkProgram __glewLinkProgram
+#define glMaxShaderCompilerThreadsARB __glewMaxShaderCompilerThreadsARB
+#define glMultiDrawArraysIndirect __glewMultiDrawArraysIndirect
+#define glMultiDrawElementsIndirect __glewMultiDrawElementsIndirect
+#define glPixelStorei __glewPixelStorei
+#define glPolygonMode __glewPolygonMode
+#define glProgramBinary __glewProgramBinary
+#define glProgramParameteri __glewProgramParameteri
+#define glQueryCounter __glewQueryCounter
+#define glSamplerParameterf __glewSamplerParameterf
+#define glSamplerParameteri __glewSamplerParameteri
+#define glScissor __glewScissor
+#define glShaderSource __glewShaderSource
+#define glTexImage2D __glewTexImage2D
+#define glTexParameterf __glewTexParameterf
+#define glTexParameteri __glewTexParameteri
+#define glTexStorage2D __glewTexStorage2D
+#define glTexSubImage2D __glewTexSubImage2D
+#define glUniform1f __glewUniform1f
+#define glUniform1i __glewUniform1i
+#define glUniform3f __glewUniform3f
+#define glUniform4f __glewUniform4f
+#define glUniformMatrix4fv __glewUniformMatrix4fv
+#define glUseProgram __glewUseProgram
+#define glValidateProgram __glewValidateProgram
+#define glVertexAttribPointer __glewVertexAttribPointer
+#define glViewport __glewViewport
+
+/* Whether each extension is supported, they all start as unsupported */
+extern GLboolean __GLEW_ARB_copy_buffer;
+#define GLEW_ARB_copy_buffer __GLEW_ARB_copy_buffer
+extern GLboolean __GLEW_ARB_draw_elements_base_vertex;
+#define GLEW_ARB_draw_elements_base_vertex __GLEW_ARB_draw_elements_base_vertex
+extern GLboolean __GLEW_ARB_get_program_binary;
+#define GLEW_ARB_get_program_binary __GLEW_ARB_get_program_binary
+extern GLboolean __GLEW_ARB_multi_draw_indirect;
+#define GLEW_ARB_multi_draw_indirect __GLEW_ARB_multi_draw_indirect
+extern GLboolean __GLEW_ARB_parallel_shader_compile;
+#define GLEW_ARB_parallel_shader_compile __GLEW_ARB_parallel_shader_compile
+extern GLboolean __GLEW_ARB_sampler_objects;
+#define GLEW_ARB_sampler_objects __GLEW_ARB_sampler_objects
+extern GLboolean __GLEW_ARB_shader_draw_parameters;
+#define GLEW_ARB_shader_draw_parameters __GLEW_ARB_shader_draw_parameters
+extern GLboolean __GLEW_ARB_shader_storage_buffer_object;
+#define GLEW_ARB_shader_storage_buffer_object __GLEW_ARB_shader_storage_buffer_object
+extern GLboolean __GLEW_ARB_texture_storage;
+#define GLEW_ARB_texture_storage __GLEW_ARB_texture_storage
+extern GLboolean __GLEW_ARB_timer_query;
+#define GLEW_ARB_timer_query __GLEW_ARB_timer_query
+
+GLenum glewInit();
+
+/* Points every function back at its stub and marks every extension as unsupported again */
+void glewResetStubs();
+
+/* The stub each function points at by default, it does nothing and returns zero */
+template <typename Function> struct GLStub;
+template <typename Result, typename... Arguments> struct GLStub<Result (APIENTRY *)(Arguments...)> {
+	static Result APIENTRY call(Arguments...) { return Result(); }
+};
+
+#endif /* TESTS_STUBS_GL_GLEW_GLEW_H_ */
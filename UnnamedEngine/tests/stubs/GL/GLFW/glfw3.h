@@ -0,0 +1,120 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef TESTS_STUBS_GL_GLFW_GLFW3_H_
+#define TESTS_STUBS_GL_GLFW_GLFW3_H_
+
+#include <GL/GLEW/glew.h>
+
+/***************************************************************************************************
+ * Stands in for GLFW when the engine is built for the tests. No window can be created, so the
+ * engine's game loop never runs, but the time and input functions behave as they would without
+ * any input
+ ***************************************************************************************************/
+
+typedef struct GLFWwindow GLFWwindow;
+typedef struct GLFWmonitor GLFWmonitor;
+
+typedef struct GLFWvidmode {
+	int width;
+	int height;
+	int redBits;
+	int greenBits;
+	int blueBits;
+	int refreshRate;
+} GLFWvidmode;
+
+typedef void (*GLFWkeyfun)(GLFWwindow*, int, int, int, int);
+typedef void (*GLFWcharfun)(GLFWwindow*, unsigned int);
+typedef void (*GLFWcursorposfun)(GLFWwindow*, double, double);
+typedef void (*GLFWcursorenterfun)(GLFWwindow*, int);
+typedef void (*GLFWmousebuttonfun)(GLFWwindow*, int, int, int);
+typedef void (*GLFWscrollfun)(GLFWwindow*, double, double);
+
+#define GLFW_RELEASE               0
+#define GLFW_PRESS                 1
+#define GLFW_REPEAT                2
+
+#define GLFW_KEY_A                 65
+#define GLFW_KEY_C                 67
+#define GLFW_KEY_D                 68
+#define GLFW_KEY_M                 77
+#define GLFW_KEY_S                 83
+#define GLFW_KEY_V                 86
+#define GLFW_KEY_W                 87
+#define GLFW_KEY_X                 88
+#define GLFW_KEY_ESCAPE            256
+#define GLFW_KEY_BACKSPACE         259
+#define GLFW_KEY_DELETE            261
+#define GLFW_KEY_RIGHT             262
+#define GLFW_KEY_LEFT              263
+#define GLFW_KEY_DOWN              264
+#define GLFW_KEY_UP                265
+#define GLFW_KEY_F3                292
+#define GLFW_KEY_LEFT_SHIFT        340
+#define GLFW_KEY_LEFT_CONTROL      341
+#define GLFW_KEY_RIGHT_SHIFT       344
+#define GLFW_KEY_RIGHT_CONTROL     345
+
+#define GLFW_MOUSE_BUTTON_LEFT     0
+#define GLFW_MOUSE_BUTTON_RIGHT    1
+#define GLFW_MOUSE_BUTTON_MIDDLE   2
+
+#define GLFW_RESIZABLE             0x00020003
+#define GLFW_DECORATED             0x00020005
+#define GLFW_FLOATING              0x00020007
+#define GLFW_RED_BITS              0x00021001
+#define GLFW_GREEN_BITS            0x00021002
+#define GLFW_BLUE_BITS             0x00021003
+#define GLFW_SAMPLES               0x0002100D
+#define GLFW_REFRESH_RATE          0x0002100F
+
+#define GLFW_CURSOR                0x00033001
+#define GLFW_CURSOR_NORMAL         0x00034001
+#define GLFW_CURSOR_DISABLED       0x00034003
+
+int glfwInit();
+void glfwTerminate();
+double glfwGetTime();
+
+void glfwDefaultWindowHints();
+void glfwWindowHint(int hint, int value);
+GLFWmonitor* glfwGetPrimaryMonitor();
+const GLFWvidmode* glfwGetVideoMode(GLFWmonitor* monitor);
+GLFWwindow* glfwCreateWindow(int width, int height, const char* title, GLFWmonitor* monitor, GLFWwindow* share);
+void glfwDestroyWindow(GLFWwindow* window);
+void glfwMakeContextCurrent(GLFWwindow* window);
+void glfwSwapInterval(int interval);
+void glfwSwapBuffers(GLFWwindow* window);
+void glfwPollEvents();
+int glfwWindowShouldClose(GLFWwindow* window);
+void glfwSetWindowPos(GLFWwindow* window, int x, int y);
+void glfwGetFramebufferSize(GLFWwindow* window, int* width, int* height);
+
+GLFWkeyfun glfwSetKeyCallback(GLFWwindow* window, GLFWkeyfun callback);
+GLFWcharfun glfwSetCharCallback(GLFWwindow* window, GLFWcharfun callback);
+GLFWcursorposfun glfwSetCursorPosCallback(GLFWwindow* window, GLFWcursorposfun callback);
+GLFWcursorenterfun glfwSetCursorEnterCallback(GLFWwindow* window, GLFWcursorenterfun callback);
+GLFWmousebuttonfun glfwSetMouseButtonCallback(GLFWwindow* window, GLFWmousebuttonfun callback);
+GLFWscrollfun glfwSetScrollCallback(GLFWwindow* window, GLFWscrollfun callback);
+int glfwGetKey(GLFWwindow* window, int key);
+int glfwGetMouseButton(GLFWwindow* window, int button);
+void glfwSetCursorPos(GLFWwindow* window, double x, double y);
+void glfwSetInputMode(GLFWwindow* window, int mode, int value);
+
+#endif /* TESTS_STUBS_GL_GLFW_GLFW3_H_ */
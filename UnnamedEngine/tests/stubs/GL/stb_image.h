@@ -0,0 +1,31 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef TESTS_STUBS_GL_STB_IMAGE_H_
+#define TESTS_STUBS_GL_STB_IMAGE_H_
+
+/***************************************************************************************************
+ * Stands in for stb_image when the engine is built for the tests. Only binary PGM and PPM images
+ * (P5 and P6) with 8 bits per channel can be loaded, so tests can write the images they need
+ ***************************************************************************************************/
+
+unsigned char* stbi_load(const char* path, int* width, int* height, int* numComponents, int requiredComponents);
+void stbi_image_free(void* pixels);
+int stbi_info(const char* path, int* width, int* height, int* numComponents);
+
+#endif /* TESTS_STUBS_GL_STB_IMAGE_H_ */
@@ -0,0 +1,248 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+
+#include <GL/GLEW/glew.h>
+#include <GL/GLFW/glfw3.h>
+#include <GL/stb_image.h>
+#include <assimp/cimport.h>
+
+#include "utils/ClipboardUtils.h"
+
+/***************************************************************************************************
+ * GLEW
+ ***************************************************************************************************/
+
+#define GLEW_STUB_FUNCTION(name) decltype(__glew##name) __glew##name = &GLStub<decltype(__glew##name)>::call;
+GLEW_STUB_FUNCTIONS
+#undef GLEW_STUB_FUNCTION
+
+GLboolean __GLEW_ARB_copy_buffer = GL_FALSE;
+GLboolean __GLEW_ARB_draw_elements_base_vertex = GL_FALSE;
+GLboolean __GLEW_ARB_get_program_binary = GL_FALSE;
+GLboolean __GLEW_ARB_multi_draw_indirect = GL_FALSE;
+GLboolean __GLEW_ARB_parallel_shader_compile = GL_FALSE;
+GLboolean __GLEW_ARB_sampler_objects = GL_FALSE;
+GLboolean __GLEW_ARB_shader_draw_parameters = GL_FALSE;
+GLboolean __GLEW_ARB_shader_storage_buffer_object = GL_FALSE;
+GLboolean __GLEW_ARB_texture_storage = GL_FALSE;
+GLboolean __GLEW_ARB_timer_query = GL_FALSE;
+
+/* The last name given out for any type of object, names are never 0 as that means no object */
+static GLuint stub_lastName = 0;
+
+static void APIENTRY stub_genNames(GLsizei count, GLuint* names) {
+	for (GLsizei a = 0; a < count; a++)
+		names[a] = ++stub_lastName;
+}
+
+static GLuint APIENTRY stub_createName() {
+	return ++stub_lastName;
+}
+
+static GLuint APIENTRY stub_createShader(GLenum type) {
+	return ++stub_lastName;
+}
+
+/* Shaders always compile and link, and have no uniforms, attributes or logs */
+static void APIENTRY stub_getShaderiv(GLuint shader, GLenum name, GLint* value) {
+	*value = name == GL_COMPILE_STATUS ? GL_TRUE : 0;
+}
+
+static void APIENTRY stub_getProgramiv(GLuint program, GLenum name, GLint* value) {
+	*value = (name == GL_LINK_STATUS || name == GL_VALIDATE_STATUS || name == GL_COMPLETION_STATUS_ARB) ? GL_TRUE : 0;
+}
+
+static GLenum APIENTRY stub_checkFramebufferStatus(GLenum target) {
+	return GL_FRAMEBUFFER_COMPLETE;
+}
+
+static const GLubyte* APIENTRY stub_getString(GLenum name) {
+	return (const GLubyte*) "Stub";
+}
+
+void glewResetStubs() {
+	#define GLEW_STUB_FUNCTION(name) __glew##name = &GLStub<decltype(__glew##name)>::call;
+	GLEW_STUB_FUNCTIONS
+	#undef GLEW_STUB_FUNCTION
+
+	__glewGenBuffers = stub_genNames;
+	__glewGenFramebuffers = stub_genNames;
+	__glewGenQueries = stub_genNames;
+	__glewGenSamplers = stub_genNames;
+	__glewGenTextures = stub_genNames;
+	__glewGenVertexArrays = stub_genNames;
+	__glewCreateProgram = stub_createName;
+	__glewCreateShader = stub_createShader;
+	__glewGetShaderiv = stub_getShaderiv;
+	__glewGetProgramiv = stub_getProgramiv;
+	__glewCheckFramebufferStatus = stub_checkFramebufferStatus;
+	__glewGetString = stub_getString;
+
+	__GLEW_ARB_copy_buffer = GL_FALSE;
+	__GLEW_ARB_draw_elements_base_vertex = GL_FALSE;
+	__GLEW_ARB_get_program_binary = GL_FALSE;
+	__GLEW_ARB_multi_draw_indirect = GL_FALSE;
+	__GLEW_ARB_parallel_shader_compile = GL_FALSE;
+	__GLEW_ARB_sampler_objects = GL_FALSE;
+	__GLEW_ARB_shader_draw_parameters = GL_FALSE;
+	__GLEW_ARB_shader_storage_buffer_object = GL_FALSE;
+	__GLEW_ARB_texture_storage = GL_FALSE;
+	__GLEW_ARB_timer_query = GL_FALSE;
+}
+
+GLenum glewInit() {
+	return GLEW_OK;
+}
+
+/* Points the functions that give out names or report a status at stubs that behave like a driver
+ * would, before anything else is initialised */
+static struct GLStubInitialiser {
+	GLStubInitialiser() { glewResetStubs(); }
+} stub_initialiser;
+
+/***************************************************************************************************/
+
+/***************************************************************************************************
+ * GLFW
+ ***************************************************************************************************/
+
+int glfwInit() { return 1; }
+void glfwTerminate() {}
+
+double glfwGetTime() {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void glfwDefaultWindowHints() {}
+void glfwWindowHint(int hint, int value) {}
+GLFWmonitor* glfwGetPrimaryMonitor() { return NULL; }
+
+const GLFWvidmode* glfwGetVideoMode(GLFWmonitor* monitor) {
+	static GLFWvidmode mode = { 1280, 720, 8, 8, 8, 60 };
+	return &mode;
+}
+
+GLFWwindow* glfwCreateWindow(int width, int height, const char* title, GLFWmonitor* monitor, GLFWwindow* share) { return NULL; }
+void glfwDestroyWindow(GLFWwindow* window) {}
+void glfwMakeContextCurrent(GLFWwindow* window) {}
+void glfwSwapInterval(int interval) {}
+void glfwSwapBuffers(GLFWwindow* window) {}
+void glfwPollEvents() {}
+int glfwWindowShouldClose(GLFWwindow* window) { return 1; }
+void glfwSetWindowPos(GLFWwindow* window, int x, int y) {}
+
+void glfwGetFramebufferSize(GLFWwindow* window, int* width, int* height) {
+	*width = 0;
+	*height = 0;
+}
+
+GLFWkeyfun glfwSetKeyCallback(GLFWwindow* window, GLFWkeyfun callback) { return NULL; }
+GLFWcharfun glfwSetCharCallback(GLFWwindow* window, GLFWcharfun callback) { return NULL; }
+GLFWcursorposfun glfwSetCursorPosCallback(GLFWwindow* window, GLFWcursorposfun callback) { return NULL; }
+GLFWcursorenterfun glfwSetCursorEnterCallback(GLFWwindow* window, GLFWcursorenterfun callback) { return NULL; }
+GLFWmousebuttonfun glfwSetMouseButtonCallback(GLFWwindow* window, GLFWmousebuttonfun callback) { return NULL; }
+GLFWscrollfun glfwSetScrollCallback(GLFWwindow* window, GLFWscrollfun callback) { return NULL; }
+int glfwGetKey(GLFWwindow* window, int key) { return GLFW_RELEASE; }
+int glfwGetMouseButton(GLFWwindow* window, int button) { return GLFW_RELEASE; }
+void glfwSetCursorPos(GLFWwindow* window, double x, double y) {}
+void glfwSetInputMode(GLFWwindow* window, int mode, int value) {}
+
+/***************************************************************************************************/
+
+/***************************************************************************************************
+ * stb_image
+ ***************************************************************************************************/
+
+/* Reads the header of a binary PGM or PPM image, leaving the file at the start of the pixels */
+static bool stub_readHeader(FILE* file, int* width, int* height, int* numComponents) {
+	char magic[3] = { 0 };
+	int maxValue = 0;
+	if (fscanf(file, "%2s %d %d %d", magic, width, height, &maxValue) != 4 || maxValue != 255)
+		return false;
+	if (strcmp(magic, "P5") == 0)
+		*numComponents = 1;
+	else if (strcmp(magic, "P6") == 0)
+		*numComponents = 3;
+	else
+		return false;
+	//A single whitespace character comes between the header and the pixels
+	fgetc(file);
+	return *width > 0 && *height > 0;
+}
+
+unsigned char* stbi_load(const char* path, int* width, int* height, int* numComponents, int requiredComponents) {
+	FILE* file = fopen(path, "rb");
+	if (file == NULL)
+		return NULL;
+	unsigned char* pixels = NULL;
+	if (stub_readHeader(file, width, height, numComponents) && (requiredComponents == 0 || requiredComponents == *numComponents)) {
+		size_t size = (size_t) *width * *height * *numComponents;
+		pixels = (unsigned char*) malloc(size);
+		if (fread(pixels, 1, size, file) != size) {
+			free(pixels);
+			pixels = NULL;
+		}
+	}
+	fclose(file);
+	return pixels;
+}
+
+void stbi_image_free(void* pixels) {
+	free(pixels);
+}
+
+int stbi_info(const char* path, int* width, int* height, int* numComponents) {
+	FILE* file = fopen(path, "rb");
+	if (file == NULL)
+		return 0;
+	bool read = stub_readHeader(file, width, height, numComponents);
+	fclose(file);
+	return read ? 1 : 0;
+}
+
+/***************************************************************************************************/
+
+/***************************************************************************************************
+ * Assimp
+ ***************************************************************************************************/
+
+const aiScene* aiImportFile(const char* path, unsigned int flags) { return NULL; }
+void aiReleaseImport(const aiScene* scene) {}
+
+/***************************************************************************************************/
+
+/***************************************************************************************************
+ * The ClipboardUtils class, which is only implemented for Windows, keeps the text in memory
+ ***************************************************************************************************/
+
+static std::string stub_clipboard;
+
+void ClipboardUtils::setText(std::string text) {
+	stub_clipboard = text;
+}
+
+std::string ClipboardUtils::getText() {
+	return stub_clipboard;
+}
+
+/***************************************************************************************************/
@@ -0,0 +1,28 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef TESTS_STUBS_ASSIMP_CIMPORT_H_
+#define TESTS_STUBS_ASSIMP_CIMPORT_H_
+
+#include "scene.h"
+
+/* Always fails, as there is no importer in the tests */
+const aiScene* aiImportFile(const char* path, unsigned int flags);
+void aiReleaseImport(const aiScene* scene);
+
+#endif /* TESTS_STUBS_ASSIMP_CIMPORT_H_ */
@@ -0,0 +1,89 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef TESTS_STUBS_ASSIMP_SCENE_H_
+#define TESTS_STUBS_ASSIMP_SCENE_H_
+
+/***************************************************************************************************
+ * Stands in for Assimp when the engine is built for the tests, with only the parts the engine
+ * uses. Nothing can be imported, so models have to be built from MeshData
+ ***************************************************************************************************/
+
+#define AI_SUCCESS 0
+#define AI_FAILURE -1
+
+#define AI_MATKEY_COLOR_AMBIENT  "$clr.ambient", 0, 0
+#define AI_MATKEY_COLOR_DIFFUSE  "$clr.diffuse", 0, 0
+#define AI_MATKEY_COLOR_SPECULAR "$clr.specular", 0, 0
+#define AI_MATKEY_SHININESS      "$mat.shininess", 0, 0
+
+#define aiProcess_Triangulate 0x8
+#define aiProcess_FlipUVs     0x800000
+
+enum aiTextureType {
+	aiTextureType_NONE,
+	aiTextureType_DIFFUSE
+};
+
+struct aiVector3D {
+	float x;
+	float y;
+	float z;
+};
+
+struct aiColor3D {
+	float r;
+	float g;
+	float b;
+	aiColor3D() : r(0), g(0), b(0) {}
+	aiColor3D(float r, float g, float b) : r(r), g(g), b(b) {}
+};
+
+struct aiString {
+	inline const char* C_Str() const { return ""; }
+};
+
+struct aiFace {
+	unsigned int mNumIndices;
+	unsigned int* mIndices;
+};
+
+struct aiMesh {
+	unsigned int mNumVertices;
+	unsigned int mNumFaces;
+	aiVector3D* mVertices;
+	aiVector3D* mNormals;
+	aiVector3D* mTextureCoords[8];
+	aiFace* mFaces;
+	unsigned int mMaterialIndex;
+};
+
+struct aiMaterial {
+	inline unsigned int GetTextureCount(aiTextureType type) const { return 0; }
+	inline int GetTexture(aiTextureType type, unsigned int index, aiString* path, void* mapping, void* uvIndex, void* blend, void* op, void* mapMode) const { return AI_FAILURE; }
+	template <typename T> inline int Get(const char* key, unsigned int type, unsigned int index, T& value) const { return AI_FAILURE; }
+};
+
+struct aiScene {
+	unsigned int mNumMeshes;
+	aiMesh** mMeshes;
+	unsigned int mNumMaterials;
+	aiMaterial** mMaterials;
+};
+
+#endif /* TESTS_STUBS_ASSIMP_SCENE_H_ */
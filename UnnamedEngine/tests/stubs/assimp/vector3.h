@@ -0,0 +1,25 @@
+/*****************************************************************************
+ *
+ *   Copyright 2015 Joel Davies
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef TESTS_STUBS_ASSIMP_VECTOR3_H_
+#define TESTS_STUBS_ASSIMP_VECTOR3_H_
+
+/* Everything the engine uses is declared in scene.h */
+#include "scene.h"
+
+#endif /* TESTS_STUBS_ASSIMP_VECTOR3_H_ */